@@ -103,7 +103,15 @@ int main(int argc, char** argv)
     po::options_description desc("Allowed options");
     desc.add_options()("help", "show help message")("port", po::value<int>()->default_value(42123),
                                                     "tcp server port")("debug", "enable debug output")("dump", "show variables")("paused", "start paused")("headless", "run without gui")(
-        "threadless", "run without threading")("fatal_exceptions", "abort execution on exception")("disable_thread_grouping", "by default create one thread per node")("input", "config file to load");
+        "threadless", "run without threading")("fatal_exceptions", "abort execution on exception")("disable_thread_grouping", "by default create one thread per node")("work_stealing", "execute all thread groups on a shared pool of workers")(
+        "worker_threads", po::value<int>()->default_value(0), "number of workers for work stealing, 0 = number of cores")(
+        "subprocess_sandboxes", po::value<int>()->default_value(0), "number of sandbox processes shared by isolated nodes, 0 = one per node")(
+        "subprocess_standby", "keep a pre-forked standby for every sandbox process")(
+        "scheduling_policy", po::value<std::string>()->default_value("fifo"), "order of ready nodes: fifo or critical_path")(
+        "fuse_chains", "execute linear chains of nodes in the same thread back to back")(
+        "loading_threads", po::value<int>()->default_value(1), "number of threads constructing nodes when a graph is loaded, 0 = number of cores, 1 = sequential")(
+        "profile-startup", "print how long the phases of booting took")(
+        "trace_file", po::value<std::string>()->default_value(""), "record execution spans and write them to this file in the chrome trace format on exit")("input", "config file to load");
 
     po::positional_options_description p;
     p.add("input", 1);
@@ -201,6 +209,15 @@ int main(int argc, char** argv)
     settings.set("headless", headless);
     settings.set("threadless", vm.count("threadless") > 0);
     settings.set("thread_grouping", vm.count("disable_thread_grouping") == 0);
+    settings.set("work_stealing", vm.count("work_stealing") > 0);
+    settings.set("worker_threads", vm["worker_threads"].as<int>());
+    settings.set("subprocess_sandboxes", vm["subprocess_sandboxes"].as<int>());
+    settings.set("subprocess_standby", vm.count("subprocess_standby") > 0);
+    settings.set("scheduling_policy", vm["scheduling_policy"].as<std::string>());
+    settings.set("fuse_chains", vm.count("fuse_chains") > 0);
+    settings.set("loading_threads", vm["loading_threads"].as<int>());
+    settings.set("profile_startup", vm.count("profile-startup") > 0);
+    settings.set("trace_file", vm["trace_file"].as<std::string>());
     settings.set("additional_args", additional_args);
     settings.set("initially_paused", vm.count("paused") > 0);
     settings.set("port", vm["port"].as<int>());
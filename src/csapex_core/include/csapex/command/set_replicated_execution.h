@@ -0,0 +1,45 @@
+#ifndef SET_REPLICATED_EXECUTION_H
+#define SET_REPLICATED_EXECUTION_H
+
+/// COMPONENT
+#include "command_impl.hpp"
+#include <csapex/utility/uuid.h>
+#include <csapex/model/execution_type.h>
+
+namespace csapex
+{
+namespace command
+{
+class CSAPEX_COMMAND_EXPORT SetReplicatedExecution : public CommandImplementation<SetReplicatedExecution>
+{
+    COMMAND_HEADER(SetReplicatedExecution);
+
+public:
+    /**
+     * @brief SetReplicatedExecution lets a node process successive tokens with the given number of instances,
+     *        a count of one switches back to direct execution
+     */
+    SetReplicatedExecution(const AUUID& graph_uuid, const UUID& node, int replicas);
+
+    std::string getDescription() const override;
+
+    void serialize(SerializationBuffer& data, SemanticVersion& version) const override;
+    void deserialize(const SerializationBuffer& data, const SemanticVersion& version) override;
+
+protected:
+    bool doExecute() override;
+    bool doUndo() override;
+    bool doRedo() override;
+
+private:
+    UUID uuid;
+    int replicas_;
+
+    ExecutionType was_type_;
+    int was_replicas_;
+};
+
+}  // namespace command
+
+}  // namespace csapex
+#endif  // SET_REPLICATED_EXECUTION_H
@@ -0,0 +1,33 @@
+#ifndef BINARY_CONFIG_H
+#define BINARY_CONFIG_H
+
+/// PROJECT
+#include <csapex_core/csapex_core_export.h>
+#include <csapex/serialization/serialization_fwd.h>
+#include <csapex/utility/yaml.h>
+
+/// SYSTEM
+#include <string>
+
+namespace csapex
+{
+/**
+ * @brief The BinaryConfig class stores configurations as a compact binary encoding of their YAML tree.
+ *        Repeated strings are written once, reading does not need to run the YAML parser.
+ *        Scalars keep their textual representation, tags and styles are not preserved.
+ */
+class CSAPEX_CORE_EXPORT BinaryConfig
+{
+public:
+    static bool isBinaryConfig(const std::string& file);
+
+    static void save(const std::string& file, const YAML::Node& node);
+    static YAML::Node load(const std::string& file);
+
+    static void write(SerializationBuffer& data, const YAML::Node& node);
+    static YAML::Node read(const SerializationBuffer& data);
+};
+
+}  // namespace csapex
+
+#endif  // BINARY_CONFIG_H
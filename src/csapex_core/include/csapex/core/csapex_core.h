@@ -27,6 +27,7 @@ class ClassLoader;
 namespace csapex
 {
 class Profiler;
+class Trace;
 
 class CSAPEX_CORE_EXPORT CsApexCore : public Observer, public Notifier, public Profilable
 {
@@ -119,6 +120,9 @@ private:
     CsApexCore(Settings& settings_, ExceptionHandler& handler, PluginLocatorPtr plugin_locator);
     CorePluginPtr makeCorePlugin(const std::string& name);
 
+    std::unique_ptr<Trace> profileStartup(const std::string& phase);
+    void reportStartupProfile();
+
 private:
     bool is_root_;
 
@@ -143,6 +147,7 @@ private:
     std::shared_ptr<CommandDispatcher> dispatcher_;
 
     std::shared_ptr<Profiler> profiler_;
+    TimerPtr startup_timer_;
 
     std::shared_ptr<PluginManager<CorePlugin>> core_plugin_manager;
     std::map<std::string, std::shared_ptr<CorePlugin>> core_plugins_;
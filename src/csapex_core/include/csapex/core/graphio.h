@@ -25,6 +25,11 @@ public:
 public:
     // options
     void setIgnoreForwardingConnections(bool ignore);
+    /**
+     * @brief setLoadingThreads sets how many nodes are constructed in parallel, 0 means one per core.
+     *        The default of 1 loads sequentially, node_constructed is always emitted on the loading thread.
+     */
+    void setLoadingThreads(std::size_t threads);
 
     // api
     void saveSettings(YAML::Node& yaml);
@@ -47,7 +52,6 @@ public:
 private:
     void saveNodes(YAML::Node& yaml);
     void loadNodes(const YAML::Node& doc, SemanticVersion version);
-    void loadNode(const YAML::Node& doc, SemanticVersion version);
 
     void saveConnections(YAML::Node& yaml);
     void loadConnections(const YAML::Node& doc, SemanticVersion version);
@@ -63,9 +67,10 @@ protected:
     void saveConnections(YAML::Node& yaml, const std::vector<ConnectionDescription>& connections);
 
     void serializeNode(YAML::Node& doc, NodeFacadeImplementationConstPtr node_handle);
-    void deserializeNode(const YAML::Node& doc, NodeFacadeImplementationPtr node_handle, SemanticVersion version);
+    void deserializeNodeState(const YAML::Node& doc, NodeFacadeImplementationPtr node_handle, SemanticVersion version);
+    void insertNode(const YAML::Node& doc, NodeFacadeImplementationPtr node_handle, SemanticVersion version);
 
-    void loadConnection(ConnectorPtr from, const UUID& to_uuid, const std::string& connection_type, SemanticVersion version);
+    void loadConnection(ConnectorPtr from, const UUID& to_uuid, const std::string& connection_type, SemanticVersion version, int queue_capacity = 1);
 
     UUID readNodeUUID(std::weak_ptr<UUIDProvider> parent, const YAML::Node& doc);
     UUID readConnectorUUID(std::weak_ptr<UUIDProvider> parent, const YAML::Node& doc);
@@ -80,6 +85,8 @@ private:
 
     bool ignore_forwarding_connections_;
     bool throw_on_error_;
+
+    std::size_t loading_threads_;
 };
 
 }  // namespace csapex
@@ -18,6 +18,7 @@ class CSAPEX_CORE_EXPORT Settings
 public:
     static const std::string settings_file;
     static const std::string config_extension;
+    static const std::string config_extension_binary;
     static const std::string template_extension;
     static const std::string message_extension;
     static const std::string message_extension_compressed;
@@ -35,7 +35,10 @@ public:
     void registerNodeType(NodeConstructor::Ptr provider, bool suppress_signals = false);
 
     NodeFacadeImplementationPtr makeNode(const std::string& type, const UUID& uuid, const UUIDProviderPtr& uuid_provider);
-    NodeFacadeImplementationPtr makeNode(const std::string& type, const UUID& uuid, const UUIDProviderPtr& uuid_provider, NodeStatePtr state);
+    /**
+     * @brief makeNode with suppress_signals does not emit node_constructed, the caller has to do it
+     */
+    NodeFacadeImplementationPtr makeNode(const std::string& type, const UUID& uuid, const UUIDProviderPtr& uuid_provider, NodeStatePtr state, bool suppress_signals = false);
 
     NodeFacadeImplementationPtr makeGraph(const UUID& uuid, const UUIDProviderPtr& uuid_provider);
     NodeFacadeImplementationPtr makeGraph(const UUID& uuid, const UUIDProviderPtr& uuid_provider, NodeStatePtr state);
@@ -12,6 +12,7 @@
 #include <csapex/model/connection_description.h>
 
 /// SYSTEM
+#include <atomic>
 #include <memory>
 #include <vector>
 #include <deque>
@@ -70,6 +71,39 @@ public:
 
     bool contains(Connector* c) const;
 
+    /**
+     * @brief setQueueCapacity sets how many tokens the connection can buffer.
+     *        With a capacity of one the producer has to wait until the consumer is done,
+     *        larger capacities let the producer continue while earlier tokens are still being processed.
+     */
+    void setQueueCapacity(std::size_t capacity);
+    std::size_t getQueueCapacity() const;
+
+    /**
+     * @brief reserveQueueCapacity lets the consumer buffer at least capacity tokens, 0 removes the reservation.
+     *        The reservation is not part of the configured capacity, which is the one that is saved.
+     */
+    void reserveQueueCapacity(std::size_t capacity);
+    std::size_t getReservedQueueCapacity() const;
+    std::size_t getQueuedTokenCount() const;
+
+    /**
+     * @brief canAcceptToken
+     * @return true, iff the producer may set the next token
+     */
+    bool canAcceptToken() const;
+
+    /**
+     * @brief getQueuedTokens
+     * @return the buffered tokens behind the front token, oldest first
+     */
+    std::vector<TokenPtr> getQueuedTokens() const;
+
+    /**
+     * @brief clearQueuedTokens drops the buffered tokens behind the front token
+     */
+    void clearQueuedTokens();
+
     virtual void setToken(const TokenPtr& msg, const bool silent = false);
 
     TokenPtr getToken() const;
@@ -84,6 +118,14 @@ public:
     bool holdsToken() const;
     bool holdsActiveToken() const;
 
+    /**
+     * @brief countMutableAccess records whether a consumer could modify a token of this connection in place
+     *        or whether it had to copy it, because the data was still shared
+     */
+    void countMutableAccess(bool copied);
+    std::size_t getAvoidedCopyCount() const;
+    std::size_t getCopyCount() const;
+
     bool isActive() const;
     void setActive(bool active);
 
@@ -103,6 +145,10 @@ public:
     void notifyMessageSet();
     void notifyMessageProcessed();
 
+private:
+    std::size_t getEffectiveQueueCapacity() const;
+    void queueCapacityChanged();
+
 public:
     slim_signal::Signal<void()> deleted;
 
@@ -141,13 +187,24 @@ protected:
 
     std::vector<FulcrumPtr> fulcrums_;
 
+    // state_ and message_ describe the token at the front, which is the one the consumer sees
     State state_;
     TokenPtr message_;
 
+    // tokens waiting behind message_, at most the configured or reserved capacity - 1
+    std::deque<TokenPtr> queue_;
+    std::size_t queue_capacity_;
+    std::size_t reserved_queue_capacity_;
+    // the producer has not been notified about the last token yet, because the queue was full
+    bool producer_waiting_;
+
     static int next_connection_id_;
 
     int seq_ = 0;
 
+    std::atomic<std::size_t> avoided_copies_{ 0 };
+    std::atomic<std::size_t> copies_{ 0 };
+
     mutable std::recursive_mutex sync;
 };
 
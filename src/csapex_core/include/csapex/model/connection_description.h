@@ -29,6 +29,8 @@ public:
 
     std::vector<Fulcrum> fulcrums;
 
+    int queue_capacity;
+
     ConnectionDescription(const UUID& from, const UUID& to, const TokenDataConstPtr& type, int id, int seq, bool active, const std::vector<Fulcrum>& fulcrums);
 
     ConnectionDescription(const ConnectionDescription& other);
@@ -37,6 +39,7 @@ public:
 
     ConnectionDescription();
 
+    SemanticVersion getVersion() const override;
     void serialize(SerializationBuffer& data, SemanticVersion& version) const override;
     void deserialize(const SerializationBuffer& data, const SemanticVersion& version) override;
 
@@ -7,7 +7,8 @@ enum class ExecutionType
 {
     AUTO = 0,
     DIRECT,
-    SUBPROCESS
+    SUBPROCESS,
+    REPLICATED
 };
 }
 
@@ -4,8 +4,26 @@
 /// COMPONENT
 #include <csapex/model/graph.h>
 
+/// SYSTEM
+#include <unordered_map>
+
 namespace csapex
 {
+struct FusedChainReport
+{
+    std::vector<UUID> nodes;
+    // number of times a node of the chain was executed directly after its predecessor
+    std::size_t fused_executions;
+    // sum of the mean execution times of the nodes in microseconds
+    double execution_time;
+    // mean time between scheduling and executing a node in microseconds, saved for every fused node
+    double handover_latency;
+    // an estimate, not a measurement: (execution_time + (n - 1) * handover_latency) / execution_time for a chain of n nodes.
+    // It assumes that fusion saves every handover and nothing else changes, so it is an upper bound that measurements fall far short of.
+    // csapex_benchmarks measures the actual speedup against unfused execution as measured_fusion_speedup.
+    double modeled_speedup;
+};
+
 class GraphImplementation : public Graph
 {
 public:
@@ -69,6 +87,18 @@ public:
 
     void analyzeGraph();
 
+    /**
+     * @brief getFusedChains lists the linear chains found by the last analysis, in execution order.
+     *        A node is fused with its child, if it is the only child and the node is its only parent.
+     *        Whether the chain is executed in one task is decided at runtime, see Scheduler::setChainFusion.
+     */
+    std::vector<std::vector<UUID>> getFusedChains() const;
+    /**
+     * @brief getFusedChainReports summarizes how often the chains were fused and how long their nodes took.
+     *        The speedup in the reports is modeled from these statistics, it is not measured.
+     */
+    std::vector<FusedChainReport> getFusedChainReports() const;
+
     void setNodeFacade(NodeFacadeImplementation* nf);
 
     // iterators
@@ -83,12 +113,18 @@ private:
 
     void buildConnectedComponents();
     void calculateDepths();
+    void calculateCriticalPaths();
+    void calculateFusedChains();
 
     std::set<graph::Vertex*> findVerticesThatNeedMessages();
     std::set<graph::Vertex*> findVerticesThatJoinStreams();
 
+    graph::VertexPtr findVertexNoThrow(const UUID& uuid) const noexcept;
+
 protected:
     std::vector<graph::VertexPtr> vertices_;
+    // index of vertices_ by the (non-composite) node UUID, maintained by addNode and deleteNode
+    std::unordered_map<UUID, graph::VertexPtr, UUID::Hasher> vertex_index_;
     std::vector<ConnectionPtr> edges_;
 
     std::map<Connection*, std::vector<slim_signal::ScopedConnection>> connection_observations_;
@@ -96,6 +132,8 @@ protected:
     std::set<graph::VertexPtr> sources_;
     std::set<graph::VertexPtr> sinks_;
 
+    std::vector<std::vector<UUID>> fused_chains_;
+
     bool in_transaction_;
 
     NodeFacadeImplementation* nf_;
@@ -26,6 +26,17 @@ public:
 
     bool is_leading_to_essential_vertex;
 
+    // number of vertices on the longest path from this vertex to any sink, including this one
+    int critical_path_length;
+    // true, iff a direct child is a joining vertex
+    bool is_unblocking_joining_vertex;
+
+    // index of the linear chain this vertex is fused into, -1 if it is not part of one
+    int fused_chain;
+    // true, iff the only child of this vertex is executed directly after it
+    bool is_fused_with_child;
+
+    SemanticVersion getVersion() const override;
     void serialize(SerializationBuffer& data, SemanticVersion& version) const override;
     void deserialize(const SerializationBuffer& data, const SemanticVersion& version) override;
 };
@@ -150,8 +150,11 @@ public:
 
     slim_signal::Signal<void()> destroyed;
 
-    slim_signal::Signal<void(NodeFacade* facade, TracingType type, std::shared_ptr<const Interval> stamp)> interval_start;
-    slim_signal::Signal<void(NodeFacade* facade, std::shared_ptr<const Interval> stamp)> interval_end;
+    slim_signal::ObservableSignal<void(NodeFacade* facade, TracingType type, std::shared_ptr<const Interval> stamp)> interval_start;
+    slim_signal::ObservableSignal<void(NodeFacade* facade, std::shared_ptr<const Interval> stamp)> interval_end;
+
+    /// remote facades report condensed intervals instead, unless interval_start or interval_end are observed
+    slim_signal::Signal<void(NodeFacade* facade, std::shared_ptr<const IntervalSummary> summary)> interval_summary;
 };
 
 }  // namespace csapex
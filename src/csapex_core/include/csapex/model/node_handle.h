@@ -138,6 +138,13 @@ public:
 
     bool updateParameterValues();
 
+    /**
+     * @brief makeReplica constructs another instance of the same node type with its own, unconnected connectors
+     * @return nullptr, if the node cannot be replicated
+     */
+    NodeHandlePtr makeReplica(const UUID& uuid, const UUIDProviderPtr& uuid_provider) const;
+    void setReplicaFactory(std::function<NodeHandlePtr(const UUID&, const UUIDProviderPtr&)> factory);
+
 public:
     void updateLoggerLevel();
 
@@ -216,6 +223,8 @@ private:
 
     Rate rate_;
 
+    std::function<NodeHandlePtr(const UUID&, const UUIDProviderPtr&)> replica_factory_;
+
     std::map<Connectable*, std::vector<slim_signal::Connection>> connections_;
 
 public:
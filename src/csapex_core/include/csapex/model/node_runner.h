@@ -13,6 +13,7 @@
 #include <mutex>
 #include <atomic>
 #include <thread>
+#include <chrono>
 
 namespace csapex
 {
@@ -42,19 +43,44 @@ public:
     void reset() override;
 
     void schedule(TaskPtr task);
-    void scheduleDelayed(TaskPtr task, std::chrono::system_clock::time_point time);
+    void scheduleDelayed(TaskPtr task, std::chrono::steady_clock::time_point time);
 
     void setSuppressExceptions(bool suppress_exceptions) override;
 
     void setNodeWorker(NodeWorkerPtr worker);
 
+    /**
+     * @brief setFusedSuccessor sets the node that is executed directly after this one,
+     *        instead of being scheduled, if both run in the same scheduler with chain fusion enabled
+     */
+    void setFusedSuccessor(NodeRunnerPtr successor);
+    NodeRunnerPtr getFusedSuccessor() const;
+
+    /**
+     * @brief setCriticalPath publishes the position of the node in the graph, which the critical path policy ranks by.
+     *        The graph analysis calls it, the workers only read the published value.
+     */
+    void setCriticalPath(int critical_path_length, bool is_unblocking_joining_vertex);
+
+    // mean execution time in microseconds, asynchronous nodes are measured until their continuation is done
+    double getMeanExecutionTime() const;
+    // mean time between scheduling and executing the node in microseconds
+    double getMeanSchedulingLatency() const;
+    std::size_t getFusedExecutionCount() const;
+
 private:
     void connectNodeWorker();
 
     void measureFrequency();
+    void measureExecutionTime();
+    long getCriticalPathPriority() const;
     void scheduleProcess();
     void checkParameters();
     void execute();
+    NodeRunnerPtr executeFusable();
+    void executeNode();
+    NodeRunnerPtr getActiveFusedSuccessor() const;
+    NodeRunnerPtr takeRequestedSuccessor(const NodeRunnerPtr& successor);
     void notify();
 
 private:
@@ -78,6 +104,21 @@ private:
     long guard_;
     double max_frequency_;
 
+    // written when an execution starts, read when it is finished, possibly by the thread of an asynchronous continuation
+    std::atomic<std::chrono::steady_clock::rep> execution_start_;
+    std::atomic<bool> measuring_execution_;
+    // exponential moving average of the execution time in microseconds
+    std::atomic<double> mean_execution_time_;
+
+    std::atomic<std::chrono::steady_clock::rep> scheduled_at_;
+    std::atomic<double> mean_scheduling_latency_;
+
+    std::atomic<long> critical_path_position_;
+
+    NodeRunnerWeakPtr fused_successor_;
+    std::atomic<bool> fused_execution_requested_;
+    std::atomic<std::size_t> fused_executions_;
+
     bool waiting_for_execution_;
 
     bool waiting_for_step_;
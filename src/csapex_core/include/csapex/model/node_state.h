@@ -34,6 +34,7 @@ public:
     void writeYaml(YAML::Node& out) const;
     void readYaml(const YAML::Node& node);
 
+    SemanticVersion getVersion() const override;
     void serialize(SerializationBuffer& data, SemanticVersion& version) const override;
     void deserialize(const SerializationBuffer& data, const SemanticVersion& version) override;
 
@@ -91,6 +92,10 @@ public:
     void setExecutionType(ExecutionType type);
     Signal execution_type_changed;
 
+    int getReplicaCount() const;
+    void setReplicaCount(int replicas);
+    Signal replica_count_changed;
+
     int getLoggerLevel() const;
     void setLoggerLevel(int level);
     Signal logger_level_changed;
@@ -151,6 +156,7 @@ private:
 
     ExecutionMode exec_mode_;
     ExecutionType exec_type_;
+    int replicas_;
 };
 
 }  // namespace csapex
@@ -0,0 +1,98 @@
+#ifndef PARAMETER_HANDLE_H
+#define PARAMETER_HANDLE_H
+
+/// SYSTEM
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace csapex
+{
+/**
+ * @brief The ParameterSnapshot struct holds the values of all parameters that are accessed via handles.
+ *        A snapshot is immutable, changes to parameters result in a new snapshot.
+ */
+struct ParameterSnapshot
+{
+    std::vector<std::shared_ptr<const void>> values;
+};
+
+/**
+ * @brief The PublishedParameterSnapshot struct is shared by a Parameterizable and its handles, it outlives both.
+ *        The generation changes with every published snapshot, so that handles only lock when they have to catch up.
+ */
+struct PublishedParameterSnapshot
+{
+    std::atomic<std::size_t> generation{ 0 };
+    std::mutex mutex;
+    std::shared_ptr<const ParameterSnapshot> snapshot;
+};
+
+/**
+ * @brief The ParameterHandle class gives typed access to a parameter without looking it up by name.
+ *        The value is read from the snapshot that was published last, usually right before the current execution.
+ *        The handle owns the snapshot it has read last, a returned reference stays valid until the next read of the same handle.
+ *        A handle must not be read by multiple threads at once, copies of it can.
+ * @see Parameterizable::getParameterHandle
+ */
+template <typename T>
+class ParameterHandle
+{
+    friend class Parameterizable;
+
+public:
+    ParameterHandle() : slot_(0), generation_(0)
+    {
+    }
+
+    bool valid() const
+    {
+        return published_ != nullptr;
+    }
+
+    const std::string& name() const
+    {
+        return name_;
+    }
+
+    const T& get() const
+    {
+        std::size_t generation = published_->generation.load(std::memory_order_acquire);
+        if (generation != generation_) {
+            std::unique_lock<std::mutex> lock(published_->mutex);
+            snapshot_ = published_->snapshot;
+            generation_ = generation;
+        }
+        return *static_cast<const T*>(snapshot_->values[slot_].get());
+    }
+
+    const T& operator*() const
+    {
+        return get();
+    }
+
+    const T* operator->() const
+    {
+        return &get();
+    }
+
+private:
+    ParameterHandle(const std::shared_ptr<PublishedParameterSnapshot>& published, std::size_t slot, const std::string& name)
+      : published_(published), slot_(slot), name_(name), generation_(0)
+    {
+    }
+
+private:
+    std::shared_ptr<PublishedParameterSnapshot> published_;
+    std::size_t slot_;
+    std::string name_;
+
+    mutable std::shared_ptr<const ParameterSnapshot> snapshot_;
+    mutable std::size_t generation_;
+};
+
+}  // namespace csapex
+
+#endif  // PARAMETER_HANDLE_H
@@ -3,6 +3,7 @@
 
 /// PROJECT
 #include <csapex/model/model_fwd.h>
+#include <csapex/model/parameter_handle.h>
 #include <csapex/param/param_fwd.h>
 #include <csapex/param/parameter.h>
 #include <csapex/param/parameter_modifier.h>
@@ -10,7 +11,9 @@
 
 /// SYSTEM
 #include <csapex/utility/slim_signal.hpp>
+#include <atomic>
 #include <mutex>
+#include <typeindex>
 
 namespace csapex
 {
@@ -294,6 +297,30 @@ public:
         return param::ParameterModifier<T>::get(getParameter(name));
     }
 
+    /**
+     * @brief getParameterHandle resolves a parameter once, so that it can be read without locking or looking it up by name.
+     *        Handles are meant to be created in setupParameters and read during processing.
+     * @param name unique name of the parameter
+     * @return a handle that returns the value of the parameter in the last published snapshot, all handles of a parameter share one slot
+     * @throws if the parameter doesn't exist or cannot be read as <b>T</b>, or if it already has a handle of another type
+     * @see publishParameterSnapshot
+     */
+    template <typename T>
+    ParameterHandle<T> getParameterHandle(const std::string& name)
+    {
+        std::size_t slot = getSnapshotSlot(name, typeid(T), [](const param::ParameterPtr& p) -> std::shared_ptr<const void> {
+            return std::make_shared<const T>(param::ParameterModifier<T>::get(p));
+        });
+        return ParameterHandle<T>(published_parameter_snapshot_, slot, name);
+    }
+
+    /**
+     * @brief publishParameterSnapshot makes the current parameter values visible to all handles.
+     *        Does nothing, if no parameter with a handle has changed since the last snapshot.
+     *        Handles keep the snapshot they have read alive.
+     */
+    void publishParameterSnapshot();
+
     /**
      * @brief setParameter directly updates the value of a parameter
      * @param name unique name of the parameter for which to get the value
@@ -491,7 +518,9 @@ public:
 
 private:
     void doSetParameterLater(const std::string& name, const param::ParameterConstPtr& value);
-    
+
+    std::size_t getSnapshotSlot(const std::string& name, const std::type_info& type, std::function<std::shared_ptr<const void>(const param::ParameterPtr&)> reader);
+
 private:
     void parameterChanged(param::ParameterPtr param);
     void parameterEnabled(param::Parameter* param, bool enabled);
@@ -507,6 +536,18 @@ private:
 
     std::map<param::Parameter*, std::vector<std::function<void(param::Parameter*)>>> param_callbacks_;
 
+    struct SnapshotSlot
+    {
+        std::string name;
+        std::type_index type;
+        param::ParameterWeakPtr param;
+        std::function<std::shared_ptr<const void>(const param::ParameterPtr&)> reader;
+        slim_signal::ScopedConnection connection;
+    };
+    std::vector<SnapshotSlot> snapshot_slots_;
+    std::atomic<bool> parameter_snapshot_dirty_;
+    std::shared_ptr<PublishedParameterSnapshot> published_parameter_snapshot_;
+
 protected:
     GenericStatePtr parameter_state_;  ///< the underlying memento
 
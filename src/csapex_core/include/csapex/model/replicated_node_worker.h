@@ -0,0 +1,100 @@
+#ifndef REPLICATED_NODE_WORKER_H
+#define REPLICATED_NODE_WORKER_H
+
+/// COMPONENT
+#include <csapex/model/node_worker.h>
+
+/// SYSTEM
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace csapex
+{
+/**
+ * @brief The ReplicatedNodeWorker keeps additional instances of a stateless node.
+ *        While the node processes the current tokens, the replicas process the tokens that are already
+ *        queued on the incoming connections. Their results are published in the order of the sequence numbers
+ *        of the inputs, so that the outputs are indistinguishable from a sequential execution.
+ */
+class CSAPEX_CORE_EXPORT ReplicatedNodeWorker : public NodeWorker
+{
+public:
+    ReplicatedNodeWorker(NodeHandlePtr node_handle);
+    ~ReplicatedNodeWorker();
+
+    std::size_t getReplicaCount() const;
+
+protected:
+    void processNode() override;
+
+private:
+    struct Result
+    {
+        std::vector<TokenPtr> outputs;
+        std::string error;
+    };
+
+    struct Replica
+    {
+        ~Replica();
+
+        NodeHandlePtr node_handle;
+        NodePtr node;
+        std::vector<InputPtr> inputs;
+        std::vector<OutputPtr> outputs;
+        bool busy = false;
+
+        // every replica processes on a thread of its own, which lives as long as the replica
+        std::thread thread;
+        std::mutex job_mutex;
+        std::condition_variable job_changed;
+        std::packaged_task<Result()> job;
+        bool stopping = false;
+    };
+
+    struct Prefetch
+    {
+        std::vector<TokenPtr> inputs;
+        Replica* replica;
+        std::future<Result> result;
+    };
+
+    /// returns false, if not all replicas could be created
+    bool updateReplicas(std::size_t count);
+    void reserveQueueCapacities(std::size_t capacity);
+    void releaseQueueCapacities();
+
+    std::vector<std::vector<TokenPtr>> getQueuedInputs() const;
+    bool isCurrentInput(const std::vector<TokenPtr>& tokens) const;
+
+    void prefetch(const NodePtr& node);
+    void dropPrefetched();
+
+    void synchronizeParameters(Replica& replica, const GenericStatePtr& parameters);
+    static std::future<Result> dispatch(Replica& replica, const std::vector<TokenPtr>& tokens);
+    static void runReplica(Replica& replica);
+    static Result processOnReplica(Replica& replica, const std::vector<TokenPtr>& tokens);
+
+    void publish(const Result& result);
+
+private:
+    UUIDProviderPtr replica_uuid_provider_;
+    int next_replica_id_;
+
+    std::vector<std::unique_ptr<Replica>> replicas_;
+    // the configured replica count for which creating the replicas failed, it is not retried until the count changes
+    std::size_t failed_replica_count_;
+    std::deque<Prefetch> prefetched_;
+
+    // connections whose queue capacity is reserved for the replicas
+    std::vector<std::weak_ptr<Connection>> reserved_connections_;
+};
+
+}  // namespace csapex
+
+#endif  // REPLICATED_NODE_WORKER_H
@@ -108,6 +108,10 @@ public:
     std::vector<UUID> getInternalSlots() const;
     std::vector<UUID> getInternalEvents() const;
 
+    /**
+     * @brief setIterationEnabled marks an input whose containers are iterated element by element.
+     *        Multiple iterated inputs are zipped, the shortest container determines the number of iterations.
+     */
     void setIterationEnabled(const UUID& external_input_uuid, bool enabled);
 
     void notifyMessagesProcessed();
@@ -130,8 +134,11 @@ private:
     void finishSubgraph();
     void notifySubgraphProcessed();
 
+    void publishCollectedElements();
+
     void sendCurrentIteration();
 
+    bool canPipelineIteration() const;
     void startNextIteration();
 
 public:
@@ -171,6 +178,17 @@ protected:
     bool has_sent_current_iteration_;
     int iteration_index_;
     int iteration_count_;
+    int iterations_received_;
+    int iteration_parallelism_;
+    mutable std::recursive_mutex iteration_mutex_;
+
+    struct CollectedElements
+    {
+        std::weak_ptr<Output> output;
+        std::vector<TokenDataConstPtr> elements;
+    };
+    // results of iterated elements, published as one vector per output when the iteration is finished
+    std::unordered_map<UUID, CollectedElements, UUID::Hasher> collected_elements_;
 
     bool is_initialized_;
 
@@ -33,10 +33,13 @@
 namespace csapex
 {
 class ProfilerImplementation;
+class SubprocessSandbox;
 class Interval;
 
 class CSAPEX_CORE_EXPORT SubprocessNodeWorker : public NodeWorker
 {
+    friend class SubprocessSandbox;
+
 private:
     using Lock = boost::interprocess::scoped_lock<boost::interprocess::interprocess_mutex>;
 
@@ -46,6 +49,8 @@ public:
 
     void initialize() override;
 
+    std::shared_ptr<SubprocessSandbox> getSandbox() const;
+
 protected:
     void processNode() override;
     void processSlot(const SlotWeakPtr& slot) override;
@@ -58,7 +63,9 @@ protected:
     void handleChangedParametersImpl(const Parameterizable::ChangedParameterList& changed_params) override;
 
 private:
-    void runSubprocessLoop();
+    // called in the sandbox
+    void prepareSubprocess();
+    void handleSubprocessMessage(const SubprocessChannel::Message& msg);
 
     void handleParameterUpdate(const SubprocessChannel::Message& msg);
 
@@ -68,11 +75,10 @@ private:
     void finishHandleProcessChild();
 
     void transmitParameter(const param::ParameterPtr& p);
+    void sendToSandbox(const SubprocessChannel::Message& msg);
 
 private:
-    pid_t pid_;
-
-    std::unique_ptr<Subprocess> subprocess_;
+    std::shared_ptr<SubprocessSandbox> sandbox_;
 
     std::vector<param::Parameter*> changed_parameters_;
 
@@ -0,0 +1,83 @@
+#ifndef SUBPROCESS_POOL_H
+#define SUBPROCESS_POOL_H
+
+/// PROJECT
+#include <csapex_core/csapex_core_export.h>
+#include <csapex/utility/singleton.hpp>
+
+/// SYSTEM
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace csapex
+{
+class SubprocessNodeWorker;
+class SubprocessSandbox;
+
+/**
+ * @brief The SubprocessPool class assigns isolated nodes to sandbox processes.
+ *        With a size of 0, every node gets a sandbox of its own. Otherwise, the nodes share at most size sandboxes.
+ *        Sandboxes are only forked when one of their nodes is executed, loading a graph does not fork at all.
+ *        Optionally, every sandbox keeps a pre-forked standby that takes over immediately after a crash.
+ */
+class CSAPEX_CORE_EXPORT SubprocessPool : public Singleton<SubprocessPool>
+{
+    friend class Singleton<SubprocessPool>;
+
+public:
+    struct Stats
+    {
+        std::size_t sandboxes = 0;
+        std::size_t forks = 0;
+        std::size_t warm_restarts = 0;
+        std::size_t cold_restarts = 0;
+    };
+
+public:
+    /**
+     * @brief setSize sets the number of sandboxes that are shared by all isolated nodes, 0 gives every node its own sandbox
+     */
+    void setSize(std::size_t size);
+    std::size_t getSize() const;
+
+    /**
+     * @brief setStandby lets every sandbox that is created afterwards keep a pre-forked standby process
+     */
+    void setStandby(bool standby);
+    bool hasStandby() const;
+
+    std::shared_ptr<SubprocessSandbox> join(SubprocessNodeWorker* worker);
+    void leave(SubprocessNodeWorker* worker, const std::shared_ptr<SubprocessSandbox>& sandbox);
+
+    void countFork();
+    void countRestart(bool warm);
+
+    Stats getStats() const;
+
+private:
+    SubprocessPool();
+
+    std::shared_ptr<SubprocessSandbox> selectSharedSandbox();
+
+private:
+    mutable std::mutex mutex_;
+
+    std::size_t size_;
+    bool standby_;
+
+    std::size_t next_id_;
+    std::vector<std::shared_ptr<SubprocessSandbox>> shared_;
+    std::size_t dedicated_;
+
+    // counted by the sandboxes, without the pool's mutex
+    std::atomic<std::size_t> forks_;
+    std::atomic<std::size_t> warm_restarts_;
+    std::atomic<std::size_t> cold_restarts_;
+};
+
+}  // namespace csapex
+
+#endif  // SUBPROCESS_POOL_H
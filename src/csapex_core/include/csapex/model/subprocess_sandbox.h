@@ -0,0 +1,113 @@
+#ifndef SUBPROCESS_SANDBOX_H
+#define SUBPROCESS_SANDBOX_H
+
+/// PROJECT
+#include <csapex_core/csapex_core_export.h>
+#include <csapex/utility/subprocess.h>
+
+/// SYSTEM
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace csapex
+{
+class SubprocessNodeWorker;
+
+/**
+ * @brief The SubprocessSandbox class is a forked process that hosts the isolated execution of one or more nodes.
+ *        The process is forked lazily, when a member is executed for the first time, so it contains every member that exists at that point.
+ *        Members lease the sandbox for one execution at a time. Messages to the sandbox are addressed to a member by its UUID.
+ *        If a member joins after the fork, the sandbox is forked again at the next lease, which resets the state of all members in the process.
+ */
+class CSAPEX_CORE_EXPORT SubprocessSandbox
+{
+public:
+    typedef std::unique_lock<std::mutex> Lease;
+
+public:
+    SubprocessSandbox(std::size_t id, bool standby);
+    ~SubprocessSandbox();
+
+    std::size_t getId() const;
+
+    void add(SubprocessNodeWorker* worker);
+    void remove(SubprocessNodeWorker* worker);
+    std::size_t getMemberCount() const;
+
+    bool isForked() const;
+
+    /**
+     * @brief lease reserves the sandbox for one execution, forks the process if it does not contain all members
+     */
+    Lease lease();
+
+    /**
+     * @brief process is the active process, in the sandbox it is the connection to the parent
+     * @pre the caller holds a lease or runs in the sandbox
+     */
+    Subprocess* process() const;
+    bool isChild() const;
+
+    /**
+     * @brief write sends a message to one member in the active process
+     * @pre the caller holds a lease
+     */
+    void write(const std::string& member, SubprocessChannel::MessageType type, const SubprocessChannel::SlotWriter& writer);
+    /**
+     * @brief update sends a message to one member in the active and the standby process, without the need of a lease.
+     *        Updates that arrive while the sandbox is forked wait for the new processes.
+     */
+    void update(const std::string& member, const SubprocessChannel::Message& msg);
+
+    /**
+     * @brief restart replaces the active process after a crash, updates that are blocked on the crashed process give up
+     * @pre the caller holds a lease
+     * @return true, if a standby process took over
+     */
+    bool restart();
+    /**
+     * @brief forkStandby replaces a standby that took over after a crash
+     */
+    void forkStandby();
+
+    /**
+     * @brief route removes the address from a message read in the sandbox
+     * @return the UUID of the addressee
+     */
+    static std::string route(SubprocessChannel::Message& msg);
+
+private:
+    std::shared_ptr<Subprocess> fork(const std::map<std::string, SubprocessNodeWorker*>& members);
+    void run(const std::map<std::string, SubprocessNodeWorker*>& members);
+
+    void write(Subprocess& process, const std::string& member, SubprocessChannel::MessageType type, const SubprocessChannel::SlotWriter& writer);
+
+private:
+    std::size_t id_;
+    bool keep_standby_;
+    std::size_t generation_;
+
+    mutable std::mutex mutex_;
+    std::mutex lease_mutex_;
+
+    // set while a process is forked without holding mutex_
+    bool forking_;
+    std::condition_variable forked_;
+
+    std::map<std::string, SubprocessNodeWorker*> members_;
+    bool is_stale_;
+
+    // shared with updates that write to a process without holding mutex_
+    std::shared_ptr<Subprocess> active_;
+    std::shared_ptr<Subprocess> standby_;
+
+    // only set in the sandbox, the process connecting it to its parent
+    Subprocess* self_;
+};
+
+}  // namespace csapex
+
+#endif  // SUBPROCESS_SANDBOX_H
@@ -9,6 +9,9 @@
 #include <csapex_core/csapex_core_export.h>
 #include <csapex/model/activity_modifier.h>
 
+/// SYSTEM
+#include <atomic>
+
 namespace csapex
 {
 class CSAPEX_CORE_EXPORT Token : public Clonable
@@ -21,6 +24,8 @@ public:
 
 public:
     Token(const TokenDataConstPtr& token);
+    Token(const Token& other);
+    ~Token() override;
 
     void setActivityModifier(ActivityModifier active);
     bool hasActivityModifier() const;
@@ -33,13 +38,37 @@ public:
 
     virtual bool cloneData(const Token& other);
 
+    /**
+     * @brief share creates a token for one consumer that references the same data without copying it.
+     *        The consumer reads the data until it calls release or the token is destroyed.
+     */
+    Ptr share() const;
+    void release();
+
+    /**
+     * @brief takeData returns the data of the token for in-place modification, nullptr if somebody else could see the modification.
+     *        This requires that the token is an unreleased consumer and the only token that still reads the data,
+     *        that no reference to the data exists outside of tokens and that only the `owners` known to the caller hold the token.
+     */
+    static TokenDataPtr takeData(const Ptr& token, long owners);
+
     static Ptr makeEmpty();
 
 private:
+    struct Claims
+    {
+        std::atomic<int> tokens{ 0 };
+        std::atomic<int> released{ 0 };
+    };
+
     Token();
+    Token(const TokenDataConstPtr& token, const std::shared_ptr<Claims>& claims);
 
 private:
     TokenDataConstPtr data_;
+    std::shared_ptr<Claims> claims_;
+    std::atomic<bool> consumer_;
+    std::atomic<bool> released_;
 
     ActivityModifier activity_modifier_;
 
@@ -4,6 +4,7 @@
 /// COMPONENT
 #include <csapex_core/csapex_core_export.h>
 #include <csapex/serialization/streamable.h>
+#include <csapex/model/token_type_descriptor.h>
 
 /// SYSTEM
 #include <memory>
@@ -22,6 +23,7 @@ public:
 public:
     TokenData(const std::string& type_name);
     TokenData(const std::string& type_name, const std::string& descriptive_name);
+    TokenData(const TokenTypeDescriptor* type);
     ~TokenData() override;
 
     TokenData::Ptr toType() const;
@@ -38,7 +40,8 @@ public:
     virtual bool acceptsConnectionFrom(const TokenData* other_side) const;
 
     virtual std::string descriptiveName() const;
-    std::string typeName() const;
+    const std::string& typeName() const;
+    const TokenTypeDescriptor* getTypeDescriptor() const;
 
     virtual void writeNative(const std::string& file, const std::string& base, const std::string& suffix) const;
 
@@ -52,8 +55,8 @@ protected:
     void setDescriptiveName(const std::string& descriptiveName);
 
 private:
-    std::string type_name_;
-    std::string descriptive_name_;
+    // shared by all instances of the same type, instead of a copy of the names per instance
+    const TokenTypeDescriptor* type_;
 };
 
 }  // namespace csapex
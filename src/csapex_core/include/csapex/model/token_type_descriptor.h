@@ -0,0 +1,66 @@
+#ifndef TOKEN_TYPE_DESCRIPTOR_H
+#define TOKEN_TYPE_DESCRIPTOR_H
+
+/// COMPONENT
+#include <csapex_core/csapex_core_export.h>
+
+/// SYSTEM
+#include <string>
+
+namespace csapex
+{
+/**
+ * @brief The TokenTypeDescriptor class holds the names of a token type, once for all instances of that type.
+ *        Descriptors are interned: equal names yield the same descriptor, which is never released.
+ *        Descriptors that only differ in their descriptive name share the same type id.
+ */
+class CSAPEX_CORE_EXPORT TokenTypeDescriptor
+{
+public:
+    // registry size up to which tryGet registers unknown names
+    static const std::size_t MAX_UNTRUSTED_COUNT = 1024;
+
+public:
+    static const TokenTypeDescriptor* get(const std::string& type_name);
+    static const TokenTypeDescriptor* get(const std::string& type_name, const std::string& descriptive_name);
+
+    /**
+     * @brief tryGet is get for names that are not under our control, e.g. read from a peer.
+     * @return nullptr, iff the names are unknown and MAX_UNTRUSTED_COUNT descriptors are registered already
+     */
+    static const TokenTypeDescriptor* tryGet(const std::string& type_name, const std::string& descriptive_name);
+
+    // number of distinct descriptors that have been registered
+    static std::size_t count();
+
+public:
+    const std::string& typeName() const
+    {
+        return type_name_;
+    }
+    const std::string& descriptiveName() const
+    {
+        return descriptive_name_;
+    }
+    int typeId() const
+    {
+        return type_id_;
+    }
+
+    TokenTypeDescriptor(const TokenTypeDescriptor&) = delete;
+    TokenTypeDescriptor& operator=(const TokenTypeDescriptor&) = delete;
+
+private:
+    TokenTypeDescriptor(const std::string& type_name, const std::string& descriptive_name, int type_id);
+
+    static const TokenTypeDescriptor* get(const std::string& type_name, const std::string& descriptive_name, std::size_t max_count);
+
+private:
+    const std::string type_name_;
+    const std::string descriptive_name_;
+    const int type_id_;
+};
+
+}  // namespace csapex
+
+#endif  // TOKEN_TYPE_DESCRIPTOR_H
@@ -22,12 +22,10 @@ public:
     typedef std::shared_ptr<GenericPointerMessage<Type>> Ptr;
     typedef std::shared_ptr<GenericPointerMessage<Type> const> ConstPtr;
 
-    GenericPointerMessage(const std::string& _frame_id = "/", Message::Stamp stamp = 0) : Message(type<GenericPointerMessage<Type>>::name(), _frame_id, stamp)
+    GenericPointerMessage(const std::string& _frame_id = "/", Message::Stamp stamp = 0) : Message(pointerTypeDescriptor(), _frame_id, stamp)
     {
         static csapex::DirectMessageConstructorRegistered<connection_types::GenericPointerMessage, Type> reg_c;
         static csapex::DirectMessageSerializerRegistered<connection_types::GenericPointerMessage, Type> reg_s;
-
-        setDescriptiveName(type2name(typeid(Type)));
     }
     GenericPointerMessage(const std::shared_ptr<Type>& ptr, const std::string& _frame_id = "/", Message::Stamp stamp = 0) : GenericPointerMessage(_frame_id, stamp)
     {
@@ -36,7 +34,7 @@ public:
 
     bool acceptsConnectionFrom(const TokenData* other_side) const override
     {
-        return descriptiveName() == other_side->descriptiveName();
+        return getTypeDescriptor() == other_side->getTypeDescriptor() || descriptiveName() == other_side->descriptiveName();
     }
 
     void serialize(SerializationBuffer& data, SemanticVersion& version) const override
@@ -62,6 +60,14 @@ public:
     }
 
     typename std::shared_ptr<Type> value;
+
+private:
+    static const TokenTypeDescriptor* pointerTypeDescriptor()
+    {
+        // pointer messages are described by the type they point to
+        static const TokenTypeDescriptor* descriptor = TokenTypeDescriptor::get(type<GenericPointerMessage<Type>>::name(), type2name(typeid(Type)));
+        return descriptor;
+    }
 };
 
 /// TRAITS
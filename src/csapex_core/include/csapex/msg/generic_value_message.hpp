@@ -35,7 +35,7 @@ public:
     typedef std::shared_ptr<GenericValueMessage<Type> const> ConstPtr;
 
     explicit GenericValueMessage(const Type& _value = Type(), const std::string& _frame_id = "/", Message::Stamp stamp = 0)
-      : Message(type<GenericValueMessage<Type>>::name(), _frame_id, stamp), value(_value)
+      : Message(typeDescriptor<GenericValueMessage<Type>>(), _frame_id, stamp), value(_value)
     {
         static_assert(should_use_value_message<Type>::value, "The type should not use a value message");
         static csapex::DirectMessageConstructorRegistered<connection_types::GenericValueMessage, Type> reg_c;
@@ -199,6 +199,22 @@ bool isExactMessage(Input* input)
     return typeid(msg) == typeid(R);
 }
 
+/**
+ * @brief getMutableMessage returns the message of the input for modification.
+ *        If no other consumer and no other reference shares the message, it is taken over without a copy, otherwise it is cloned.
+ *        Since the input may see the modifications, it should not be read again afterwards.
+ */
+CSAPEX_CORE_EXPORT TokenDataPtr getMutableMessage(Input* input);
+
+template <typename R>
+std::shared_ptr<R> getMutableMessage(Input* input)
+{
+    if (!isMessage<R>(input)) {
+        throwError(getMessage(input), typeid(R));
+    }
+    return message_cast<R>(getMutableMessage(input));
+}
+
 template <typename R>
 bool isValue(Input* input)
 {
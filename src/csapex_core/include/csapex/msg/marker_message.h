@@ -15,6 +15,7 @@ public:
 
 protected:
     MarkerMessage(const std::string& name, Stamp stamp);
+    MarkerMessage(const TokenTypeDescriptor* type, Stamp stamp);
 
 public:
     bool canConnectTo(const TokenData* other_side) const override;
@@ -7,6 +7,7 @@
 #include <csapex/msg/token_traits.h>
 #include <csapex_core/csapex_core_export.h>
 #include <csapex/utility/export_plugin.h>
+#include <csapex/utility/interned_string.h>
 
 namespace csapex
 {
@@ -25,12 +26,15 @@ public:
 
 protected:
     Message(const std::string& name, const std::string& frame_id, Stamp stamp_micro_seconds);
+    Message(const TokenTypeDescriptor* type, const std::string& frame_id, Stamp stamp_micro_seconds);
+    Message(const TokenTypeDescriptor* type, const InternedString& frame_id, Stamp stamp_micro_seconds);
     ~Message() override;
 
     bool cloneDataFrom(const Clonable& other) override;
 
 public:
-    std::string frame_id;
+    // frame ids are interned, copying a message does not copy its frame id
+    InternedString frame_id;
     Stamp stamp_micro_seconds;
 };
 
@@ -3,6 +3,7 @@
 
 /// PROJECT
 #include <csapex_core/csapex_core_export.h>
+#include <csapex/msg/message_pool.h>
 
 /// SYSTEM
 #include <memory>
@@ -94,7 +95,8 @@ public:
                 return nullptr;
             }
         } else {
-            return std::make_shared<T>(std::forward<Args>(args)...);
+            // message and control block share one block that is recycled by the pool of T
+            return std::allocate_shared<T>(MessagePoolAllocator<T>(MessagePool::getTypePool<T>()), std::forward<Args>(args)...);
         }
     }
 
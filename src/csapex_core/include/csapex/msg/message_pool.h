@@ -0,0 +1,128 @@
+#ifndef MESSAGE_POOL_H
+#define MESSAGE_POOL_H
+
+/// PROJECT
+#include <csapex_core/csapex_core_export.h>
+#include <csapex/utility/singleton.hpp>
+
+/// SYSTEM
+#include <map>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+
+namespace csapex
+{
+/**
+ * @brief The MessagePool class recycles the storage of messages that are allocated via a MessageAllocator.
+ *        There is one pool per message type. Freed blocks are first kept in a small cache of the freeing thread,
+ *        then in a shared free list, so that messages which are produced at a constant rate stop reaching the heap.
+ */
+class CSAPEX_CORE_EXPORT MessagePool : public Singleton<MessagePool>
+{
+    friend class Singleton<MessagePool>;
+
+public:
+    class TypePool;
+
+    struct Stats
+    {
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+        std::size_t bytes_live = 0;
+        std::size_t bytes_cached = 0;
+    };
+
+public:
+    ~MessagePool() override;
+
+    template <typename T>
+    static TypePool* getTypePool()
+    {
+        static TypePool* pool = instance().getTypePool(typeid(T));
+        return pool;
+    }
+    TypePool* getTypePool(const std::type_info& type);
+
+    static void* allocate(TypePool* pool, std::size_t bytes);
+    static void deallocate(TypePool* pool, void* ptr, std::size_t bytes);
+
+    /**
+     * @brief reserve pre-allocates blocks for a message type
+     * @param type_name the demangled C++ name of the message type, e.g. csapex::connection_types::GenericValueMessage<int>
+     * @param count number of blocks that are allocated up front and kept in the free list
+     */
+    void reserve(const std::string& type_name, std::size_t count);
+    std::map<std::string, std::size_t> getReservations() const;
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    Stats getStats() const;
+    Stats getStats(const std::string& type_name) const;
+
+    /**
+     * @brief clear releases all blocks in the shared free lists
+     */
+    void clear();
+
+private:
+    MessagePool();
+
+private:
+    mutable std::recursive_mutex mutex_;
+    std::unordered_map<std::string, TypePool*> pools_;
+    std::map<std::string, std::size_t> reservations_;
+};
+
+/**
+ * @brief The MessagePoolAllocator class is a std allocator that takes its storage from a MessagePool::TypePool,
+ *        it is meant for std::allocate_shared, so that the message and its control block share one recycled block.
+ */
+template <typename T>
+class MessagePoolAllocator
+{
+    template <typename U>
+    friend class MessagePoolAllocator;
+
+public:
+    typedef T value_type;
+
+    explicit MessagePoolAllocator(MessagePool::TypePool* pool) : pool_(pool)
+    {
+    }
+
+    template <typename U>
+    MessagePoolAllocator(const MessagePoolAllocator<U>& other) : pool_(other.pool_)
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(MessagePool::allocate(pool_, n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, std::size_t n)
+    {
+        MessagePool::deallocate(pool_, ptr, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const MessagePoolAllocator<U>& other) const
+    {
+        return pool_ == other.pool_;
+    }
+    template <typename U>
+    bool operator!=(const MessagePoolAllocator<U>& other) const
+    {
+        return pool_ != other.pool_;
+    }
+
+private:
+    MessagePool::TypePool* pool_;
+};
+
+}  // namespace csapex
+
+#endif  // MESSAGE_POOL_H
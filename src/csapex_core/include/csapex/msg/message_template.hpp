@@ -131,15 +131,15 @@ public:
     typedef MessageTemplateContainer<Type, std::is_integral<Type>::value> ValueContainer;
     typedef MessageTemplate<Type, Instance> Self;
 
-    explicit MessageTemplate(const std::string& _frame_id = "/", Message::Stamp stamp = 0) : Message(type<Instance>::name(), _frame_id, stamp)
+    explicit MessageTemplate(const std::string& _frame_id = "/", Message::Stamp stamp = 0) : Message(typeDescriptor<Instance>(), _frame_id, stamp)
     {
     }
 
-    MessageTemplate(const Self& copy) : Message(type<Instance>::name(), copy.frame_id, copy.stamp_micro_seconds), ValueContainer(static_cast<const ValueContainer&>(copy))
+    MessageTemplate(const Self& copy) : Message(typeDescriptor<Instance>(), copy.frame_id, copy.stamp_micro_seconds), ValueContainer(static_cast<const ValueContainer&>(copy))
     {
     }
 
-    MessageTemplate(Self&& moved) : Message(type<Instance>::name(), moved.frame_id, moved.stamp_micro_seconds), ValueContainer(static_cast<ValueContainer&&>(moved))
+    MessageTemplate(Self&& moved) : Message(typeDescriptor<Instance>(), moved.frame_id, moved.stamp_micro_seconds), ValueContainer(static_cast<ValueContainer&&>(moved))
     {
     }
 
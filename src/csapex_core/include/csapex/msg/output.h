@@ -10,6 +10,9 @@
 #include <csapex/utility/shared_ptr_tools.hpp>
 #include <csapex/model/observer.h>
 
+/// SYSTEM
+#include <atomic>
+
 namespace csapex
 {
 class CSAPEX_CORE_EXPORT Output : public Connectable, public MessageAllocator, public Observer
@@ -67,6 +70,13 @@ public:
 
     bool isConnected() const override;
 
+    /**
+     * @brief setSharingMessages lets all connections share the published data instead of copying it per connection.
+     *        A node may only opt in if it never modifies a message after publishing it.
+     */
+    void setSharingMessages(bool sharing);
+    bool isSharingMessages() const;
+
     std::vector<ConnectionPtr> getConnections() const override;
 
     virtual bool hasMessage() = 0;
@@ -87,6 +97,8 @@ protected:
     OutputTransition* transition_;
 
     State state_;
+
+    std::atomic<bool> sharing_messages_;
 };
 
 }  // namespace csapex
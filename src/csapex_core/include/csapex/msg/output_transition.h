@@ -51,6 +51,9 @@ private:
     std::unordered_map<UUID, OutputPtr, UUID::Hasher> outputs_;
 
     long sequence_number_;
+
+    bool filling_connections_;
+    bool processed_while_filling_;
 };
 }  // namespace csapex
 
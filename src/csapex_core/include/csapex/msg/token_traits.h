@@ -27,6 +27,16 @@ inline std::string serializationName()
     return type<TT>::name();
 }
 
+/**
+ * @brief typeDescriptor looks up the descriptor of a message type once, instead of once per instance
+ */
+template <typename T>
+inline const TokenTypeDescriptor* typeDescriptor()
+{
+    static const TokenTypeDescriptor* descriptor = TokenTypeDescriptor::get(serializationName<T>());
+    return descriptor;
+}
+
 TokenPtr makeToken(const TokenDataConstPtr& data);
 
 template <typename T>
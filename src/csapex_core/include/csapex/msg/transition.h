@@ -40,6 +40,7 @@ public:
     bool areAllConnections(Connection::State a, /*or*/ Connection::State b) const;
     bool areAllConnections(Connection::State a, /*or*/ Connection::State b, /*or*/ Connection::State c) const;
     bool isOneConnection(Connection::State state) const;
+    bool canAllConnectionsAcceptTokens() const;
 
     std::vector<ConnectionPtr> getConnections() const;
 
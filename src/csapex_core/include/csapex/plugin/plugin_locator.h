@@ -3,6 +3,7 @@
 
 /// COMPONENT
 #include <csapex/core/settings.h>
+#include <csapex/utility/utility_fwd.h>
 
 /// SYSTEM
 #include <string>
@@ -61,6 +62,12 @@ public:
     void setPluginPaths(const std::string& type, const std::vector<std::string>& paths);
     std::vector<std::string> getPluginPaths(const std::string& type) const;
 
+    /**
+     * @brief setStartupTimer lets plugin managers record the phases of loading plugins, nullptr disables it
+     */
+    void setStartupTimer(TimerPtr timer);
+    TimerPtr getStartupTimer() const;
+
 private:
     PluginLocator(const PluginLocator& copy) = delete;
     PluginLocator& operator=(const PluginLocator& copy) = delete;
@@ -80,6 +87,8 @@ private:
     param::StringListParameterPtr ignored_persistent_;
 
     std::map<std::string, std::vector<std::string>> plugin_paths_;
+
+    TimerPtr startup_timer_;
 };
 }  // namespace csapex
 
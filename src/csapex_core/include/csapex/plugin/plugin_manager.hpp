@@ -5,6 +5,8 @@
 #include <csapex/utility/constructor.hpp>
 #include <csapex/plugin/plugin_locator.h>
 #include <csapex/plugin/plugin_constructor.hpp>
+#include <csapex/plugin/plugin_manifest_index.h>
+#include <csapex/profiling/timer.h>
 
 /// SYSTEM
 #include <csapex/utility/slim_signal.hpp>
@@ -27,6 +29,30 @@ namespace bf3 = boost::filesystem3;
 
 namespace csapex
 {
+class PluginManagerLocker
+{
+public:
+    static std::mutex& getMutex()
+    {
+        static PluginManagerLocker instance;
+        return instance.mutex;
+    }
+
+    static std::mutex& getLoaderMutex()
+    {
+        static std::mutex loader_mutex;
+        return loader_mutex;
+    }
+
+private:
+    PluginManagerLocker()
+    {
+    }
+
+private:
+    std::mutex mutex;
+};
+
 template <class M>
 class PluginManagerImp
 {
@@ -64,55 +90,77 @@ protected:
 
             library_paths_.insert(library_paths_.end(), library_paths.begin(), library_paths.end());
 
-            for (std::vector<std::string>::const_iterator manifest = xml_files.begin(); manifest != xml_files.end(); ++manifest) {
-                processManifest(locator, *manifest);
+            Timer* timer = locator->getStartupTimer().get();
+            PluginManifestIndex& index = PluginManifestIndex::instance();
+
+            std::vector<PluginManifest> manifests(xml_files.size());
+            std::vector<std::size_t> outdated;
+            {
+                Trace::Ptr trace = timer ? timer->step("read manifest index") : nullptr;
+                for (std::size_t i = 0; i < xml_files.size(); ++i) {
+                    if (!index.lookup(xml_files[i], manifests[i])) {
+                        outdated.push_back(i);
+                    }
+                }
+            }
+
+            if (!outdated.empty()) {
+                Trace::Ptr trace = timer ? timer->step("parse manifests") : nullptr;
+                std::vector<std::string> outdated_files;
+                for (std::size_t i : outdated) {
+                    outdated_files.push_back(xml_files[i]);
+                }
+                std::vector<PluginManifest> parsed = index.parse(outdated_files);
+                for (std::size_t j = 0; j < outdated.size(); ++j) {
+                    manifests[outdated[j]] = std::move(parsed[j]);
+                }
             }
+
+            {
+                // manifests are registered in the order of the locators, independent of parsing
+                Trace::Ptr trace = timer ? timer->step("register plugins") : nullptr;
+                for (const PluginManifest& manifest : manifests) {
+                    processManifest(locator, manifest);
+                }
+            }
+
+            index.save();
         }
 
         plugins_loaded_ = true;
     }
 
-    bool processManifest(csapex::PluginLocator* locator, const std::string& xml_file)
+    bool processManifest(csapex::PluginLocator* locator, const PluginManifest& manifest)
     {
-        if (!bf3::exists(xml_file)) {
+        if (!manifest.valid) {
             return false;
         }
 
-        TiXmlDocument document;
-        document.LoadFile(xml_file);
-        TiXmlElement* config = document.RootElement();
-        if (config == nullptr) {
-            std::cerr << "[Plugin] Cannot load the file " << xml_file << std::endl;
-            return false;
-        }
-
-        TiXmlElement* library = config;
-        if (library->ValueStr() != "library") {
-            library = library->NextSiblingElement("library");
-        }
-        while (library != nullptr) {
-            std::string library_name = library->Attribute("path");
-            if (library_name.size() == 0) {
-                std::cerr << "[Plugin] Item in row" << library->Row() << " does not contain a path attribute" << std::endl;
-                continue;
+        for (const PluginManifest::Library& library : manifest.libraries) {
+            if (!locator->isLibraryIgnored(library.name)) {
+                loadLibrary(library);
             }
 
-            if (!locator->isLibraryIgnored(library_name)) {
-                loadLibrary(library_name, library);
-            }
+            library_to_locator_[library.name] = locator;
+        }
 
-            library_to_locator_[library_name] = locator;
+        if (manifest.document) {
+            manifest_loaded(manifest.file, manifest.document->RootElement());
 
-            library = library->NextSiblingElement("library");
+        } else if (manifest_loaded.hasReceivers()) {
+            // entries from the index carry no document, it is only parsed again if somebody is interested
+            TiXmlDocument document;
+            if (document.LoadFile(manifest.file)) {
+                manifest_loaded(manifest.file, document.RootElement());
+            }
         }
 
-        manifest_loaded(xml_file, config);
-
         return true;
     }
 
-    void loadLibrary(const std::string& library_name, TiXmlElement* library)
+    void loadLibrary(const PluginManifest::Library& library)
     {
+        const std::string& library_name = library.name;
 #if !WIN32
         std::stringstream ld_paths(getenv("LD_LIBRARY_PATH"));
         std::string ld_path;
@@ -130,37 +178,23 @@ protected:
         }
 #endif
 
-        TiXmlElement* class_element = library->FirstChildElement("class");
-        while (class_element) {
-            loadClass(library_name, class_element);
-
-            class_element = class_element->NextSiblingElement("class");
+        for (const PluginManifest::Class& class_entry : library.classes) {
+            loadClass(library_name, class_entry);
         }
     }
 
-    void loadClass(const std::string& library_name, TiXmlElement* class_element)
+    void loadClass(const std::string& library_name, const PluginManifest::Class& class_entry)
     {
-        std::string base_class_type = class_element->Attribute("base_class_type");
-        std::string derived_class = class_element->Attribute("type");
-
-        std::string lookup_name;
-        if (class_element->Attribute("name") != nullptr) {
-            lookup_name = class_element->Attribute("name");
-        } else {
-            lookup_name = derived_class;
-        }
-
-        if (base_class_type == full_name_) {
-            std::string description = readString(class_element, "description");
-            std::string icon = readString(class_element, "icon");
-            std::string tags = readString(class_element, "tags");
+        const std::string& lookup_name = class_entry.name;
 
+        if (class_entry.base_class_type == full_name_) {
             PluginConstructorM constructor;
             constructor.setType(lookup_name);
-            constructor.setDescription(description);
-            constructor.setIcon(icon);
-            constructor.setTags(tags);
+            constructor.setDescription(class_entry.description);
+            constructor.setIcon(class_entry.icon);
+            constructor.setTags(class_entry.tags);
 
+            // the library is only opened once the first instance is requested
             constructor.setConstructor([this, lookup_name]() { return createInstance(lookup_name); });
             constructor.setLibraryName(library_name);
 
@@ -205,6 +239,8 @@ protected:
         std::string library_path = library_name + ".so";
 #endif
 
+        // instances can be created from multiple threads, e.g. when a graph is loaded
+        std::unique_lock<std::mutex> lock(PluginManagerLocker::getLoaderMutex());
         auto pos = loaders_.find(library_path);
         if (pos == loaders_.end()) {
             try {
@@ -227,17 +263,6 @@ protected:
         }
     }
 
-    std::string readString(TiXmlElement* class_element, const std::string& name)
-    {
-        TiXmlElement* description = class_element->FirstChildElement(name);
-        std::string description_str;
-        if (description) {
-            description_str = description->GetText() ? description->GetText() : "";
-        }
-
-        return description_str;
-    }
-
     std::time_t getLastModification(const std::string& class_name)
     {
         std::string library = plugin_to_library_.at(class_name);
@@ -251,6 +276,7 @@ protected:
 
 protected:
     slim_signal::Signal<void(const std::string&)> loaded;
+    // only emitted for manifests that had to be parsed, not for the ones served from the manifest index
     slim_signal::Signal<void(const std::string& file, const TiXmlElement* document)> manifest_loaded;
 
 protected:
@@ -276,24 +302,6 @@ struct PluginManagerGroup
     };
 };
 
-class PluginManagerLocker
-{
-public:
-    static std::mutex& getMutex()
-    {
-        static PluginManagerLocker instance;
-        return instance.mutex;
-    }
-
-private:
-    PluginManagerLocker()
-    {
-    }
-
-private:
-    std::mutex mutex;
-};
-
 template <class M>
 class PluginManager
 {
@@ -0,0 +1,100 @@
+#ifndef PLUGIN_MANIFEST_INDEX_H
+#define PLUGIN_MANIFEST_INDEX_H
+
+/// PROJECT
+#include <csapex_core/csapex_core_export.h>
+#include <csapex/utility/singleton.hpp>
+
+/// SYSTEM
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class TiXmlDocument;
+
+namespace csapex
+{
+/**
+ * @brief The PluginManifest struct contains everything a plugin manager needs to know about one plugin XML file
+ */
+struct PluginManifest
+{
+    struct Class
+    {
+        std::string base_class_type;
+        std::string type;
+        std::string name;
+        std::string description;
+        std::string icon;
+        std::string tags;
+    };
+
+    struct Library
+    {
+        std::string name;
+        std::vector<Class> classes;
+    };
+
+    std::string file;
+    uint64_t content_hash = 0;
+    uint64_t size = 0;
+    bool valid = false;
+
+    std::vector<Library> libraries;
+
+    // only set if the manifest has just been parsed, never persisted
+    std::shared_ptr<TiXmlDocument> document;
+};
+
+/**
+ * @brief The PluginManifestIndex class caches parsed plugin manifests in a binary file.
+ *        An entry is only used as long as size and content hash of its manifest are unchanged.
+ *        Checking an entry reads the manifest, but does not parse it.
+ */
+class CSAPEX_CORE_EXPORT PluginManifestIndex : public Singleton<PluginManifestIndex>
+{
+    friend class Singleton<PluginManifestIndex>;
+
+public:
+    /**
+     * @brief setFile reads the index from the given file and persists all future changes there
+     */
+    void setFile(const std::string& index_file);
+
+    bool lookup(const std::string& xml_file, PluginManifest& manifest);
+
+    /**
+     * @brief parse reads the given manifests in parallel and updates the index with the result
+     */
+    std::vector<PluginManifest> parse(const std::vector<std::string>& xml_files);
+
+    void save();
+
+    std::size_t countHits() const;
+    std::size_t countMisses() const;
+
+private:
+    PluginManifestIndex();
+
+    void read();
+    void store(const PluginManifest& manifest);
+
+    static PluginManifest parseManifest(const std::string& xml_file);
+
+private:
+    mutable std::mutex mutex_;
+
+    std::string index_file_;
+    std::map<std::string, PluginManifest> entries_;
+    bool dirty_;
+
+    std::size_t hits_;
+    std::size_t misses_;
+};
+
+}  // namespace csapex
+
+#endif  // PLUGIN_MANIFEST_INDEX_H
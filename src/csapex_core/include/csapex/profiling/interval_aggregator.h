@@ -0,0 +1,43 @@
+#ifndef INTERVAL_AGGREGATOR_H
+#define INTERVAL_AGGREGATOR_H
+
+/// COMPONENT
+#include <csapex_core/csapex_profiling_export.h>
+#include <csapex/profiling/interval_summary.h>
+
+/// SYSTEM
+#include <memory>
+#include <mutex>
+
+namespace csapex
+{
+/**
+ * @brief The IntervalAggregator class collects the intervals of one timer into summaries of fixed time windows.
+ *        Intervals are assigned to the window in which they ended. It is safe to add intervals from multiple threads.
+ */
+class CSAPEX_PROFILING_EXPORT IntervalAggregator
+{
+public:
+    IntervalAggregator(long window_micro_seconds);
+
+    /// returns the summary of the previous window when the interval ends in a later one, nullptr otherwise
+    std::shared_ptr<const IntervalSummary> add(const Interval& interval);
+
+    /// returns the summary of the current window and starts a new one, nullptr if the window is empty
+    std::shared_ptr<const IntervalSummary> flush();
+
+    /// like flush, but only if the current window ended before now_micro, so that the last window of an idle timer is not held back
+    std::shared_ptr<const IntervalSummary> flushExpired(long now_micro);
+
+    long getWindowMicro() const;
+
+private:
+    std::mutex mutex_;
+
+    long window_micro_;
+    std::shared_ptr<IntervalSummary> current_;
+};
+
+}  // namespace csapex
+
+#endif  // INTERVAL_AGGREGATOR_H
@@ -0,0 +1,66 @@
+#ifndef INTERVAL_SUMMARY_H
+#define INTERVAL_SUMMARY_H
+
+/// COMPONENT
+#include <csapex_core/csapex_profiling_export.h>
+#include <csapex/serialization/serializable.h>
+
+/// SYSTEM
+#include <array>
+#include <map>
+#include <string>
+
+namespace csapex
+{
+class Interval;
+
+/**
+ * @brief The IntervalSummary class condenses all intervals of a timer that ended within one time window.
+ *        It replaces the individual intervals where transmitting all of them would be too expensive.
+ */
+class CSAPEX_PROFILING_EXPORT IntervalSummary : public Serializable
+{
+protected:
+    CLONABLE_IMPLEMENTATION(IntervalSummary);
+
+public:
+    /// bin 0 counts intervals shorter than 10us, each further bin doubles the bound, the last bin is unbounded
+    static constexpr std::size_t HISTOGRAM_BINS = 16;
+
+    static std::size_t getBin(long length_micro_seconds);
+    static long getBinUpperBoundMicro(std::size_t bin);
+
+public:
+    IntervalSummary();
+    IntervalSummary(const std::string& name, long window_start_micro, long window_end_micro);
+
+    void add(const Interval& interval);
+
+    bool empty() const;
+    double getMeanMs() const;
+
+    void serialize(SerializationBuffer& data, SemanticVersion& version) const override;
+    void deserialize(const SerializationBuffer& data, const SemanticVersion& version) override;
+
+public:
+    std::string name;
+
+    long window_start_micro;
+    long window_end_micro;
+
+    uint32_t count;
+    uint32_t active_count;
+
+    double total_ms;
+    double min_ms;
+    double max_ms;
+
+    std::array<uint32_t, HISTOGRAM_BINS> histogram;
+
+    /// accumulated length of the top level steps of the intervals
+    std::map<std::string, double> steps_ms;
+};
+
+}  // namespace csapex
+
+#endif  // INTERVAL_SUMMARY_H
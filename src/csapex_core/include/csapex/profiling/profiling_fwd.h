@@ -16,6 +16,7 @@ namespace csapex
 FWD(Profiler)
 FWD(ProfilerImplementation)
 FWD(Interval)
+FWD(IntervalSummary)
 }  // namespace csapex
 
 #undef FWD
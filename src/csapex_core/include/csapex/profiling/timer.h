@@ -8,6 +8,7 @@
 #include <csapex_core/csapex_profiling_export.h>
 
 /// SYSTEM
+#include <atomic>
 #include <chrono>
 #include <memory>
 #include <vector>
@@ -16,11 +17,21 @@
 
 namespace csapex
 {
+/**
+ * @brief The Timer class measures a run and its nested steps.
+ *        Steps are recorded into a fixed number of slots without locking or allocating,
+ *        the Interval tree is only built from them when the run is finished.
+ */
 class CSAPEX_PROFILING_EXPORT Timer
 {
+    friend class Trace;
+
 public:
     typedef std::shared_ptr<Timer> Ptr;
 
+    /// steps beyond this number per run are dropped
+    static constexpr std::size_t STEP_CAPACITY = 256;
+
 public:
     slim_signal::Signal<void(Interval::Ptr)> finished;
 
@@ -44,24 +55,47 @@ public:
 
     long elapsedMs() const;
 
-    Interval::Ptr pushInterval(const std::string& name);
-    void popInterval();
-
     void setActivity(bool active);
 
     Interval::Ptr getRoot() const;
 
+    std::size_t countDroppedSteps() const;
+
+private:
+    struct Step
+    {
+        uint32_t name;
+        int parent;
+        uint64_t begin_ns;
+        /// the run the step belongs to, stored after the fields above, so that a half written step is never read
+        std::atomic<uint32_t> generation{ 0 };
+        /// the run that closed the step and its duration, so that a step of an earlier run cannot end this one
+        std::atomic<uint64_t> end{ 0 };
+    };
+
+    /// returns the slot of the step, -1 if it was dropped
+    int openStep(uint32_t name, int parent, uint32_t generation, uint64_t begin_ns);
+    void closeStep(int step, uint32_t generation, uint64_t begin_ns, uint64_t end_ns);
+
+    void buildIntervals(uint64_t finish_ns);
+
 private:
     std::string timer_name_;
 
     Interval::Ptr root_;
 
-    std::mutex active_intervals_mutex_;
-    std::deque<Interval::Ptr> active_intervals_;
+    std::unique_ptr<Step[]> steps_;
+    std::atomic<uint32_t> step_count_;
+    std::atomic<uint32_t> generation_;
+    std::atomic<std::size_t> dropped_steps_;
+    std::vector<Interval*> step_intervals_;
 
     bool enabled_;
     bool dirty_;
     bool finished_;
+
+    uint32_t trace_name_;
+    uint64_t trace_begin_ns_;
 };
 
 }  // namespace csapex
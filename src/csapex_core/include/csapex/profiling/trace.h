@@ -6,14 +6,28 @@
 #include <csapex_core/csapex_profiling_export.h>
 
 /// SYSTEM
+#include <cstdint>
 #include <memory>
 
 namespace csapex
 {
 class Timer;
 
+/**
+ * @brief The Trace class records a step of a Timer for the lifetime of the object.
+ *        Traces that are created on the same thread while another one is alive are nested in it.
+ *        While the Tracer is enabled, the step is also recorded there.
+ */
 class CSAPEX_PROFILING_EXPORT Trace
 {
+public:
+    struct Scope
+    {
+        Timer* timer;
+        int step;
+        uint32_t generation;
+    };
+
 public:
     typedef std::unique_ptr<Trace> Ptr;
 
@@ -28,7 +42,12 @@ private:
 
 private:
     Timer* timer_;
-    Interval::Ptr interval_;
+    Scope scope_;
+    Scope enclosing_;
+
+    uint32_t name_;
+    uint64_t begin_ns_;
+    bool traced_;
 };
 
 }  // namespace csapex
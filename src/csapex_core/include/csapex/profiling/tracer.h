@@ -0,0 +1,160 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+/// COMPONENT
+#include <csapex_core/csapex_profiling_export.h>
+
+/// PROJECT
+#include <csapex/utility/singleton.hpp>
+
+/// SYSTEM
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace csapex
+{
+/**
+ * @brief The TraceEvent struct is one finished span as it is stored in the ring buffers of the Tracer
+ */
+struct TraceEvent
+{
+    uint64_t begin_ns;
+    uint64_t end_ns;
+    uint32_t name;
+    uint32_t thread;
+};
+
+/**
+ * @brief The Tracer class records spans into fixed size per-thread ring buffers without locking.
+ *        The buffers are drained asynchronously, events are dropped when a buffer is full.
+ *        Recorded spans can be exported in the Chrome trace event format (chrome://tracing, Perfetto).
+ */
+class CSAPEX_PROFILING_EXPORT Tracer : public Singleton<Tracer>
+{
+    friend class Singleton<Tracer>;
+
+public:
+    struct Buffer;
+
+    static constexpr std::size_t BUFFER_CAPACITY = 4096;
+
+public:
+    static uint64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    bool isEnabled() const
+    {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+    void setEnabled(bool enabled);
+
+    /// enables tracing and drains the buffers in the background every `period`
+    void start(std::chrono::milliseconds period = std::chrono::milliseconds(100));
+    /// stops the background drain, recorded events are kept
+    void stop();
+
+    void shutdown() override;
+
+    /// returns a stable id for the name, cached per thread after the first call
+    uint32_t intern(const std::string& name);
+
+    void record(uint32_t name, uint64_t begin_ns, uint64_t end_ns);
+
+    /// moves all events from the thread buffers into the history, returns the number of moved events
+    std::size_t drain();
+
+    std::vector<TraceEvent> getEvents() const;
+    std::string getName(uint32_t name) const;
+
+    void setHistoryLength(std::size_t max_events);
+    void clear();
+
+    std::size_t countDroppedEvents() const;
+
+    void writeChromeTrace(std::ostream& out);
+    void writeChromeTrace(const std::string& file);
+
+private:
+    Tracer();
+    ~Tracer() override;
+
+    Buffer& getLocalBuffer();
+
+private:
+    std::atomic<bool> enabled_;
+    uint64_t origin_ns_;
+
+    mutable std::mutex names_mutex_;
+    std::vector<std::string> names_;
+    std::unordered_map<std::string, uint32_t> name_ids_;
+
+    std::mutex buffers_mutex_;
+    std::vector<std::shared_ptr<Buffer>> buffers_;
+    uint32_t next_thread_;
+
+    mutable std::mutex events_mutex_;
+    std::deque<TraceEvent> events_;
+    std::size_t max_events_;
+    std::atomic<std::size_t> dropped_;
+
+    std::thread drain_thread_;
+    std::mutex drain_mutex_;
+    std::condition_variable drain_changed_;
+    bool draining_;
+};
+
+/**
+ * @brief The TraceSpan class records the lifetime of a scope with the Tracer, if it is enabled
+ */
+class TraceSpan
+{
+public:
+    explicit TraceSpan(uint32_t name) : TraceSpan(name, true)
+    {
+    }
+    /// a span that is not `recorded` does nothing, for scopes that are traced otherwise
+    TraceSpan(uint32_t name, bool recorded) : name_(name), begin_ns_(recorded && Tracer::instance().isEnabled() ? Tracer::now() : 0)
+    {
+    }
+    explicit TraceSpan(const std::string& name) : TraceSpan(Tracer::instance().isEnabled() ? Tracer::instance().intern(name) : 0)
+    {
+    }
+
+    ~TraceSpan()
+    {
+        if (begin_ns_ != 0) {
+            Tracer::instance().record(name_, begin_ns_, Tracer::now());
+        }
+    }
+
+    TraceSpan(const TraceSpan& copy) = delete;
+    TraceSpan& operator=(const TraceSpan& copy) = delete;
+
+private:
+    uint32_t name_;
+    uint64_t begin_ns_;
+};
+
+}  // namespace csapex
+
+#define TRACE_SPAN_CONCATENATE_DETAIL(x, y) x##y
+#define TRACE_SPAN_CONCATENATE(x, y) TRACE_SPAN_CONCATENATE_DETAIL(x, y)
+
+/// traces the enclosing scope, `name` has to be a constant because it is only interned once
+#define TRACE_SPAN(name)                                                                                                                                                                               \
+    static const uint32_t TRACE_SPAN_CONCATENATE(__trace_span_name__, __LINE__) = csapex::Tracer::instance().intern(name);                                                                          \
+    csapex::TraceSpan TRACE_SPAN_CONCATENATE(__trace_span__, __LINE__)(TRACE_SPAN_CONCATENATE(__trace_span_name__, __LINE__))
+
+#endif  // TRACER_H
@@ -11,6 +11,17 @@
 
 namespace csapex
 {
+/**
+ * @brief The SchedulingPolicy enum determines how a scheduler orders the tasks that are ready
+ *  - FIFO: tasks are executed in the order they are scheduled
+ *  - CRITICAL_PATH: nodes with the longest remaining path to a sink and nodes that unblock joins are executed first
+ */
+enum class SchedulingPolicy
+{
+    FIFO,
+    CRITICAL_PATH
+};
+
 class CSAPEX_CORE_EXPORT Scheduler
 {
 public:
@@ -34,12 +45,24 @@ public:
 
     virtual bool isEmpty() const = 0;
 
+    /**
+     * @brief setSchedulingPolicy selects the order of ready tasks, schedulers that don't support policies use FIFO
+     */
+    virtual void setSchedulingPolicy(SchedulingPolicy policy);
+    virtual SchedulingPolicy getSchedulingPolicy() const;
+
+    /**
+     * @brief setChainFusion allows nodes of linear chains to run their successor directly, instead of scheduling it
+     */
+    virtual void setChainFusion(bool fusion);
+    virtual bool isChainFusionEnabled() const;
+
     virtual void add(TaskGeneratorPtr schedulable) = 0;
     virtual void add(TaskGeneratorPtr schedulable, const std::vector<TaskPtr>& initial_tasks) = 0;
     virtual std::vector<TaskPtr> remove(TaskGenerator* schedulable) = 0;
 
     virtual void schedule(TaskPtr schedulable) = 0;
-    virtual void scheduleDelayed(TaskPtr schedulable, std::chrono::system_clock::time_point time) = 0;
+    virtual void scheduleDelayed(TaskPtr schedulable, std::chrono::steady_clock::time_point time) = 0;
 
 public:
     slim_signal::Signal<void()> stepping_enabled;
@@ -20,6 +20,7 @@ FWD(ThreadPool)
 FWD(ThreadGroup)
 FWD(Task)
 FWD(TimedQueue)
+FWD(WorkerPool)
 }  // namespace csapex
 
 #undef FWD
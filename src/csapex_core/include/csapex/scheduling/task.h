@@ -6,6 +6,7 @@
 #include <csapex_core/csapex_core_export.h>
 
 /// SYSTEM
+#include <atomic>
 #include <functional>
 #include <string>
 
@@ -25,6 +26,12 @@ public:
     void setScheduled(bool scheduled);
     bool isScheduled() const;
 
+    /**
+     * @brief markScheduled atomically sets the scheduled flag
+     * @return false, iff the task was already scheduled
+     */
+    bool markScheduled();
+
     TaskGenerator* getParent() const;
     std::string getName() const;
 
@@ -34,7 +41,7 @@ private:
     std::function<void()> callback_;
 
     long priority_;
-    bool scheduled_;
+    std::atomic<bool> scheduled_;
 };
 
 }  // namespace csapex
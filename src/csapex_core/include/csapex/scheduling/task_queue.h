@@ -0,0 +1,73 @@
+#ifndef TASK_QUEUE_H
+#define TASK_QUEUE_H
+
+/// COMPONENT
+#include <csapex/scheduling/scheduling_fwd.h>
+#include <csapex_core/csapex_core_export.h>
+
+/// SYSTEM
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace csapex
+{
+/**
+ * @brief The TaskQueue class is a priority queue for tasks with many producers and one consumer.
+ *        Pushing never blocks: tasks are appended to a lock-free inbox and the scheduled flag of
+ *        each task is used to suppress duplicates in O(1).
+ *        The consumer moves the inbox into a private priority ordered set when it pops.
+ */
+class CSAPEX_CORE_EXPORT TaskQueue
+{
+public:
+    TaskQueue();
+    ~TaskQueue();
+
+    TaskQueue(const TaskQueue&) = delete;
+    TaskQueue& operator=(const TaskQueue&) = delete;
+
+    /**
+     * @brief push adds a task, can be called from any thread
+     * @return false, iff the task was already scheduled
+     */
+    bool push(const TaskPtr& task);
+
+    /**
+     * @brief pop takes the task with the highest priority, tasks of equal priority are returned in FIFO order
+     * @return the next task or nullptr, if the queue is empty
+     */
+    TaskPtr pop();
+
+    bool empty();
+
+    /**
+     * @brief removeIf takes all tasks out of the queue that match the predicate
+     */
+    std::vector<TaskPtr> removeIf(const std::function<bool(const TaskPtr&)>& predicate);
+    void clear();
+
+private:
+    struct Node;
+
+    void drainInbox();
+
+private:
+    // producers append at head_, the consumer reads after tail_
+    std::atomic<Node*> head_;
+    Node* tail_;
+
+    std::mutex consumer_mtx_;
+
+    struct greater
+    {
+        bool operator()(const TaskPtr& a, const TaskPtr& b) const;
+    };
+    std::multiset<TaskPtr, greater> ready_;
+};
+
+}  // namespace csapex
+
+#endif  // TASK_QUEUE_H
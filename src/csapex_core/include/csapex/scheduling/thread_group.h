@@ -4,6 +4,7 @@
 /// PROJECT
 #include <csapex/scheduling/scheduler.h>
 #include <csapex/scheduling/task.h>
+#include <csapex/scheduling/task_queue.h>
 #include <csapex/core/core_fwd.h>
 #include <csapex/utility/utility_fwd.h>
 #include <csapex/profiling/profiling_fwd.h>
@@ -56,6 +57,12 @@ public:
     std::size_t size() const;
     bool isEmpty() const override;
 
+    void setSchedulingPolicy(SchedulingPolicy policy) override;
+    SchedulingPolicy getSchedulingPolicy() const override;
+
+    void setChainFusion(bool fusion) override;
+    bool isChainFusionEnabled() const override;
+
     void setPause(bool pause) override;
     void setSteppingMode(bool stepping) override;
 
@@ -70,13 +77,21 @@ public:
 
     bool isRunning() const;
 
+    /**
+     * @brief useWorkerPool executes the tasks of this group on a shared pool instead of a private thread.
+     *        Tasks of the same generator are still executed in sequence, different generators run in parallel.
+     *        The scheduling policy still applies: generators are handed to the pool with the priority of their next task.
+     */
+    void useWorkerPool(WorkerPoolPtr pool);
+    WorkerPoolPtr getWorkerPool() const;
+
     void add(TaskGeneratorPtr generator) override;
     void add(TaskGeneratorPtr generator, const std::vector<TaskPtr>& initial_tasks) override;
 
     std::vector<TaskPtr> remove(TaskGenerator* generator) override;
 
     void schedule(TaskPtr schedulable) override;
-    void scheduleDelayed(TaskPtr schedulable, std::chrono::system_clock::time_point time) override;
+    void scheduleDelayed(TaskPtr schedulable, std::chrono::steady_clock::time_point time) override;
 
     std::vector<TaskGeneratorPtr>::iterator begin();
     std::vector<TaskGeneratorPtr>::const_iterator begin() const;
@@ -102,6 +117,15 @@ private:
     void executeTask(const TaskPtr& task);
 
     void checkIfStepIsDone();
+    void notifyWorkAvailable();
+
+    struct Strand;
+    typedef std::shared_ptr<Strand> StrandPtr;
+
+    void dispatch(const StrandPtr& strand);
+    void executeStrand(const StrandPtr& strand, long epoch);
+    void resumeParkedStrands();
+    void waitForIdleWorkers(std::unique_lock<std::recursive_mutex>& lock);
 
 private:
     ExceptionHandler& handler_;
@@ -122,7 +146,9 @@ private:
     std::vector<TaskGeneratorPtr> generators_;
     std::map<TaskGenerator*, std::vector<slim_signal::ScopedConnection>> generator_connections_;
 
-    std::condition_variable_any work_available_;
+    std::mutex work_available_mtx_;
+    std::condition_variable work_available_;
+    std::atomic<bool> waiting_for_work_;
     std::condition_variable_any pause_changed_;
 
     std::recursive_mutex tasks_mtx_;
@@ -134,12 +160,22 @@ private:
         }
     };
 
-    std::multiset<TaskPtr, greater> tasks_;
+    TaskQueue tasks_;
+
+    WorkerPoolPtr worker_pool_;
+    std::map<TaskGenerator*, StrandPtr> strands_;
+    std::vector<StrandPtr> parked_strands_;
+    long dispatch_epoch_;
+    int executing_tasks_;
+    int exclusive_sections_;
+    std::condition_variable_any workers_idle_;
 
     std::recursive_mutex state_mtx_;
     std::atomic<bool> running_;
     std::atomic<bool> pause_;
     std::atomic<bool> stepping_;
+    std::atomic<SchedulingPolicy> scheduling_policy_;
+    std::atomic<bool> chain_fusion_;
 
     mutable std::recursive_mutex execution_mtx_;
 };
@@ -3,6 +3,7 @@
 
 /// COMPONENT
 #include <csapex/scheduling/executor.h>
+#include <csapex/scheduling/scheduler.h>
 #include <csapex/scheduling/scheduling_fwd.h>
 #include <csapex/core/exception_handler.h>
 #include <csapex/utility/utility_fwd.h>
@@ -30,6 +31,27 @@ public:
     bool isThreadingEnabled() const;
     bool isGroupingEnabled() const;
 
+    /**
+     * @brief enableWorkStealing executes all groups on a shared pool of workers.
+     *        Groups then only serve as affinity hints, nodes of the same group can run in parallel.
+     * @param worker_count number of workers, 0 means one per hardware thread
+     */
+    void enableWorkStealing(std::size_t worker_count = 0);
+    bool isWorkStealingEnabled() const;
+    WorkerPoolPtr getWorkerPool() const;
+
+    /**
+     * @brief setSchedulingPolicy selects how all groups of this pool order the tasks that are ready
+     */
+    void setSchedulingPolicy(SchedulingPolicy policy);
+    SchedulingPolicy getSchedulingPolicy() const;
+
+    /**
+     * @brief setChainFusion lets all groups of this pool execute fused chains of nodes in a single task
+     */
+    void setChainFusion(bool fusion);
+    bool isChainFusionEnabled() const;
+
     void performStep() override;
 
     void start() override;
@@ -99,6 +121,9 @@ private:
     ExceptionHandler& handler_;
 
     TimedQueuePtr timed_queue_;
+    WorkerPoolPtr worker_pool_;
+    SchedulingPolicy scheduling_policy_;
+    bool chain_fusion_;
 
     bool enable_threading_;
     bool grouping_;
@@ -3,60 +3,75 @@
 
 /// COMPONENT
 #include <csapex/scheduling/scheduling_fwd.h>
+#include <csapex_core/csapex_core_export.h>
 
 /// SYSTEM
 #include <thread>
 #include <condition_variable>
 #include <chrono>
-#include <set>
-#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
 
 namespace csapex
 {
-class TimedQueue
+/**
+ * @brief The TimedQueue class hands tasks to their scheduler once a point in time is reached.
+ *        Pending tasks are kept in a hashed timer wheel with millisecond slots on the monotonic clock.
+ *        A single thread sleeps until the next deadline and then schedules all expired tasks in one batch.
+ */
+class CSAPEX_CORE_EXPORT TimedQueue
 {
+public:
+    typedef std::chrono::steady_clock clock;
+
+    static constexpr std::size_t SLOT_COUNT = 1024;
+
 public:
     TimedQueue();
     ~TimedQueue();
 
-    void schedule(SchedulerPtr scheduler, TaskPtr schedulable, std::chrono::system_clock::time_point time);
+    /**
+     * @brief schedule queues a task, tasks whose time has already passed are scheduled immediately
+     */
+    void schedule(SchedulerPtr scheduler, TaskPtr schedulable, clock::time_point time);
 
     void start();
     void stop();
 
-private:
-    void loop();
-    void sleep();
+    std::size_t size();
 
 private:
-    std::thread scheduling_thread_;
-    std::thread sleeping_thread_;
-
-    std::atomic<bool> scheduling_running_;
-    std::atomic<bool> sleeping_running_;
-
     struct Unit
     {
         SchedulerPtr scheduler;
         TaskPtr schedulable;
-        std::chrono::system_clock::time_point time;
+        std::int64_t tick;
     };
 
-    struct UnitCompare
-    {
-        bool operator()(const Unit& a, const Unit& b) const
-        {
-            return a.time < b.time;
-        }
-    };
+    void loop();
+
+    std::int64_t ticksUntil(clock::time_point time) const;
+    clock::time_point timeOf(std::int64_t tick) const;
+
+    void advance(std::int64_t tick, std::vector<Unit>& expired);
+    void expireSlot(std::size_t slot, std::int64_t tick, std::vector<Unit>& expired);
+    std::int64_t nextDeadline() const;
+
+private:
+    std::thread timer_thread_;
+    bool running_;
+
+    std::mutex mtx_;
+    std::condition_variable wheel_changed_;
 
-    std::mutex task_mtx_;
-    std::condition_variable tasks_changed_;
-    std::set<Unit, UnitCompare> tasks_;
+    clock::time_point epoch_;
+    // every tick up to and including current_tick_ has been expired
+    std::int64_t current_tick_;
+    std::int64_t next_wake_up_tick_;
 
-    std::mutex sleep_mtx_;
-    std::condition_variable next_wake_up_changed_;
-    std::chrono::system_clock::time_point next_wake_up_;
+    std::size_t pending_;
+    std::vector<std::vector<Unit>> slots_;
 };
 
 }  // namespace csapex
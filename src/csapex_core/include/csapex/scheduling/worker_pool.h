@@ -0,0 +1,94 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+/// COMPONENT
+#include <csapex/scheduling/scheduling_fwd.h>
+#include <csapex_core/csapex_core_export.h>
+
+/// SYSTEM
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace csapex
+{
+/**
+ * @brief The WorkerPool class runs jobs on a fixed number of worker threads.
+ *        Every worker owns a deque: jobs posted from a worker are pushed to its own deque and
+ *        executed LIFO, idle workers steal the oldest jobs from the other workers.
+ *        Jobs with a higher priority are taken first, both from the own deque and when stealing.
+ */
+class CSAPEX_CORE_EXPORT WorkerPool
+{
+public:
+    typedef std::function<void()> Job;
+
+public:
+    /**
+     * @param worker_count number of threads, 0 means one per hardware thread
+     */
+    WorkerPool(std::size_t worker_count = 0);
+    ~WorkerPool();
+
+    std::size_t getWorkerCount() const;
+
+    void start();
+    void stop();
+    bool isRunning() const;
+
+    /**
+     * @brief post queues a job for execution
+     * @param affinity_hint preferred worker for jobs that are posted from outside the pool, -1 for round robin
+     * @param priority jobs with a higher priority are executed first
+     */
+    void post(Job job, int affinity_hint = -1, long priority = 0);
+
+    /**
+     * @return true, iff the calling thread is one of the workers of this pool
+     */
+    bool isWorkerThread() const;
+
+    std::size_t getExecutedCount() const;
+    std::size_t getStolenCount() const;
+
+private:
+    struct Entry
+    {
+        Job job;
+        long priority;
+    };
+
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<Entry> jobs;
+        std::thread thread;
+    };
+
+    void workerLoop(std::size_t index);
+
+    bool popLocal(std::size_t index, Job& job);
+    bool steal(std::size_t thief, Job& job);
+
+private:
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    std::atomic<bool> running_;
+    std::atomic<std::size_t> pending_;
+    std::atomic<std::size_t> next_worker_;
+
+    std::atomic<std::size_t> executed_;
+    std::atomic<std::size_t> stolen_;
+
+    std::mutex sleep_mtx_;
+    std::condition_variable work_available_;
+};
+
+}  // namespace csapex
+
+#endif  // WORKER_POOL_H
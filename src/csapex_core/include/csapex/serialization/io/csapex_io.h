@@ -9,6 +9,9 @@
 #include <csapex/model/model_fwd.h>
 #include <csapex/utility/data_traits.hpp>
 
+/// SYSTEM
+#include <algorithm>
+
 namespace csapex
 {
 // base
@@ -26,8 +29,7 @@ const SerializationBuffer& operator>>(const SerializationBuffer& data, UUID& s);
 template <typename S, typename std::enable_if<std::is_base_of<Serializable, S>::value, int>::type = 0>
 SerializationBuffer& operator<<(SerializationBuffer& data, const std::vector<S>& s)
 {
-    apex_assert_lt_hard(s.size(), std::numeric_limits<uint8_t>::max());
-    data << (static_cast<uint8_t>(s.size()));
+    data.writeLength(s.size());
     for (const S& elem : s) {
         // disambiguate possible overloads for serializable objects
         data << static_cast<const Serializable&>(elem);
@@ -38,11 +40,10 @@ SerializationBuffer& operator<<(SerializationBuffer& data, const std::vector<S>&
 template <typename S, typename std::enable_if<std::is_integral<S>::value && std::is_base_of<Serializable, S>::value, int>::type = 0>
 const SerializationBuffer& operator>>(const SerializationBuffer& data, std::vector<S>& s)
 {
-    uint8_t len;
-    data >> len;
-    s.reserve(len);
+    uint64_t len = data.readLength();
+    s.reserve(std::min<uint64_t>(len, data.size() - data.getPos()));
     s.clear();
-    for (uint8_t i = 0; i < len; ++i) {
+    for (uint64_t i = 0; i < len; ++i) {
         S integral;
         data >> integral;
         s.push_back(integral);
@@ -53,11 +54,10 @@ const SerializationBuffer& operator>>(const SerializationBuffer& data, std::vect
 template <typename S, typename std::enable_if<!std::is_integral<S>::value && std::is_base_of<Serializable, S>::value && std::is_default_constructible<S>::value, int>::type = 0>
 const SerializationBuffer& operator>>(const SerializationBuffer& data, std::vector<S>& s)
 {
-    uint8_t len;
-    data >> len;
-    s.reserve(len);
+    uint64_t len = data.readLength();
+    s.reserve(std::min<uint64_t>(len, data.size() - data.getPos()));
     s.clear();
-    for (uint8_t i = 0; i < len; ++i) {
+    for (uint64_t i = 0; i < len; ++i) {
         s.emplace_back();
         data >> static_cast<Serializable&>(s.back());
     }
@@ -67,11 +67,10 @@ const SerializationBuffer& operator>>(const SerializationBuffer& data, std::vect
 template <typename S, typename std::enable_if<!std::is_integral<S>::value && std::is_base_of<Serializable, S>::value && !std::is_default_constructible<S>::value, int>::type = 0>
 const SerializationBuffer& operator>>(const SerializationBuffer& data, std::vector<S>& s)
 {
-    uint8_t len;
-    data >> len;
-    s.reserve(len);
+    uint64_t len = data.readLength();
+    s.reserve(std::min<uint64_t>(len, data.size() - data.getPos()));
     s.clear();
-    for (uint8_t i = 0; i < len; ++i) {
+    for (uint64_t i = 0; i < len; ++i) {
         std::shared_ptr<S> object = makeEmpty<S>();
         data >> static_cast<Serializable&>(*object);
         s.push_back(*object);
@@ -7,6 +7,7 @@
 #include <csapex/msg/token_traits.h>
 
 /// SYSTEM
+#include <algorithm>
 #include <map>
 #include <vector>
 #include <set>
@@ -22,25 +23,54 @@ SerializationBuffer& operator<<(SerializationBuffer& data, const std::stringstre
 const SerializationBuffer& operator>>(const SerializationBuffer& data, std::stringstream& s);
 
 // VECTOR
-template <typename S, typename std::enable_if<!std::is_base_of<Serializable, S>::value, int>::type = 0>
+namespace detail
+{
+/**
+ * @brief vectors of these types are contiguous and are copied as one block
+ */
+template <typename S>
+struct is_bulk_serializable : std::integral_constant<bool, (std::is_integral<S>::value && !std::is_same<S, bool>::value) || std::is_same<S, float>::value || std::is_same<S, double>::value>
+{
+};
+}  // namespace detail
+
+template <typename S, typename std::enable_if<detail::is_bulk_serializable<S>::value, int>::type = 0>
+SerializationBuffer& operator<<(SerializationBuffer& data, const std::vector<S>& s)
+{
+    data.writeLength(s.size());
+    data.writeArray(s.data(), s.size());
+    return data;
+}
+
+template <typename S, typename std::enable_if<detail::is_bulk_serializable<S>::value, int>::type = 0>
+const SerializationBuffer& operator>>(const SerializationBuffer& data, std::vector<S>& s)
+{
+    uint64_t len = data.readLength();
+    if (len > (data.size() - data.getPos()) / sizeof(S)) {
+        throw std::out_of_range("vector of " + std::to_string(len) + " elements exceeds the buffer");
+    }
+    s.resize(len);
+    data.readArray(s.data(), len);
+    return data;
+}
+
+template <typename S, typename std::enable_if<!detail::is_bulk_serializable<S>::value && !std::is_base_of<Serializable, S>::value, int>::type = 0>
 SerializationBuffer& operator<<(SerializationBuffer& data, const std::vector<S>& s)
 {
-    apex_assert_lt_hard(s.size(), std::numeric_limits<uint8_t>::max());
-    data << (static_cast<uint8_t>(s.size()));
+    data.writeLength(s.size());
     for (const S& elem : s) {
         data << elem;
     }
     return data;
 }
 
-template <typename S, typename std::enable_if<std::is_integral<S>::value && !std::is_base_of<Serializable, S>::value, int>::type = 0>
+template <typename S, typename std::enable_if<std::is_same<S, bool>::value, int>::type = 0>
 const SerializationBuffer& operator>>(const SerializationBuffer& data, std::vector<S>& s)
 {
-    uint8_t len;
-    data >> len;
-    s.reserve(len);
+    uint64_t len = data.readLength();
+    s.reserve(std::min<uint64_t>(len, data.size() - data.getPos()));
     s.clear();
-    for (uint8_t i = 0; i < len; ++i) {
+    for (uint64_t i = 0; i < len; ++i) {
         S integral;
         data >> integral;
         s.push_back(integral);
@@ -48,14 +78,13 @@ const SerializationBuffer& operator>>(const SerializationBuffer& data, std::vect
     return data;
 }
 
-template <typename S, typename std::enable_if<!std::is_integral<S>::value && !std::is_base_of<Serializable, S>::value && std::is_default_constructible<S>::value, int>::type = 0>
+template <typename S, typename std::enable_if<!std::is_integral<S>::value && !detail::is_bulk_serializable<S>::value && !std::is_base_of<Serializable, S>::value && std::is_default_constructible<S>::value, int>::type = 0>
 const SerializationBuffer& operator>>(const SerializationBuffer& data, std::vector<S>& s)
 {
-    uint8_t len;
-    data >> len;
-    s.reserve(len);
+    uint64_t len = data.readLength();
+    s.reserve(std::min<uint64_t>(len, data.size() - data.getPos()));
     s.clear();
-    for (uint8_t i = 0; i < len; ++i) {
+    for (uint64_t i = 0; i < len; ++i) {
         s.emplace_back();
         data >> s.back();
     }
@@ -65,11 +94,10 @@ const SerializationBuffer& operator>>(const SerializationBuffer& data, std::vect
 template <typename S, typename std::enable_if<!std::is_integral<S>::value && !std::is_base_of<Serializable, S>::value && !std::is_default_constructible<S>::value, int>::type = 0>
 const SerializationBuffer& operator>>(const SerializationBuffer& data, std::vector<S>& s)
 {
-    uint8_t len;
-    data >> len;
-    s.reserve(len);
+    uint64_t len = data.readLength();
+    s.reserve(std::min<uint64_t>(len, data.size() - data.getPos()));
     s.clear();
-    for (uint8_t i = 0; i < len; ++i) {
+    for (uint64_t i = 0; i < len; ++i) {
         std::shared_ptr<S> object = makeEmpty<S>();
         data >> object;
         s.push_back(*object);
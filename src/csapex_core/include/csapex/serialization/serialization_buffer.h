@@ -9,6 +9,9 @@
 /// SYSTEM
 #include <vector>
 #include <inttypes.h>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
 #include <string>
 #include <functional>
 #include <sstream>
@@ -73,27 +76,90 @@ public:
     template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
     SerializationBuffer& operator<<(T i)
     {
-        std::size_t nbytes = sizeof(T);
-        for (std::size_t byte = 0; byte < nbytes; ++byte) {
-            const uint8_t part = static_cast<uint8_t>((i >> (byte * 8)) & 0xFF);
-            push_back(part);
-        }
+        writeArray(&i, 1);
         return *this;
     }
     template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
     const SerializationBuffer& operator>>(T& i) const
     {
-        std::size_t nbytes = sizeof(T);
-        T res = 0;
-        for (std::size_t byte = 0; byte < nbytes; ++byte) {
-            const uint8_t part = static_cast<uint8_t>(at(pos++));
-            const auto raw = part << (byte * 8);
-            res |= static_cast<T>(raw);
-        }
-        i = res;
+        readArray(&i, 1);
         return *this;
     }
 
+    // LENGTHS
+    /**
+     * @brief writeLength writes the size of a container or string.
+     *        Sizes below the maximum of Short are written as Short, like in streams that predate large containers.
+     *        Larger sizes are escaped with that maximum, which old writers never produced, and follow as uint64.
+     */
+    template <typename Short = uint8_t>
+    void writeLength(uint64_t length)
+    {
+        static_assert(std::is_unsigned<Short>::value, "lengths are unsigned");
+        if (length < std::numeric_limits<Short>::max()) {
+            *this << static_cast<Short>(length);
+        } else {
+            *this << std::numeric_limits<Short>::max();
+            *this << length;
+        }
+    }
+    template <typename Short = uint8_t>
+    uint64_t readLength() const
+    {
+        static_assert(std::is_unsigned<Short>::value, "lengths are unsigned");
+        Short length;
+        *this >> length;
+        if (length < std::numeric_limits<Short>::max()) {
+            return length;
+        }
+        uint64_t long_length;
+        *this >> long_length;
+        return long_length;
+    }
+
+    // CONTIGUOUS ARRAYS
+    /**
+     * @brief writeArray appends count integers in little endian byte order.
+     *        On little endian hosts this is a single memcpy into space that is reserved ahead.
+     */
+    template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+    void writeArray(const T* data, std::size_t count)
+    {
+        uint8_t* dst = grow(count * sizeof(T));
+        if (HOST_IS_LITTLE_ENDIAN && !std::is_same<T, bool>::value) {
+            std::memcpy(dst, data, count * sizeof(T));
+        } else {
+            for (std::size_t idx = 0; idx < count; ++idx) {
+                const T i = data[idx];
+                for (std::size_t byte = 0; byte < sizeof(T); ++byte) {
+                    *dst++ = static_cast<uint8_t>((i >> (byte * 8)) & 0xFF);
+                }
+            }
+        }
+    }
+    template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+    void readArray(T* data, std::size_t count) const
+    {
+        const uint8_t* src = consume(count * sizeof(T));
+        if (HOST_IS_LITTLE_ENDIAN && !std::is_same<T, bool>::value) {
+            std::memcpy(data, src, count * sizeof(T));
+        } else {
+            for (std::size_t idx = 0; idx < count; ++idx) {
+                T res = 0;
+                for (std::size_t byte = 0; byte < sizeof(T); ++byte) {
+                    const auto raw = *src++ << (byte * 8);
+                    res |= static_cast<T>(raw);
+                }
+                data[idx] = res;
+            }
+        }
+    }
+
+    void writeArray(const float* data, std::size_t count);
+    void readArray(float* data, std::size_t count) const;
+    void writeArray(const double* data, std::size_t count);
+    void readArray(double* data, std::size_t count) const;
+
     // FLOATS
     SerializationBuffer& operator<<(float f);
     const SerializationBuffer& operator>>(float& f) const;
@@ -139,6 +205,22 @@ public:
 private:
     static void init();
 
+    /**
+     * @brief grow appends length bytes and returns a pointer to the first one
+     */
+    uint8_t* grow(std::size_t length);
+    /**
+     * @brief consume advances the read position by length bytes and returns a pointer to the first one
+     * @throws std::out_of_range if the buffer is too short
+     */
+    const uint8_t* consume(std::size_t length) const;
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    static constexpr bool HOST_IS_LITTLE_ENDIAN = false;
+#else
+    static constexpr bool HOST_IS_LITTLE_ENDIAN = true;
+#endif
+
 private:
     mutable std::size_t pos;
 
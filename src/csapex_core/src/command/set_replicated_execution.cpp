@@ -0,0 +1,92 @@
+/// HEADER
+#include <csapex/command/set_replicated_execution.h>
+
+/// COMPONENT
+#include <csapex/command/command.h>
+#include <csapex/model/graph/graph_impl.h>
+#include <csapex/model/node_handle.h>
+#include <csapex/model/node_facade_impl.h>
+#include <csapex/model/node_state.h>
+#include <csapex/command/command_serializer.h>
+#include <csapex/serialization/io/std_io.h>
+#include <csapex/serialization/io/csapex_io.h>
+#include <csapex/utility/assert.h>
+
+/// SYSTEM
+#include <sstream>
+
+using namespace csapex;
+using namespace csapex::command;
+
+CSAPEX_REGISTER_COMMAND_SERIALIZER(SetReplicatedExecution)
+
+SetReplicatedExecution::SetReplicatedExecution(const AUUID& parent_uuid, const UUID& node, int replicas)
+  : CommandImplementation(parent_uuid), uuid(node), replicas_(replicas), was_type_(ExecutionType::AUTO), was_replicas_(1)
+{
+}
+
+std::string SetReplicatedExecution::getDescription() const
+{
+    std::stringstream ss;
+    ss << "switch processing of " << uuid << " to ";
+    if (replicas_ > 1) {
+        ss << replicas_ << " replicas";
+    } else {
+        ss << "not replicated";
+    }
+
+    return ss.str();
+}
+
+bool SetReplicatedExecution::doExecute()
+{
+    NodeFacadeImplementationPtr nf = std::dynamic_pointer_cast<NodeFacadeImplementation>(getGraph()->findNodeFacade(uuid));
+    apex_assert_hard(nf);
+
+    NodeStatePtr state = nf->getNodeState();
+    was_type_ = state->getExecutionType();
+    was_replicas_ = state->getReplicaCount();
+
+    // the count has to be known before the node worker is replaced
+    state->setReplicaCount(replicas_);
+    state->setExecutionType(replicas_ > 1 ? ExecutionType::REPLICATED : ExecutionType::DIRECT);
+
+    return true;
+}
+
+bool SetReplicatedExecution::doUndo()
+{
+    NodeFacadeImplementationPtr nf = std::dynamic_pointer_cast<NodeFacadeImplementation>(getGraph()->findNodeFacade(uuid));
+    apex_assert_hard(nf);
+
+    NodeStatePtr state = nf->getNodeState();
+    state->setReplicaCount(was_replicas_);
+    state->setExecutionType(was_type_);
+
+    return true;
+}
+
+bool SetReplicatedExecution::doRedo()
+{
+    return doExecute();
+}
+
+void SetReplicatedExecution::serialize(SerializationBuffer& data, SemanticVersion& version) const
+{
+    Command::serialize(data, version);
+
+    data << uuid;
+    data << replicas_;
+    data << was_type_;
+    data << was_replicas_;
+}
+
+void SetReplicatedExecution::deserialize(const SerializationBuffer& data, const SemanticVersion& version)
+{
+    Command::deserialize(data, version);
+
+    data >> uuid;
+    data >> replicas_;
+    data >> was_type_;
+    data >> was_replicas_;
+}
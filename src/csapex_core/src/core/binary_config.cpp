@@ -0,0 +1,222 @@
+/// HEADER
+#include <csapex/core/binary_config.h>
+
+/// PROJECT
+#include <csapex/core/settings.h>
+#include <csapex/serialization/io/std_io.h>
+
+/// SYSTEM
+#include <cstdio>
+#include <deque>
+#include <stdexcept>
+#include <unordered_map>
+#include <boost/filesystem.hpp>
+#include <boost/version.hpp>
+#if (BOOST_VERSION / 100000) >= 1 && (BOOST_VERSION / 100 % 1000) >= 54
+namespace bf3 = boost::filesystem;
+#else
+namespace bf3 = boost::filesystem3;
+#endif
+
+using namespace csapex;
+
+namespace
+{
+const std::string MAGIC = "csapex_binary_config";
+const uint8_t VERSION = 1;
+
+enum class NodeTag : uint8_t
+{
+    NIL = 0,
+    SCALAR = 1,
+    SEQUENCE = 2,
+    MAP = 3
+};
+
+class Encoder
+{
+public:
+    Encoder(SerializationBuffer& data) : data_(data)
+    {
+    }
+
+    void write(const YAML::Node& node)
+    {
+        switch (node.Type()) {
+            case YAML::NodeType::Scalar:
+                data_ << static_cast<uint8_t>(NodeTag::SCALAR);
+                writeString(node.Scalar());
+                break;
+            case YAML::NodeType::Sequence:
+                data_ << static_cast<uint8_t>(NodeTag::SEQUENCE);
+                data_.writeLength(node.size());
+                for (const YAML::Node& child : node) {
+                    write(child);
+                }
+                break;
+            case YAML::NodeType::Map:
+                data_ << static_cast<uint8_t>(NodeTag::MAP);
+                data_.writeLength(node.size());
+                for (const auto& pair : node) {
+                    write(pair.first);
+                    write(pair.second);
+                }
+                break;
+            default:
+                data_ << static_cast<uint8_t>(NodeTag::NIL);
+                break;
+        }
+    }
+
+private:
+    // strings are referenced by their index after their first occurrence, 0 introduces a new string
+    void writeString(const std::string& str)
+    {
+        auto pos = strings_.find(str);
+        if (pos != strings_.end()) {
+            data_.writeLength(pos->second);
+        } else {
+            std::size_t id = strings_.size() + 1;
+            strings_[str] = id;
+            data_.writeLength(0);
+            data_ << str;
+        }
+    }
+
+private:
+    SerializationBuffer& data_;
+    std::unordered_map<std::string, std::size_t> strings_;
+};
+
+class Decoder
+{
+public:
+    Decoder(const SerializationBuffer& data) : data_(data)
+    {
+    }
+
+    YAML::Node read()
+    {
+        uint8_t tag;
+        data_ >> tag;
+
+        switch (static_cast<NodeTag>(tag)) {
+            case NodeTag::NIL:
+                return YAML::Node(YAML::NodeType::Null);
+            case NodeTag::SCALAR:
+                return YAML::Node(readString());
+            case NodeTag::SEQUENCE: {
+                YAML::Node node(YAML::NodeType::Sequence);
+                for (uint64_t i = 0, n = data_.readLength(); i < n; ++i) {
+                    node.push_back(read());
+                }
+                return node;
+            }
+            case NodeTag::MAP: {
+                YAML::Node node(YAML::NodeType::Map);
+                for (uint64_t i = 0, n = data_.readLength(); i < n; ++i) {
+                    YAML::Node key = read();
+                    node[key] = read();
+                }
+                return node;
+            }
+            default:
+                throw std::runtime_error("invalid node tag " + std::to_string(tag) + " in binary config");
+        }
+    }
+
+private:
+    const std::string& readString()
+    {
+        uint64_t id = data_.readLength();
+        if (id == 0) {
+            strings_.emplace_back();
+            data_ >> strings_.back();
+            return strings_.back();
+        }
+        if (id > strings_.size()) {
+            throw std::runtime_error("invalid string reference in binary config");
+        }
+        return strings_[id - 1];
+    }
+
+private:
+    const SerializationBuffer& data_;
+    std::deque<std::string> strings_;
+};
+}  // namespace
+
+bool BinaryConfig::isBinaryConfig(const std::string& file)
+{
+    const std::string& ext = Settings::config_extension_binary;
+    return file.size() >= ext.size() && file.compare(file.size() - ext.size(), ext.size(), ext) == 0;
+}
+
+void BinaryConfig::write(SerializationBuffer& data, const YAML::Node& node)
+{
+    data << MAGIC << VERSION;
+    Encoder(data).write(node);
+}
+
+YAML::Node BinaryConfig::read(const SerializationBuffer& data)
+{
+    std::string magic;
+    uint8_t version;
+    data >> magic >> version;
+    if (magic != MAGIC) {
+        throw std::runtime_error("not a binary config");
+    }
+    if (version != VERSION) {
+        throw std::runtime_error("unsupported binary config version " + std::to_string(version));
+    }
+    return Decoder(data).read();
+}
+
+void BinaryConfig::save(const std::string& path, const YAML::Node& node)
+{
+    SerializationBuffer buffer;
+    write(buffer, node);
+    buffer.finalize();
+
+    // write to a temporary file first, so that a full disk or a crash never leaves a truncated config behind
+    std::string tmp_file = bf3::unique_path(path + ".%%%%-%%%%").string();
+    auto file = std::fopen(tmp_file.c_str(), "wb");
+    if (!file) {
+        throw std::runtime_error("cannot open file " + tmp_file + " for writing");
+    }
+    std::size_t written = std::fwrite(buffer.data(), sizeof(uint8_t), buffer.size(), file);
+    bool closed = std::fclose(file) == 0;
+
+    boost::system::error_code ec;
+    if (written == buffer.size() && closed) {
+        bf3::rename(tmp_file, path, ec);
+    }
+    if (written != buffer.size() || !closed || ec) {
+        bf3::remove(tmp_file, ec);
+        throw std::runtime_error("cannot write file " + path);
+    }
+}
+
+YAML::Node BinaryConfig::load(const std::string& path)
+{
+    auto file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        throw std::runtime_error("cannot open file " + path + " for reading");
+    }
+
+    std::fseek(file, 0, SEEK_END);
+    std::size_t n = std::ftell(file);
+    std::rewind(file);
+
+    SerializationBuffer buffer;
+    buffer.resize(n);
+
+    std::size_t bytes = std::fread(buffer.data(), 1, n, file);
+    std::fclose(file);
+
+    if (bytes != n) {
+        throw std::runtime_error("cannot read file " + path);
+    }
+
+    return read(buffer);
+}
@@ -2,6 +2,7 @@
 #include <csapex/core/csapex_core.h>
 
 /// COMPONENT
+#include <csapex/core/binary_config.h>
 #include <csapex/core/bootstrap.h>
 #include <csapex/core/core_plugin.h>
 #include <csapex/core/exception_handler.h>
@@ -17,10 +18,14 @@
 #include <csapex/model/node_runner.h>
 #include <csapex/model/node_state.h>
 #include <csapex/model/subgraph_node.h>
+#include <csapex/model/subprocess_pool.h>
 #include <csapex/msg/any_message.h>
 #include <csapex/plugin/plugin_locator.h>
 #include <csapex/plugin/plugin_manager.hpp>
+#include <csapex/plugin/plugin_manifest_index.h>
 #include <csapex/profiling/profiler_impl.h>
+#include <csapex/profiling/timer.h>
+#include <csapex/profiling/tracer.h>
 #include <csapex/scheduling/thread_pool.h>
 #include <csapex/serialization/snippet.h>
 #include <csapex/utility/assert.h>
@@ -31,7 +36,9 @@
 #include <csapex/io/server.h>
 
 /// SYSTEM
+#include <algorithm>
 #include <fstream>
+#include <iomanip>
 #ifdef WIN32
 #include <direct.h>
 #endif
@@ -56,6 +63,16 @@ CsApexCore::CsApexCore(Settings& settings, ExceptionHandler& handler, csapex::Pl
 
     thread_pool_ =
         std::make_shared<ThreadPool>(exception_handler_, !settings_.get<bool>("threadless", false), settings_.get<bool>("thread_grouping", true), settings_.get<bool>("initially_paused", false));
+    if (settings_.get<bool>("work_stealing", false)) {
+        // 0 picks the number of hardware threads
+        thread_pool_->enableWorkStealing(static_cast<std::size_t>(std::max(0, settings_.get<int>("worker_threads", 0))));
+    }
+    if (settings_.get<std::string>("scheduling_policy", "fifo") == "critical_path") {
+        thread_pool_->setSchedulingPolicy(SchedulingPolicy::CRITICAL_PATH);
+    }
+    thread_pool_->setChainFusion(settings_.get<bool>("fuse_chains", false));
+    SubprocessPool::instance().setSize(static_cast<std::size_t>(std::max(0, settings_.get<int>("subprocess_sandboxes", 0))));
+    SubprocessPool::instance().setStandby(settings_.get<bool>("subprocess_standby", false));
 
     observe(thread_pool_->paused, paused);
 
@@ -96,6 +113,17 @@ CsApexCore::CsApexCore(Settings& settings, ExceptionHandler& handler) : CsApexCo
 
     observe(exception_handler_.assertion_failed, [this]() { setPause(true); });
 
+    if (settings_.get<bool>("profile_startup", false)) {
+        startup_timer_ = std::make_shared<Timer>("startup");
+        plugin_locator_->setStartupTimer(startup_timer_);
+    }
+    if (!settings_.get<std::string>("trace_file", "").empty()) {
+        Tracer::instance().start();
+    }
+    if (settings_.get<bool>("plugin_index", true)) {
+        PluginManifestIndex::instance().setFile(Settings::defaultConfigPath() + "cfg/plugin_index");
+    }
+
     StreamInterceptor::instance().start();
     MessageProviderManager::instance().setPluginLocator(plugin_locator_);
     MessageRendererManager::instance().setPluginLocator(plugin_locator_);
@@ -135,6 +163,12 @@ CsApexCore::~CsApexCore()
         thread_pool_->clear();
 
         MessageRendererManager::instance().shutdown();
+
+        std::string trace_file = settings_.get<std::string>("trace_file", "");
+        if (!trace_file.empty()) {
+            Tracer::instance().stop();
+            Tracer::instance().writeChromeTrace(trace_file);
+        }
     }
 
     for (std::map<std::string, CorePlugin::Ptr>::iterator it = core_plugins_.begin(); it != core_plugins_.end(); ++it) {
@@ -212,6 +246,7 @@ void CsApexCore::init()
 
         if (is_root_) {
             status_changed("loading core plugins");
+            auto phase = profileStartup("core plugins");
             core_plugin_manager->load(plugin_locator_.get());
 
             for (const auto& cp : core_plugin_manager->getConstructors()) {
@@ -232,6 +267,7 @@ void CsApexCore::init()
         observe(node_factory_->notification, notification);
 
         if (is_root_) {
+            auto phase = profileStartup("node plugins");
             node_factory_->loadPlugins();
         }
 
@@ -239,6 +275,7 @@ void CsApexCore::init()
         observe(node_factory_->node_constructed, [this](NodeFacadePtr n) { n->getNodeState()->setMaximumFrequency(settings_.getPersistent("default_frequency", 60)); });
 
         status_changed("make graph");
+        auto phase = profileStartup("make graph");
 
         root_facade_ = node_factory_->makeGraph(UUIDProvider::makeUUID_without_parent("~"), root_uuid_provider_);
         apex_assert_hard(root_facade_);
@@ -259,6 +296,7 @@ void CsApexCore::init()
             root_->getSubgraphNode()->createInternalSlot(makeEmpty<connection_types::AnyMessage>(), root_->getLocalGraph()->makeUUID("slot_exit"), "exit", [this](const TokenPtr&) { shutdown(); });
             root_->getSubgraphNode()->createInternalSlot(makeEmpty<connection_types::AnyMessage>(), root_->getLocalGraph()->makeUUID("slot_abort"), "abort", [this](const TokenPtr&) { abort(); });
         }
+        phase.reset();
 
         if (is_root_) {
             for (auto plugin : core_plugins_) {
@@ -267,6 +305,7 @@ void CsApexCore::init()
 
             if (snippet_factory_) {
                 status_changed("loading snippets");
+                auto snippet_phase = profileStartup("snippets");
                 snippet_factory_->loadSnippets();
                 observe(snippet_factory_->snippet_set_changed, new_snippet_type);
             }
@@ -297,6 +336,7 @@ void CsApexCore::boot()
     status_changed("booting up");
 
     if(settings_.get("use_boot_plugins", true)) {
+        auto phase = profileStartup("boot plugins");
         bool require_boot_plugin = settings_.get("require_boot_plugin", true);
         bootstrap_->bootFrom(csapex::info::CSAPEX_DEFAULT_BOOT_PLUGIN_DIR, plugin_locator_.get(), require_boot_plugin);
     }
@@ -307,6 +347,7 @@ void CsApexCore::boot()
 void CsApexCore::startup()
 {
     status_changed("loading config");
+    auto phase = profileStartup("load config");
     try {
         std::string cfg = settings_.getTemporary<std::string>("config", Settings::defaultConfigFile());
 
@@ -322,10 +363,59 @@ void CsApexCore::startup()
     } catch (const std::exception& e) {
         std::cerr << "error loading the config: " << e.what() << std::endl;
     }
+    phase.reset();
+
+    reportStartupProfile();
 
     status_changed("painting user interface");
 }
 
+std::unique_ptr<Trace> CsApexCore::profileStartup(const std::string& phase)
+{
+    if (startup_timer_) {
+        return startup_timer_->step(phase);
+    }
+    return nullptr;
+}
+
+namespace
+{
+void printPhases(const Interval& interval, int depth)
+{
+    std::vector<Interval::Ptr> phases;
+    for (const auto& pair : interval.sub) {
+        phases.push_back(pair.second);
+    }
+    std::sort(phases.begin(), phases.end(), [](const Interval::Ptr& a, const Interval::Ptr& b) { return a->getStartMicro() < b->getStartMicro(); });
+
+    for (const Interval::Ptr& phase : phases) {
+        std::cout << std::string(2 * depth, ' ') << std::left << std::setw(40 - 2 * depth) << phase->name() << std::right << std::setw(10) << std::fixed << std::setprecision(1) << phase->lengthMs()
+                  << " ms" << std::endl;
+        printPhases(*phase, depth + 1);
+    }
+}
+}  // namespace
+
+void CsApexCore::reportStartupProfile()
+{
+    if (!startup_timer_) {
+        return;
+    }
+
+    startup_timer_->finish();
+
+    Interval::Ptr root = startup_timer_->getRoot();
+    std::cout << "startup profile:" << std::endl;
+    printPhases(*root, 1);
+    std::cout << "  " << std::left << std::setw(38) << "total" << std::right << std::setw(10) << std::fixed << std::setprecision(1) << root->lengthMs() << " ms" << std::endl;
+
+    const PluginManifestIndex& index = PluginManifestIndex::instance();
+    std::cout << "  plugin manifests: " << index.countHits() << " from the index, " << index.countMisses() << " parsed" << std::endl;
+
+    plugin_locator_->setStartupTimer(nullptr);
+    startup_timer_.reset();
+}
+
 void CsApexCore::startMainLoop()
 {
     main_thread_ = std::thread([this]() {
@@ -507,15 +597,19 @@ void CsApexCore::saveAs(const std::string& file, bool quiet)
     graphio.saveSettings(node_map);
     graphio.saveGraphTo(node_map);
 
-    YAML::Emitter yaml;
+    if (BinaryConfig::isBinaryConfig(file)) {
+        auto interlude = timer->step("write binary");
+        BinaryConfig::save(file, node_map);
 
-    {
-        auto interlude = timer->step("emit yaml");
-        yaml << node_map;
-    }
+    } else {
+        YAML::Emitter yaml;
+
+        {
+            auto interlude = timer->step("emit yaml");
+            yaml << node_map;
+        }
 
-    //    std::cerr << yaml.c_str() << std::endl;
-    {
+        //    std::cerr << yaml.c_str() << std::endl;
         auto interlude = timer->step("write yaml");
         std::ofstream ofs(file.c_str());
         ofs << "#!" << settings_.get<std::string>("path_to_bin") << '\n';
@@ -560,9 +654,10 @@ void CsApexCore::load(const std::string& file)
     slim_signal::ScopedConnection connection = graphio.loadViewRequest.connect(load_detail_request);
 
     graphio.useProfiler(profiler_);
+    graphio.setLoadingThreads(std::max(0, settings_.get<int>("loading_threads", 1)));
 
     if (bf3::exists(file)) {
-        YAML::Node node_map = YAML::LoadFile(file.c_str());
+        YAML::Node node_map = BinaryConfig::isBinaryConfig(file) ? BinaryConfig::load(file) : YAML::LoadFile(file.c_str());
 
         // first load settings
         settings_.loadTemporary(node_map);
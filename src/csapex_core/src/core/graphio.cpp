@@ -15,6 +15,7 @@
 #include <csapex/model/generic_state.h>
 #include <csapex/msg/input.h>
 #include <csapex/msg/output.h>
+#include <csapex/msg/message_pool.h>
 #include <csapex/signal/event.h>
 #include <csapex/signal/slot.h>
 #include <csapex/model/fulcrum.h>
@@ -31,9 +32,12 @@
 
 /// SYSTEM
 #include <boost/filesystem.hpp>
+#include <atomic>
 #include <iostream>
 #include <fstream>
+#include <functional>
 #include <sys/types.h>
+#include <thread>
 
 using namespace csapex;
 
@@ -45,7 +49,13 @@ using namespace csapex;
     }
 
 GraphIO::GraphIO(GraphFacadeImplementation& graph, NodeFactoryImplementation* node_factory, bool throw_on_error)
-  : graph_(graph), node_factory_(node_factory), position_offset_x_(0.0), position_offset_y_(0.0), ignore_forwarding_connections_(false), throw_on_error_(throw_on_error)
+  : graph_(graph)
+  , node_factory_(node_factory)
+  , position_offset_x_(0.0)
+  , position_offset_y_(0.0)
+  , ignore_forwarding_connections_(false)
+  , throw_on_error_(throw_on_error)
+  , loading_threads_(1)
 {
 }
 
@@ -54,9 +64,19 @@ void GraphIO::setIgnoreForwardingConnections(bool ignore)
     ignore_forwarding_connections_ = ignore;
 }
 
+void GraphIO::setLoadingThreads(std::size_t threads)
+{
+    loading_threads_ = threads > 0 ? threads : std::thread::hardware_concurrency();
+}
+
 void GraphIO::saveSettings(YAML::Node& doc)
 {
     doc["uuid_map"] = graph_.getLocalGraph()->getUUIDMap();
+
+    std::map<std::string, std::size_t> reservations = MessagePool::instance().getReservations();
+    if (!reservations.empty()) {
+        doc["message_pool"] = reservations;
+    }
 }
 
 void GraphIO::loadSettings(const YAML::Node& doc)
@@ -64,6 +84,13 @@ void GraphIO::loadSettings(const YAML::Node& doc)
     if (doc["uuid_map"].IsDefined()) {
         graph_.getLocalGraph()->uuids_ = doc["uuid_map"].as<std::map<std::string, int>>();
     }
+
+    if (doc["message_pool"].IsDefined()) {
+        // message type -> number of preallocated messages
+        for (const auto& pair : doc["message_pool"].as<std::map<std::string, std::size_t>>()) {
+            MessagePool::instance().reserve(pair.first, pair.second);
+        }
+    }
 }
 
 Snippet GraphIO::saveGraph()
@@ -242,12 +269,108 @@ void GraphIO::loadNodes(const YAML::Node& doc, SemanticVersion version)
     TimerPtr timer = getProfiler()->getTimer("load graph");
 
     YAML::Node nodes = doc["nodes"];
-    if (nodes.IsDefined()) {
-        for (std::size_t i = 0, total = nodes.size(); i < total; ++i) {
-            const YAML::Node& n = nodes[i];
+    if (!nodes.IsDefined()) {
+        return;
+    }
+
+    struct PendingNode
+    {
+        UUID uuid;
+        std::string type;
+        YAML::Node doc;
+        NodeFacadeImplementationPtr facade;
+        std::string error;
+    };
+
+    // yaml-cpp nodes cannot be shared between threads, every node gets its own copy
+    std::vector<PendingNode> pending(nodes.size());
+    for (std::size_t i = 0, total = nodes.size(); i < total; ++i) {
+        const YAML::Node& n = nodes[i];
+        PendingNode& node = pending[i];
+        node.uuid = readNodeUUID(graph_.getLocalGraph()->shared_from_this(), n["uuid"]);
+        node.type = n["type"].as<std::string>();
+        node.doc = YAML::Clone(n);
+    }
+
+    // make sure that the factory is fully initialized before it is used concurrently
+    node_factory_->getConstructors();
+
+    std::size_t workers = std::min(loading_threads_, pending.size());
+    auto for_each_pending = [&](const std::function<void(PendingNode&)>& fn) {
+        if (workers <= 1) {
+            for (PendingNode& node : pending) {
+                fn(node);
+            }
 
-            auto interlude = timer->step(n["uuid"].as<std::string>());
-            loadNode(n, version);
+        } else {
+            std::atomic<std::size_t> next(0);
+            std::vector<std::thread> threads;
+            for (std::size_t w = 0; w < workers; ++w) {
+                threads.emplace_back([&]() {
+                    for (std::size_t i = next++; i < pending.size(); i = next++) {
+                        fn(pending[i]);
+                    }
+                });
+            }
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+        }
+    };
+    auto fail = [](PendingNode& node, const std::string& error) {
+        node.error = error;
+        node.facade.reset();
+    };
+
+    {
+        // constructing nodes and reading their state only touches the node itself
+        auto interlude = timer->step("construct nodes");
+        for_each_pending([&](PendingNode& node) {
+            try {
+                node.facade = node_factory_->makeNode(node.type, node.uuid, graph_.getLocalGraph(), nullptr, true);
+            } catch (const std::exception& e) {
+                fail(node, type2name(typeid(e)) + ", what=" + e.what());
+            } catch (const Failure& e) {
+                fail(node, std::string("failure, what=") + e.what());
+            }
+        });
+
+        // observers of the factory are not thread safe, they see the nodes on this thread before their state is read
+        for (PendingNode& node : pending) {
+            if (node.facade) {
+                node_factory_->node_constructed(node.facade);
+            }
+        }
+
+        for_each_pending([&](PendingNode& node) {
+            if (!node.facade) {
+                return;
+            }
+            try {
+                deserializeNodeState(node.doc, node.facade, version);
+            } catch (const std::exception& e) {
+                fail(node, type2name(typeid(e)) + ", what=" + e.what());
+            } catch (const Failure& e) {
+                fail(node, std::string("failure, what=") + e.what());
+            }
+        });
+    }
+
+    {
+        // wiring the nodes into the graph happens in file order on this thread
+        auto interlude = timer->step("insert nodes");
+        for (PendingNode& node : pending) {
+            if (!node.error.empty()) {
+                sendNotificationStreamGraphio("cannot load state for box " << node.uuid << ": " << node.error);
+            }
+            if (node.facade) {
+                try {
+                    insertNode(node.doc, node.facade, version);
+
+                } catch (const std::exception& e) {
+                    sendNotificationStreamGraphio("cannot load state for box " << node.uuid << ": " << type2name(typeid(e)) << ", what=" << e.what());
+                }
+            }
         }
     }
 }
@@ -294,25 +417,6 @@ UUID GraphIO::readConnectorUUID(std::weak_ptr<UUIDProvider> parent, const YAML::
     return uuid;
 }
 
-void GraphIO::loadNode(const YAML::Node& doc, SemanticVersion version)
-{
-    UUID uuid = readNodeUUID(graph_.getLocalGraph()->shared_from_this(), doc["uuid"]);
-
-    std::string type = doc["type"].as<std::string>();
-
-    NodeFacadeImplementationPtr node_facade = node_factory_->makeNode(type, uuid, graph_.getLocalGraph());
-    if (!node_facade) {
-        return;
-    }
-
-    try {
-        deserializeNode(doc, node_facade, version);
-
-    } catch (const std::exception& e) {
-        sendNotificationStreamGraphio("cannot load state for box " << uuid << ": " << type2name(typeid(e)) << ", what=" << e.what());
-    }
-}
-
 void GraphIO::saveConnections(YAML::Node& yaml)
 {
     auto interlude = getProfiler()->getTimer("save graph")->step("save connections");
@@ -321,7 +425,7 @@ void GraphIO::saveConnections(YAML::Node& yaml)
 
 void GraphIO::saveConnections(YAML::Node& yaml, const std::vector<ConnectionDescription>& connections)
 {
-    std::unordered_map<UUID, std::vector<std::pair<UUID, std::string>>, UUID::Hasher> connection_map;
+    std::unordered_map<UUID, std::vector<const ConnectionDescription*>, UUID::Hasher> connection_map;
 
     for (const ConnectionDescription& connection : connections) {
         if (ignore_forwarding_connections_) {
@@ -330,9 +434,7 @@ void GraphIO::saveConnections(YAML::Node& yaml, const std::vector<ConnectionDesc
             }
         }
 
-        std::string type = connection.active ? "active" : "default";
-
-        connection_map[connection.from].push_back(std::make_pair(connection.to, type));
+        connection_map[connection.from].push_back(&connection);
 
         if (!connection.fulcrums.empty()) {
             YAML::Node fulcrum;
@@ -345,9 +447,17 @@ void GraphIO::saveConnections(YAML::Node& yaml, const std::vector<ConnectionDesc
     for (const auto& pair : connection_map) {
         YAML::Node entry(YAML::NodeType::Map);
         entry["uuid"] = pair.first.getFullName();
-        for (const auto& info : pair.second) {
-            entry["targets"].push_back(info.first.getFullName());
-            entry["types"].push_back(info.second);
+
+        bool has_queues = false;
+        for (const ConnectionDescription* connection : pair.second) {
+            entry["targets"].push_back(connection->to.getFullName());
+            entry["types"].push_back(connection->active ? "active" : "default");
+            has_queues |= connection->queue_capacity != 1;
+        }
+        if (has_queues) {
+            for (const ConnectionDescription* connection : pair.second) {
+                entry["queue_capacities"].push_back(connection->queue_capacity);
+            }
         }
         yaml["connections"].push_back(entry);
     }
@@ -398,6 +508,9 @@ void GraphIO::loadConnection(const YAML::Node& connection, SemanticVersion versi
     const YAML::Node& types = connection["types"];
     apex_assert_hard(!types.IsDefined() || (types.Type() == YAML::NodeType::Sequence && targets.size() == types.size()));
 
+    const YAML::Node& queue_capacities = connection["queue_capacities"];
+    apex_assert_hard(!queue_capacities.IsDefined() || (queue_capacities.Type() == YAML::NodeType::Sequence && targets.size() == queue_capacities.size()));
+
     for (unsigned j = 0; j < targets.size(); ++j) {
         UUID to_uuid = readConnectorUUID(graph_.getLocalGraph()->shared_from_this(), targets[j]);
 
@@ -408,9 +521,11 @@ void GraphIO::loadConnection(const YAML::Node& connection, SemanticVersion versi
             connection_type = types[j].as<std::string>();
         }
 
+        int queue_capacity = queue_capacities.IsDefined() ? queue_capacities[j].as<int>() : 1;
+
         ConnectorPtr from = graph_.findConnectorNoThrow(from_uuid);
         if (from) {
-            loadConnection(from, to_uuid, connection_type, version);
+            loadConnection(from, to_uuid, connection_type, version, queue_capacity);
         } else {
             sendNotificationStreamGraphio("cannot load connection from '" << from_uuid << "' to '" << to_uuid << "', '" << from_uuid << "' doesn't exist.");
         }
@@ -503,7 +618,7 @@ void GraphIO::loadFulcrum(const YAML::Node& fulcrum, SemanticVersion version)
     }
 }
 
-void GraphIO::loadConnection(ConnectorPtr from, const UUID& to_uuid, const std::string& connection_type, SemanticVersion version)
+void GraphIO::loadConnection(ConnectorPtr from, const UUID& to_uuid, const std::string& connection_type, SemanticVersion version, int queue_capacity)
 {
     try {
         NodeHandle* target = graph_.getLocalGraph()->findNodeHandleForConnector(to_uuid);
@@ -522,6 +637,7 @@ void GraphIO::loadConnection(ConnectorPtr from, const UUID& to_uuid, const std::
             if (connection_type == "active") {
                 c->setActive(true);
             }
+            c->setQueueCapacity(queue_capacity);
             graph_.getLocalGraph()->addConnection(c);
         }
 
@@ -557,7 +673,7 @@ void GraphIO::serializeNode(YAML::Node& doc, NodeFacadeImplementationConstPtr no
     }
 }
 
-void GraphIO::deserializeNode(const YAML::Node& doc, NodeFacadeImplementationPtr node_facade, SemanticVersion version)
+void GraphIO::deserializeNodeState(const YAML::Node& doc, NodeFacadeImplementationPtr node_facade, SemanticVersion version)
 {
     NodeState::Ptr s = node_facade->getNodeState();
     s->readYaml(doc);
@@ -575,7 +691,10 @@ void GraphIO::deserializeNode(const YAML::Node& doc, NodeFacadeImplementationPtr
     apex_assert_hard(node);
 
     NodeSerializer::instance().deserialize(*node, doc);
+}
 
+void GraphIO::insertNode(const YAML::Node& doc, NodeFacadeImplementationPtr node_facade, SemanticVersion version)
+{
     graph_.getLocalGraph()->addNode(node_facade);
 
     node_facade->handleChangedParameters();
@@ -584,6 +703,7 @@ void GraphIO::deserializeNode(const YAML::Node& doc, NodeFacadeImplementationPtr
         GraphFacadeImplementationPtr subgraph = graph_.getLocalSubGraph(node_facade->getUUID());
         if (subgraph) {
             GraphIO sub_graph_io(*subgraph, node_factory_, throw_on_error_);
+            sub_graph_io.setLoadingThreads(loading_threads_);
             slim_signal::ScopedConnection connection = sub_graph_io.loadViewRequest.connect(loadViewRequest);
 
             sub_graph_io.loadGraph(doc["subgraph"]);
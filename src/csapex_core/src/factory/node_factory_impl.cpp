@@ -182,6 +182,8 @@ void NodeFactoryImplementation::ensureLoaded()
         if (!node_manager_->pluginsLoaded()) {
             node_manager_->load(plugin_locator_);
 
+            TimerPtr timer = plugin_locator_->getStartupTimer();
+            Trace::Ptr trace = timer ? timer->step("build prototypes") : nullptr;
             rebuildPrototypes();
 
             tag_map_has_to_be_rebuilt_ = true;
@@ -208,7 +210,7 @@ NodeFacadeImplementationPtr NodeFactoryImplementation::makeNode(const std::strin
     return makeNode(target_type, uuid, uuid_provider, nullptr);
 }
 
-NodeFacadeImplementationPtr NodeFactoryImplementation::makeNode(const std::string& target_type, const UUID& uuid, const UUIDProviderPtr& uuid_provider, NodeStatePtr state)
+NodeFacadeImplementationPtr NodeFactoryImplementation::makeNode(const std::string& target_type, const UUID& uuid, const UUIDProviderPtr& uuid_provider, NodeStatePtr state, bool suppress_signals)
 {
     NodeConstructorPtr p = getConstructor(target_type);
     if (p) {
@@ -224,7 +226,9 @@ NodeFacadeImplementationPtr NodeFactoryImplementation::makeNode(const std::strin
 
         NodeFacadeImplementationPtr result = std::make_shared<NodeFacadeImplementation>(nh);
 
-        node_constructed(result);
+        if (!suppress_signals) {
+            node_constructed(result);
+        }
 
         return result;
 
@@ -17,6 +17,7 @@
 #include <csapex/model/node_state.h>
 
 /// SYSTEM
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
@@ -28,7 +29,8 @@ Connection::Connection(OutputPtr from, InputPtr to) : Connection(from, to, next_
 {
 }
 
-Connection::Connection(OutputPtr from, InputPtr to, int id) : from_(from), to_(to), id_(id), active_(false), detached_(false), state_(State::NOT_INITIALIZED)
+Connection::Connection(OutputPtr from, InputPtr to, int id)
+  : from_(from), to_(to), id_(id), active_(false), detached_(false), state_(State::NOT_INITIALIZED), queue_capacity_(1), reserved_queue_capacity_(0), producer_waiting_(false)
 {
     from->enabled_changed.connect(source_enable_changed);
     to->enabled_changed.connect(sink_enabled_changed);
@@ -43,7 +45,7 @@ Connection::Connection(OutputPtr from, InputPtr to, int id) : from_(from), to_(t
 Connection::~Connection()
 {
     if (from_) {
-        if (state_ != Connection::State::DONE) {
+        if (producer_waiting_) {
             notifyMessageProcessed();
         }
     }
@@ -117,6 +119,86 @@ void Connection::reset()
     std::unique_lock<std::recursive_mutex> lock(sync);
     state_ = Connection::State::NOT_INITIALIZED;
     message_.reset();
+    queue_.clear();
+    producer_waiting_ = false;
+}
+
+void Connection::setQueueCapacity(std::size_t capacity)
+{
+    {
+        std::unique_lock<std::recursive_mutex> lock(sync);
+        queue_capacity_ = std::max<std::size_t>(1, capacity);
+    }
+    queueCapacityChanged();
+}
+
+std::size_t Connection::getQueueCapacity() const
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    return queue_capacity_;
+}
+
+void Connection::reserveQueueCapacity(std::size_t capacity)
+{
+    {
+        std::unique_lock<std::recursive_mutex> lock(sync);
+        reserved_queue_capacity_ = capacity;
+    }
+    queueCapacityChanged();
+}
+
+std::size_t Connection::getReservedQueueCapacity() const
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    return reserved_queue_capacity_;
+}
+
+std::size_t Connection::getEffectiveQueueCapacity() const
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    return std::max(queue_capacity_, reserved_queue_capacity_);
+}
+
+void Connection::queueCapacityChanged()
+{
+    bool notify_producer = false;
+    {
+        std::unique_lock<std::recursive_mutex> lock(sync);
+
+        // tokens beyond a reduced capacity are kept, the producer waits until they are processed
+        bool full = getQueuedTokenCount() >= getEffectiveQueueCapacity();
+        notify_producer = producer_waiting_ && !full;
+        producer_waiting_ = producer_waiting_ && full;
+    }
+
+    if (notify_producer) {
+        notifyMessageProcessed();
+    }
+}
+
+std::size_t Connection::getQueuedTokenCount() const
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    return (state_ == State::NOT_INITIALIZED ? 0 : 1) + queue_.size();
+}
+
+bool Connection::canAcceptToken() const
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    return !producer_waiting_;
+}
+
+std::vector<TokenPtr> Connection::getQueuedTokens() const
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    return std::vector<TokenPtr>(queue_.begin(), queue_.end());
+}
+
+void Connection::clearQueuedTokens()
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    // a waiting producer is released when the front token is processed
+    queue_.clear();
 }
 
 TokenPtr Connection::getToken() const
@@ -143,8 +225,29 @@ bool Connection::holdsActiveToken() const
     return message_ && message_->hasActivityModifier();
 }
 
+void Connection::countMutableAccess(bool copied)
+{
+    if (copied) {
+        ++copies_;
+    } else {
+        ++avoided_copies_;
+    }
+}
+
+std::size_t Connection::getAvoidedCopyCount() const
+{
+    return avoided_copies_;
+}
+
+std::size_t Connection::getCopyCount() const
+{
+    return copies_;
+}
+
 void Connection::setTokenProcessed()
 {
+    bool notify_producer = false;
+    bool next_token_available = false;
     {
         std::unique_lock<std::recursive_mutex> lock(sync);
         if (getState() == State::DONE) {
@@ -152,32 +255,59 @@ void Connection::setTokenProcessed()
             return;
         }
         setState(State::DONE);
+
+        if (!queue_.empty()) {
+            // move the next buffered token to the front
+            message_ = queue_.front();
+            queue_.pop_front();
+            setState(State::UNREAD);
+            next_token_available = true;
+        }
+
+        // a slot has been freed
+        notify_producer = producer_waiting_;
+        producer_waiting_ = false;
     }
 
     // std::cerr << *this << " is done" << std::endl;
-    notifyMessageProcessed();
+    if (notify_producer) {
+        notifyMessageProcessed();
+    }
+    if (next_token_available) {
+        notifyMessageSet();
+    }
 }
 
 void Connection::setToken(const TokenPtr& token, const bool silent)
 {
+    bool is_front = false;
     {
-        TokenPtr msg = token->cloneAs<Token>();
+        // every connection gets its own token, the data is only shared between consumers if the producer does not modify it anymore
+        TokenPtr msg = from_->isSharingMessages() ? token->share() : token->cloneAs<Token>()->share();
 
         std::unique_lock<std::recursive_mutex> lock(sync);
         apex_assert_hard(msg != nullptr);
-        apex_assert_hard(state_ == State::NOT_INITIALIZED);
+        apex_assert_hard(!producer_waiting_);
 
         if (!isActive() && msg->hasActivityModifier()) {
             // remove active flag if the connection is inactive
             msg->setActivityModifier(ActivityModifier::NONE);
         }
 
-        message_ = msg;
         ++seq_;
-        setState(State::UNREAD);
+        if (state_ == State::NOT_INITIALIZED) {
+            message_ = msg;
+            setState(State::UNREAD);
+            is_front = true;
+        } else {
+            queue_.push_back(msg);
+        }
+
+        // the producer is notified once the consumer frees a slot
+        producer_waiting_ = getQueuedTokenCount() >= getEffectiveQueueCapacity();
     }
 
-    if(!silent) {
+    if (!silent && is_front) {
         notifyMessageSet();
     }
 }
@@ -312,7 +442,9 @@ int Connection::id() const
 ConnectionDescription Connection::getDescription() const
 {
     TokenDataConstPtr type = message_ ? message_->getTokenData() : makeEmpty<connection_types::AnyMessage>();
-    return ConnectionDescription(from_->getUUID(), to_->getUUID(), type, id_, seq_, isActive(), getFulcrumsCopy());
+    ConnectionDescription description(from_->getUUID(), to_->getUUID(), type, id_, seq_, isActive(), getFulcrumsCopy());
+    description.queue_capacity = getQueueCapacity();
+    return description;
 }
 
 bool Connection::contains(Connector* c) const
@@ -10,16 +10,16 @@
 using namespace csapex;
 
 ConnectionDescription::ConnectionDescription(const UUID& from, const UUID& to, const TokenDataConstPtr& type, int id, int seq, bool active, const std::vector<Fulcrum>& fulcrums)
-  : from(from), to(to), from_label(""), to_label(""), type(type), id(id), seq(seq), active(active), fulcrums(fulcrums)
+  : from(from), to(to), from_label(""), to_label(""), type(type), id(id), seq(seq), active(active), fulcrums(fulcrums), queue_capacity(1)
 {
 }
 
 ConnectionDescription::ConnectionDescription(const ConnectionDescription& other)
-  : from(other.from), to(other.to), from_label(other.from_label), to_label(other.to_label), type(other.type), id(other.id), seq(other.seq), active(other.active), fulcrums(other.fulcrums)
+  : from(other.from), to(other.to), from_label(other.from_label), to_label(other.to_label), type(other.type), id(other.id), seq(other.seq), active(other.active), fulcrums(other.fulcrums), queue_capacity(other.queue_capacity)
 {
 }
 
-ConnectionDescription::ConnectionDescription()
+ConnectionDescription::ConnectionDescription() : queue_capacity(1)
 {
 }
 
@@ -34,6 +34,7 @@ ConnectionDescription& ConnectionDescription::operator=(const ConnectionDescript
     active = other.active;
     fulcrums = other.fulcrums;
     seq = other.seq;
+    queue_capacity = other.queue_capacity;
 
     return *this;
 }
@@ -43,6 +44,12 @@ bool ConnectionDescription::operator==(const ConnectionDescription& other) const
     return from == other.from && to_label == other.to_label;
 }
 
+SemanticVersion ConnectionDescription::getVersion() const
+{
+    // 0.1.0: queue_capacity
+    return SemanticVersion(0, 1, 0);
+}
+
 void ConnectionDescription::serialize(SerializationBuffer& data, SemanticVersion& version) const
 {
     data << from;
@@ -54,6 +61,7 @@ void ConnectionDescription::serialize(SerializationBuffer& data, SemanticVersion
     data << active;
     data << fulcrums;
     data << seq;
+    data << queue_capacity;
 }
 void ConnectionDescription::deserialize(const SerializationBuffer& data, const SemanticVersion& version)
 {
@@ -66,4 +74,7 @@ void ConnectionDescription::deserialize(const SerializationBuffer& data, const S
     data >> active;
     data >> fulcrums;
     data >> seq;
+    if (version >= SemanticVersion(0, 1, 0)) {
+        data >> queue_capacity;
+    }
 }
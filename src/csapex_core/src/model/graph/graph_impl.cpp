@@ -13,6 +13,7 @@
 #include <csapex/model/node.h>
 #include <csapex/model/node_facade_impl.h>
 #include <csapex/model/node_handle.h>
+#include <csapex/model/node_runner.h>
 #include <csapex/model/node_worker.h>
 #include <csapex/model/node_state.h>
 #include <csapex/model/graph/vertex.h>
@@ -21,6 +22,9 @@
 #include <csapex/model/graph_facade_impl.h>
 #include <csapex/model/subgraph_node.h>
 
+/// SYSTEM
+#include <algorithm>
+
 using namespace csapex;
 
 GraphImplementation::GraphImplementation() : in_transaction_(false), nf_(nullptr)
@@ -87,6 +91,7 @@ void GraphImplementation::addNode(NodeFacadeImplementationPtr nf)
     apex_assert_hard_msg(nf, "NodeFacade added is not null");
     graph::VertexPtr vertex = std::make_shared<graph::Vertex>(nf);
     vertices_.push_back(vertex);
+    vertex_index_[nf->getUUID()] = vertex;
 
     nf->getNodeHandle()->setVertex(vertex);
 
@@ -119,22 +124,12 @@ void GraphImplementation::deleteNode(const UUID& uuid)
     NodeHandle* node_handle = findNodeHandle(uuid);
     node_handle->stop();
 
-    graph::VertexPtr removed;
-
-    for (auto it = vertices_.begin(); it != vertices_.end();) {
-        NodeFacadePtr node = (*it)->getNodeFacade();
-        if (node->getUUID() == uuid) {
-            removed = *it;
-            vertices_.erase(it);
+    graph::VertexPtr removed = findVertexNoThrow(uuid);
+    apex_assert_hard(removed);
 
-            break;
+    vertex_index_.erase(uuid);
+    vertices_.erase(std::find(vertices_.begin(), vertices_.end(), removed));
 
-        } else {
-            ++it;
-        }
-    }
-
-    apex_assert_hard(removed);
     apex_assert_hard(removed == node_handle->getVertex());
 
     sources_.erase(removed);
@@ -321,6 +316,8 @@ void GraphImplementation::analyzeGraph()
     buildConnectedComponents();
 
     calculateDepths();
+    calculateCriticalPaths();
+    calculateFusedChains();
 
     state_changed();
 }
@@ -592,6 +589,196 @@ void GraphImplementation::calculateDepths()
     }
 }
 
+namespace
+{
+std::set<graph::Vertex*> getDistinct(const std::vector<graph::VertexPtr>& vertices)
+{
+    std::set<graph::Vertex*> res;
+    for (const graph::VertexPtr& vertex : vertices) {
+        if (vertex) {
+            res.insert(vertex.get());
+        }
+    }
+    return res;
+}
+
+NodeRunnerPtr getNodeRunner(const graph::Vertex* vertex)
+{
+    if (NodeFacadeImplementationPtr nf = std::dynamic_pointer_cast<NodeFacadeImplementation>(vertex->getNodeFacade())) {
+        return nf->getNodeRunner();
+    }
+    return nullptr;
+}
+
+bool isFusable(const graph::Vertex* vertex)
+{
+    NodeFacadeImplementationPtr nf = std::dynamic_pointer_cast<NodeFacadeImplementation>(vertex->getNodeFacade());
+    // sub graphs forward their messages internally, they are never executed as a single step
+    return nf && nf->getNodeRunner() && !nf->getNodeHandle()->isGraph();
+}
+
+graph::Vertex* getFusableChild(graph::Vertex* vertex)
+{
+    std::set<graph::Vertex*> children = getDistinct(vertex->getChildren());
+    if (children.size() != 1) {
+        return nullptr;
+    }
+    graph::Vertex* child = *children.begin();
+    if (child == vertex || getDistinct(child->getParents()).size() != 1) {
+        return nullptr;
+    }
+    if (!isFusable(vertex) || !isFusable(child)) {
+        return nullptr;
+    }
+    return child;
+}
+}  // namespace
+
+void GraphImplementation::calculateCriticalPaths()
+{
+    // process the vertices in reverse topological order, starting at the sinks:
+    // a vertex is visited once all of its children are done
+    std::map<graph::Vertex*, std::size_t> pending_children;
+    std::deque<graph::Vertex*> Q;
+    for (const graph::VertexPtr& vertex : vertices_) {
+        NodeCharacteristics& characteristics = vertex->getNodeCharacteristics();
+        characteristics.critical_path_length = 0;
+        characteristics.is_unblocking_joining_vertex = false;
+
+        std::size_t children = vertex->getChildren().size();
+        pending_children[vertex.get()] = children;
+        if (children == 0) {
+            Q.push_back(vertex.get());
+        }
+    }
+
+    while (!Q.empty()) {
+        graph::Vertex* top = Q.front();
+        Q.pop_front();
+
+        NodeCharacteristics& characteristics = top->getNodeCharacteristics();
+        int longest_child_path = 0;
+        for (const graph::VertexPtr& child : top->getChildren()) {
+            if (child) {
+                const NodeCharacteristics& child_characteristics = child->getNodeCharacteristics();
+                longest_child_path = std::max(longest_child_path, child_characteristics.critical_path_length);
+                characteristics.is_unblocking_joining_vertex |= child_characteristics.is_joining_vertex;
+            }
+        }
+        characteristics.critical_path_length = longest_child_path + 1;
+
+        for (const graph::VertexPtr& parent : top->getParents()) {
+            auto pos = parent ? pending_children.find(parent.get()) : pending_children.end();
+            if (pos != pending_children.end() && --pos->second == 0) {
+                Q.push_back(parent.get());
+            }
+        }
+    }
+
+    // the node runners rank their tasks by a copy, the characteristics are not read while scheduling
+    for (const graph::VertexPtr& vertex : vertices_) {
+        if (NodeRunnerPtr runner = getNodeRunner(vertex.get())) {
+            const NodeCharacteristics& characteristics = vertex->getNodeCharacteristics();
+            runner->setCriticalPath(characteristics.critical_path_length, characteristics.is_unblocking_joining_vertex);
+        }
+    }
+}
+
+void GraphImplementation::calculateFusedChains()
+{
+    fused_chains_.clear();
+
+    std::map<graph::Vertex*, graph::Vertex*> fused_child;
+    std::set<graph::Vertex*> has_fused_parent;
+    for (const graph::VertexPtr& vertex : vertices_) {
+        NodeCharacteristics& characteristics = vertex->getNodeCharacteristics();
+        characteristics.fused_chain = -1;
+        characteristics.is_fused_with_child = false;
+
+        graph::Vertex* child = getFusableChild(vertex.get());
+        if (child) {
+            fused_child[vertex.get()] = child;
+            has_fused_parent.insert(child);
+        }
+    }
+
+    for (const graph::VertexPtr& vertex : vertices_) {
+        if (NodeRunnerPtr runner = getNodeRunner(vertex.get())) {
+            runner->setFusedSuccessor(nullptr);
+        }
+    }
+
+    // every chain is walked from its head, a cycle of single parent nodes has no head and is never fused
+    for (const graph::VertexPtr& vertex : vertices_) {
+        if (has_fused_parent.find(vertex.get()) != has_fused_parent.end() || fused_child.find(vertex.get()) == fused_child.end()) {
+            continue;
+        }
+
+        int chain = fused_chains_.size();
+        std::vector<UUID> nodes;
+        for (graph::Vertex* current = vertex.get(); current;) {
+            auto next = fused_child.find(current);
+            NodeCharacteristics& characteristics = current->getNodeCharacteristics();
+            characteristics.fused_chain = chain;
+            characteristics.is_fused_with_child = next != fused_child.end();
+            nodes.push_back(current->getUUID());
+
+            graph::Vertex* child = next != fused_child.end() ? next->second : nullptr;
+            if (child) {
+                if (NodeRunnerPtr runner = getNodeRunner(current)) {
+                    runner->setFusedSuccessor(getNodeRunner(child));
+                }
+            }
+            current = child;
+        }
+        fused_chains_.push_back(nodes);
+    }
+}
+
+std::vector<std::vector<UUID>> GraphImplementation::getFusedChains() const
+{
+    return fused_chains_;
+}
+
+std::vector<FusedChainReport> GraphImplementation::getFusedChainReports() const
+{
+    std::vector<FusedChainReport> reports;
+    for (const std::vector<UUID>& chain : fused_chains_) {
+        FusedChainReport report;
+        report.nodes = chain;
+        report.fused_executions = 0;
+        report.execution_time = 0.0;
+        report.handover_latency = 0.0;
+
+        int latency_samples = 0;
+        for (const UUID& uuid : chain) {
+            graph::VertexPtr vertex = findVertexNoThrow(uuid);
+            NodeRunnerPtr runner = vertex ? getNodeRunner(vertex.get()) : nullptr;
+            if (!runner) {
+                continue;
+            }
+            report.fused_executions += runner->getFusedExecutionCount();
+            report.execution_time += runner->getMeanExecutionTime();
+
+            double latency = runner->getMeanSchedulingLatency();
+            if (latency > 0.0) {
+                report.handover_latency += latency;
+                ++latency_samples;
+            }
+        }
+        if (latency_samples > 0) {
+            report.handover_latency /= latency_samples;
+        }
+
+        // without fusion, every node but the head pays the latency of a round trip through the scheduler
+        double handovers = (chain.size() - 1) * report.handover_latency;
+        report.modeled_speedup = report.execution_time > 0.0 ? (report.execution_time + handovers) / report.execution_time : 1.0;
+
+        reports.push_back(report);
+    }
+    return reports;
+}
+
 void GraphImplementation::checkNodeState(NodeHandle* nh)
 {
     // check if the node should be enabled
@@ -700,20 +887,24 @@ NodeHandle* GraphImplementation::findNodeHandleNoThrow(const UUID& uuid) const n
             return local_graph->findNodeHandleNoThrow(uuid.nestedUUID());
         }
 
-    } else {
-        for (const auto& vertex : vertices_) {
-            NodeFacadePtr facade = vertex->getNodeFacade();
-            if (facade->getUUID() == uuid) {
-                NodeFacadeImplementationPtr local_facade = std::dynamic_pointer_cast<NodeFacadeImplementation>(facade);
-                apex_assert_hard(local_facade);
-                return local_facade->getNodeHandle().get();
-            }
-        }
+    } else if (graph::VertexPtr vertex = findVertexNoThrow(uuid)) {
+        NodeFacadeImplementationPtr local_facade = std::dynamic_pointer_cast<NodeFacadeImplementation>(vertex->getNodeFacade());
+        apex_assert_hard(local_facade);
+        return local_facade->getNodeHandle().get();
     }
 
     return nullptr;
 }
 
+graph::VertexPtr GraphImplementation::findVertexNoThrow(const UUID& uuid) const noexcept
+{
+    auto pos = vertex_index_.find(uuid);
+    if (pos != vertex_index_.end()) {
+        return pos->second;
+    }
+    return nullptr;
+}
+
 NodeHandle* GraphImplementation::findNodeHandleForConnectorNoThrow(const UUID& uuid) const noexcept
 {
     return findNodeHandleNoThrow(uuid.parentUUID());
@@ -775,13 +966,8 @@ NodeFacadePtr GraphImplementation::findNodeFacadeNoThrow(const UUID& uuid) const
             return graph->findNodeFacadeNoThrow(uuid.nestedUUID());
         }
 
-    } else {
-        for (const auto& vertex : vertices_) {
-            NodeFacadePtr nf = vertex->getNodeFacade();
-            if (nf->getUUID() == uuid) {
-                return nf;
-            }
-        }
+    } else if (graph::VertexPtr vertex = findVertexNoThrow(uuid)) {
+        return vertex->getNodeFacade();
     }
 
     return nullptr;
@@ -13,10 +13,19 @@ NodeCharacteristics::NodeCharacteristics()
   , is_joining_vertex_counterpart(false)
   , is_combined_by_joining_vertex(false)
   , is_leading_to_joining_vertex(false)
-  ,
+  , is_leading_to_essential_vertex(false)
+  , critical_path_length(0)
+  , is_unblocking_joining_vertex(false)
+  , fused_chain(-1)
+  , is_fused_with_child(false)
+{
+}
 
-  is_leading_to_essential_vertex(false)
+SemanticVersion NodeCharacteristics::getVersion() const
 {
+    // 0.1.0: critical_path_length, is_unblocking_joining_vertex
+    // 0.2.0: fused_chain, is_fused_with_child
+    return SemanticVersion(0, 2, 0);
 }
 
 void NodeCharacteristics::serialize(SerializationBuffer& data, SemanticVersion& version) const
@@ -28,6 +37,10 @@ void NodeCharacteristics::serialize(SerializationBuffer& data, SemanticVersion&
     data << is_combined_by_joining_vertex;
     data << is_leading_to_joining_vertex;
     data << is_leading_to_essential_vertex;
+    data << critical_path_length;
+    data << is_unblocking_joining_vertex;
+    data << fused_chain;
+    data << is_fused_with_child;
 }
 void NodeCharacteristics::deserialize(const SerializationBuffer& data, const SemanticVersion& version)
 {
@@ -38,4 +51,12 @@ void NodeCharacteristics::deserialize(const SerializationBuffer& data, const Sem
     data >> is_combined_by_joining_vertex;
     data >> is_leading_to_joining_vertex;
     data >> is_leading_to_essential_vertex;
+    if (version >= SemanticVersion(0, 1, 0)) {
+        data >> critical_path_length;
+        data >> is_unblocking_joining_vertex;
+    }
+    if (version >= SemanticVersion(0, 2, 0)) {
+        data >> fused_chain;
+        data >> is_fused_with_child;
+    }
 }
@@ -135,14 +135,29 @@ NodeHandlePtr NodeConstructor::makePrototype() const
     return makeNodeHandle(tmp_uuid_provider_->makeUUID("prototype"), tmp_uuid_provider_);
 }
 
+namespace
+{
+NodeHandlePtr constructNodeHandle(const std::string& type, const NodePtr& node, const UUID& uuid, const UUIDProviderPtr& uuid_provider)
+{
+    OutputTransitionPtr ot = std::make_shared<OutputTransition>();
+    InputTransitionPtr it = std::make_shared<InputTransition>();
+    NodeHandlePtr node_handle = std::make_shared<NodeHandle>(type, uuid, node, uuid_provider, it, ot);
+    node->initialize(node_handle);
+    return node_handle;
+}
+}  // namespace
+
 NodeHandlePtr NodeConstructor::makeNodeHandle(const UUID& uuid, const UUIDProviderPtr& uuid_provider) const
 {
     try {
-        NodePtr node = makeNode();
-        OutputTransitionPtr ot = std::make_shared<OutputTransition>();
-        InputTransitionPtr it = std::make_shared<InputTransition>();
-        NodeHandlePtr node_handle = std::make_shared<NodeHandle>(type_, uuid, node, uuid_provider, it, ot);
-        node->initialize(node_handle);
+        NodeHandlePtr node_handle = constructNodeHandle(type_, makeNode(), uuid, uuid_provider);
+
+        // replicas are constructed the same way, the caller is responsible for setting them up
+        std::string type = type_;
+        std::function<NodePtr()> make_node = c;
+        node_handle->setReplicaFactory([type, make_node](const UUID& replica_uuid, const UUIDProviderPtr& replica_uuid_provider) {
+            return constructNodeHandle(type, make_node(), replica_uuid, replica_uuid_provider);
+        });
 
         if (!uuid.empty() && uuid_provider) {
             uuid_provider->registerUUID(uuid);
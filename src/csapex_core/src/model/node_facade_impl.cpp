@@ -9,6 +9,7 @@
 #include <csapex/model/node_handle.h>
 #include <csapex/model/node_state.h>
 #include <csapex/model/direct_node_worker.h>
+#include <csapex/model/replicated_node_worker.h>
 #include <csapex/model/subprocess_node_worker.h>
 #include <csapex/model/subgraph_node.h>
 #include <csapex/msg/input.h>
@@ -98,6 +99,9 @@ NodeWorkerPtr NodeFacadeImplementation::createNodeWorker()
         case ExecutionType::SUBPROCESS:
             nw = std::make_shared<SubprocessNodeWorker>(nh_);
             break;
+        case ExecutionType::REPLICATED:
+            nw = std::make_shared<ReplicatedNodeWorker>(nh_);
+            break;
     }
 
     return nw;
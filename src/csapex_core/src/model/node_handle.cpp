@@ -1091,6 +1091,19 @@ const Rate& NodeHandle::getRate() const
     return rate_;
 }
 
+NodeHandlePtr NodeHandle::makeReplica(const UUID& uuid, const UUIDProviderPtr& uuid_provider) const
+{
+    if (!replica_factory_ || isGraph()) {
+        return nullptr;
+    }
+    return replica_factory_(uuid, uuid_provider);
+}
+
+void NodeHandle::setReplicaFactory(std::function<NodeHandlePtr(const UUID&, const UUIDProviderPtr&)> factory)
+{
+    replica_factory_ = factory;
+}
+
 void NodeHandle::setNodeRunner(NodeRunnerWeakPtr runner)
 {
     node_runner_ = runner;
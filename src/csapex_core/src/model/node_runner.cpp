@@ -19,6 +19,24 @@
 
 using namespace csapex;
 
+namespace
+{
+// the lower bits of a critical path priority hold the execution time, the upper bits the position in the graph
+const int COST_BITS = 24;
+const long MAX_COST = (1l << COST_BITS) - 1;
+
+// weight of a new measurement in the moving average of the execution time
+const double EXECUTION_TIME_SMOOTHING = 0.2;
+
+// the successor of the node that is currently executed in this thread, if it is fused with it
+thread_local NodeRunner* fusion_target = nullptr;
+
+double smooth(double mean, double value)
+{
+    return mean == 0.0 ? value : mean + EXECUTION_TIME_SMOOTHING * (value - mean);
+}
+}  // namespace
+
 NodeRunner::NodeRunner(NodeWorkerPtr worker)
   : worker_(worker)
   , nh_(worker->getNodeHandle())
@@ -28,6 +46,14 @@ NodeRunner::NodeRunner(NodeWorkerPtr worker)
   , possible_steps_(0)
   , step_done_(false)
   , guard_(-1)
+  , execution_start_(0)
+  , measuring_execution_(false)
+  , mean_execution_time_(0.0)
+  , scheduled_at_(0)
+  , mean_scheduling_latency_(0.0)
+  , critical_path_position_(0)
+  , fused_execution_requested_(false)
+  , fused_executions_(0)
   , waiting_for_execution_(false)
   , waiting_for_step_(false)
   , suppress_exceptions_(true)
@@ -63,11 +89,39 @@ void NodeRunner::measureFrequency()
     }
 }
 
+void NodeRunner::measureExecutionTime()
+{
+    if (!measuring_execution_.exchange(false)) {
+        return;
+    }
+
+    // messages_processed is only signaled after the continuation of an asynchronous node
+    std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now().time_since_epoch() - std::chrono::steady_clock::duration(execution_start_);
+    double duration = std::chrono::duration<double, std::micro>(elapsed).count();
+    mean_execution_time_ = smooth(mean_execution_time_, duration);
+}
+
+long NodeRunner::getCriticalPathPriority() const
+{
+    // nodes with a longer path ahead are preferred, then nodes whose output completes a join,
+    // nodes in the same position are ordered by their measured cost, the most expensive first
+    long position = critical_path_position_.load(std::memory_order_relaxed);
+    long cost = std::min(MAX_COST, static_cast<long>(mean_execution_time_));
+    return (position << COST_BITS) | cost;
+}
+
+void NodeRunner::setCriticalPath(int critical_path_length, bool is_unblocking_joining_vertex)
+{
+    critical_path_position_ = 2 * static_cast<long>(std::max(0, critical_path_length)) + (is_unblocking_joining_vertex ? 1 : 0);
+}
+
 void NodeRunner::reset()
 {
     waiting_for_execution_ = false;
     waiting_for_step_ = false;
     remaining_tasks_.clear();
+    fused_execution_requested_ = false;
+    scheduled_at_ = 0;
 
     execute_->setScheduled(false);
     check_parameters_->setScheduled(false);
@@ -110,6 +164,7 @@ void NodeRunner::connectNodeWorker()
     });
 
     observe(worker_->messages_processed, [this]() {
+        measureExecutionTime();
         measureFrequency();
         step_done_ = true;
         // TRACE worker_->getNode()->ainfo << "end step" << std::endl;
@@ -173,10 +228,19 @@ void NodeRunner::scheduleProcess()
     if (!paused_) {
         bool source = nh_->isSource();
         if (!source || !stepping_ || possible_steps_) {
-            // execute_->setPriority(std::max<long>(0, worker_->getSequenceNumber()));
             // if(worker_->canExecute()) {
             if (!waiting_for_execution_) {
                 if(!execute_->isScheduled()) {
+                    std::unique_lock<std::recursive_mutex> lock(mutex_);
+                    bool critical_path = scheduler_ && scheduler_->getSchedulingPolicy() == SchedulingPolicy::CRITICAL_PATH;
+                    lock.unlock();
+                    if (fusion_target == this) {
+                        // the predecessor runs this node as soon as it is done
+                        fused_execution_requested_ = true;
+                        return;
+                    }
+                    execute_->setPriority(critical_path ? getCriticalPathPriority() : 0);
+                    scheduled_at_ = std::chrono::steady_clock::now().time_since_epoch().count();
                     schedule(execute_);
                 }
             }
@@ -196,6 +260,68 @@ void NodeRunner::notify()
 }
 
 void NodeRunner::execute()
+{
+    auto scheduled_at = scheduled_at_.exchange(0);
+    if (scheduled_at != 0) {
+        std::chrono::steady_clock::duration latency = std::chrono::steady_clock::now().time_since_epoch() - std::chrono::steady_clock::duration(scheduled_at);
+        mean_scheduling_latency_ = smooth(mean_scheduling_latency_, std::chrono::duration<double, std::micro>(latency).count());
+    }
+
+    // the nodes of a fused chain are executed one after another, without returning to the scheduler
+    NodeRunnerPtr next = executeFusable();
+    while (next) {
+        next = next->executeFusable();
+    }
+}
+
+NodeRunnerPtr NodeRunner::executeFusable()
+{
+    NodeRunnerPtr successor = getActiveFusedSuccessor();
+
+    NodeRunner* previous_target = fusion_target;
+    fusion_target = successor.get();
+    try {
+        executeNode();
+
+    } catch (...) {
+        fusion_target = previous_target;
+        if (NodeRunnerPtr requested = takeRequestedSuccessor(successor)) {
+            requested->scheduleProcess();
+        }
+        throw;
+    }
+    fusion_target = previous_target;
+
+    NodeRunnerPtr requested = takeRequestedSuccessor(successor);
+    if (requested) {
+        ++requested->fused_executions_;
+    }
+    return requested;
+}
+
+NodeRunnerPtr NodeRunner::getActiveFusedSuccessor() const
+{
+    std::unique_lock<std::recursive_mutex> lock(mutex_);
+    NodeRunnerPtr successor = fused_successor_.lock();
+    if (!successor || !scheduler_ || !scheduler_->isChainFusionEnabled()) {
+        return nullptr;
+    }
+    // throttled nodes have to wait for their own schedule
+    if (successor->getScheduler() != scheduler_ || successor->isPaused() || successor->max_frequency_ > 0.0) {
+        return nullptr;
+    }
+    return successor;
+}
+
+NodeRunnerPtr NodeRunner::takeRequestedSuccessor(const NodeRunnerPtr& successor)
+{
+    if (successor && successor->fused_execution_requested_.exchange(false)) {
+        return successor;
+    }
+    return nullptr;
+}
+
+void NodeRunner::executeNode()
 {
     if (stepping_ && possible_steps_ <= 0) {
         return;
@@ -209,7 +335,7 @@ void NodeRunner::execute()
             if (f > max_frequency_) {
                 auto next_process = rate.endOfCycle();
 
-                auto now = std::chrono::system_clock::now();
+                auto now = std::chrono::steady_clock::now();
 
                 if (next_process > now) {
                     scheduleDelayed(execute_, next_process);
@@ -231,7 +357,10 @@ void NodeRunner::execute()
 
         try {
             if (worker_->canExecute()) {
+                execution_start_ = std::chrono::steady_clock::now().time_since_epoch().count();
+                measuring_execution_ = true;
                 if (!worker_->startProcessingMessages()) {
+                    measuring_execution_ = false;
                     possible_steps_++;
                 }
             }
@@ -276,7 +405,7 @@ void NodeRunner::schedule(TaskPtr task)
     }
 }
 
-void NodeRunner::scheduleDelayed(TaskPtr task, std::chrono::system_clock::time_point time)
+void NodeRunner::scheduleDelayed(TaskPtr task, std::chrono::steady_clock::time_point time)
 {
     std::unique_lock<std::recursive_mutex> lock(mutex_);
     scheduler_->scheduleDelayed(task, time);
@@ -405,3 +534,30 @@ void NodeRunner::setNodeWorker(NodeWorkerPtr worker)
     worker_ = worker;
     connectNodeWorker();
 }
+
+void NodeRunner::setFusedSuccessor(NodeRunnerPtr successor)
+{
+    std::unique_lock<std::recursive_mutex> lock(mutex_);
+    fused_successor_ = successor;
+}
+
+NodeRunnerPtr NodeRunner::getFusedSuccessor() const
+{
+    std::unique_lock<std::recursive_mutex> lock(mutex_);
+    return fused_successor_.lock();
+}
+
+double NodeRunner::getMeanExecutionTime() const
+{
+    return mean_execution_time_;
+}
+
+double NodeRunner::getMeanSchedulingLatency() const
+{
+    return mean_scheduling_latency_;
+}
+
+std::size_t NodeRunner::getFusedExecutionCount() const
+{
+    return fused_executions_;
+}
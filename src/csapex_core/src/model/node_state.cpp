@@ -10,6 +10,7 @@
 
 /// SYSTEM
 #include <iostream>
+#include <algorithm>
 
 using namespace csapex;
 
@@ -31,6 +32,7 @@ NodeState::NodeState(const NodeHandle* parent)
   , b_(-1)
   , exec_mode_(ExecutionMode::SEQUENTIAL)
   , exec_type_(ExecutionType::AUTO)
+  , replicas_(1)
 {
     if (parent) {
         label_ = parent->getUUID().getFullName();
@@ -72,6 +74,7 @@ NodeState& NodeState::operator=(const NodeState& rhs)
     thread_id_ = rhs.thread_id_;
     exec_mode_ = rhs.exec_mode_;
     exec_type_ = rhs.exec_type_;
+    replicas_ = rhs.replicas_;
     logger_level_ = rhs.logger_level_;
 
     dictionary = rhs.dictionary;
@@ -92,6 +95,7 @@ NodeState& NodeState::operator=(const NodeState& rhs)
     (thread_changed)();
     (execution_mode_changed)();
     (execution_type_changed)();
+    (replica_count_changed)();
     (logger_level_changed)();
 
     return *this;
@@ -300,6 +304,20 @@ void NodeState::setExecutionType(ExecutionType type)
     }
 }
 
+int NodeState::getReplicaCount() const
+{
+    return replicas_;
+}
+void NodeState::setReplicaCount(int replicas)
+{
+    replicas = std::max(1, replicas);
+    if (replicas_ != replicas) {
+        replicas_ = replicas;
+
+        (replica_count_changed)();
+    }
+}
+
 int NodeState::getLoggerLevel() const
 {
     return logger_level_;
@@ -333,6 +351,7 @@ void NodeState::writeYaml(YAML::Node& out) const
     out["flipped"] = flipped_;
     out["exec_mode"] = (int)exec_mode_;
     out["exec_type"] = (int)exec_type_;
+    out["replicas"] = replicas_;
     out["logger_level"] = logger_level_;
 
     if (!dictionary.empty()) {
@@ -401,6 +420,9 @@ void NodeState::readYaml(const YAML::Node& node)
     if (node["exec_type"].IsDefined()) {
         setExecutionType(static_cast<ExecutionType>(node["exec_type"].as<int>()));
     }
+    if (node["replicas"].IsDefined()) {
+        setReplicaCount(node["replicas"].as<int>());
+    }
 
     if (node["label"].IsDefined()) {
         setLabel(node["label"].as<std::string>());
@@ -466,6 +488,12 @@ void NodeState::readYaml(const YAML::Node& node)
     }
 }
 
+SemanticVersion NodeState::getVersion() const
+{
+    // 0.1.0: replicas
+    return SemanticVersion(0, 1, 0);
+}
+
 void NodeState::serialize(SerializationBuffer& data, SemanticVersion& version) const
 {
     data << max_frequency_;
@@ -493,6 +521,7 @@ void NodeState::serialize(SerializationBuffer& data, SemanticVersion& version) c
 
     data << exec_mode_;
     data << exec_type_;
+    data << replicas_;
 
     YAML::Node yaml;
     parameter_state->writeYaml(yaml);
@@ -526,6 +555,9 @@ void NodeState::deserialize(const SerializationBuffer& data, const SemanticVersi
 
     data >> exec_mode_;
     data >> exec_type_;
+    if (version >= SemanticVersion(0, 1, 0)) {
+        data >> replicas_;
+    }
 
     YAML::Node yaml;
     data >> yaml;
@@ -581,6 +581,9 @@ bool NodeWorker::startProcessingMessages()
         handleChangedParameters();
     }
 
+    // parameter handles read the values that were current when the execution started
+    node->publishParameterSnapshot();
+
     {
         std::unique_lock<std::recursive_mutex> lock(sync);
         apex_assert_hard(isEnabled());
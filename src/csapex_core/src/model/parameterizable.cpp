@@ -7,12 +7,14 @@
 #include <csapex/param/parameter.h>
 
 /// SYSTEM
+#include <algorithm>
 #include <mutex>
 #include <iostream>
+#include <stdexcept>
 
 using namespace csapex;
 
-Parameterizable::Parameterizable() : parameter_state_(new GenericState), silent_(false)
+Parameterizable::Parameterizable() : parameter_snapshot_dirty_(false), published_parameter_snapshot_(std::make_shared<PublishedParameterSnapshot>()), parameter_state_(new GenericState), silent_(false)
 {
 }
 
@@ -353,6 +355,75 @@ void Parameterizable::doSetParameterLater(const std::string& name, const param::
     parameters_changed();
 }
 
+std::size_t Parameterizable::getSnapshotSlot(const std::string& name, const std::type_info& type, std::function<std::shared_ptr<const void>(const param::ParameterPtr&)> reader)
+{
+    param::ParameterPtr param = getParameter(name);
+
+    std::size_t slot;
+    {
+        std::unique_lock<std::recursive_mutex> lock(mutex_);
+        auto pos = std::find_if(snapshot_slots_.begin(), snapshot_slots_.end(), [&name](const SnapshotSlot& s) { return s.name == name; });
+        if (pos != snapshot_slots_.end()) {
+            if (pos->type != std::type_index(type)) {
+                throw std::logic_error(std::string("parameter ") + name + " already has a handle of type " + pos->type.name());
+            }
+            if (pos->param.lock() == param) {
+                return pos - snapshot_slots_.begin();
+            }
+            // the parameter has been replaced, the slot follows the new one
+            slot = pos - snapshot_slots_.begin();
+            pos->param = param;
+
+        } else {
+            slot = snapshot_slots_.size();
+            snapshot_slots_.push_back(SnapshotSlot{ name, std::type_index(type), param, reader, slim_signal::ScopedConnection() });
+        }
+
+        snapshot_slots_[slot].connection = param->parameter_changed.connect([this](param::Parameter*) { parameter_snapshot_dirty_ = true; });
+    }
+
+    // the handle has to be readable right away
+    parameter_snapshot_dirty_ = true;
+    publishParameterSnapshot();
+
+    return slot;
+}
+
+void Parameterizable::publishParameterSnapshot()
+{
+    if (!parameter_snapshot_dirty_.exchange(false)) {
+        return;
+    }
+
+    std::unique_lock<std::recursive_mutex> lock(mutex_);
+
+    std::shared_ptr<const ParameterSnapshot> current;
+    {
+        std::unique_lock<std::mutex> published_lock(published_parameter_snapshot_->mutex);
+        current = published_parameter_snapshot_->snapshot;
+    }
+
+    auto snapshot = std::make_shared<ParameterSnapshot>();
+    snapshot->values.reserve(snapshot_slots_.size());
+    for (std::size_t slot = 0; slot < snapshot_slots_.size(); ++slot) {
+        std::shared_ptr<const void> value;
+        if (param::ParameterPtr param = snapshot_slots_[slot].param.lock()) {
+            value = snapshot_slots_[slot].reader(param);
+        } else if (current && slot < current->values.size()) {
+            // the parameter has been removed, keep the last known value
+            value = current->values[slot];
+        }
+        snapshot->values.push_back(value);
+    }
+
+    // handles that still read an older snapshot keep it alive themselves
+    {
+        std::unique_lock<std::mutex> published_lock(published_parameter_snapshot_->mutex);
+        published_parameter_snapshot_->snapshot = snapshot;
+    }
+    published_parameter_snapshot_->generation.fetch_add(1, std::memory_order_release);
+}
+
 void Parameterizable::triggerParameterSetChanged()
 {
     std::unique_lock<std::recursive_mutex> lock(mutex_);
@@ -409,4 +480,5 @@ void Parameterizable::setParameterState(GenericStatePtr m)
 {
     std::unique_lock<std::recursive_mutex> lock(mutex_);
     parameter_state_->setFrom(*m);
+    parameter_snapshot_dirty_ = true;
 }
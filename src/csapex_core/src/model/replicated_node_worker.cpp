@@ -0,0 +1,407 @@
+/// HEADER
+#include <csapex/model/replicated_node_worker.h>
+
+/// COMPONENT
+#include <csapex/model/connection.h>
+#include <csapex/model/generic_state.h>
+#include <csapex/model/node.h>
+#include <csapex/model/node_handle.h>
+#include <csapex/model/node_state.h>
+#include <csapex/model/token.h>
+#include <csapex/msg/input.h>
+#include <csapex/msg/marker_message.h>
+#include <csapex/msg/no_message.h>
+#include <csapex/msg/output.h>
+#include <csapex/utility/assert.h>
+#include <csapex/utility/thread.h>
+#include <csapex/utility/uuid_provider.h>
+
+/// SYSTEM
+#include <algorithm>
+#include <limits>
+
+using namespace csapex;
+
+namespace
+{
+// parameter inputs are not replicated, their values are taken from the node's parameter state
+std::vector<InputPtr> getDataInputs(NodeHandle& node_handle)
+{
+    std::vector<InputPtr> inputs;
+    for (const InputPtr& input : node_handle.getExternalInputs()) {
+        if (!node_handle.isParameterInput(input->getUUID())) {
+            inputs.push_back(input);
+        }
+    }
+    return inputs;
+}
+
+std::vector<OutputPtr> getDataOutputs(NodeHandle& node_handle)
+{
+    std::vector<OutputPtr> outputs;
+    for (const OutputPtr& output : node_handle.getExternalOutputs()) {
+        if (!node_handle.isParameterOutput(output->getUUID())) {
+            outputs.push_back(output);
+        }
+    }
+    return outputs;
+}
+
+bool isSameToken(const TokenPtr& a, const TokenPtr& b)
+{
+    return a && b && a->getSequenceNumber() == b->getSequenceNumber() && a->getTokenData() == b->getTokenData();
+}
+}  // namespace
+
+ReplicatedNodeWorker::ReplicatedNodeWorker(NodeHandlePtr node_handle) : NodeWorker(node_handle), replica_uuid_provider_(std::make_shared<UUIDProvider>()), next_replica_id_(0), failed_replica_count_(0)
+{
+}
+
+ReplicatedNodeWorker::~ReplicatedNodeWorker()
+{
+    dropPrefetched();
+    releaseQueueCapacities();
+}
+
+ReplicatedNodeWorker::Replica::~Replica()
+{
+    {
+        std::unique_lock<std::mutex> lock(job_mutex);
+        stopping = true;
+        job_changed.notify_one();
+    }
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+std::size_t ReplicatedNodeWorker::getReplicaCount() const
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    return replicas_.size();
+}
+
+void ReplicatedNodeWorker::processNode()
+{
+    NodePtr node = node_handle_->getNode().lock();
+    apex_assert_hard(node);
+
+    std::size_t replicas = std::max(1, node_handle_->getNodeState()->getReplicaCount());
+    if (node->isAsynchronous() || replicas <= 1) {
+        failed_replica_count_ = 0;
+        dropPrefetched();
+        releaseQueueCapacities();
+        NodeWorker::processNode();
+        return;
+    }
+
+    // the node itself is the first replica
+    if (replicas_.size() != replicas - 1 && replicas != failed_replica_count_) {
+        dropPrefetched();
+        // after a failure, the available replicas are used instead of retrying on every execution
+        failed_replica_count_ = updateReplicas(replicas - 1) ? 0 : replicas;
+    }
+    reserveQueueCapacities(replicas_.size() + 1);
+
+    if (!prefetched_.empty() && isCurrentInput(prefetched_.front().inputs)) {
+        Prefetch current = std::move(prefetched_.front());
+        prefetched_.pop_front();
+
+        Result result = current.result.get();
+        current.replica->busy = false;
+
+        // the next tokens are still queued, keep the replicas busy before the current one is released
+        prefetch(node);
+
+        publish(result);
+        finishProcessing();
+
+    } else {
+        // nothing usable was prefetched, e.g. after a reset or a marker
+        dropPrefetched();
+        prefetch(node);
+
+        NodeWorker::processNode();
+    }
+}
+
+bool ReplicatedNodeWorker::updateReplicas(std::size_t count)
+{
+    while (replicas_.size() > count) {
+        apex_assert_hard(!replicas_.back()->busy);
+        replicas_.pop_back();
+    }
+
+    while (replicas_.size() < count) {
+        UUID uuid = replica_uuid_provider_->makeUUID("replica_" + std::to_string(next_replica_id_++));
+        NodeHandlePtr replica_handle = node_handle_->makeReplica(uuid, replica_uuid_provider_);
+        if (!replica_handle) {
+            return false;
+        }
+
+        NodePtr replica_node = replica_handle->getNode().lock();
+        apex_assert_hard(replica_node);
+
+        try {
+            replica_node->setupParameters(*replica_node);
+            replica_node->setup(*replica_handle);
+
+        } catch (const std::exception& e) {
+            replica_node->aerr << "replica setup failed: " << e.what() << std::endl;
+            return false;
+        }
+
+        std::unique_ptr<Replica> replica(new Replica);
+        replica->node_handle = replica_handle;
+        replica->node = replica_node;
+        replica->inputs = getDataInputs(*replica_handle);
+        replica->outputs = getDataOutputs(*replica_handle);
+        replica->thread = std::thread([r = replica.get()]() {
+            csapex::thread::set_name("replica");
+            runReplica(*r);
+        });
+
+        std::unique_lock<std::recursive_mutex> lock(sync);
+        replicas_.emplace_back(std::move(replica));
+    }
+    return true;
+}
+
+void ReplicatedNodeWorker::reserveQueueCapacities(std::size_t capacity)
+{
+    // the replicas can only work ahead on tokens that the producers were allowed to send,
+    // the configured capacities stay untouched, so they are restored as soon as the reservation is released
+    for (const InputPtr& input : node_handle_->getExternalInputs()) {
+        for (const ConnectionPtr& connection : input->getConnections()) {
+            if (connection->getReservedQueueCapacity() == capacity) {
+                continue;
+            }
+            connection->reserveQueueCapacity(capacity);
+
+            auto pos = std::find_if(reserved_connections_.begin(), reserved_connections_.end(), [&connection](const std::weak_ptr<Connection>& c) { return c.lock() == connection; });
+            if (pos == reserved_connections_.end()) {
+                reserved_connections_.push_back(connection);
+            }
+        }
+    }
+}
+
+void ReplicatedNodeWorker::releaseQueueCapacities()
+{
+    for (const std::weak_ptr<Connection>& c : reserved_connections_) {
+        if (ConnectionPtr connection = c.lock()) {
+            connection->reserveQueueCapacity(0);
+        }
+    }
+    reserved_connections_.clear();
+}
+
+std::vector<std::vector<TokenPtr>> ReplicatedNodeWorker::getQueuedInputs() const
+{
+    std::vector<InputPtr> inputs = getDataInputs(*node_handle_);
+
+    for (const InputPtr& input : node_handle_->getExternalInputs()) {
+        if (node_handle_->isParameterInput(input->getUUID()) && input->isConnected()) {
+            // queued parameter values would have to be applied to the replicas in order
+            return {};
+        }
+    }
+
+    // tokens are processed together, if they are at the same position in their queues
+    std::size_t depth = std::numeric_limits<std::size_t>::max();
+    std::vector<std::vector<TokenPtr>> queues(inputs.size());
+    bool has_connected_input = false;
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        if (inputs[i]->hasEnabledConnection()) {
+            auto connections = inputs[i]->getConnections();
+            apex_assert_hard(connections.size() == 1);
+            queues[i] = connections.front()->getQueuedTokens();
+            depth = std::min(depth, queues[i].size());
+            has_connected_input = true;
+        }
+    }
+    if (!has_connected_input) {
+        return {};
+    }
+
+    std::vector<std::vector<TokenPtr>> rows;
+    for (std::size_t row = 0; row < depth; ++row) {
+        std::vector<TokenPtr> tokens(inputs.size());
+        for (std::size_t i = 0; i < inputs.size(); ++i) {
+            if (!queues[i].empty()) {
+                const TokenPtr& token = queues[i][row];
+                // markers and activity changes are handled by the node itself, the replicas stop there
+                if (token->hasActivityModifier() || std::dynamic_pointer_cast<connection_types::MarkerMessage const>(token->getTokenData())) {
+                    return rows;
+                }
+                tokens[i] = token;
+            }
+        }
+        rows.push_back(tokens);
+    }
+    return rows;
+}
+
+bool ReplicatedNodeWorker::isCurrentInput(const std::vector<TokenPtr>& tokens) const
+{
+    std::vector<InputPtr> inputs = getDataInputs(*node_handle_);
+    if (inputs.size() != tokens.size()) {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        if (tokens[i] && !isSameToken(tokens[i], inputs[i]->getToken())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ReplicatedNodeWorker::prefetch(const NodePtr& node)
+{
+    std::vector<std::vector<TokenPtr>> queued = getQueuedInputs();
+
+    // the prefetched results have to belong to the tokens at the front of the queues
+    std::size_t row = 0;
+    for (; row < prefetched_.size(); ++row) {
+        if (row >= queued.size() || queued[row] != prefetched_[row].inputs) {
+            break;
+        }
+    }
+    if (row < prefetched_.size()) {
+        dropPrefetched();
+        row = 0;
+    }
+
+    std::size_t input_count = getDataInputs(*node_handle_).size();
+    std::size_t output_count = getDataOutputs(*node_handle_).size();
+
+    GenericStatePtr parameters;
+    for (; row < queued.size(); ++row) {
+        auto pos = std::find_if(replicas_.begin(), replicas_.end(), [](const std::unique_ptr<Replica>& r) { return !r->busy; });
+        if (pos == replicas_.end()) {
+            break;
+        }
+        Replica* replica = pos->get();
+        if (replica->inputs.size() != input_count || replica->outputs.size() != output_count) {
+            // the node has changed its connectors since the replica was created
+            break;
+        }
+
+        if (!parameters) {
+            parameters = node->getParameterStateClone();
+        }
+        synchronizeParameters(*replica, parameters);
+
+        replica->busy = true;
+
+        Prefetch p;
+        p.inputs = queued[row];
+        p.replica = replica;
+        p.result = dispatch(*replica, queued[row]);
+        prefetched_.emplace_back(std::move(p));
+    }
+}
+
+void ReplicatedNodeWorker::dropPrefetched()
+{
+    for (Prefetch& p : prefetched_) {
+        p.result.wait();
+        p.replica->busy = false;
+    }
+    prefetched_.clear();
+}
+
+void ReplicatedNodeWorker::synchronizeParameters(Replica& replica, const GenericStatePtr& parameters)
+{
+    replica.node->setParameterState(parameters);
+
+    for (auto& pair : replica.node->getChangedParameters()) {
+        if (param::ParameterPtr p = pair.first.lock()) {
+            for (auto& cb : pair.second) {
+                cb(p.get());
+            }
+        }
+    }
+
+    replica.node->publishParameterSnapshot();
+}
+
+std::future<ReplicatedNodeWorker::Result> ReplicatedNodeWorker::dispatch(Replica& replica, const std::vector<TokenPtr>& tokens)
+{
+    std::packaged_task<Result()> job([&replica, tokens]() { return processOnReplica(replica, tokens); });
+    std::future<Result> result = job.get_future();
+
+    std::unique_lock<std::mutex> lock(replica.job_mutex);
+    apex_assert_hard(!replica.job.valid());
+    replica.job = std::move(job);
+    replica.job_changed.notify_one();
+
+    return result;
+}
+
+void ReplicatedNodeWorker::runReplica(Replica& replica)
+{
+    std::unique_lock<std::mutex> lock(replica.job_mutex);
+    while (true) {
+        replica.job_changed.wait(lock, [&replica]() { return replica.stopping || replica.job.valid(); });
+        if (replica.stopping) {
+            return;
+        }
+
+        std::packaged_task<Result()> job = std::move(replica.job);
+        lock.unlock();
+        job();
+        lock.lock();
+    }
+}
+
+ReplicatedNodeWorker::Result ReplicatedNodeWorker::processOnReplica(Replica& replica, const std::vector<TokenPtr>& tokens)
+{
+    Result result;
+
+    // the replica only gets a shared claim, so it cannot modify data that the node will see later
+    std::vector<TokenPtr> claims;
+    for (std::size_t i = 0; i < replica.inputs.size(); ++i) {
+        if (tokens[i]) {
+            claims.push_back(tokens[i]->share());
+            replica.inputs[i]->setToken(claims.back());
+        } else {
+            replica.inputs[i]->setToken(connection_types::makeEmptyToken<connection_types::NoMessage>());
+        }
+    }
+
+    try {
+        replica.node->process(*replica.node_handle, *replica.node);
+
+    } catch (const std::exception& e) {
+        result.error = e.what();
+    }
+
+    for (const OutputPtr& output : replica.outputs) {
+        result.outputs.push_back(output->getAddedToken());
+        output->clearBuffer();
+    }
+
+    for (const TokenPtr& claim : claims) {
+        claim->release();
+    }
+
+    return result;
+}
+
+void ReplicatedNodeWorker::publish(const Result& result)
+{
+    if (!result.error.empty()) {
+        setError(true, result.error);
+        return;
+    }
+
+    std::vector<OutputPtr> outputs = getDataOutputs(*node_handle_);
+    apex_assert_hard(outputs.size() == result.outputs.size());
+    for (std::size_t i = 0; i < outputs.size(); ++i) {
+        if (result.outputs[i]) {
+            outputs[i]->addMessage(result.outputs[i]);
+        }
+    }
+}
@@ -18,6 +18,7 @@
 #include <csapex/model/node_worker.h>
 
 /// SYSTEM
+#include <algorithm>
 #include <iostream>
 
 using namespace csapex;
@@ -29,6 +30,10 @@ SubgraphNode::SubgraphNode(GraphImplementationPtr graph)
   , is_subgraph_finished_(false)
   , is_iterating_(false)
   , has_sent_current_iteration_(false)
+  , iteration_index_(0)
+  , iteration_count_(0)
+  , iterations_received_(0)
+  , iteration_parallelism_(1)
   , is_initialized_(false)
   ,
 
@@ -176,6 +181,16 @@ void SubgraphNode::setupParameters(Parameterizable& params)
                                            setIterationEnabled(id, iterate);
                                        }
                                    });
+
+    params.addConditionalParameter(param::factory::declareRange("iteration_parallelism",
+                                                                param::ParameterDescription("Maximum number of container elements that are processed by the subgraph at the same time. "
+                                                                                            "Results are collected in the order of the elements. "
+                                                                                            "Only nested nodes in PIPELINING execution mode work on different elements concurrently, "
+                                                                                            "sequential nodes hold an element until the whole chain behind them is done. "
+                                                                                            "A node can only start on the next element while its successor is busy if the connection between them "
+                                                                                            "has a queue capacity of at least 2."),
+                                                                1, 64, 1, 1),
+                                   [this]() { return readParameter<bool>("iterate_containers"); }, iteration_parallelism_);
 }
 
 void SubgraphNode::process(NodeModifier& node_modifier, Parameterizable& params, Continuation continuation)
@@ -192,20 +207,34 @@ void SubgraphNode::process(NodeModifier& node_modifier, Parameterizable& params,
     apex_assert_hard(transition_relay_out_->areAllConnections(Connection::State::NOT_INITIALIZED));
     apex_assert_hard(transition_relay_out_->canStartSendingMessages());
 
+    std::unique_lock<std::recursive_mutex> lock(iteration_mutex_);
+
     is_iterating_ = false;
     has_sent_current_iteration_ = false;
     is_subgraph_finished_ = false;
+    iteration_count_ = 0;
+    iteration_index_ = 0;
+    iterations_received_ = 0;
+    collected_elements_.clear();
 
+    // iterated containers are zipped, the shortest one determines the number of iterations
     for (const InputPtr& i : node_modifier.getMessageInputs()) {
         if (msg::hasMessage(i.get())) {
             TokenDataConstPtr m = msg::getMessage(i.get());
-            OutputPtr o = external_to_internal_outputs_.at(i->getUUID());
-
             if (m->isContainer() && iterated_inputs_.find(i->getUUID()) != iterated_inputs_.end()) {
+                int count = m->nestedValueCount();
+                iteration_count_ = is_iterating_ ? std::min(iteration_count_, count) : count;
                 is_iterating_ = true;
-                iteration_count_ = m->nestedValueCount();
-                iteration_index_ = 1;
+            }
+        }
+    }
+
+    for (const InputPtr& i : node_modifier.getMessageInputs()) {
+        if (msg::hasMessage(i.get())) {
+            TokenDataConstPtr m = msg::getMessage(i.get());
+            OutputPtr o = external_to_internal_outputs_.at(i->getUUID());
 
+            if (m->isContainer() && iterated_inputs_.find(i->getUUID()) != iterated_inputs_.end()) {
                 if (iteration_count_ > 0) {
                     msg::publish(o.get(), m->nestedValue(0));
                 }
@@ -215,6 +244,9 @@ void SubgraphNode::process(NodeModifier& node_modifier, Parameterizable& params,
             }
         }
     }
+    if (is_iterating_) {
+        iteration_index_ = 1;
+    }
 
     if (transition_relay_out_->hasConnection()) {
         // TRACE ainfo << "send internal output messages" << std::endl;
@@ -366,19 +398,11 @@ UUID SubgraphNode::addForwardingOutput(const UUID& internal_uuid, const TokenDat
     relay->message_set.connect([this, external_output_weak, relay](Connectable*) {
         if (auto external_output = external_output_weak.lock()) {
             TokenPtr token = relay->getToken();
+            std::unique_lock<std::recursive_mutex> lock(iteration_mutex_);
             if (is_iterating_) {
-                connection_types::GenericVectorMessage::Ptr vector;
-                if (!external_output->hasMessage()) {
-                    vector = connection_types::GenericVectorMessage::make(token->getTokenData());
-                } else {
-                    auto collected = external_output->getAddedToken()->getTokenData()->cloneAs<TokenData>();
-                    vector = std::dynamic_pointer_cast<connection_types::GenericVectorMessage>(collected);
-                }
-                apex_assert(vector);
-                vector->addNestedValue(token->getTokenData());
-                msg::publish(external_output.get(), vector);
-
-                external_output->setType(vector);
+                CollectedElements& collected = collected_elements_[external_output->getUUID()];
+                collected.output = external_output;
+                collected.elements.push_back(token->getTokenData());
 
             } else {
                 msg::publish(external_output.get(), token->getTokenData());
@@ -651,14 +675,14 @@ std::vector<UUID> SubgraphNode::getInternalEvents() const
 
 void SubgraphNode::setIterationEnabled(const UUID& external_input_uuid, bool enabled)
 {
-    if (enabled) {
-        // only one iteration is allowed for now
-        apex_assert_eq(0, iterated_inputs_.size());
+    InputPtr i = node_handle_->getInput(external_input_uuid);
+    OutputPtr o = external_to_internal_outputs_.at(i->getUUID());
 
-        iterated_inputs_.insert(external_input_uuid);
-
-        InputPtr i = node_handle_->getInput(external_input_uuid);
-        OutputPtr o = external_to_internal_outputs_.at(i->getUUID());
+    if (enabled) {
+        bool was_iterating = !iterated_inputs_.empty();
+        if (!iterated_inputs_.insert(external_input_uuid).second) {
+            return;
+        }
 
         // change the output type of the subgraph
         TokenDataConstPtr vector_type = i->getType();
@@ -666,6 +690,11 @@ void SubgraphNode::setIterationEnabled(const UUID& external_input_uuid, bool ena
             o->setType(vector_type->nestedType());
         }
 
+        if (was_iterating) {
+            // the input types have already been changed by the first iterated input
+            return;
+        }
+
         // change the input type of the subgraph
         for (const UUID& id : transition_relay_in_->getInputs()) {
             InputPtr i = transition_relay_in_->getInput(id);
@@ -680,7 +709,15 @@ void SubgraphNode::setIterationEnabled(const UUID& external_input_uuid, bool ena
         }
 
     } else {
-        iterated_inputs_.erase(external_input_uuid);
+        if (iterated_inputs_.erase(external_input_uuid) == 0) {
+            return;
+        }
+
+        o->setType(i->getType());
+
+        if (!iterated_inputs_.empty()) {
+            return;
+        }
 
         // change back the input type of the subgraph
         for (const UUID& id : transition_relay_in_->getInputs()) {
@@ -709,9 +746,11 @@ void SubgraphNode::currentIterationIsProcessed()
 
 void SubgraphNode::subgraphHasProducedAllMessages()
 {
+    std::unique_lock<std::recursive_mutex> lock(iteration_mutex_);
     if (transition_relay_in_->isEnabled()) {  // TODO: check this in checkIfEnabled
 
-        apex_assert_hard(!has_sent_current_iteration_);
+        // when iterations are pipelined, results of earlier elements can still be outstanding
+        apex_assert_hard(!has_sent_current_iteration_ || iterations_received_ < iteration_index_);
         sendCurrentIteration();
 
         tryFinishSubgraph();
@@ -721,7 +760,8 @@ void SubgraphNode::subgraphHasProducedAllMessages()
 void SubgraphNode::tryFinishSubgraph()
 {
     // TRACE ainfo << "try finish" << std::endl;
-    bool can_start_next_iteration = node_handle_->isSink() || has_sent_current_iteration_;
+    std::unique_lock<std::recursive_mutex> lock(iteration_mutex_);
+    bool can_start_next_iteration = node_handle_->isSink() || has_sent_current_iteration_ || canPipelineIteration();
     if (can_start_next_iteration) {
         bool last_iteration = !is_iterating_ || iteration_index_ >= iteration_count_;
         if (last_iteration) {
@@ -755,10 +795,33 @@ void SubgraphNode::finishSubgraph()
         // is_iterating_ = false;
         has_sent_current_iteration_ = false;
 
+        publishCollectedElements();
+
         notifySubgraphProcessed();
     }
 }
 
+void SubgraphNode::publishCollectedElements()
+{
+    std::unique_lock<std::recursive_mutex> lock(iteration_mutex_);
+    for (auto& pair : collected_elements_) {
+        CollectedElements& collected = pair.second;
+        OutputPtr output = collected.output.lock();
+        if (!output || collected.elements.empty()) {
+            continue;
+        }
+
+        // a new vector is built once, instead of extending an already published one for every element
+        connection_types::GenericVectorMessage::Ptr vector = connection_types::GenericVectorMessage::make(collected.elements.front());
+        for (const TokenDataConstPtr& element : collected.elements) {
+            vector->addNestedValue(element);
+        }
+        msg::publish(output.get(), vector);
+        output->setType(vector);
+    }
+    collected_elements_.clear();
+}
+
 void SubgraphNode::notifySubgraphProcessed()
 {
     //    if(node_handle_->isSource() && node_handle_->isSink()) {
@@ -783,7 +846,10 @@ void SubgraphNode::sendCurrentIteration()
     transition_relay_in_->forwardMessages();
 
     has_sent_current_iteration_ = true;
-    if (is_iterating_ && iteration_index_ < iteration_count_) {
+    if (is_iterating_) {
+        ++iterations_received_;
+    }
+    if (is_iterating_ && iterations_received_ < iteration_count_) {
         // TRACE ainfo << "mark read" << std::endl;
         transition_relay_in_->notifyMessageRead();
         transition_relay_in_->notifyMessageProcessed();
@@ -795,6 +861,13 @@ void SubgraphNode::sendCurrentIteration()
     }
 }
 
+bool SubgraphNode::canPipelineIteration() const
+{
+    // results arrive in the same order as the elements are sent, since every connection is a FIFO
+    int in_flight = iteration_index_ - iterations_received_;
+    return is_iterating_ && in_flight < iteration_parallelism_;
+}
+
 void SubgraphNode::startNextIteration()
 {
     //    ainfo << "start iteration " << iteration_index_ << std::endl;
@@ -11,6 +11,8 @@
 #include <csapex/model/node_modifier.h>
 #include <csapex/model/node_state.h>
 #include <csapex/model/subgraph_node.h>
+#include <csapex/model/subprocess_pool.h>
+#include <csapex/model/subprocess_sandbox.h>
 #include <csapex/msg/any_message.h>
 #include <csapex/msg/end_of_sequence_message.h>
 #include <csapex/msg/generic_value_message.hpp>
@@ -44,20 +46,69 @@
 
 using namespace csapex;
 
-SubprocessNodeWorker::SubprocessNodeWorker(NodeHandlePtr node_handle) : NodeWorker(node_handle), pid_(-1), subprocess_(new Subprocess(node_handle->getUUID().getFullName()))
+namespace
+{
+/**
+ * @brief The SlotStreamBuffer class lets YAML be parsed from and emitted into shared memory slots without intermediate copies
+ */
+class SlotStreamBuffer : public std::streambuf
+{
+public:
+    SlotStreamBuffer(uint8_t* data, std::size_t length)
+    {
+        char* begin = reinterpret_cast<char*>(data);
+        setp(begin, begin + length);
+    }
+    SlotStreamBuffer(const uint8_t* data, std::size_t length)
+    {
+        char* begin = const_cast<char*>(reinterpret_cast<const char*>(data));
+        setg(begin, begin, begin + length);
+    }
+
+    std::size_t written() const
+    {
+        return pptr() - pbase();
+    }
+};
+
+YAML::Node readYaml(const SubprocessChannel::Message& msg)
+{
+    SlotStreamBuffer buffer(msg.data, msg.length);
+    std::istream stream(&buffer);
+    return YAML::Load(stream);
+}
+
+SubprocessChannel::SlotWriter yamlWriter(const YAML::Node& yaml)
+{
+    return [&yaml](uint8_t* slot, std::size_t capacity) -> std::size_t {
+        SlotStreamBuffer buffer(slot, capacity);
+        std::ostream stream(&buffer);
+        YAML::Emitter emitter(stream);
+        emitter << yaml;
+        if (!stream || !emitter.good()) {
+            throw std::runtime_error("message does not fit into a slot of " + std::to_string(capacity) + " bytes");
+        }
+        return buffer.written();
+    };
+}
+
+}  // namespace
+
+SubprocessNodeWorker::SubprocessNodeWorker(NodeHandlePtr node_handle) : NodeWorker(node_handle)
 {
 }
 
 void SubprocessNodeWorker::initialize()
 {
-    pid_ = subprocess_->fork([this]() { runSubprocessLoop(); });
+    // the sandbox is forked when a member is executed for the first time
+    sandbox_ = SubprocessPool::instance().join(this);
 
     observe(node_handle_->connector_created, [this](ConnectablePtr c, bool internal) {
         if (!internal) {
             node_handle_->execution_requested([this, c]() {
                 SerializationBuffer msg;
                 c->getDescription().serializeVersioned(msg);
-                subprocess_->in.write({ SubprocessChannel::MessageType::PORT_ADD, msg.data(), msg.size() });
+                sendToSandbox({ SubprocessChannel::MessageType::PORT_ADD, msg.data(), msg.size() });
             });
         }
     });
@@ -65,92 +116,87 @@ void SubprocessNodeWorker::initialize()
         node_handle_->execution_requested([this]() {
             SerializationBuffer msg;
             getNodeHandle()->getNodeState()->serializeVersioned(msg);
-            subprocess_->in.write({ SubprocessChannel::MessageType::NODE_STATE_CHANGED, msg.data(), msg.size() });
+            sendToSandbox({ SubprocessChannel::MessageType::NODE_STATE_CHANGED, msg.data(), msg.size() });
         });
     });
 
     NodeWorker::initialize();
 }
 
-void SubprocessNodeWorker::runSubprocessLoop()
+std::shared_ptr<SubprocessSandbox> SubprocessNodeWorker::getSandbox() const
 {
-    NodePtr node = getNode();
+    return sandbox_;
+}
 
-    try {
-        observe(node->getParameterState()->parameter_changed, [&](param::Parameter* p) { changed_parameters_.push_back(p); });
+void SubprocessNodeWorker::sendToSandbox(const SubprocessChannel::Message& msg)
+{
+    // the standby has to know the same state when it takes over
+    sandbox_->update(getUUID().getFullName(), msg);
+}
 
-        while (subprocess_->isActive()) {
-            // wait for a message
-            SubprocessChannel::Message msg = subprocess_->in.read();
-            if (msg.type == SubprocessChannel::MessageType::SHUTDOWN) {
-                return;
-            }
+void SubprocessNodeWorker::prepareSubprocess()
+{
+    NodePtr node = getNode();
+    observe(node->getParameterState()->parameter_changed, [this](param::Parameter* p) { changed_parameters_.push_back(p); });
+}
+
+void SubprocessNodeWorker::handleSubprocessMessage(const SubprocessChannel::Message& msg)
+{
+    NodePtr node = getNode();
 
-            switch (msg.type) {
-                case SubprocessChannel::MessageType::PARAMETER_UPDATE:
-                    handleParameterUpdate(msg);
-                    break;
-
-                case SubprocessChannel::MessageType::PROCESS_SYNC:
-                case SubprocessChannel::MessageType::PROCESS_ASYNC:
-                    handleProcessChild(msg);
-                    break;
-
-                case SubprocessChannel::MessageType::PROCESS_SLOT:
-                    handleProcessSlotChild(msg);
-                    break;
-
-                case SubprocessChannel::MessageType::NODE_STATE_CHANGED:
-                    node->stateChanged();
-                    break;
-
-                case SubprocessChannel::MessageType::PORT_ADD: {
-                    ConnectorDescription des;
-                    SerializationBuffer buffer(msg.data, msg.length);
-                    des.deserializeVersioned(buffer);
-                    if (des.is_variadic) {
-                        switch (des.connector_type) {
-                            case ConnectorType::INPUT: {
-                                auto vi = std::dynamic_pointer_cast<VariadicInputs>(getNode());
-                                vi->createVariadicInput(des.token_type, des.label, des.optional);
-                            } break;
-                            case ConnectorType::OUTPUT: {
-                                auto vo = std::dynamic_pointer_cast<VariadicOutputs>(getNode());
-                                vo->createVariadicOutput(des.token_type, des.label);
-                            } break;
-                            default:
-                                break;
-                        }
-                    } else {
-                        switch (des.connector_type) {
-                            case ConnectorType::INPUT:
-                                getNodeHandle()->addInput(des.token_type, des.label, des.optional);
-                                break;
-                            case ConnectorType::OUTPUT:
-                                getNodeHandle()->addOutput(des.token_type, des.label);
-                                break;
-                            default:
-                                break;
-                        }
-                    }
-
-                } break;
-
-                default:
-                    node->aerr << "subprocess received unknown message: " << (int)msg.type << std::endl;
-                    break;
+    switch (msg.type) {
+        case SubprocessChannel::MessageType::PARAMETER_UPDATE:
+            handleParameterUpdate(msg);
+            break;
+
+        case SubprocessChannel::MessageType::PROCESS_SYNC:
+        case SubprocessChannel::MessageType::PROCESS_ASYNC:
+            handleProcessChild(msg);
+            break;
+
+        case SubprocessChannel::MessageType::PROCESS_SLOT:
+            handleProcessSlotChild(msg);
+            break;
+
+        case SubprocessChannel::MessageType::NODE_STATE_CHANGED:
+            node->stateChanged();
+            break;
+
+        case SubprocessChannel::MessageType::PORT_ADD: {
+            ConnectorDescription des;
+            SerializationBuffer buffer(msg.data, msg.length);
+            des.deserializeVersioned(buffer);
+            if (des.is_variadic) {
+                switch (des.connector_type) {
+                    case ConnectorType::INPUT: {
+                        auto vi = std::dynamic_pointer_cast<VariadicInputs>(getNode());
+                        vi->createVariadicInput(des.token_type, des.label, des.optional);
+                    } break;
+                    case ConnectorType::OUTPUT: {
+                        auto vo = std::dynamic_pointer_cast<VariadicOutputs>(getNode());
+                        vo->createVariadicOutput(des.token_type, des.label);
+                    } break;
+                    default:
+                        break;
+                }
+            } else {
+                switch (des.connector_type) {
+                    case ConnectorType::INPUT:
+                        getNodeHandle()->addInput(des.token_type, des.label, des.optional);
+                        break;
+                    case ConnectorType::OUTPUT:
+                        getNodeHandle()->addOutput(des.token_type, des.label);
+                        break;
+                    default:
+                        break;
+                }
             }
-        }
 
-    } catch (const SubprocessChannel::ShutdownException& e) {
-        // ignore
+        } break;
 
-    } catch (const boost::interprocess::interprocess_exception& e) {
-        std::cout << "interprocess exception " << getUUID() << " >> error: " << e.what() << std::endl;
-        std::cout << "native error: " << e.get_native_error() << std::endl;
-        std::cout << "error code:   " << e.get_error_code() << std::endl;
-    } catch (const std::exception& e) {
-        std::cout << "subprocess " << getUUID() << " >> error: " << e.what() << std::endl;
+        default:
+            node->aerr << "subprocess received unknown message: " << (int)msg.type << std::endl;
+            break;
     }
 }
 
@@ -164,7 +210,7 @@ void SubprocessNodeWorker::handleProcessChild(const SubprocessChannel::Message&
 
     try {
         if (msg.data) {
-            YAML::Node yaml = YAML::Load(msg.toString());
+            YAML::Node yaml = readYaml(msg);
             for (const YAML::Node& node : yaml) {
                 UUID uuid = node["uuid"].as<UUID>();
                 auto msg = MessageSerializer::deserializeYamlMessage(node["data"]);
@@ -205,7 +251,7 @@ void SubprocessNodeWorker::handleProcessSlotChild(const SubprocessChannel::Messa
 
     try {
         if (msg.data) {
-            YAML::Node yaml = YAML::Load(msg.toString());
+            YAML::Node yaml = readYaml(msg);
             UUID uuid = yaml["uuid"].as<UUID>();
             auto msg = MessageSerializer::deserializeYamlMessage(yaml["data"]);
 
@@ -230,7 +276,7 @@ void SubprocessNodeWorker::finishHandleProcessChild()
 {
     NodePtr node = getNode();
 
-    YAML::Emitter result_emitter;
+    YAML::Node result;
     try {
         // send parameter updates
         for (param::Parameter* parameter : changed_parameters_) {
@@ -251,9 +297,6 @@ void SubprocessNodeWorker::finishHandleProcessChild()
                 // TODO serialize token! (+ activity, ...)
                 node["data"] = MessageSerializer::serializeYamlMessage(*msg->getTokenData());
 
-                YAML::Emitter emitter;
-                emitter << node;
-
                 yaml.push_back(node);
             }
         }
@@ -267,14 +310,11 @@ void SubprocessNodeWorker::finishHandleProcessChild()
                 // TODO serialize token! (+ activity, ...)
                 node["data"] = MessageSerializer::serializeYamlMessage(*msg->getTokenData());
 
-                YAML::Emitter emitter;
-                emitter << node;
-
                 yaml.push_back(node);
             }
         }
 
-        result_emitter << yaml;
+        result = yaml;
 
     } catch (const std::exception& e) {
         node->aerr << "finishHandleProcessChild: " << e.what() << std::endl;
@@ -284,14 +324,18 @@ void SubprocessNodeWorker::finishHandleProcessChild()
         node->aerr << "unknown error in finishHandleProcessChild" << std::endl;
     }
 
-    subprocess_->flush();
-
-    subprocess_->out.write({ SubprocessChannel::MessageType::PROCESS_FINISHED, result_emitter.c_str() });
+    Subprocess* connection = sandbox_->process();
+    connection->flush();
+    connection->out.write(SubprocessChannel::MessageType::PROCESS_FINISHED, yamlWriter(result));
 }
 
 SubprocessNodeWorker::~SubprocessNodeWorker()
 {
     stopObserving();
+
+    if (sandbox_) {
+        SubprocessPool::instance().leave(this, sandbox_);
+    }
 }
 
 void SubprocessNodeWorker::handleParameterUpdate(const SubprocessChannel::Message& msg)
@@ -311,7 +355,7 @@ void SubprocessNodeWorker::handleParameterUpdate(const SubprocessChannel::Messag
 void SubprocessNodeWorker::handleProcessParent(const SubprocessChannel::Message& msg)
 {
     if (msg.data) {
-        YAML::Node yaml = YAML::Load(msg.toString());
+        YAML::Node yaml = readYaml(msg);
 
         for (const YAML::Node& node : yaml) {
             UUID uuid = node["uuid"].as<UUID>();
@@ -331,7 +375,7 @@ void SubprocessNodeWorker::handleProcessParent(const SubprocessChannel::Message&
 
 void SubprocessNodeWorker::processNode()
 {
-    apex_assert(pid_ != -1);
+    apex_assert_msg(!sandbox_->isChild(), "processNode called in subprocess");
 
     std::unique_lock<std::recursive_mutex> lock(current_exec_mode_mutex_);
 
@@ -340,16 +384,22 @@ void SubprocessNodeWorker::processNode()
 
     bool sync = !node->isAsynchronous();
 
+    // the sandbox is reserved from the request until the result has been read
+    SubprocessSandbox::Lease lease;
+
     try {
         apex_assert_hard(node->getNodeHandle());
         if (sync) {
-            apex_assert_msg(pid_ != 0, "processNode called in subprocess");
+            lease = sandbox_->lease();
             startSubprocess(SubprocessChannel::MessageType::PROCESS_SYNC);
 
         } else {
             async_future_ = std::async(std::launch::async, [this]() {
-                startSubprocess(SubprocessChannel::MessageType::PROCESS_ASYNC);
-                finishSubprocess();
+                {
+                    SubprocessSandbox::Lease lease = sandbox_->lease();
+                    startSubprocess(SubprocessChannel::MessageType::PROCESS_ASYNC);
+                    finishSubprocess();
+                }
                 finishProcessing();
             });
         }
@@ -364,7 +414,11 @@ void SubprocessNodeWorker::processNode()
     if (sync) {
         lock.unlock();
 
-        finishSubprocess();
+        if (lease) {
+            finishSubprocess();
+            // successors could be members of the same sandbox
+            lease.unlock();
+        }
         finishProcessing();
     }
 }
@@ -387,15 +441,12 @@ void SubprocessNodeWorker::startSubprocess(const SubprocessChannel::MessageType
         }
     }
 
-    YAML::Emitter emitter;
-    emitter << yaml;
-
-    subprocess_->in.write({ type, emitter.c_str() });
+    sandbox_->write(getUUID().getFullName(), type, yamlWriter(yaml));
 }
 
 void SubprocessNodeWorker::processSlot(const SlotWeakPtr& slot_w)
 {
-    apex_assert_msg(pid_ != 0, "processSlot called in subprocess");
+    apex_assert_msg(!sandbox_->isChild(), "processSlot called in subprocess");
 
     SlotPtr slot = slot_w.lock();
     apex_assert_hard(slot);
@@ -425,10 +476,8 @@ void SubprocessNodeWorker::startSubprocessSlot(const SlotPtr& slot)
         // TODO serialize token! (+ activity, ...)
         yaml["data"] = MessageSerializer::serializeYamlMessage(*msg);
 
-        YAML::Emitter emitter;
-        emitter << yaml;
-
-        subprocess_->in.write({ SubprocessChannel::MessageType::PROCESS_SLOT, emitter.c_str() });
+        SubprocessSandbox::Lease lease = sandbox_->lease();
+        sandbox_->write(getUUID().getFullName(), SubprocessChannel::MessageType::PROCESS_SLOT, yamlWriter(yaml));
 
         finishSubprocess();
     }
@@ -442,7 +491,7 @@ void SubprocessNodeWorker::finishSubprocess()
     // wait for the end of processing
 
     while (!done_processing) {
-        SubprocessChannel::Message msg = subprocess_->out.read();
+        SubprocessChannel::Message msg = sandbox_->process()->out.read();
         switch (msg.type) {
             case SubprocessChannel::MessageType::PARAMETER_UPDATE:
                 handleParameterUpdate(msg);
@@ -471,33 +520,40 @@ void SubprocessNodeWorker::finishSubprocess()
         }
     }
 
+    Subprocess* connection = sandbox_->process();
     if (crashed) {
         getNode()->aerr << "*** node crashed! ***" << std::endl;
 
-        std::string out = subprocess_->getChildStdOut();
+        std::string out = connection->getChildStdOut();
         if (!out.empty()) {
             getNode()->aerr << "*** STDOUT: ***" << std::endl;
             getNode()->aerr << out << std::endl;
         }
 
-        std::string err = subprocess_->getChildStdErr();
+        std::string err = connection->getChildStdErr();
         if (!err.empty()) {
             getNode()->aerr << "*** STDERR: ***" << std::endl;
             getNode()->aerr << err << std::endl;
         }
 
-        getNode()->aerr << "*** restarting subprocess ***" << std::endl;
+        if (sandbox_->restart()) {
+            getNode()->aerr << "*** switched to standby subprocess ***" << std::endl;
 
-        subprocess_.reset(new Subprocess(getUUID().getFullName()));
-        pid_ = subprocess_->fork([this]() { runSubprocessLoop(); });
+            // replace the standby once the node is idle
+            std::shared_ptr<SubprocessSandbox> sandbox = sandbox_;
+            node_handle_->execution_requested([sandbox]() { sandbox->forkStandby(); });
+
+        } else {
+            getNode()->aerr << "*** restarting subprocess ***" << std::endl;
+        }
 
     } else {
-        std::string out = subprocess_->getChildStdOut();
+        std::string out = connection->getChildStdOut();
         if (!out.empty()) {
             getNode()->ainfo << out << std::endl;
         }
 
-        std::string err = subprocess_->getChildStdErr();
+        std::string err = connection->getChildStdErr();
         if (!err.empty()) {
             getNode()->aerr << err << std::endl;
         }
@@ -513,11 +569,14 @@ void SubprocessNodeWorker::finishProcessing()
 
 void SubprocessNodeWorker::transmitParameter(const param::ParameterPtr& p)
 {
-    SubprocessChannel& channel = subprocess_->isChild() ? subprocess_->out : subprocess_->in;
-
     SerializationBuffer buffer = PacketSerializer::serializePacket(p);
+    SubprocessChannel::Message msg{ SubprocessChannel::MessageType::PARAMETER_UPDATE, buffer.data(), buffer.size() };
 
-    channel.write({ SubprocessChannel::MessageType::PARAMETER_UPDATE, buffer.data(), buffer.size() });
+    if (sandbox_->isChild()) {
+        sandbox_->process()->out.write(msg);
+    } else {
+        sendToSandbox(msg);
+    }
 }
 
 void SubprocessNodeWorker::handleChangedParametersImpl(const Parameterizable::ChangedParameterList& changed_params)
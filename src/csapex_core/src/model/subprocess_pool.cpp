@@ -0,0 +1,120 @@
+/// HEADER
+#include <csapex/model/subprocess_pool.h>
+
+/// COMPONENT
+#include <csapex/model/subprocess_sandbox.h>
+
+/// SYSTEM
+#include <algorithm>
+#include <iterator>
+
+using namespace csapex;
+
+SubprocessPool::SubprocessPool() : size_(0), standby_(false), next_id_(0), dedicated_(0), forks_(0), warm_restarts_(0), cold_restarts_(0)
+{
+}
+
+void SubprocessPool::setSize(std::size_t size)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    // existing sandboxes are kept until their last node leaves
+    size_ = size;
+}
+
+std::size_t SubprocessPool::getSize() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return size_;
+}
+
+void SubprocessPool::setStandby(bool standby)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    standby_ = standby;
+}
+
+bool SubprocessPool::hasStandby() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return standby_;
+}
+
+std::shared_ptr<SubprocessSandbox> SubprocessPool::join(SubprocessNodeWorker* worker)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    std::shared_ptr<SubprocessSandbox> sandbox;
+    if (size_ == 0) {
+        sandbox = std::make_shared<SubprocessSandbox>(next_id_++, standby_);
+        ++dedicated_;
+    } else {
+        sandbox = selectSharedSandbox();
+    }
+
+    sandbox->add(worker);
+    return sandbox;
+}
+
+std::shared_ptr<SubprocessSandbox> SubprocessPool::selectSharedSandbox()
+{
+    auto by_members = [](const std::shared_ptr<SubprocessSandbox>& a, const std::shared_ptr<SubprocessSandbox>& b) { return a->getMemberCount() < b->getMemberCount(); };
+
+    // joining a sandbox that has not been forked yet is free
+    std::vector<std::shared_ptr<SubprocessSandbox>> unforked;
+    std::copy_if(shared_.begin(), shared_.end(), std::back_inserter(unforked), [](const std::shared_ptr<SubprocessSandbox>& s) { return !s->isForked(); });
+    if (!unforked.empty()) {
+        return *std::min_element(unforked.begin(), unforked.end(), by_members);
+    }
+
+    if (shared_.size() < size_) {
+        shared_.push_back(std::make_shared<SubprocessSandbox>(next_id_++, standby_));
+        return shared_.back();
+    }
+
+    // the sandbox has to be forked again, the smallest one loses the least state
+    return *std::min_element(shared_.begin(), shared_.end(), by_members);
+}
+
+void SubprocessPool::leave(SubprocessNodeWorker* worker, const std::shared_ptr<SubprocessSandbox>& sandbox)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    sandbox->remove(worker);
+    if (sandbox->getMemberCount() > 0) {
+        return;
+    }
+
+    auto pos = std::find(shared_.begin(), shared_.end(), sandbox);
+    if (pos != shared_.end()) {
+        shared_.erase(pos);
+    } else if (dedicated_ > 0) {
+        --dedicated_;
+    }
+}
+
+void SubprocessPool::countFork()
+{
+    ++forks_;
+}
+
+void SubprocessPool::countRestart(bool warm)
+{
+    if (warm) {
+        ++warm_restarts_;
+    } else {
+        ++cold_restarts_;
+    }
+}
+
+SubprocessPool::Stats SubprocessPool::getStats() const
+{
+    Stats stats;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        stats.sandboxes = shared_.size() + dedicated_;
+    }
+    stats.forks = forks_;
+    stats.warm_restarts = warm_restarts_;
+    stats.cold_restarts = cold_restarts_;
+    return stats;
+}
@@ -0,0 +1,299 @@
+/// HEADER
+#include <csapex/model/subprocess_sandbox.h>
+
+/// COMPONENT
+#include <csapex/model/subprocess_node_worker.h>
+#include <csapex/model/subprocess_pool.h>
+
+/// SYSTEM
+#include <cstring>
+#include <unistd.h>
+#include <boost/interprocess/exceptions.hpp>
+
+using namespace csapex;
+
+SubprocessSandbox::SubprocessSandbox(std::size_t id, bool standby) : id_(id), keep_standby_(standby), generation_(0), forking_(false), is_stale_(false), self_(nullptr)
+{
+}
+
+SubprocessSandbox::~SubprocessSandbox()
+{
+    // the processes are shut down and joined by their destructors
+}
+
+std::size_t SubprocessSandbox::getId() const
+{
+    return id_;
+}
+
+void SubprocessSandbox::add(SubprocessNodeWorker* worker)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    members_[worker->getUUID().getFullName()] = worker;
+
+    // the running process does not contain the new member
+    if (active_ || forking_) {
+        is_stale_ = true;
+    }
+}
+
+void SubprocessSandbox::remove(SubprocessNodeWorker* worker)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto pos = members_.find(worker->getUUID().getFullName());
+    if (pos != members_.end() && pos->second == worker) {
+        members_.erase(pos);
+    }
+}
+
+std::size_t SubprocessSandbox::getMemberCount() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return members_.size();
+}
+
+bool SubprocessSandbox::isForked() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return active_ != nullptr;
+}
+
+SubprocessSandbox::Lease SubprocessSandbox::lease()
+{
+    Lease lease(lease_mutex_);
+
+    // replaced processes are shut down after the lock is released
+    std::shared_ptr<Subprocess> old_active;
+    std::shared_ptr<Subprocess> old_standby;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!active_ || is_stale_) {
+        std::map<std::string, SubprocessNodeWorker*> members = members_;
+        bool with_standby = keep_standby_;
+        is_stale_ = false;
+
+        // the child would inherit a held lock in its locked state, updates wait until the new processes are assigned
+        forking_ = true;
+        lock.unlock();
+
+        std::shared_ptr<Subprocess> active;
+        std::shared_ptr<Subprocess> standby;
+        try {
+            active = fork(members);
+            if (with_standby) {
+                standby = fork(members);
+            }
+        } catch (...) {
+            lock.lock();
+            forking_ = false;
+            is_stale_ = true;
+            forked_.notify_all();
+            throw;
+        }
+
+        lock.lock();
+        old_active = std::move(active_);
+        old_standby = std::move(standby_);
+        active_ = active;
+        standby_ = standby;
+        forking_ = false;
+        forked_.notify_all();
+    }
+    lock.unlock();
+
+    return lease;
+}
+
+Subprocess* SubprocessSandbox::process() const
+{
+    // in the sandbox, the lock might have been copied in a locked state
+    if (self_) {
+        return self_;
+    }
+    return active_.get();
+}
+
+bool SubprocessSandbox::isChild() const
+{
+    return self_ != nullptr;
+}
+
+void SubprocessSandbox::write(const std::string& member, SubprocessChannel::MessageType type, const SubprocessChannel::SlotWriter& writer)
+{
+    write(*active_, member, type, writer);
+}
+
+void SubprocessSandbox::update(const std::string& member, const SubprocessChannel::Message& msg)
+{
+    auto copy = [&msg](uint8_t* slot, std::size_t capacity) -> std::size_t {
+        if (msg.length > capacity) {
+            throw std::runtime_error("message does not fit into a slot of " + std::to_string(capacity) + " bytes");
+        }
+        if (msg.length > 0) {
+            std::memcpy(slot, msg.data, msg.length);
+        }
+        return msg.length;
+    };
+
+    // processes that are forked later already contain the change
+    std::shared_ptr<Subprocess> active;
+    std::shared_ptr<Subprocess> standby;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        forked_.wait(lock, [this]() { return !forking_; });
+        active = active_;
+        standby = standby_;
+    }
+
+    // writing blocks while the ring is full, so it must not hold up a restart
+    if (active) {
+        write(*active, member, msg.type, copy);
+    }
+    if (standby) {
+        write(*standby, member, msg.type, copy);
+    }
+}
+
+void SubprocessSandbox::write(Subprocess& process, const std::string& member, SubprocessChannel::MessageType type, const SubprocessChannel::SlotWriter& writer)
+{
+    process.in.write(type, [&member, &writer](uint8_t* slot, std::size_t capacity) -> std::size_t {
+        uint32_t length = static_cast<uint32_t>(member.size());
+        std::size_t header = sizeof(length) + length;
+        if (header > capacity) {
+            throw std::runtime_error("address does not fit into a slot of " + std::to_string(capacity) + " bytes");
+        }
+        std::memcpy(slot, &length, sizeof(length));
+        std::memcpy(slot + sizeof(length), member.data(), length);
+
+        return header + writer(slot + header, capacity - header);
+    });
+}
+
+std::string SubprocessSandbox::route(SubprocessChannel::Message& msg)
+{
+    uint32_t length = 0;
+    if (msg.length < sizeof(length)) {
+        throw std::runtime_error("sandbox message without address");
+    }
+    std::memcpy(&length, msg.data, sizeof(length));
+    std::size_t header = sizeof(length) + length;
+    if (msg.length < header) {
+        throw std::runtime_error("sandbox message with a truncated address");
+    }
+
+    std::string member(reinterpret_cast<const char*>(msg.data) + sizeof(length), length);
+
+    msg.length -= header;
+    msg.data = msg.length > 0 ? msg.data + header : nullptr;
+
+    return member;
+}
+
+bool SubprocessSandbox::restart()
+{
+    // destroyed last, this waits for the crashed child
+    std::shared_ptr<Subprocess> crashed;
+
+    bool warm = false;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        crashed = std::move(active_);
+        if (standby_ && !is_stale_) {
+            active_ = std::move(standby_);
+            warm = true;
+        }
+        // without a standby, the next lease forks a new process
+    }
+
+    // the crashed child never frees its ring, blocked updates would wait forever
+    if (crashed) {
+        crashed->in.shutdown();
+    }
+
+    SubprocessPool::instance().countRestart(warm);
+    return warm;
+}
+
+void SubprocessSandbox::forkStandby()
+{
+    Lease lease = this->lease();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!keep_standby_ || standby_) {
+        return;
+    }
+    std::map<std::string, SubprocessNodeWorker*> members = members_;
+    forking_ = true;
+    lock.unlock();
+
+    std::shared_ptr<Subprocess> standby;
+    try {
+        standby = fork(members);
+    } catch (...) {
+        lock.lock();
+        forking_ = false;
+        forked_.notify_all();
+        throw;
+    }
+
+    lock.lock();
+    standby_ = standby;
+    forking_ = false;
+    forked_.notify_all();
+}
+
+std::shared_ptr<Subprocess> SubprocessSandbox::fork(const std::map<std::string, SubprocessNodeWorker*>& members)
+{
+    // requires lease_mutex_, the process only gets to know the members through this copy
+
+    // channels of replaced processes may still exist, so every process gets its own name
+    std::string name = "csapex_sandbox_" + std::to_string(getpid()) + "_" + std::to_string(id_) + "_" + std::to_string(++generation_);
+
+    std::shared_ptr<Subprocess> process = std::make_shared<Subprocess>(name);
+    Subprocess* connection = process.get();
+    connection->fork([this, connection, members]() {
+        self_ = connection;
+        run(members);
+    });
+
+    SubprocessPool::instance().countFork();
+
+    return process;
+}
+
+void SubprocessSandbox::run(const std::map<std::string, SubprocessNodeWorker*>& members)
+{
+    try {
+        for (const auto& pair : members) {
+            pair.second->prepareSubprocess();
+        }
+
+        while (self_->isActive()) {
+            // wait for a message
+            SubprocessChannel::Message msg = self_->in.read();
+            if (msg.type == SubprocessChannel::MessageType::SHUTDOWN) {
+                return;
+            }
+
+            std::string member = route(msg);
+            auto pos = members.find(member);
+            if (pos == members.end()) {
+                // the member has joined after the fork, the parent will fork again
+                std::cout << "sandbox " << id_ << " does not contain " << member << std::endl;
+                continue;
+            }
+
+            pos->second->handleSubprocessMessage(msg);
+        }
+
+    } catch (const SubprocessChannel::ShutdownException& e) {
+        // ignore
+
+    } catch (const boost::interprocess::interprocess_exception& e) {
+        std::cout << "interprocess exception in sandbox " << id_ << " >> error: " << e.what() << std::endl;
+        std::cout << "native error: " << e.get_native_error() << std::endl;
+        std::cout << "error code:   " << e.get_error_code() << std::endl;
+    } catch (const std::exception& e) {
+        std::cout << "sandbox " << id_ << " >> error: " << e.what() << std::endl;
+    }
+}
@@ -3,14 +3,34 @@
 
 using namespace csapex;
 
-Token::Token(const TokenDataConstPtr& token) : data_(token), activity_modifier_(ActivityModifier::NONE), seq_no_(-1)
+Token::Token(const TokenDataConstPtr& token) : Token(token, std::make_shared<Claims>())
 {
 }
 
-Token::Token() : activity_modifier_(ActivityModifier::NONE), seq_no_(-1)
+Token::Token() : Token(nullptr)
 {
 }
 
+Token::Token(const TokenDataConstPtr& token, const std::shared_ptr<Claims>& claims)
+  : data_(token), claims_(claims), consumer_(false), released_(false), activity_modifier_(ActivityModifier::NONE), seq_no_(-1)
+{
+    ++claims_->tokens;
+}
+
+Token::Token(const Token& other) : Token(other.data_, other.claims_)
+{
+    activity_modifier_ = other.activity_modifier_;
+    seq_no_ = other.seq_no_;
+}
+
+Token::~Token()
+{
+    if (released_) {
+        --claims_->released;
+    }
+    --claims_->tokens;
+}
+
 void Token::setActivityModifier(ActivityModifier active)
 {
     activity_modifier_ = active;
@@ -50,6 +70,42 @@ bool Token::cloneData(const Token& other)
     return true;
 }
 
+Token::Ptr Token::share() const
+{
+    Ptr token(new Token(data_, claims_));
+    token->activity_modifier_ = activity_modifier_;
+    token->seq_no_ = seq_no_;
+    token->consumer_ = true;
+
+    return token;
+}
+
+void Token::release()
+{
+    if (consumer_.exchange(false)) {
+        released_ = true;
+        ++claims_->released;
+    }
+}
+
+TokenDataPtr Token::takeData(const Ptr& token, long owners)
+{
+    // a holder of the token that is unknown to the caller, e.g. a preview, would see the modification
+    if (!token || token.use_count() > owners || !token->consumer_) {
+        return nullptr;
+    }
+    // every other token that reads the data, including the committed token of the output, prevents taking it
+    const Claims& claims = *token->claims_;
+    if (claims.tokens - claims.released != 1) {
+        return nullptr;
+    }
+    // every reference to the data has to belong to a token, otherwise somebody else can still read it
+    if (token->data_.use_count() != claims.tokens) {
+        return nullptr;
+    }
+    return std::const_pointer_cast<TokenData>(token->data_);
+}
+
 Token::Ptr Token::makeEmpty()
 {
     return Ptr{ new Token };
@@ -12,16 +12,19 @@
 
 using namespace csapex;
 
-TokenData::TokenData()
+TokenData::TokenData() : type_(TokenTypeDescriptor::get(""))
 {
 }
 
-TokenData::TokenData(const std::string& type_name) : type_name_(type_name)
+TokenData::TokenData(const std::string& type_name) : type_(TokenTypeDescriptor::get(type_name))
 {
-    setDescriptiveName(type_name);
 }
 
-TokenData::TokenData(const std::string& type_name, const std::string& descriptive_name) : type_name_(type_name), descriptive_name_(descriptive_name)
+TokenData::TokenData(const std::string& type_name, const std::string& descriptive_name) : type_(TokenTypeDescriptor::get(type_name, descriptive_name))
+{
+}
+
+TokenData::TokenData(const TokenTypeDescriptor* type) : type_(type)
 {
 }
 
@@ -31,7 +34,7 @@ TokenData::~TokenData()
 
 void TokenData::setDescriptiveName(const std::string& name)
 {
-    descriptive_name_ = name;
+    type_ = TokenTypeDescriptor::get(type_->typeName(), name);
 }
 
 bool TokenData::canConnectTo(const TokenData* other_side) const
@@ -41,28 +44,41 @@ bool TokenData::canConnectTo(const TokenData* other_side) const
 
 bool TokenData::acceptsConnectionFrom(const TokenData* other_side) const
 {
-    return type_name_ == other_side->typeName();
+    return type_->typeId() == other_side->type_->typeId();
 }
 
 std::string TokenData::descriptiveName() const
 {
-    return descriptive_name_;
+    return type_->descriptiveName();
 }
 
-std::string TokenData::typeName() const
+const std::string& TokenData::typeName() const
 {
-    return type_name_;
+    return type_->typeName();
+}
+
+const TokenTypeDescriptor* TokenData::getTypeDescriptor() const
+{
+    return type_;
 }
 
 void TokenData::serialize(SerializationBuffer& data, SemanticVersion& version) const
 {
-    data << type_name_;
-    data << descriptive_name_;
+    data << type_->typeName();
+    data << type_->descriptiveName();
 }
 void TokenData::deserialize(const SerializationBuffer& data, const SemanticVersion& version)
 {
-    data >> type_name_;
-    data >> descriptive_name_;
+    std::string type_name;
+    std::string descriptive_name;
+    data >> type_name;
+    data >> descriptive_name;
+
+    // descriptors are never released, so a peer must not be able to register names without bound,
+    // beyond that, the token keeps the descriptor of its own type
+    if (const TokenTypeDescriptor* type = TokenTypeDescriptor::tryGet(type_name, descriptive_name)) {
+        type_ = type;
+    }
 }
 
 TokenData::Ptr TokenData::toType() const
@@ -0,0 +1,84 @@
+/// HEADER
+#include <csapex/model/token_type_descriptor.h>
+
+/// SYSTEM
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+using namespace csapex;
+
+namespace
+{
+struct Registry
+{
+    std::shared_timed_mutex mutex;
+    std::map<std::pair<std::string, std::string>, std::unique_ptr<TokenTypeDescriptor>> descriptors;
+    std::unordered_map<std::string, int> type_ids;
+};
+
+Registry& registry()
+{
+    // never destroyed: messages in static objects can outlive this translation unit during shutdown
+    static Registry* registry = new Registry;
+    return *registry;
+}
+}  // namespace
+
+TokenTypeDescriptor::TokenTypeDescriptor(const std::string& type_name, const std::string& descriptive_name, int type_id)
+  : type_name_(type_name), descriptive_name_(descriptive_name), type_id_(type_id)
+{
+}
+
+const TokenTypeDescriptor* TokenTypeDescriptor::get(const std::string& type_name)
+{
+    return get(type_name, type_name);
+}
+
+const TokenTypeDescriptor* TokenTypeDescriptor::get(const std::string& type_name, const std::string& descriptive_name)
+{
+    return get(type_name, descriptive_name, std::numeric_limits<std::size_t>::max());
+}
+
+const TokenTypeDescriptor* TokenTypeDescriptor::tryGet(const std::string& type_name, const std::string& descriptive_name)
+{
+    return get(type_name, descriptive_name, MAX_UNTRUSTED_COUNT);
+}
+
+const TokenTypeDescriptor* TokenTypeDescriptor::get(const std::string& type_name, const std::string& descriptive_name, std::size_t max_count)
+{
+    Registry& r = registry();
+    auto key = std::make_pair(type_name, descriptive_name);
+
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(r.mutex);
+        auto pos = r.descriptors.find(key);
+        if (pos != r.descriptors.end()) {
+            return pos->second.get();
+        }
+    }
+
+    std::unique_lock<std::shared_timed_mutex> lock(r.mutex);
+    auto pos = r.descriptors.find(key);
+    if (pos != r.descriptors.end()) {
+        return pos->second.get();
+    }
+    if (r.descriptors.size() >= max_count) {
+        return nullptr;
+    }
+
+    auto id = r.type_ids.emplace(type_name, static_cast<int>(r.type_ids.size())).first;
+    std::unique_ptr<TokenTypeDescriptor>& descriptor = r.descriptors[key];
+    descriptor.reset(new TokenTypeDescriptor(type_name, descriptive_name, id->second));
+    return descriptor.get();
+}
+
+std::size_t TokenTypeDescriptor::count()
+{
+    Registry& r = registry();
+    std::shared_lock<std::shared_timed_mutex> lock(r.mutex);
+    return r.descriptors.size();
+}
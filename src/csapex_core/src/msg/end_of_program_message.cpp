@@ -9,7 +9,7 @@ CSAPEX_REGISTER_MESSAGE(csapex::connection_types::EndOfProgramMessage)
 using namespace csapex;
 using namespace connection_types;
 
-EndOfProgramMessage::EndOfProgramMessage() : MarkerMessage(type<EndOfProgramMessage>::name(), 0)
+EndOfProgramMessage::EndOfProgramMessage() : MarkerMessage(typeDescriptor<EndOfProgramMessage>(), 0)
 {
 }
 
@@ -9,7 +9,7 @@ CSAPEX_REGISTER_MESSAGE(csapex::connection_types::EndOfSequenceMessage)
 using namespace csapex;
 using namespace connection_types;
 
-EndOfSequenceMessage::EndOfSequenceMessage() : MarkerMessage(type<EndOfSequenceMessage>::name(), 0)
+EndOfSequenceMessage::EndOfSequenceMessage() : MarkerMessage(typeDescriptor<EndOfSequenceMessage>(), 0)
 {
 }
 
@@ -12,11 +12,11 @@ CSAPEX_REGISTER_MESSAGE_WITH_NAME(csapex::connection_types::GenericVectorMessage
 using namespace csapex;
 using namespace connection_types;
 
-GenericVectorMessage::GenericVectorMessage(EntryInterface::Ptr pimpl, const std::string& frame_id, Message::Stamp stamp) : Message(type<GenericVectorMessage>::name(), frame_id, stamp), pimpl(pimpl)
+GenericVectorMessage::GenericVectorMessage(EntryInterface::Ptr pimpl, const std::string& frame_id, Message::Stamp stamp) : Message(typeDescriptor<GenericVectorMessage>(), frame_id, stamp), pimpl(pimpl)
 {
 }
 
-GenericVectorMessage::GenericVectorMessage() : Message(type<GenericVectorMessage>::name(), "/", 0), pimpl(std::make_shared<InstancedImplementation>(std::make_shared<AnyMessage>()))
+GenericVectorMessage::GenericVectorMessage() : Message(typeDescriptor<GenericVectorMessage>(), InternedString(), 0), pimpl(std::make_shared<InstancedImplementation>(std::make_shared<AnyMessage>()))
 {
 }
 
@@ -219,6 +219,10 @@ void InputTransition::notifyMessageProcessed()
         forwarded_ = false;
         processed_ = true;
         for (const ConnectionPtr& c : connections_) {
+            // the node is done with the data, other consumers may now take it over
+            if (TokenPtr token = c->getToken()) {
+                token->release();
+            }
             c->setTokenProcessed();
         }
 
@@ -6,6 +6,7 @@
 #include <csapex/msg/output.h>
 #include <csapex/signal/event.h>
 #include <csapex/model/token.h>
+#include <csapex/model/connection.h>
 
 using namespace csapex;
 
@@ -17,6 +18,26 @@ TokenDataConstPtr csapex::msg::getMessage(Input* input)
     return token->getTokenData();
 }
 
+TokenDataPtr csapex::msg::getMutableMessage(Input* input)
+{
+    apex_assert_hard_msg(input->isEnabled(), "you have requested a message from a disabled input");
+    TokenPtr token = input->getToken();
+    apex_assert_hard_msg(token, "tried to read from an empty input");
+
+    // the connection, the input and this function hold the token
+    TokenDataPtr data = Token::takeData(token, 3);
+    bool copied = data == nullptr;
+    if (copied) {
+        data = token->getTokenData()->cloneAs<TokenData>();
+    }
+
+    for (const ConnectionPtr& connection : input->getConnections()) {
+        connection->countMutableAccess(copied);
+    }
+
+    return data;
+}
+
 bool csapex::msg::hasMessage(Input* input)
 {
     return input->hasMessage() && input->isEnabled();
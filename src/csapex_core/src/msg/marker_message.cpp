@@ -8,6 +8,10 @@ MarkerMessage::MarkerMessage(const std::string& name, Stamp stamp) : Message(nam
 {
 }
 
+MarkerMessage::MarkerMessage(const TokenTypeDescriptor* type, Stamp stamp) : Message(type, InternedString(), stamp)
+{
+}
+
 bool MarkerMessage::canConnectTo(const TokenData*) const
 {
     return true;
@@ -8,11 +8,27 @@
 using namespace csapex;
 using namespace connection_types;
 
-Message::Message(const std::string& name, const std::string& frame_id, Stamp stamp) : TokenData(name), frame_id(frame_id), stamp_micro_seconds(stamp)
+namespace
+{
+InternedString makeFrameId(const std::string& frame_id)
 {
     if (frame_id.size() > 0 && frame_id.at(0) == '/') {
-        this->frame_id = frame_id.substr(1);
+        return InternedString(frame_id.substr(1));
     }
+    return InternedString(frame_id);
+}
+}  // namespace
+
+Message::Message(const std::string& name, const std::string& frame_id, Stamp stamp) : TokenData(name), frame_id(makeFrameId(frame_id)), stamp_micro_seconds(stamp)
+{
+}
+
+Message::Message(const TokenTypeDescriptor* type, const std::string& frame_id, Stamp stamp) : TokenData(type), frame_id(makeFrameId(frame_id)), stamp_micro_seconds(stamp)
+{
+}
+
+Message::Message(const TokenTypeDescriptor* type, const InternedString& frame_id, Stamp stamp) : TokenData(type), frame_id(frame_id), stamp_micro_seconds(stamp)
+{
 }
 
 Message::~Message()
@@ -32,14 +48,16 @@ void Message::serialize(SerializationBuffer& data, SemanticVersion& version) con
 {
     TokenData::serialize(data, version);
 
-    data << frame_id;
+    data << frame_id.str();
     data << stamp_micro_seconds;
 }
 void Message::deserialize(const SerializationBuffer& data, const SemanticVersion& version)
 {
     TokenData::deserialize(data, version);
 
-    data >> frame_id;
+    std::string frame;
+    data >> frame;
+    frame_id = frame;
     data >> stamp_micro_seconds;
 }
 
@@ -55,7 +73,7 @@ Node convert<csapex::connection_types::Message>::encode(const csapex::connection
 
     Node node;
     node["version"] = vnode;
-    node["frame_id"] = rhs.frame_id;
+    node["frame_id"] = rhs.frame_id.str();
     node["stamp"] = rhs.stamp_micro_seconds;
     return node;
 }
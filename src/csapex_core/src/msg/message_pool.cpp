@@ -0,0 +1,286 @@
+/// HEADER
+#include <csapex/msg/message_pool.h>
+
+/// PROJECT
+#include <csapex/utility/type.h>
+
+/// SYSTEM
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <vector>
+
+using namespace csapex;
+
+namespace
+{
+// blocks every thread keeps per type before they go to the shared free list
+const std::size_t THREAD_CACHE_SIZE = 8;
+// blocks kept in the shared free list, if no larger reservation exists
+const std::size_t SHARED_CACHE_SIZE = 64;
+
+std::atomic<bool> pool_enabled(true);
+}  // namespace
+
+class MessagePool::TypePool
+{
+public:
+    explicit TypePool(const std::string& name) : name(name), block_size(0), reserved(0), closed(false), hits(0), misses(0), live_blocks(0), cached_blocks(0)
+    {
+    }
+
+    bool isPoolable(std::size_t bytes) const
+    {
+        return bytes == block_size;
+    }
+
+    void prewarm()
+    {
+        // requires mutex
+        std::size_t size = block_size;
+        if (size == 0) {
+            // the size is known after the first allocation
+            return;
+        }
+        while (free.size() < reserved) {
+            free.push_back(::operator new(size));
+            ++cached_blocks;
+        }
+    }
+
+    const std::string name;
+
+    // all blocks of a type have the same size, which is set by the first allocation
+    std::atomic<std::size_t> block_size;
+
+    std::mutex mutex;
+    std::vector<void*> free;
+    std::size_t reserved;
+
+    std::atomic<bool> closed;
+
+    std::atomic<std::size_t> hits;
+    std::atomic<std::size_t> misses;
+    std::atomic<std::size_t> live_blocks;
+    std::atomic<std::size_t> cached_blocks;
+};
+
+namespace
+{
+void releaseToSharedList(MessagePool::TypePool* pool, void* block)
+{
+    // block is counted as cached
+    std::unique_lock<std::mutex> lock(pool->mutex);
+    if (!pool->closed && pool->free.size() < std::max(SHARED_CACHE_SIZE, pool->reserved)) {
+        pool->free.push_back(block);
+    } else {
+        --pool->cached_blocks;
+        ::operator delete(block);
+    }
+}
+
+// set once the cache of this thread has been destroyed, blocks freed afterwards bypass it
+thread_local bool thread_cache_destroyed = false;
+
+struct ThreadCache
+{
+    ~ThreadCache()
+    {
+        thread_cache_destroyed = true;
+
+        // hand the blocks of an exiting thread to the shared free lists
+        for (auto& pair : blocks) {
+            for (void* block : pair.second) {
+                releaseToSharedList(pair.first, block);
+            }
+        }
+    }
+
+    std::unordered_map<MessagePool::TypePool*, std::vector<void*>> blocks;
+};
+
+std::vector<void*>* localBlocks(MessagePool::TypePool* pool)
+{
+    if (thread_cache_destroyed) {
+        return nullptr;
+    }
+    thread_local ThreadCache thread_cache;
+    return &thread_cache.blocks[pool];
+}
+
+}  // namespace
+
+MessagePool::MessagePool()
+{
+}
+
+MessagePool::~MessagePool()
+{
+    // the type pools themselves are never deleted: messages can outlive the pool during shutdown
+    std::unique_lock<std::recursive_mutex> lock(mutex_);
+    for (auto& pair : pools_) {
+        TypePool* pool = pair.second;
+        pool->closed = true;
+    }
+    clear();
+}
+
+MessagePool::TypePool* MessagePool::getTypePool(const std::type_info& type)
+{
+    std::string name = type2name(type);
+
+    std::unique_lock<std::recursive_mutex> lock(mutex_);
+    TypePool*& pool = pools_[name];
+    if (!pool) {
+        pool = new TypePool(name);
+
+        auto pos = reservations_.find(name);
+        if (pos != reservations_.end()) {
+            pool->reserved = pos->second;
+        }
+    }
+    return pool;
+}
+
+void* MessagePool::allocate(TypePool* pool, std::size_t bytes)
+{
+    std::size_t expected = 0;
+    if (!pool->block_size.compare_exchange_strong(expected, bytes) && expected != bytes) {
+        // not the size this pool manages
+        ++pool->misses;
+        return ::operator new(bytes);
+    }
+
+    ++pool->live_blocks;
+
+    if (pool_enabled) {
+        std::vector<void*>* local = localBlocks(pool);
+        if (local && !local->empty()) {
+            void* block = local->back();
+            local->pop_back();
+            --pool->cached_blocks;
+            ++pool->hits;
+            return block;
+        }
+
+        std::unique_lock<std::mutex> lock(pool->mutex);
+        if (expected == 0) {
+            // first allocation of this type, apply a reservation
+            pool->prewarm();
+        }
+        if (!pool->free.empty()) {
+            void* block = pool->free.back();
+            pool->free.pop_back();
+            --pool->cached_blocks;
+            ++pool->hits;
+            return block;
+        }
+    }
+
+    ++pool->misses;
+    return ::operator new(bytes);
+}
+
+void MessagePool::deallocate(TypePool* pool, void* ptr, std::size_t bytes)
+{
+    if (!pool->isPoolable(bytes)) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    --pool->live_blocks;
+
+    if (!pool_enabled || pool->closed) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    ++pool->cached_blocks;
+
+    std::vector<void*>* local = localBlocks(pool);
+    if (local && local->size() < THREAD_CACHE_SIZE) {
+        local->push_back(ptr);
+        return;
+    }
+
+    releaseToSharedList(pool, ptr);
+}
+
+void MessagePool::reserve(const std::string& type_name, std::size_t count)
+{
+    std::unique_lock<std::recursive_mutex> lock(mutex_);
+    reservations_[type_name] = count;
+
+    auto pos = pools_.find(type_name);
+    if (pos != pools_.end()) {
+        TypePool* pool = pos->second;
+        std::unique_lock<std::mutex> pool_lock(pool->mutex);
+        pool->reserved = count;
+        pool->prewarm();
+    }
+}
+
+std::map<std::string, std::size_t> MessagePool::getReservations() const
+{
+    std::unique_lock<std::recursive_mutex> lock(mutex_);
+    return reservations_;
+}
+
+void MessagePool::setEnabled(bool enabled)
+{
+    pool_enabled = enabled;
+    if (!enabled) {
+        clear();
+    }
+}
+
+bool MessagePool::isEnabled() const
+{
+    return pool_enabled;
+}
+
+MessagePool::Stats MessagePool::getStats() const
+{
+    Stats stats;
+
+    std::unique_lock<std::recursive_mutex> lock(mutex_);
+    for (const auto& pair : pools_) {
+        Stats type_stats = getStats(pair.first);
+        stats.hits += type_stats.hits;
+        stats.misses += type_stats.misses;
+        stats.bytes_live += type_stats.bytes_live;
+        stats.bytes_cached += type_stats.bytes_cached;
+    }
+    return stats;
+}
+
+MessagePool::Stats MessagePool::getStats(const std::string& type_name) const
+{
+    Stats stats;
+
+    std::unique_lock<std::recursive_mutex> lock(mutex_);
+    auto pos = pools_.find(type_name);
+    if (pos != pools_.end()) {
+        const TypePool* pool = pos->second;
+        stats.hits = pool->hits;
+        stats.misses = pool->misses;
+        stats.bytes_live = pool->live_blocks * pool->block_size;
+        stats.bytes_cached = pool->cached_blocks * pool->block_size;
+    }
+    return stats;
+}
+
+void MessagePool::clear()
+{
+    std::unique_lock<std::recursive_mutex> lock(mutex_);
+    for (auto& pair : pools_) {
+        TypePool* pool = pair.second;
+
+        std::unique_lock<std::mutex> pool_lock(pool->mutex);
+        for (void* block : pool->free) {
+            ::operator delete(block);
+        }
+        pool->cached_blocks -= pool->free.size();
+        pool->free.clear();
+    }
+}
@@ -9,7 +9,7 @@ CSAPEX_REGISTER_MESSAGE(csapex::connection_types::NoMessage)
 using namespace csapex;
 using namespace connection_types;
 
-NoMessage::NoMessage() : MarkerMessage(type<NoMessage>::name(), 0)
+NoMessage::NoMessage() : MarkerMessage(typeDescriptor<NoMessage>(), 0)
 {
 }
 
@@ -16,7 +16,7 @@
 
 using namespace csapex;
 
-Output::Output(const UUID& uuid, ConnectableOwnerWeakPtr owner) : Connectable(uuid, owner), transition_(nullptr), state_(State::IDLE)
+Output::Output(const UUID& uuid, ConnectableOwnerWeakPtr owner) : Connectable(uuid, owner), transition_(nullptr), state_(State::IDLE), sharing_messages_(false)
 {
 }
 
@@ -64,7 +64,7 @@ void Output::notifyMessageProcessed()
         processing_lock.unlock();
 
         for (const ConnectionPtr& connection : connections_) {
-            apex_assert_hard(connection->getState() == Connection::State::DONE);
+            apex_assert_hard(connection->canAcceptToken());
         }
         message_processed(shared_from_this());
     } else {
@@ -93,7 +93,7 @@ void Output::notifyMessageProcessed(Connection* connection)
 //     }
 
     for (auto connection : connections_) {
-        if (connection->getState() != Connection::State::DONE) {
+        if (!connection->canAcceptToken()) {
             // std::cerr << getUUID() << " :::: " << *connection << "-> is not yet done " << std::endl;
             return;
         }
@@ -163,6 +163,8 @@ void Output::disable()
 
     if (isProcessing()) {
         for (auto connection : connections_) {
+            // buffered tokens are dropped, only the one at the front is marked as processed
+            connection->clearQueuedTokens();
             if (connection->getState() == Connection::State::UNREAD) {
                 connection->readToken();
             }
@@ -181,7 +183,7 @@ bool Output::isConnected() const
 bool Output::canReceiveToken() const
 {
     for (const ConnectionPtr& connection : connections_) {
-        if (connection->getState() != Connection::State::NOT_INITIALIZED) {
+        if (!connection->canAcceptToken()) {
             return false;
         }
     }
@@ -198,6 +200,16 @@ bool Output::canSendMessages() const
     return !isProcessing();
 }
 
+void Output::setSharingMessages(bool sharing)
+{
+    sharing_messages_ = sharing;
+}
+
+bool Output::isSharingMessages() const
+{
+    return sharing_messages_;
+}
+
 void Output::publish()
 {
     std::unique_lock<std::recursive_mutex> processing_lock(processing_mutex_);
@@ -232,6 +244,10 @@ void Output::publish()
         // std::cerr << getUUID() << " :::: "
         //           << "is notified processed in publish because no message is sent" << std::endl;
         notifyMessageProcessed();
+
+    } else if (canReceiveToken()) {
+        // every connection has buffered the token and still has free slots
+        notifyMessageProcessed();
     }
 }
 
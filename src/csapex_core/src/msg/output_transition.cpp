@@ -15,10 +15,10 @@
 
 using namespace csapex;
 
-OutputTransition::OutputTransition(delegate::Delegate0<> activation_fn) : Transition(activation_fn), sequence_number_(-1)
+OutputTransition::OutputTransition(delegate::Delegate0<> activation_fn) : Transition(activation_fn), sequence_number_(-1), filling_connections_(false), processed_while_filling_(false)
 {
 }
-OutputTransition::OutputTransition() : Transition(), sequence_number_(-1)
+OutputTransition::OutputTransition() : Transition(), sequence_number_(-1), filling_connections_(false), processed_while_filling_(false)
 {
 }
 
@@ -145,14 +145,14 @@ bool OutputTransition::canStartSendingMessages() const
             }
         }
     }
-    return areAllConnections(Connection::State::DONE, Connection::State::NOT_INITIALIZED);
+    return canAllConnectionsAcceptTokens();
 }
 
 bool OutputTransition::sendMessages(bool is_active)
 {
     std::unique_lock<std::recursive_mutex> lock(sync);
 
-    apex_assert_hard(areAllConnections(Connection::State::NOT_INITIALIZED));
+    apex_assert_hard(canAllConnectionsAcceptTokens());
 
     bool has_sent_activator_message = false;
 
@@ -188,7 +188,12 @@ bool OutputTransition::sendMessages(bool is_active)
 void OutputTransition::tokenProcessed()
 {
     std::unique_lock<std::recursive_mutex> lock(sync);
-    if (!areAllConnections(Connection::State::DONE)) {
+    if (filling_connections_) {
+        // an output with buffering connections is processed while the others are still publishing
+        processed_while_filling_ = true;
+        return;
+    }
+    if (!canAllConnectionsAcceptTokens()) {
         // if (!outputs_.empty()) {
         //     std::cerr << outputs_.begin()->second->getUUID() << ": cannot publish next, not all connections are done:" << std::endl;
         //     for (const ConnectionPtr& connection : connections_) {
@@ -210,7 +215,7 @@ void OutputTransition::tokenProcessed()
         return;
     }
 
-    apex_assert_hard(areAllConnections(Connection::State::DONE));
+    apex_assert_hard(canAllConnectionsAcceptTokens());
 
     APEX_DEBUG_CERR << "all outputs are done" << std::endl;
 
@@ -252,7 +257,10 @@ void OutputTransition::fillConnections()
         return;
     }
 
-    apex_assert_hard(areAllConnections(Connection::State::NOT_INITIALIZED));
+    apex_assert_hard(canAllConnectionsAcceptTokens());
+
+    filling_connections_ = true;
+    processed_while_filling_ = false;
 
     for (const auto& pair : outputs_) {
         OutputPtr out = pair.second;
@@ -261,6 +269,14 @@ void OutputTransition::fillConnections()
             out->publish();
         }
     }
+
+    filling_connections_ = false;
+
+    if (processed_while_filling_) {
+        processed_while_filling_ = false;
+        lock.unlock();
+        tokenProcessed();
+    }
 }
 
 void OutputTransition::clearBuffer()
@@ -109,6 +109,17 @@ bool Transition::isOneConnection(Connection::State state) const
     return false;
 }
 
+bool Transition::canAllConnectionsAcceptTokens() const
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    for (const ConnectionPtr& connection : connections_) {
+        if (connection->isEnabled() && !connection->canAcceptToken()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool Transition::hasConnection() const
 {
     std::unique_lock<std::recursive_mutex> lock(sync);
@@ -125,3 +125,13 @@ std::vector<std::string> PluginLocator::getPluginPaths(const std::string& type)
         return {};
     }
 }
+
+void PluginLocator::setStartupTimer(TimerPtr timer)
+{
+    startup_timer_ = timer;
+}
+
+TimerPtr PluginLocator::getStartupTimer() const
+{
+    return startup_timer_;
+}
@@ -0,0 +1,343 @@
+/// HEADER
+#include <csapex/plugin/plugin_manifest_index.h>
+
+/// PROJECT
+#include <csapex/serialization/io/std_io.h>
+
+/// SYSTEM
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <boost/filesystem.hpp>
+#include <boost/version.hpp>
+#if (BOOST_VERSION / 100000) >= 1 && (BOOST_VERSION / 100 % 1000) >= 54
+namespace bf3 = boost::filesystem;
+#else
+namespace bf3 = boost::filesystem3;
+#endif
+#if WIN32
+#define TIXML_USE_STL
+#include <tinyxml/tinyxml.h>
+#else
+#include <tinyxml.h>
+#endif
+
+using namespace csapex;
+
+namespace
+{
+const std::string INDEX_MAGIC = "csapex_plugin_index";
+// 2: content hash instead of the modification time
+const uint16_t INDEX_VERSION = 2;
+
+/**
+ * @brief fingerprint reads the manifest and hashes its content with FNV-1a.
+ *        Modification times can miss edits within their resolution, the content cannot.
+ */
+bool fingerprint(const std::string& file, uint64_t& content_hash, uint64_t& size)
+{
+    std::ifstream in(file, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+
+    uint64_t hash = 14695981039346656037ull;
+    uint64_t bytes = 0;
+    char chunk[4096];
+    while (in.read(chunk, sizeof(chunk)) || in.gcount() > 0) {
+        for (std::streamsize i = 0; i < in.gcount(); ++i) {
+            hash = (hash ^ static_cast<uint8_t>(chunk[i])) * 1099511628211ull;
+        }
+        bytes += in.gcount();
+    }
+
+    content_hash = hash;
+    size = bytes;
+    return true;
+}
+
+std::string readString(TiXmlElement* class_element, const std::string& name)
+{
+    TiXmlElement* description = class_element->FirstChildElement(name);
+    std::string description_str;
+    if (description) {
+        description_str = description->GetText() ? description->GetText() : "";
+    }
+
+    return description_str;
+}
+
+std::string readAttribute(TiXmlElement* element, const char* name)
+{
+    const char* value = element->Attribute(name);
+    return value ? value : "";
+}
+}  // namespace
+
+namespace csapex
+{
+SerializationBuffer& operator<<(SerializationBuffer& data, const PluginManifest::Class& c)
+{
+    data << c.base_class_type << c.type << c.name << c.description << c.icon << c.tags;
+    return data;
+}
+const SerializationBuffer& operator>>(const SerializationBuffer& data, PluginManifest::Class& c)
+{
+    data >> c.base_class_type >> c.type >> c.name >> c.description >> c.icon >> c.tags;
+    return data;
+}
+
+SerializationBuffer& operator<<(SerializationBuffer& data, const PluginManifest::Library& l)
+{
+    data << l.name << l.classes;
+    return data;
+}
+const SerializationBuffer& operator>>(const SerializationBuffer& data, PluginManifest::Library& l)
+{
+    data >> l.name >> l.classes;
+    return data;
+}
+
+SerializationBuffer& operator<<(SerializationBuffer& data, const PluginManifest& m)
+{
+    data << m.file << m.content_hash << m.size << m.libraries;
+    return data;
+}
+const SerializationBuffer& operator>>(const SerializationBuffer& data, PluginManifest& m)
+{
+    data >> m.file >> m.content_hash >> m.size >> m.libraries;
+    m.valid = true;
+    return data;
+}
+}  // namespace csapex
+
+PluginManifestIndex::PluginManifestIndex() : dirty_(false), hits_(0), misses_(0)
+{
+}
+
+void PluginManifestIndex::setFile(const std::string& index_file)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (index_file == index_file_) {
+        return;
+    }
+
+    index_file_ = index_file;
+    entries_.clear();
+    dirty_ = false;
+
+    read();
+}
+
+void PluginManifestIndex::read()
+{
+    auto file = std::fopen(index_file_.c_str(), "rb");
+    if (!file) {
+        return;
+    }
+
+    std::fseek(file, 0, SEEK_END);
+    std::size_t n = std::ftell(file);
+    std::rewind(file);
+
+    SerializationBuffer buffer;
+    buffer.resize(n);
+
+    std::size_t bytes = std::fread(buffer.data(), 1, n, file);
+    std::fclose(file);
+
+    if (bytes != n) {
+        return;
+    }
+
+    try {
+        std::string magic;
+        uint16_t version;
+        buffer >> magic >> version;
+        if (magic != INDEX_MAGIC || version != INDEX_VERSION) {
+            return;
+        }
+
+        std::vector<PluginManifest> manifests;
+        buffer >> manifests;
+        for (PluginManifest& manifest : manifests) {
+            std::string key = manifest.file;
+            entries_[key] = std::move(manifest);
+        }
+
+    } catch (const std::exception& e) {
+        std::cerr << "[Plugin] Ignoring corrupt manifest index " << index_file_ << ": " << e.what() << std::endl;
+        entries_.clear();
+    }
+}
+
+void PluginManifestIndex::save()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!dirty_ || index_file_.empty()) {
+        return;
+    }
+
+    std::vector<PluginManifest> manifests;
+    manifests.reserve(entries_.size());
+    for (const auto& pair : entries_) {
+        manifests.push_back(pair.second);
+    }
+
+    SerializationBuffer buffer;
+    buffer << INDEX_MAGIC << INDEX_VERSION << manifests;
+    buffer.finalize();
+
+    boost::system::error_code ec;
+    bf3::path target(index_file_);
+    bf3::create_directories(target.parent_path(), ec);
+
+    // write to a temporary file first, so that concurrent instances never read a partial index
+    std::string tmp_file = bf3::unique_path(index_file_ + ".%%%%-%%%%").string();
+    auto file = std::fopen(tmp_file.c_str(), "wb");
+    if (!file) {
+        std::cerr << "[Plugin] Cannot write the manifest index " << index_file_ << std::endl;
+        return;
+    }
+    std::size_t written = std::fwrite(buffer.data(), sizeof(uint8_t), buffer.size(), file);
+    std::fclose(file);
+
+    if (written == buffer.size()) {
+        bf3::rename(tmp_file, target, ec);
+    }
+    if (written != buffer.size() || ec) {
+        bf3::remove(tmp_file, ec);
+        return;
+    }
+
+    dirty_ = false;
+}
+
+bool PluginManifestIndex::lookup(const std::string& xml_file, PluginManifest& manifest)
+{
+    uint64_t content_hash;
+    uint64_t size;
+    bool readable = fingerprint(xml_file, content_hash, size);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto pos = entries_.find(xml_file);
+    if (pos != entries_.end()) {
+        if (readable && content_hash == pos->second.content_hash && size == pos->second.size) {
+            manifest = pos->second;
+            ++hits_;
+            return true;
+        }
+    }
+
+    ++misses_;
+    return false;
+}
+
+std::vector<PluginManifest> PluginManifestIndex::parse(const std::vector<std::string>& xml_files)
+{
+    std::vector<PluginManifest> manifests(xml_files.size());
+
+    std::size_t workers = std::min<std::size_t>(std::max(1u, std::thread::hardware_concurrency()), xml_files.size());
+    if (workers <= 1) {
+        for (std::size_t i = 0; i < xml_files.size(); ++i) {
+            manifests[i] = parseManifest(xml_files[i]);
+        }
+
+    } else {
+        std::atomic<std::size_t> next(0);
+        std::vector<std::thread> threads;
+        for (std::size_t w = 0; w < workers; ++w) {
+            threads.emplace_back([&]() {
+                for (std::size_t i = next++; i < xml_files.size(); i = next++) {
+                    manifests[i] = parseManifest(xml_files[i]);
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    for (const PluginManifest& manifest : manifests) {
+        if (manifest.valid) {
+            store(manifest);
+        }
+    }
+
+    return manifests;
+}
+
+void PluginManifestIndex::store(const PluginManifest& manifest)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    PluginManifest& entry = entries_[manifest.file];
+    entry = manifest;
+    entry.document.reset();
+    dirty_ = true;
+}
+
+std::size_t PluginManifestIndex::countHits() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+std::size_t PluginManifestIndex::countMisses() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+PluginManifest PluginManifestIndex::parseManifest(const std::string& xml_file)
+{
+    PluginManifest manifest;
+    manifest.file = xml_file;
+
+    // hash before parsing, a manifest changed in between is then parsed again next time
+    if (!fingerprint(xml_file, manifest.content_hash, manifest.size)) {
+        return manifest;
+    }
+
+    auto document = std::make_shared<TiXmlDocument>();
+    document->LoadFile(xml_file);
+    TiXmlElement* config = document->RootElement();
+    if (config == nullptr) {
+        std::cerr << "[Plugin] Cannot load the file " << xml_file << std::endl;
+        return manifest;
+    }
+
+    TiXmlElement* library = config;
+    if (library->ValueStr() != "library") {
+        library = library->NextSiblingElement("library");
+    }
+    for (; library != nullptr; library = library->NextSiblingElement("library")) {
+        std::string library_name = readAttribute(library, "path");
+        if (library_name.size() == 0) {
+            std::cerr << "[Plugin] Item in row" << library->Row() << " does not contain a path attribute" << std::endl;
+            continue;
+        }
+
+        PluginManifest::Library entry;
+        entry.name = library_name;
+
+        for (TiXmlElement* class_element = library->FirstChildElement("class"); class_element; class_element = class_element->NextSiblingElement("class")) {
+            PluginManifest::Class c;
+            c.base_class_type = readAttribute(class_element, "base_class_type");
+            c.type = readAttribute(class_element, "type");
+            c.name = class_element->Attribute("name") != nullptr ? class_element->Attribute("name") : c.type;
+            c.description = readString(class_element, "description");
+            c.icon = readString(class_element, "icon");
+            c.tags = readString(class_element, "tags");
+            entry.classes.push_back(c);
+        }
+
+        manifest.libraries.push_back(entry);
+    }
+
+    manifest.document = document;
+    manifest.valid = true;
+    return manifest;
+}
@@ -0,0 +1,72 @@
+/// HEADER
+#include <csapex/profiling/interval_aggregator.h>
+
+/// PROJECT
+#include <csapex/profiling/interval.h>
+
+/// SYSTEM
+#include <algorithm>
+
+using namespace csapex;
+
+IntervalAggregator::IntervalAggregator(long window_micro_seconds) : window_micro_(std::max(1l, window_micro_seconds))
+{
+}
+
+long IntervalAggregator::getWindowMicro() const
+{
+    return window_micro_;
+}
+
+std::shared_ptr<const IntervalSummary> IntervalAggregator::add(const Interval& interval)
+{
+    long end = interval.getEndMicro();
+    long window_start = end - (end % window_micro_);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    std::shared_ptr<const IntervalSummary> finished;
+    if (current_ && window_start > current_->window_start_micro) {
+        finished = current_;
+        current_.reset();
+    }
+
+    if (!current_) {
+        current_ = std::make_shared<IntervalSummary>(interval.name(), window_start, window_start + window_micro_);
+    }
+
+    // intervals that end late are counted in the current window
+    current_->add(interval);
+
+    return finished;
+}
+
+std::shared_ptr<const IntervalSummary> IntervalAggregator::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    std::shared_ptr<const IntervalSummary> finished = current_;
+    current_.reset();
+
+    if (finished && finished->empty()) {
+        return nullptr;
+    }
+    return finished;
+}
+
+std::shared_ptr<const IntervalSummary> IntervalAggregator::flushExpired(long now_micro)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if (!current_ || current_->window_end_micro > now_micro) {
+        return nullptr;
+    }
+
+    std::shared_ptr<const IntervalSummary> finished = current_;
+    current_.reset();
+
+    if (finished->empty()) {
+        return nullptr;
+    }
+    return finished;
+}
@@ -0,0 +1,110 @@
+/// HEADER
+#include <csapex/profiling/interval_summary.h>
+
+/// PROJECT
+#include <csapex/profiling/interval.h>
+#include <csapex/serialization/io/std_io.h>
+
+/// SYSTEM
+#include <algorithm>
+
+using namespace csapex;
+
+std::size_t IntervalSummary::getBin(long length_micro_seconds)
+{
+    std::size_t bin = 0;
+    while (bin < HISTOGRAM_BINS - 1 && length_micro_seconds >= getBinUpperBoundMicro(bin)) {
+        ++bin;
+    }
+    return bin;
+}
+
+long IntervalSummary::getBinUpperBoundMicro(std::size_t bin)
+{
+    return 10l << bin;
+}
+
+IntervalSummary::IntervalSummary() : IntervalSummary("", 0, 0)
+{
+}
+
+IntervalSummary::IntervalSummary(const std::string& name, long window_start_micro, long window_end_micro)
+  : name(name), window_start_micro(window_start_micro), window_end_micro(window_end_micro), count(0), active_count(0), total_ms(0.0), min_ms(0.0), max_ms(0.0)
+{
+    histogram.fill(0);
+}
+
+void IntervalSummary::add(const Interval& interval)
+{
+    double length = interval.lengthMs();
+
+    if (count == 0) {
+        min_ms = length;
+        max_ms = length;
+    } else {
+        min_ms = std::min(min_ms, length);
+        max_ms = std::max(max_ms, length);
+    }
+
+    ++count;
+    if (interval.isActive()) {
+        ++active_count;
+    }
+    total_ms += length;
+
+    ++histogram[getBin(static_cast<long>(length * 1e3))];
+
+    for (const auto& pair : interval.sub) {
+        steps_ms[pair.first] += pair.second->lengthMs();
+    }
+}
+
+bool IntervalSummary::empty() const
+{
+    return count == 0;
+}
+
+double IntervalSummary::getMeanMs() const
+{
+    return count > 0 ? total_ms / count : 0.0;
+}
+
+void IntervalSummary::serialize(SerializationBuffer& data, SemanticVersion& version) const
+{
+    data << name;
+    data << window_start_micro;
+    data << window_end_micro;
+
+    data << count;
+    data << active_count;
+
+    data << total_ms;
+    data << min_ms;
+    data << max_ms;
+
+    for (uint32_t bin : histogram) {
+        data << bin;
+    }
+
+    data << steps_ms;
+}
+
+void IntervalSummary::deserialize(const SerializationBuffer& data, const SemanticVersion& version)
+{
+    data >> name;
+    data >> window_start_micro;
+    data >> window_end_micro;
+
+    data >> count;
+    data >> active_count;
+
+    data >> total_ms;
+    data >> min_ms;
+    data >> max_ms;
+
+    for (uint32_t& bin : histogram) {
+        data >> bin;
+    }
+
+    data >> steps_ms;
+}
@@ -1,46 +1,131 @@
 /// HEADER
 #include <csapex/profiling/timer.h>
 
+/// COMPONENT
+#include <csapex/profiling/tracer.h>
+
 /// SYSTEM
+#include <algorithm>
 #include <assert.h>
 
 using namespace csapex;
 
-Timer::Timer(const std::string& name, bool enabled) : timer_name_(name), root_(new Interval(name)), enabled_(enabled), dirty_(false), finished_(true)
+namespace
+{
+// a closed step stores a flag, the lower bits of the generation that closed it and its duration in one word
+const uint64_t END_CLOSED = 1ull << 63;
+const int END_GENERATION_SHIFT = 40;
+const uint64_t END_GENERATION_MASK = (1ull << 23) - 1;
+// durations are limited to about 18 minutes
+const uint64_t END_DURATION_MASK = (1ull << END_GENERATION_SHIFT) - 1;
+
+uint64_t packEnd(uint32_t generation, uint64_t duration_ns)
+{
+    return END_CLOSED | ((generation & END_GENERATION_MASK) << END_GENERATION_SHIFT) | std::min(duration_ns, END_DURATION_MASK);
+}
+
+bool isClosedIn(uint64_t end, uint32_t generation)
 {
+    return (end & END_CLOSED) && ((end >> END_GENERATION_SHIFT) & END_GENERATION_MASK) == (generation & END_GENERATION_MASK);
+}
+}  // namespace
+
+Timer::Timer(const std::string& name, bool enabled)
+  : timer_name_(name)
+  , root_(new Interval(name))
+  , steps_(new Step[STEP_CAPACITY])
+  , step_count_(0)
+  , generation_(0)
+  , dropped_steps_(0)
+  , enabled_(enabled)
+  , dirty_(false)
+  , finished_(true)
+  , trace_name_(0)
+  , trace_begin_ns_(0)
+{
+    step_intervals_.reserve(STEP_CAPACITY);
     restart();
 }
 Timer::~Timer()
 {
 }
 
-Interval::Ptr Timer::pushInterval(const std::string& name)
+int Timer::openStep(uint32_t name, int parent, uint32_t generation, uint64_t begin_ns)
 {
-    Interval::Ptr result;
-    {
-        std::unique_lock<std::mutex> lock(active_intervals_mutex_);
-        if (active_intervals_.empty()) {
-            active_intervals_.emplace_back(std::make_shared<Interval>(name));
-        }
-        auto& siblings = active_intervals_.back()->sub;
-        if (siblings.find(name) == siblings.end()) {
-            result = std::make_shared<Interval>(name);
-            siblings[name] = result;
-
-        } else {
-            result = siblings[name];
-        }
-        active_intervals_.push_back(result);
+    // checking first keeps the counter from growing for timers that are never restarted
+    if (step_count_.load(std::memory_order_relaxed) >= STEP_CAPACITY) {
+        dropped_steps_.fetch_add(1, std::memory_order_relaxed);
+        return -1;
+    }
+    uint32_t index = step_count_.fetch_add(1, std::memory_order_relaxed);
+    if (index >= STEP_CAPACITY) {
+        dropped_steps_.fetch_add(1, std::memory_order_relaxed);
+        return -1;
     }
 
-    result->start();
-    return result;
+    Step& step = steps_[index];
+    step.name = name;
+    step.parent = parent;
+    step.begin_ns = begin_ns;
+    step.end.store(0, std::memory_order_relaxed);
+    // publishes the step, a trace that was opened before a restart publishes it for the earlier run
+    step.generation.store(generation, std::memory_order_release);
+    return index;
 }
 
-void Timer::popInterval()
+void Timer::closeStep(int step, uint32_t generation, uint64_t begin_ns, uint64_t end_ns)
 {
-    std::unique_lock<std::mutex> lock(active_intervals_mutex_);
-    active_intervals_.pop_back();
+    // a step that outlives its run must not end a step of the next one, even if it passes this check before a restart
+    if (step >= 0 && generation == generation_.load(std::memory_order_acquire)) {
+        steps_[step].end.store(packEnd(generation, end_ns - begin_ns), std::memory_order_release);
+    }
+}
+
+void Timer::buildIntervals(uint64_t finish_ns)
+{
+    Tracer& tracer = Tracer::instance();
+
+    // steps are measured with the steady clock, intervals with the high resolution clock
+    auto offset = std::chrono::high_resolution_clock::now().time_since_epoch() - std::chrono::nanoseconds(finish_ns);
+
+    uint32_t generation = generation_.load(std::memory_order_acquire);
+    std::size_t count = std::min<std::size_t>(step_count_.load(std::memory_order_acquire), STEP_CAPACITY);
+    step_intervals_.clear();
+    for (std::size_t i = 0; i < count; ++i) {
+        const Step& step = steps_[i];
+
+        // the slot is claimed, but the step is not published yet or belongs to an earlier run
+        if (step.generation.load(std::memory_order_acquire) != generation) {
+            step_intervals_.push_back(nullptr);
+            continue;
+        }
+
+        // parents are opened before their children
+        Interval* parent = root_.get();
+        if (step.parent >= 0 && static_cast<std::size_t>(step.parent) < i && step_intervals_[step.parent]) {
+            parent = step_intervals_[step.parent];
+        }
+
+        // steps with the same name are accumulated, as long as they have the same parent
+        std::string name = tracer.getName(step.name);
+        Interval::Ptr& interval = parent->sub[name];
+        if (!interval) {
+            interval = std::make_shared<Interval>(name);
+        }
+
+        // steps that are still open end with the run
+        uint64_t end_ns = finish_ns;
+        uint64_t end = step.end.load(std::memory_order_acquire);
+        if (isClosedIn(end, generation)) {
+            end_ns = step.begin_ns + (end & END_DURATION_MASK);
+        }
+        interval->start_ = std::chrono::time_point<std::chrono::high_resolution_clock>(std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(offset + std::chrono::nanoseconds(step.begin_ns)));
+        interval->end_ = std::chrono::time_point<std::chrono::high_resolution_clock>(std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(offset + std::chrono::nanoseconds(end_ns)));
+        interval->length_micro_seconds_ += (end_ns - step.begin_ns) / 1000;
+        interval->stopped_ = true;
+
+        step_intervals_.push_back(interval.get());
+    }
 }
 
 void Timer::setActivity(bool active)
@@ -53,6 +138,11 @@ Interval::Ptr Timer::getRoot() const
     return root_;
 }
 
+std::size_t Timer::countDroppedSteps() const
+{
+    return dropped_steps_.load(std::memory_order_relaxed);
+}
+
 std::vector<std::pair<std::string, double> > Timer::entries() const
 {
     std::vector<std::pair<std::string, double> > result;
@@ -87,9 +177,17 @@ void Timer::restart()
     }
 
     root_.reset(new Interval(timer_name_));
-    {
-        std::unique_lock<std::mutex> lock(active_intervals_mutex_);
-        active_intervals_.push_back(root_);
+    generation_.fetch_add(1, std::memory_order_acq_rel);
+    step_count_.store(0, std::memory_order_release);
+
+    Tracer& tracer = Tracer::instance();
+    if (tracer.isEnabled()) {
+        if (trace_name_ == 0) {
+            trace_name_ = tracer.intern(timer_name_);
+        }
+        trace_begin_ns_ = Tracer::now();
+    } else {
+        trace_begin_ns_ = 0;
     }
 
     finished_ = false;
@@ -98,18 +196,18 @@ void Timer::restart()
 void Timer::finish()
 {
     finished_ = true;
-    {
-        std::unique_lock<std::mutex> lock(active_intervals_mutex_);
-        while (!active_intervals_.empty()) {
-            active_intervals_.back()->stop();
-            active_intervals_.pop_back();
-        }
-    }
+    root_->stop();
 
     if (dirty_) {
         dirty_ = false;
     } else {
         if (enabled_) {
+            uint64_t finish_ns = Tracer::now();
+            buildIntervals(finish_ns);
+
+            if (trace_begin_ns_ != 0) {
+                Tracer::instance().record(trace_name_, trace_begin_ns_, finish_ns);
+            }
             finished(root_);
         }
     }
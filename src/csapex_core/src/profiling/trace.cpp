@@ -3,9 +3,21 @@
 
 /// COMPONENT
 #include <csapex/profiling/timer.h>
+#include <csapex/profiling/tracer.h>
 
 using namespace csapex;
 
+namespace
+{
+// the innermost trace that is alive on this thread
+thread_local Trace::Scope current_scope{ nullptr, -1, 0 };
+
+bool operator==(const Trace::Scope& a, const Trace::Scope& b)
+{
+    return a.timer == b.timer && a.step == b.step && a.generation == b.generation;
+}
+}  // namespace
+
 Trace::Ptr Timer::step(const std::string& name)
 {
     return Trace::Ptr(new Trace(this, name));
@@ -14,16 +26,31 @@ Trace::Trace(const std::shared_ptr<Timer>& parent, const std::string& name) : Tr
 {
 }
 
-Trace::Trace(Timer* parent, const std::string& name) : timer_(parent)
+Trace::Trace(Timer* parent, const std::string& name) : timer_(parent), enclosing_(current_scope)
 {
-    // start new interval in timer
-    interval_ = timer_->pushInterval(name);
+    Tracer& tracer = Tracer::instance();
+    name_ = tracer.intern(name);
+    traced_ = tracer.isEnabled();
+    begin_ns_ = Tracer::now();
+
+    uint32_t generation = timer_->generation_.load(std::memory_order_acquire);
+    bool nested = enclosing_.timer == timer_ && enclosing_.generation == generation;
+
+    scope_ = Scope{ timer_, timer_->openStep(name_, nested ? enclosing_.step : -1, generation, begin_ns_), generation };
+    current_scope = scope_;
 }
 
 Trace::~Trace()
 {
-    if (!interval_->isStopped()) {
-        interval_->stop();
-        timer_->popInterval();
+    uint64_t end_ns = Tracer::now();
+    timer_->closeStep(scope_.step, scope_.generation, begin_ns_, end_ns);
+
+    // traces that end out of order leave the scope of the later one in place
+    if (current_scope == scope_) {
+        current_scope = enclosing_;
+    }
+
+    if (traced_) {
+        Tracer::instance().record(name_, begin_ns_, end_ns);
     }
 }
@@ -0,0 +1,296 @@
+/// HEADER
+#include <csapex/profiling/tracer.h>
+
+/// SYSTEM
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iomanip>
+
+using namespace csapex;
+
+/**
+ * @brief The Buffer struct is a single producer, single consumer ring buffer owned by one thread
+ */
+struct Tracer::Buffer
+{
+    Buffer(uint32_t thread) : head(0), tail(0), thread(thread), orphaned(false)
+    {
+    }
+
+    bool push(const TraceEvent& event)
+    {
+        uint64_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= BUFFER_CAPACITY) {
+            return false;
+        }
+        events[h % BUFFER_CAPACITY] = event;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename Container>
+    std::size_t pop(Container& out)
+    {
+        uint64_t t = tail.load(std::memory_order_relaxed);
+        uint64_t h = head.load(std::memory_order_acquire);
+        for (uint64_t i = t; i < h; ++i) {
+            out.push_back(events[i % BUFFER_CAPACITY]);
+        }
+        tail.store(h, std::memory_order_release);
+        return h - t;
+    }
+
+    std::array<TraceEvent, BUFFER_CAPACITY> events;
+    std::atomic<uint64_t> head;
+    std::atomic<uint64_t> tail;
+
+    const uint32_t thread;
+    std::atomic<bool> orphaned;
+};
+
+namespace
+{
+/// marks the buffer of a thread as orphaned when the thread ends, so that it can be released after the next drain
+struct LocalBuffer
+{
+    ~LocalBuffer()
+    {
+        if (buffer) {
+            buffer->orphaned = true;
+        }
+    }
+
+    std::shared_ptr<Tracer::Buffer> buffer;
+};
+
+thread_local LocalBuffer local_buffer;
+thread_local std::unordered_map<std::string, uint32_t> local_names;
+
+void writeEscaped(std::ostream& out, const std::string& str)
+{
+    for (char c : str) {
+        switch (c) {
+            case '"':
+                out << "\\\"";
+                break;
+            case '\\':
+                out << "\\\\";
+                break;
+            case '\n':
+                out << "\\n";
+                break;
+            case '\t':
+                out << "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec << std::setfill(' ');
+                } else {
+                    out << c;
+                }
+        }
+    }
+}
+}  // namespace
+
+Tracer::Tracer() : enabled_(false), origin_ns_(now()), next_thread_(1), max_events_(1000000), dropped_(0), draining_(false)
+{
+    // id 0 is reserved for unnamed spans
+    names_.push_back("");
+    name_ids_[""] = 0;
+}
+
+Tracer::~Tracer()
+{
+    stop();
+}
+
+void Tracer::shutdown()
+{
+    stop();
+}
+
+void Tracer::setEnabled(bool enabled)
+{
+    enabled_ = enabled;
+}
+
+void Tracer::start(std::chrono::milliseconds period)
+{
+    setEnabled(true);
+
+    std::unique_lock<std::mutex> lock(drain_mutex_);
+    if (draining_) {
+        return;
+    }
+    draining_ = true;
+
+    drain_thread_ = std::thread([this, period]() {
+        std::unique_lock<std::mutex> lock(drain_mutex_);
+        while (draining_) {
+            drain_changed_.wait_for(lock, period);
+            lock.unlock();
+            drain();
+            lock.lock();
+        }
+    });
+}
+
+void Tracer::stop()
+{
+    {
+        std::unique_lock<std::mutex> lock(drain_mutex_);
+        draining_ = false;
+        drain_changed_.notify_all();
+    }
+    if (drain_thread_.joinable()) {
+        drain_thread_.join();
+    }
+}
+
+uint32_t Tracer::intern(const std::string& name)
+{
+    auto local = local_names.find(name);
+    if (local != local_names.end()) {
+        return local->second;
+    }
+
+    uint32_t id;
+    {
+        std::unique_lock<std::mutex> lock(names_mutex_);
+        auto pos = name_ids_.find(name);
+        if (pos == name_ids_.end()) {
+            id = names_.size();
+            names_.push_back(name);
+            name_ids_[name] = id;
+        } else {
+            id = pos->second;
+        }
+    }
+
+    local_names[name] = id;
+    return id;
+}
+
+std::string Tracer::getName(uint32_t name) const
+{
+    std::unique_lock<std::mutex> lock(names_mutex_);
+    return name < names_.size() ? names_[name] : std::string();
+}
+
+Tracer::Buffer& Tracer::getLocalBuffer()
+{
+    if (!local_buffer.buffer) {
+        std::unique_lock<std::mutex> lock(buffers_mutex_);
+        local_buffer.buffer = std::make_shared<Buffer>(next_thread_++);
+        buffers_.push_back(local_buffer.buffer);
+    }
+    return *local_buffer.buffer;
+}
+
+void Tracer::record(uint32_t name, uint64_t begin_ns, uint64_t end_ns)
+{
+    Buffer& buffer = getLocalBuffer();
+    if (!buffer.push(TraceEvent{ begin_ns, end_ns, name, buffer.thread })) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+std::size_t Tracer::drain()
+{
+    std::vector<TraceEvent> drained;
+    {
+        std::unique_lock<std::mutex> lock(buffers_mutex_);
+        for (auto it = buffers_.begin(); it != buffers_.end();) {
+            Buffer& buffer = **it;
+            // read the flag first, the owning thread cannot record anymore once it is set
+            bool orphaned = buffer.orphaned;
+            buffer.pop(drained);
+            if (orphaned) {
+                it = buffers_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    if (drained.empty()) {
+        return 0;
+    }
+
+    std::unique_lock<std::mutex> lock(events_mutex_);
+    events_.insert(events_.end(), drained.begin(), drained.end());
+    if (events_.size() > max_events_) {
+        std::size_t overflow = events_.size() - max_events_;
+        dropped_.fetch_add(overflow, std::memory_order_relaxed);
+        events_.erase(events_.begin(), events_.begin() + overflow);
+    }
+    return drained.size();
+}
+
+std::vector<TraceEvent> Tracer::getEvents() const
+{
+    std::unique_lock<std::mutex> lock(events_mutex_);
+    return std::vector<TraceEvent>(events_.begin(), events_.end());
+}
+
+void Tracer::setHistoryLength(std::size_t max_events)
+{
+    std::unique_lock<std::mutex> lock(events_mutex_);
+    max_events_ = max_events;
+}
+
+void Tracer::clear()
+{
+    drain();
+
+    std::unique_lock<std::mutex> lock(events_mutex_);
+    events_.clear();
+    dropped_ = 0;
+}
+
+std::size_t Tracer::countDroppedEvents() const
+{
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+void Tracer::writeChromeTrace(std::ostream& out)
+{
+    drain();
+
+    std::vector<TraceEvent> events = getEvents();
+    std::sort(events.begin(), events.end(), [](const TraceEvent& a, const TraceEvent& b) { return a.begin_ns < b.begin_ns; });
+
+    std::vector<std::string> names;
+    {
+        std::unique_lock<std::mutex> lock(names_mutex_);
+        names = names_;
+    }
+
+    // timestamps are given in microseconds relative to the creation of the tracer
+    auto micro = [this](uint64_t ns) { return (static_cast<int64_t>(ns) - static_cast<int64_t>(origin_ns_)) * 1e-3; };
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const TraceEvent& event : events) {
+        if (!first) {
+            out << ",";
+        }
+        first = false;
+
+        out << "\n{\"name\":\"";
+        writeEscaped(out, event.name < names.size() ? names[event.name] : std::string());
+        out << "\",\"cat\":\"csapex\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread;
+        out << ",\"ts\":" << micro(event.begin_ns);
+        out << ",\"dur\":" << (event.end_ns - event.begin_ns) * 1e-3 << "}";
+    }
+    out << "\n]}\n";
+}
+
+void Tracer::writeChromeTrace(const std::string& file)
+{
+    std::ofstream out(file);
+    writeChromeTrace(out);
+}
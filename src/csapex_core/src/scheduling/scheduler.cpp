@@ -6,3 +6,21 @@ using namespace csapex;
 Scheduler::~Scheduler()
 {
 }
+
+void Scheduler::setSchedulingPolicy(SchedulingPolicy /*policy*/)
+{
+}
+
+SchedulingPolicy Scheduler::getSchedulingPolicy() const
+{
+    return SchedulingPolicy::FIFO;
+}
+
+void Scheduler::setChainFusion(bool /*fusion*/)
+{
+}
+
+bool Scheduler::isChainFusionEnabled() const
+{
+    return false;
+}
@@ -48,3 +48,8 @@ void Task::setScheduled(bool scheduled)
 {
     scheduled_ = scheduled;
 }
+
+bool Task::markScheduled()
+{
+    return !scheduled_.exchange(true);
+}
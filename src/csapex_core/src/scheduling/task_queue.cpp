@@ -0,0 +1,118 @@
+/// HEADER
+#include <csapex/scheduling/task_queue.h>
+
+/// PROJECT
+#include <csapex/scheduling/task.h>
+
+using namespace csapex;
+
+struct TaskQueue::Node
+{
+    Node() : next(nullptr)
+    {
+    }
+    explicit Node(const TaskPtr& task) : task(task), next(nullptr)
+    {
+    }
+
+    TaskPtr task;
+    std::atomic<Node*> next;
+};
+
+bool TaskQueue::greater::operator()(const TaskPtr& a, const TaskPtr& b) const
+{
+    return a->getPriority() > b->getPriority();
+}
+
+TaskQueue::TaskQueue() : head_(new Node), tail_(head_.load())
+{
+}
+
+TaskQueue::~TaskQueue()
+{
+    clear();
+    delete tail_;
+}
+
+bool TaskQueue::push(const TaskPtr& task)
+{
+    if (!task->markScheduled()) {
+        return false;
+    }
+
+    Node* node = new Node(task);
+    Node* prev = head_.exchange(node);
+    // between the exchange and this store the consumer sees the queue as empty
+    prev->next.store(node);
+
+    return true;
+}
+
+void TaskQueue::drainInbox()
+{
+    // requires consumer_mtx_
+    Node* next = tail_->next.load();
+    while (next) {
+        // multiset inserts equal priorities at the end, which keeps FIFO order
+        ready_.insert(std::move(next->task));
+
+        delete tail_;
+        tail_ = next;
+        next = tail_->next.load();
+    }
+}
+
+TaskPtr TaskQueue::pop()
+{
+    std::unique_lock<std::mutex> lock(consumer_mtx_);
+    drainInbox();
+
+    if (ready_.empty()) {
+        return nullptr;
+    }
+
+    TaskPtr task = *ready_.begin();
+    ready_.erase(ready_.begin());
+
+    task->setScheduled(false);
+
+    return task;
+}
+
+bool TaskQueue::empty()
+{
+    std::unique_lock<std::mutex> lock(consumer_mtx_);
+    return ready_.empty() && tail_->next.load() == nullptr;
+}
+
+std::vector<TaskPtr> TaskQueue::removeIf(const std::function<bool(const TaskPtr&)>& predicate)
+{
+    std::vector<TaskPtr> removed;
+
+    std::unique_lock<std::mutex> lock(consumer_mtx_);
+    drainInbox();
+
+    for (auto it = ready_.begin(); it != ready_.end();) {
+        const TaskPtr& task = *it;
+        if (predicate(task)) {
+            task->setScheduled(false);
+            removed.push_back(task);
+            it = ready_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    return removed;
+}
+
+void TaskQueue::clear()
+{
+    std::unique_lock<std::mutex> lock(consumer_mtx_);
+    drainInbox();
+
+    for (const TaskPtr& task : ready_) {
+        task->setScheduled(false);
+    }
+    ready_.clear();
+}
@@ -10,8 +10,10 @@
 #include <csapex/utility/exceptions.h>
 #include <csapex/core/exception_handler.h>
 #include <csapex/scheduling/timed_queue.h>
+#include <csapex/scheduling/worker_pool.h>
 #include <csapex/profiling/profiler.h>
 #include <csapex/profiling/trace.h>
+#include <csapex/profiling/tracer.h>
 #include <csapex/utility/yaml.h>
 
 /// SYSTEM
@@ -19,16 +21,28 @@
 
 using namespace csapex;
 
+namespace
+{
+thread_local ThreadGroup* current_group = nullptr;
+}  // namespace
+
+struct ThreadGroup::Strand
+{
+    // all tasks of one generator, at most one of them is executed at any time
+    std::multiset<TaskPtr, greater> tasks;
+    bool active = false;
+};
+
 int ThreadGroup::next_id_ = ThreadGroup::MINIMUM_THREAD_ID;
 
 ThreadGroup::ThreadGroup(TimedQueuePtr timed_queue, ExceptionHandler& handler, int id, std::string name)
-  : handler_(handler), destroyed_(false), id_(id), name_(name), cpu_affinity_(new CpuAffinity), timed_queue_(timed_queue), running_(false), pause_(false), stepping_(false)
+  : handler_(handler), destroyed_(false), id_(id), name_(name), cpu_affinity_(new CpuAffinity), timed_queue_(timed_queue), dispatch_epoch_(0), executing_tasks_(0), exclusive_sections_(0), waiting_for_work_(false), running_(false), pause_(false), stepping_(false), scheduling_policy_(SchedulingPolicy::FIFO), chain_fusion_(false)
 {
     next_id_ = std::max(next_id_, id + 1);
     setup();
 }
 ThreadGroup::ThreadGroup(TimedQueuePtr timed_queue, ExceptionHandler& handler, std::string name)
-  : handler_(handler), destroyed_(false), id_(next_id_++), name_(name), cpu_affinity_(new CpuAffinity), timed_queue_(timed_queue), running_(false), pause_(false), stepping_(false)
+  : handler_(handler), destroyed_(false), id_(next_id_++), name_(name), cpu_affinity_(new CpuAffinity), timed_queue_(timed_queue), dispatch_epoch_(0), executing_tasks_(0), exclusive_sections_(0), waiting_for_work_(false), running_(false), pause_(false), stepping_(false), scheduling_policy_(SchedulingPolicy::FIFO), chain_fusion_(false)
 {
     setup();
 }
@@ -116,6 +130,26 @@ bool ThreadGroup::isEmpty() const
     return generators_.empty();
 }
 
+void ThreadGroup::setSchedulingPolicy(SchedulingPolicy policy)
+{
+    scheduling_policy_ = policy;
+}
+
+SchedulingPolicy ThreadGroup::getSchedulingPolicy() const
+{
+    return scheduling_policy_;
+}
+
+void ThreadGroup::setChainFusion(bool fusion)
+{
+    chain_fusion_ = fusion;
+}
+
+bool ThreadGroup::isChainFusionEnabled() const
+{
+    return chain_fusion_;
+}
+
 void ThreadGroup::setPause(bool pause)
 {
     if (pause != pause_) {
@@ -127,6 +161,12 @@ void ThreadGroup::setPause(bool pause)
 
         std::unique_lock<std::recursive_mutex> lock(state_mtx_);
         pause_changed_.notify_all();
+        lock.unlock();
+
+        if (worker_pool_ && !pause_) {
+            std::unique_lock<std::recursive_mutex> tasks_lock(tasks_mtx_);
+            resumeParkedStrands();
+        }
     }
 }
 
@@ -154,6 +194,23 @@ void ThreadGroup::step()
 {
     begin_step();
 
+    if (worker_pool_) {
+        // no task of this group may run while the generators are stepped
+        std::unique_lock<std::recursive_mutex> tasks_lock(tasks_mtx_);
+        ++exclusive_sections_;
+        waitForIdleWorkers(tasks_lock);
+        tasks_lock.unlock();
+
+        for (auto generator : generators_) {
+            generator->step();
+        }
+
+        tasks_lock.lock();
+        --exclusive_sections_;
+        resumeParkedStrands();
+        return;
+    }
+
     std::unique_lock<std::recursive_mutex> state_lock(execution_mtx_);
     for (auto generator : generators_) {
         generator->step();
@@ -209,6 +266,16 @@ void ThreadGroup::start()
 
     running_ = true;
 
+    if (worker_pool_) {
+        lock.unlock();
+
+        std::unique_lock<std::recursive_mutex> tasks_lock(tasks_mtx_);
+        for (const auto& pair : strands_) {
+            dispatch(pair.second);
+        }
+        return;
+    }
+
     scheduler_thread_ = std::thread([this]() {
         csapex::thread::set_name((name_).c_str());
         updateAffinity();
@@ -224,12 +291,23 @@ void ThreadGroup::stop()
         running_ = false;
         pause_changed_.notify_all();
     }
-    {
+    if (worker_pool_) {
+        std::unique_lock<std::recursive_mutex> lock(tasks_mtx_);
+        waitForIdleWorkers(lock);
+
+        // jobs that are still queued in the pool belong to an old epoch and are ignored
+        ++dispatch_epoch_;
+        for (const auto& pair : strands_) {
+            pair.second->active = false;
+        }
+        parked_strands_.clear();
+    } else {
         std::unique_lock<std::recursive_mutex> state_lock(execution_mtx_);
     }
     {
+        notifyWorkAvailable();
+
         std::unique_lock<std::recursive_mutex> lock(tasks_mtx_);
-        work_available_.notify_all();
         if (scheduler_thread_.joinable()) {
             lock.unlock();
 
@@ -259,6 +337,29 @@ void ThreadGroup::clear()
     {
         std::unique_lock<std::recursive_mutex> lock(tasks_mtx_);
         tasks_.clear();
+
+        for (const auto& pair : strands_) {
+            for (const TaskPtr& task : pair.second->tasks) {
+                task->setScheduled(false);
+            }
+            pair.second->tasks.clear();
+        }
+    }
+
+    if (worker_pool_) {
+        std::unique_lock<std::recursive_mutex> tasks_lock(tasks_mtx_);
+        ++exclusive_sections_;
+        waitForIdleWorkers(tasks_lock);
+        tasks_lock.unlock();
+
+        for (auto generator : generators_) {
+            generator->reset();
+        }
+
+        tasks_lock.lock();
+        --exclusive_sections_;
+        resumeParkedStrands();
+        return;
     }
 
     std::unique_lock<std::recursive_mutex> state_lock(execution_mtx_);
@@ -290,8 +391,6 @@ void ThreadGroup::add(TaskGeneratorPtr generator, const std::vector<TaskPtr>& in
     for (const TaskPtr& t : initial_tasks) {
         schedule(t);
     }
-
-    work_available_.notify_all();
 }
 
 void ThreadGroup::checkIfStepIsDone()
@@ -305,20 +404,20 @@ void ThreadGroup::checkIfStepIsDone()
 
 std::vector<TaskPtr> ThreadGroup::remove(TaskGenerator* generator)
 {
-    std::vector<TaskPtr> remaining_tasks;
-
     std::unique_lock<std::recursive_mutex> lock(tasks_mtx_);
 
     TaskGeneratorPtr removed;
 
-    for (auto it = tasks_.begin(); it != tasks_.end();) {
-        TaskPtr task = *it;
-        if (task->getParent() == generator) {
+    std::vector<TaskPtr> remaining_tasks = tasks_.removeIf([generator](const TaskPtr& task) { return task->getParent() == generator; });
+
+    auto strand = strands_.find(generator);
+    if (strand != strands_.end()) {
+        for (const TaskPtr& task : strand->second->tasks) {
+            task->setScheduled(false);
             remaining_tasks.push_back(task);
-            it = tasks_.erase(it);
-        } else {
-            ++it;
         }
+        strand->second->tasks.clear();
+        strands_.erase(strand);
     }
 
     for (auto it = generators_.begin(); it != generators_.end();) {
@@ -330,8 +429,6 @@ std::vector<TaskPtr> ThreadGroup::remove(TaskGenerator* generator)
         }
     }
 
-    work_available_.notify_all();
-
     generator_connections_[generator].clear();
 
     generator_removed(removed);
@@ -343,26 +440,37 @@ void ThreadGroup::schedule(TaskPtr task)
 {
     apex_assert_hard(!destroyed_);
 
-    std::unique_lock<std::recursive_mutex> tasks_lock(tasks_mtx_);
+    if (worker_pool_) {
+        std::unique_lock<std::recursive_mutex> tasks_lock(tasks_mtx_);
+        if (!task->markScheduled()) {
+            return;
+        }
 
-    if (!tasks_.empty()) {
-        //        for(const TaskPtr& t : tasks_) {
-        for (auto it = tasks_.begin(); it != tasks_.end(); ++it) {
-            const TaskPtr& t = *it;
-            if (t.get() == task.get()) {
-                return;
-            }
+        StrandPtr& strand = strands_[task->getParent()];
+        if (!strand) {
+            strand = std::make_shared<Strand>();
         }
-    }
+        strand->tasks.insert(task);
 
-    tasks_.insert(task);
+        dispatch(strand);
+        return;
+    }
 
-    task->setScheduled(true);
+    if (tasks_.push(task)) {
+        notifyWorkAvailable();
+    }
+}
 
-    work_available_.notify_all();
+void ThreadGroup::notifyWorkAvailable()
+{
+    // only take the lock if the scheduler thread might be sleeping
+    if (waiting_for_work_) {
+        std::unique_lock<std::mutex> lock(work_available_mtx_);
+        work_available_.notify_all();
+    }
 }
 
-void ThreadGroup::scheduleDelayed(TaskPtr schedulable, std::chrono::system_clock::time_point time)
+void ThreadGroup::scheduleDelayed(TaskPtr schedulable, std::chrono::steady_clock::time_point time)
 {
     timed_queue_->schedule(shared_from_this(), schedulable, time);
 }
@@ -381,14 +489,17 @@ void ThreadGroup::schedulingLoop()
 
 bool ThreadGroup::waitForTasks()
 {
-    std::unique_lock<std::recursive_mutex> lock(tasks_mtx_);
+    std::unique_lock<std::mutex> lock(work_available_mtx_);
+    waiting_for_work_ = true;
     while (tasks_.empty()) {
         work_available_.wait_for(lock, std::chrono::seconds(1));
 
         if (!running_) {
+            waiting_for_work_ = false;
             return false;
         }
     }
+    waiting_for_work_ = false;
 
     return true;
 }
@@ -403,23 +514,14 @@ void ThreadGroup::handlePause()
 
 bool ThreadGroup::executeNextTask()
 {
-    std::unique_lock<std::recursive_mutex> tasks_lock(tasks_mtx_);
-    if (!tasks_.empty()) {
-        TaskPtr task = *tasks_.begin();
-        tasks_.erase(tasks_.begin());
-
-        task->setScheduled(false);
+    TaskPtr task = tasks_.pop();
+    if (task) {
+        std::unique_lock<std::recursive_mutex> state_lock(state_mtx_);
+        if (running_) {
+            state_lock.unlock();
 
-        tasks_lock.unlock();
-
-        {
-            std::unique_lock<std::recursive_mutex> state_lock(state_mtx_);
-            if (running_) {
-                state_lock.unlock();
-
-                executeTask(task);
-                return true;
-            }
+            executeTask(task);
+            return true;
         }
     }
 
@@ -429,7 +531,10 @@ bool ThreadGroup::executeNextTask()
 void ThreadGroup::executeTask(const TaskPtr& task)
 {
     try {
-        std::unique_lock<std::recursive_mutex> state_lock(execution_mtx_);
+        std::unique_lock<std::recursive_mutex> state_lock(execution_mtx_, std::defer_lock);
+        if (!worker_pool_) {
+            state_lock.lock();
+        }
         ProfilerPtr profiler = getProfiler();
         Trace::Ptr interlude;
         if (profiler && profiler->isEnabled()) {
@@ -437,6 +542,10 @@ void ThreadGroup::executeTask(const TaskPtr& task)
             interlude.reset(new Trace(timer, task->getName()));
         }
 
+        // a profiler step is recorded with the tracer as well, the task must not be recorded twice
+        Tracer& tracer = Tracer::instance();
+        TraceSpan span(!interlude && tracer.isEnabled() ? tracer.intern(task->getName()) : 0, !interlude);
+
         task->execute();
 
     } catch (const std::exception& e) {
@@ -456,6 +565,110 @@ void ThreadGroup::executeTask(const TaskPtr& task)
     }
 }
 
+void ThreadGroup::useWorkerPool(WorkerPoolPtr pool)
+{
+    apex_assert_hard(!scheduler_thread_.joinable());
+
+    std::unique_lock<std::recursive_mutex> tasks_lock(tasks_mtx_);
+    worker_pool_ = pool;
+
+    // hand over everything that has been scheduled so far
+    for (const TaskPtr& task : tasks_.removeIf([](const TaskPtr&) { return true; })) {
+        schedule(task);
+    }
+}
+
+WorkerPoolPtr ThreadGroup::getWorkerPool() const
+{
+    return worker_pool_;
+}
+
+void ThreadGroup::dispatch(const StrandPtr& strand)
+{
+    // requires tasks_mtx_
+    if (strand->active || strand->tasks.empty() || !running_) {
+        return;
+    }
+
+    strand->active = true;
+
+    ThreadGroupWeakPtr self_weak = shared_from_this();
+    long epoch = dispatch_epoch_;
+    // the strand competes with the strands of all groups with the priority of its next task
+    long priority = (*strand->tasks.begin())->getPriority();
+    worker_pool_->post(
+        [self_weak, strand, epoch]() {
+            if (ThreadGroupPtr self = self_weak.lock()) {
+                self->executeStrand(strand, epoch);
+            }
+        },
+        id_ >= DEFAULT_GROUP_ID ? id_ : -1, priority);
+}
+
+void ThreadGroup::executeStrand(const StrandPtr& strand, long epoch)
+{
+    std::unique_lock<std::recursive_mutex> tasks_lock(tasks_mtx_);
+    if (epoch != dispatch_epoch_) {
+        return;
+    }
+    if (!running_ || strand->tasks.empty()) {
+        strand->active = false;
+        return;
+    }
+    if (pause_ || exclusive_sections_ > 0) {
+        // keep the strand active, it is dispatched again on resume
+        parked_strands_.push_back(strand);
+        return;
+    }
+
+    TaskPtr task = *strand->tasks.begin();
+    strand->tasks.erase(strand->tasks.begin());
+    task->setScheduled(false);
+
+    ++executing_tasks_;
+    tasks_lock.unlock();
+
+    ThreadGroup* outer_group = current_group;
+    current_group = this;
+    executeTask(task);
+    current_group = outer_group;
+
+    tasks_lock.lock();
+    --executing_tasks_;
+    workers_idle_.notify_all();
+
+    if (epoch != dispatch_epoch_) {
+        return;
+    }
+
+    strand->active = false;
+    dispatch(strand);
+}
+
+void ThreadGroup::resumeParkedStrands()
+{
+    // requires tasks_mtx_
+    if (pause_ || exclusive_sections_ > 0) {
+        return;
+    }
+
+    std::vector<StrandPtr> parked;
+    parked.swap(parked_strands_);
+    for (const StrandPtr& strand : parked) {
+        strand->active = false;
+        dispatch(strand);
+    }
+}
+
+void ThreadGroup::waitForIdleWorkers(std::unique_lock<std::recursive_mutex>& lock)
+{
+    // a task of this group might be the caller, it cannot wait for itself
+    int own_tasks = current_group == this ? 1 : 0;
+    while (executing_tasks_ > own_tasks) {
+        workers_idle_.wait(lock);
+    }
+}
+
 std::vector<TaskGeneratorPtr>::iterator ThreadGroup::begin()
 {
     return generators_.begin();
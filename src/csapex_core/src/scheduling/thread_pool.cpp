@@ -8,6 +8,7 @@
 #include <csapex/scheduling/task.h>
 #include <csapex/scheduling/task_generator.h>
 #include <csapex/scheduling/timed_queue.h>
+#include <csapex/scheduling/worker_pool.h>
 #include <csapex/utility/cpu_affinity.h>
 
 /// SYSTEM
@@ -18,14 +19,14 @@
 using namespace csapex;
 
 ThreadPool::ThreadPool(ExceptionHandler& handler, bool enable_threading, bool grouping, bool initially_paused)
-  : handler_(handler), timed_queue_(new TimedQueue), enable_threading_(enable_threading), grouping_(grouping), private_group_cpu_affinity_(new CpuAffinity), suppress_exceptions_(true)
+  : handler_(handler), timed_queue_(new TimedQueue), scheduling_policy_(SchedulingPolicy::FIFO), chain_fusion_(false), enable_threading_(enable_threading), grouping_(grouping), private_group_cpu_affinity_(new CpuAffinity), suppress_exceptions_(true)
 {
     setPause(initially_paused);
     setup();
 }
 
 ThreadPool::ThreadPool(Executor* parent, ExceptionHandler& handler, bool enable_threading, bool grouping, bool initially_paused)
-  : handler_(handler), enable_threading_(enable_threading), grouping_(grouping), private_group_cpu_affinity_(new CpuAffinity), suppress_exceptions_(true)
+  : handler_(handler), scheduling_policy_(SchedulingPolicy::FIFO), chain_fusion_(false), enable_threading_(enable_threading), grouping_(grouping), private_group_cpu_affinity_(new CpuAffinity), suppress_exceptions_(true)
 {
     setPause(initially_paused);
     setup();
@@ -35,6 +36,8 @@ void ThreadPool::setup()
 {
     default_group_ = std::make_shared<ThreadGroup>(timed_queue_, handler_, ThreadGroup::DEFAULT_GROUP_ID, "default");
     default_group_->useProfiler(getProfiler());
+    default_group_->setSchedulingPolicy(scheduling_policy_);
+    default_group_->setChainFusion(chain_fusion_);
     default_group_->setPause(isPaused());
 
     groups_.push_back(default_group_);
@@ -60,6 +63,52 @@ bool ThreadPool::isGroupingEnabled() const
     return grouping_;
 }
 
+void ThreadPool::enableWorkStealing(std::size_t worker_count)
+{
+    apex_assert_hard(!isRunning());
+
+    worker_pool_ = std::make_shared<WorkerPool>(worker_count);
+    for (const ThreadGroupPtr& group : groups_) {
+        group->useWorkerPool(worker_pool_);
+    }
+}
+
+bool ThreadPool::isWorkStealingEnabled() const
+{
+    return worker_pool_ != nullptr;
+}
+
+WorkerPoolPtr ThreadPool::getWorkerPool() const
+{
+    return worker_pool_;
+}
+
+void ThreadPool::setSchedulingPolicy(SchedulingPolicy policy)
+{
+    scheduling_policy_ = policy;
+    for (const ThreadGroupPtr& group : groups_) {
+        group->setSchedulingPolicy(policy);
+    }
+}
+
+SchedulingPolicy ThreadPool::getSchedulingPolicy() const
+{
+    return scheduling_policy_;
+}
+
+void ThreadPool::setChainFusion(bool fusion)
+{
+    chain_fusion_ = fusion;
+    for (const ThreadGroupPtr& group : groups_) {
+        group->setChainFusion(fusion);
+    }
+}
+
+bool ThreadPool::isChainFusionEnabled() const
+{
+    return chain_fusion_;
+}
+
 void ThreadPool::performStep()
 {
     if (!default_group_->isEmpty() || groups_.size() > 1) {
@@ -74,6 +123,9 @@ void ThreadPool::start()
     if (timed_queue_) {
         timed_queue_->start();
     }
+    if (worker_pool_) {
+        worker_pool_->start();
+    }
     for (auto g : groups_) {
         g->start();
     }
@@ -90,6 +142,9 @@ void ThreadPool::stop()
     for (auto g : groups_) {
         g->stop();
     }
+    if (worker_pool_) {
+        worker_pool_->stop();
+    }
     group_assignment_.clear();
     groups_.clear();
     apex_assert_hard(group_assignment_.empty());
@@ -250,6 +305,11 @@ void ThreadPool::usePrivateThreadFor(TaskGenerator* task)
 
         group->getCpuAffinity()->set(private_group_cpu_affinity_->get());
 
+        if (worker_pool_) {
+            group->useWorkerPool(worker_pool_);
+        }
+        group->setSchedulingPolicy(scheduling_policy_);
+        group->setChainFusion(chain_fusion_);
         group->setPause(isPaused());
         group->useProfiler(getProfiler());
 
@@ -324,6 +384,11 @@ ThreadGroup* ThreadPool::createGroup(const std::string& name, int id)
     } else {
         group = std::make_shared<ThreadGroup>(timed_queue_, handler_, name);
     }
+    if (worker_pool_) {
+        group->useWorkerPool(worker_pool_);
+    }
+    group->setSchedulingPolicy(scheduling_policy_);
+    group->setChainFusion(chain_fusion_);
     group->setPause(isPaused());
     group->useProfiler(getProfiler());
 
@@ -449,6 +514,11 @@ void ThreadPool::loadSettings(YAML::Node& node)
                     std::string group_name = group["name"].as<std::string>();
 
                     auto g = std::make_shared<ThreadGroup>(timed_queue_, handler_, group_id, group_name);
+                    if (worker_pool_) {
+                        g->useWorkerPool(worker_pool_);
+                    }
+                    g->setSchedulingPolicy(scheduling_policy_);
+                    g->setChainFusion(chain_fusion_);
                     g->setPause(isPaused());
                     g->useProfiler(getProfiler());
 
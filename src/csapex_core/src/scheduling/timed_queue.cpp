@@ -6,9 +6,20 @@
 #include <csapex/scheduling/task.h>
 #include <csapex/utility/thread.h>
 
+/// SYSTEM
+#include <algorithm>
+#include <limits>
+
 using namespace csapex;
 
-TimedQueue::TimedQueue() : scheduling_running_(false), sleeping_running_(false)
+namespace
+{
+const std::int64_t NO_DEADLINE = std::numeric_limits<std::int64_t>::max();
+}
+
+constexpr std::size_t TimedQueue::SLOT_COUNT;
+
+TimedQueue::TimedQueue() : running_(false), epoch_(clock::now()), current_tick_(0), next_wake_up_tick_(NO_DEADLINE), pending_(0), slots_(SLOT_COUNT)
 {
 }
 TimedQueue::~TimedQueue()
@@ -18,121 +29,160 @@ TimedQueue::~TimedQueue()
 
 void TimedQueue::start()
 {
-    next_wake_up_ = std::chrono::system_clock::now();
+    std::unique_lock<std::mutex> lock(mtx_);
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    timer_thread_ = std::thread([this]() { loop(); });
+}
 
-    // this thread schedules tasks that have expired
-    scheduling_running_ = true;
-    scheduling_thread_ = std::thread([this]() { loop(); });
+void TimedQueue::stop()
+{
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        running_ = false;
+        wheel_changed_.notify_all();
+    }
+    if (timer_thread_.joinable()) {
+        timer_thread_.join();
+    }
+}
 
-    // this thread sleeps until the time given by 'next_wake_up_' is reached.
-    // it then wakes up the scheduling thread
-    sleeping_running_ = true;
-    sleeping_thread_ = std::thread([this]() { sleep(); });
+std::size_t TimedQueue::size()
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+    return pending_;
 }
 
-void TimedQueue::stop()
+std::int64_t TimedQueue::ticksUntil(clock::time_point time) const
 {
-    if (scheduling_thread_.joinable()) {
-        {
-            std::unique_lock<std::mutex> lock(task_mtx_);
-            scheduling_running_ = false;
-        }
-        apex_assert_eq_hard(false, scheduling_running_);
-        tasks_changed_.notify_all();
-        apex_assert_eq_hard(false, scheduling_running_);
-        scheduling_thread_.join();
+    // round up, a task must never be scheduled before its time
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(time - epoch_).count();
+    return (us + 999) / 1000;
+}
+
+TimedQueue::clock::time_point TimedQueue::timeOf(std::int64_t tick) const
+{
+    return epoch_ + std::chrono::milliseconds(tick);
+}
+
+void TimedQueue::schedule(SchedulerPtr scheduler, TaskPtr schedulable, clock::time_point time)
+{
+    if (time <= clock::now()) {
+        scheduler->schedule(schedulable);
+        return;
     }
-    if (sleeping_thread_.joinable()) {
-        {
-            std::unique_lock<std::mutex> lock(sleep_mtx_);
-            sleeping_running_ = false;
-        }
-        apex_assert_eq_hard(false, sleeping_running_);
-        next_wake_up_changed_.notify_all();
-        apex_assert_eq_hard(false, sleeping_running_);
-        sleeping_thread_.join();
+
+    std::unique_lock<std::mutex> lock(mtx_);
+
+    // the tick has to be compared with current_tick_ under the lock, a tick that has already
+    // been expired would otherwise only be found again after a full rotation
+    const std::int64_t tick = ticksUntil(time);
+    if (tick <= current_tick_) {
+        lock.unlock();
+        scheduler->schedule(schedulable);
+        return;
+    }
+
+    Unit unit;
+    unit.scheduler = scheduler;
+    unit.schedulable = schedulable;
+    unit.tick = tick;
+
+    slots_[tick % SLOT_COUNT].push_back(std::move(unit));
+    ++pending_;
+
+    if (tick < next_wake_up_tick_) {
+        // the timer thread sleeps too long -> wake it up to recompute the deadline
+        next_wake_up_tick_ = tick;
+        wheel_changed_.notify_all();
     }
 }
 
 void TimedQueue::loop()
 {
-    csapex::thread::set_name("queue:exec");
-
-    std::unique_lock<std::mutex> lock(task_mtx_);
-    while (scheduling_running_) {
-        // wait until a task is available
-        while (tasks_.empty()) {
-            tasks_changed_.wait_for(lock, std::chrono::milliseconds(100));
-            if (!scheduling_running_) {
-                return;
-            }
-        }
+    csapex::thread::set_name("queue:timer");
 
-        // schedule all tasks that have expired
-        while (!tasks_.empty()) {
-            const Unit& front = *tasks_.begin();
+    std::vector<Unit> expired;
 
-            auto now = std::chrono::system_clock::now();
-            if (now >= front.time) {
-                Unit unit = front;
-                tasks_.erase(tasks_.begin());
-                lock.unlock();
+    std::unique_lock<std::mutex> lock(mtx_);
+    while (running_) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - epoch_).count();
+        advance(elapsed, expired);
 
+        if (!expired.empty()) {
+            lock.unlock();
+            for (const Unit& unit : expired) {
                 unit.scheduler->schedule(unit.schedulable);
-
-                lock.lock();
-            } else {
-                break;
             }
+            expired.clear();
+            lock.lock();
+            continue;
         }
 
-        // notify the sleeping thread, if there are remaining tasks
-        if (!tasks_.empty()) {
-            Unit front = *tasks_.begin();
-            lock.unlock();
+        next_wake_up_tick_ = nextDeadline();
+        if (next_wake_up_tick_ == NO_DEADLINE) {
+            wheel_changed_.wait(lock);
+        } else {
+            wheel_changed_.wait_until(lock, timeOf(next_wake_up_tick_));
+        }
+    }
+}
 
-            {
-                std::unique_lock<std::mutex> lock(sleep_mtx_);
-                next_wake_up_ = front.time;
-                next_wake_up_changed_.notify_all();
-            }
+void TimedQueue::advance(std::int64_t tick, std::vector<Unit>& expired)
+{
+    if (tick <= current_tick_) {
+        return;
+    }
 
-            lock.lock();
+    if (pending_ > 0) {
+        if (tick - current_tick_ >= static_cast<std::int64_t>(SLOT_COUNT)) {
+            // at least one full rotation has passed
+            for (std::size_t slot = 0; slot < SLOT_COUNT; ++slot) {
+                expireSlot(slot, tick, expired);
+            }
+        } else {
+            for (std::int64_t t = current_tick_ + 1; t <= tick; ++t) {
+                expireSlot(t % SLOT_COUNT, tick, expired);
+            }
         }
     }
+
+    current_tick_ = tick;
 }
 
-void TimedQueue::sleep()
+void TimedQueue::expireSlot(std::size_t slot, std::int64_t tick, std::vector<Unit>& expired)
 {
-    csapex::thread::set_name("queue:sleep");
-
-    std::unique_lock<std::mutex> lock(sleep_mtx_);
-    while (sleeping_running_) {
-        // wait for a sleep command
-        next_wake_up_changed_.wait(lock);
-
-        auto now = std::chrono::system_clock::now();
-        if (now < next_wake_up_) {
-            // the next sleep target is in the future -> sleep
-            std::this_thread::sleep_until(next_wake_up_);
-            tasks_changed_.notify_all();
+    std::vector<Unit>& units = slots_[slot];
+    for (std::size_t i = 0; i < units.size();) {
+        if (units[i].tick <= tick) {
+            expired.push_back(std::move(units[i]));
+            units[i] = std::move(units.back());
+            units.pop_back();
+            --pending_;
+        } else {
+            // due in a later rotation
+            ++i;
         }
     }
 }
 
-void TimedQueue::schedule(SchedulerPtr scheduler, TaskPtr schedulable, std::chrono::system_clock::time_point time)
+std::int64_t TimedQueue::nextDeadline() const
 {
-    Unit unit;
-    unit.scheduler = scheduler;
-    unit.schedulable = schedulable;
-    unit.time = time;
-
-    std::unique_lock<std::mutex> lock(task_mtx_);
-    auto front = tasks_.begin();
-    tasks_.insert(unit);
+    if (pending_ == 0) {
+        return NO_DEADLINE;
+    }
 
-    if (tasks_.begin() != front) {
-        // the earliest entry changed -> notify the scheduling thread immediately
-        tasks_changed_.notify_all();
+    std::int64_t next = NO_DEADLINE;
+    for (std::int64_t t = current_tick_ + 1, end = current_tick_ + SLOT_COUNT; t <= end; ++t) {
+        for (const Unit& unit : slots_[t % SLOT_COUNT]) {
+            next = std::min(next, unit.tick);
+        }
+        if (next == t) {
+            // no earlier slot is occupied
+            break;
+        }
     }
+    return next;
 }
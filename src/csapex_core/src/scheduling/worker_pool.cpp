@@ -0,0 +1,188 @@
+/// HEADER
+#include <csapex/scheduling/worker_pool.h>
+
+/// PROJECT
+#include <csapex/utility/thread.h>
+
+/// SYSTEM
+#include <algorithm>
+#include <iterator>
+#include <string>
+
+using namespace csapex;
+
+namespace
+{
+thread_local WorkerPool* current_pool = nullptr;
+thread_local std::size_t current_worker = 0;
+}  // namespace
+
+WorkerPool::WorkerPool(std::size_t worker_count) : running_(false), pending_(0), next_worker_(0), executed_(0), stolen_(0)
+{
+    if (worker_count == 0) {
+        worker_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (std::size_t i = 0; i < worker_count; ++i) {
+        workers_.emplace_back(new Worker);
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    stop();
+}
+
+std::size_t WorkerPool::getWorkerCount() const
+{
+    return workers_.size();
+}
+
+void WorkerPool::start()
+{
+    if (running_) {
+        return;
+    }
+
+    running_ = true;
+    for (std::size_t i = 0, n = workers_.size(); i < n; ++i) {
+        workers_[i]->thread = std::thread([this, i]() {
+            std::string name = std::string("worker ") + std::to_string(i);
+            csapex::thread::set_name(name.c_str());
+
+            current_pool = this;
+            current_worker = i;
+
+            workerLoop(i);
+
+            current_pool = nullptr;
+        });
+    }
+}
+
+void WorkerPool::stop()
+{
+    {
+        std::unique_lock<std::mutex> lock(sleep_mtx_);
+        running_ = false;
+        work_available_.notify_all();
+    }
+
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+
+    for (auto& worker : workers_) {
+        std::unique_lock<std::mutex> lock(worker->mutex);
+        worker->jobs.clear();
+    }
+    pending_ = 0;
+}
+
+bool WorkerPool::isRunning() const
+{
+    return running_;
+}
+
+bool WorkerPool::isWorkerThread() const
+{
+    return current_pool == this;
+}
+
+void WorkerPool::post(Job job, int affinity_hint, long priority)
+{
+    std::size_t index;
+    if (current_pool == this) {
+        // keep follow up work on the same core, other workers steal it if they run dry
+        index = current_worker;
+    } else if (affinity_hint >= 0) {
+        index = static_cast<std::size_t>(affinity_hint) % workers_.size();
+    } else {
+        index = next_worker_++ % workers_.size();
+    }
+
+    Worker& worker = *workers_[index];
+    {
+        std::unique_lock<std::mutex> lock(worker.mutex);
+        worker.jobs.push_back(Entry{ std::move(job), priority });
+    }
+    ++pending_;
+
+    std::unique_lock<std::mutex> lock(sleep_mtx_);
+    work_available_.notify_one();
+}
+
+std::size_t WorkerPool::getExecutedCount() const
+{
+    return executed_;
+}
+
+std::size_t WorkerPool::getStolenCount() const
+{
+    return stolen_;
+}
+
+void WorkerPool::workerLoop(std::size_t index)
+{
+    while (running_) {
+        Job job;
+        if (popLocal(index, job) || steal(index, job)) {
+            --pending_;
+            ++executed_;
+
+            job();
+
+        } else {
+            std::unique_lock<std::mutex> lock(sleep_mtx_);
+            work_available_.wait_for(lock, std::chrono::milliseconds(100), [this]() { return pending_ > 0 || !running_; });
+        }
+    }
+}
+
+bool WorkerPool::popLocal(std::size_t index, Job& job)
+{
+    Worker& worker = *workers_[index];
+    std::unique_lock<std::mutex> lock(worker.mutex);
+    if (worker.jobs.empty()) {
+        return false;
+    }
+
+    // the newest of the jobs with the highest priority
+    auto best = std::prev(worker.jobs.end());
+    for (auto it = best; it != worker.jobs.begin();) {
+        --it;
+        if (it->priority > best->priority) {
+            best = it;
+        }
+    }
+
+    job = std::move(best->job);
+    worker.jobs.erase(best);
+    return true;
+}
+
+bool WorkerPool::steal(std::size_t thief, Job& job)
+{
+    for (std::size_t offset = 1, n = workers_.size(); offset < n; ++offset) {
+        Worker& victim = *workers_[(thief + offset) % n];
+        std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || victim.jobs.empty()) {
+            continue;
+        }
+
+        // the oldest of the jobs with the highest priority
+        auto best = victim.jobs.begin();
+        for (auto it = std::next(best); it != victim.jobs.end(); ++it) {
+            if (it->priority > best->priority) {
+                best = it;
+            }
+        }
+
+        job = std::move(best->job);
+        victim.jobs.erase(best);
+        ++stolen_;
+        return true;
+    }
+    return false;
+}
@@ -6,16 +6,18 @@ using namespace csapex;
 // STRINGS
 SerializationBuffer& csapex::operator<<(SerializationBuffer& data, const std::string& s)
 {
-    apex_assert_lt_hard(s.size(), std::numeric_limits<uint16_t>::max());
-    data << static_cast<uint16_t>(s.size());
+    data.writeLength<uint16_t>(s.size());
     data.writeRaw(s.data(), s.size());
     return data;
 }
 
 const SerializationBuffer& csapex::operator>>(const SerializationBuffer& data, std::string& s)
 {
-    uint16_t str_len;
-    data >> str_len;
+    uint64_t str_len = data.readLength<uint16_t>();
+    if (str_len > data.size() - data.getPos()) {
+        throw std::out_of_range("string of " + std::to_string(str_len) + " bytes exceeds the buffer");
+    }
+    s.clear();
     if (str_len > 0) {
         s.resize(str_len);
         data.readRaw(&s.at(0), str_len);
@@ -15,6 +15,7 @@
 #include <csapex/model/token_data.h>
 #include <csapex/param/parameter.h>
 #include <csapex/profiling/interval.h>
+#include <csapex/profiling/interval_summary.h>
 #include <csapex/serialization/packet_serializer.h>
 #include <csapex/serialization/snippet.h>
 #include <csapex/serialization/streamable.h>
@@ -22,6 +23,8 @@
 #include <csapex/utility/yaml.h>
 
 /// SYSTEM
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
 using namespace csapex;
@@ -153,6 +156,7 @@ void SerializationBuffer::init()
         ADD_ANY_TYPE(TracingType);
         ADD_ANY_TYPE(ErrorState::ErrorLevel);
         ADD_ANY_TYPE_1PC(std::string, name(), Interval);
+        ADD_ANY_TYPE(IntervalSummary);
 
         initialized_ = true;
     }
@@ -235,30 +239,50 @@ StreamablePtr SerializationBuffer::read() const
     return nullptr;
 }
 
+uint8_t* SerializationBuffer::grow(std::size_t length)
+{
+    const std::size_t old_size = size();
+    if (old_size + length > capacity()) {
+        // reserve ahead, an exact reserve would reallocate on every write
+        reserve(std::max(old_size + length, 2 * capacity()));
+    }
+    resize(old_size + length);
+    return data() + old_size;
+}
+
+const uint8_t* SerializationBuffer::consume(std::size_t length) const
+{
+    if (pos + length > size()) {
+        throw std::out_of_range("cannot read " + std::to_string(length) + " bytes at position " + std::to_string(pos) + ", the buffer has " + std::to_string(size()));
+    }
+    const uint8_t* start = data() + pos;
+    pos += length;
+    return start;
+}
+
 void SerializationBuffer::writeRaw(const char* data, const std::size_t length)
 {
-    reserve(size() + length);
-    std::copy(data, data + length, std::back_inserter(*this));
+    writeRaw(reinterpret_cast<const uint8_t*>(data), length);
 }
 
 void SerializationBuffer::writeRaw(const uint8_t* data, const std::size_t length)
 {
-    reserve(size() + length);
-    std::copy(data, data + length, std::back_inserter(*this));
+    if (length > 0) {
+        std::memcpy(grow(length), data, length);
+    }
 }
 
 void SerializationBuffer::readRaw(char* data, const std::size_t length) const
 {
-    const char* start = reinterpret_cast<const char*>(&at(pos));
-    std::copy(start, start + length, data);
-    pos += length;
+    readRaw(reinterpret_cast<uint8_t*>(data), length);
 }
 
 void SerializationBuffer::readRaw(uint8_t* data, const std::size_t length) const
 {
-    const uint8_t* start = &at(pos);
-    std::copy(start, start + length, data);
-    pos += length;
+    const uint8_t* start = consume(length);
+    if (length > 0) {
+        std::memcpy(data, start, length);
+    }
 }
 
 SerializationBuffer& SerializationBuffer::writeAny(const std::any& any)
@@ -296,145 +320,97 @@ const SerializationBuffer& SerializationBuffer::readAny(std::any& any) const
     return *this;
 }
 
-#if G_BYTE_ORDER == G_LITTLE_ENDIAN
-union _GFloatIEEE754
-{
-    float v_float;
-    struct
-    {
-        uint mantissa : 23;
-        uint biased_exponent : 8;
-        uint sign : 1;
-    } mpn;
-};
-union _GDoubleIEEE754
+// FLOATS
+void SerializationBuffer::writeArray(const float* data, std::size_t count)
 {
-    double v_double;
-    struct
-    {
-        uint mantissa_low : 32;
-        uint mantissa_high : 20;
-        uint biased_exponent : 11;
-        uint sign : 1;
-    } mpn;
-};
-#elif G_BYTE_ORDER == G_BIG_ENDIAN
-union _GFloatIEEE754
-{
-    float v_float;
-    struct
-    {
-        uint sign : 1;
-        uint biased_exponent : 8;
-        uint mantissa : 23;
-    } mpn;
-};
-union _GDoubleIEEE754
-{
-    double v_double;
-    struct
-    {
-        uint sign : 1;
-        uint biased_exponent : 11;
-        uint mantissa_high : 20;
-        uint mantissa_low : 32;
-    } mpn;
-};
-#else /* !G_LITTLE_ENDIAN && !G_BIG_ENDIAN */
-#error unknown ENDIAN type
-#endif /* !G_LITTLE_ENDIAN && !G_BIG_ENDIAN */
+    uint8_t* dst = grow(count * 4);
+    for (std::size_t idx = 0; idx < count; ++idx, dst += 4) {
+        uint32_t bits;
+        std::memcpy(&bits, &data[idx], 4);
+
+        const uint32_t sign = bits >> 31;
+        const uint32_t biased_exponent = (bits >> 23) & 0xFF;
+        const uint32_t mantissa = bits & 0x7FFFFF;
+
+        /***
+         * sign  | mantissa    |  exponent
+         *   1         23             8
+         *   1   | 2 - 24      | 25 - 32
+         */
+        dst[0] = (sign << 7) | (mantissa >> (23 - 7));
+        dst[1] = (mantissa >> (23 - 7 - 8)) & 0xFF;
+        dst[2] = (mantissa >> (23 - 7 - 16)) & 0xFF;
+        dst[3] = biased_exponent;
+    }
+}
 
-SerializationBuffer& SerializationBuffer::operator<<(float f)
+void SerializationBuffer::readArray(float* data, std::size_t count) const
 {
-    _GFloatIEEE754 ieee;
-    ieee.v_float = f;
-
-    /***
-     * sign  | mantissa    |  exponent
-     *   1         23             8
-     *   1   | 2 - 24      | 25 - 32
-     */
-    uint8_t bytes[4];
-    // memset(&bytes[0], 0, 4);
-    bytes[0] = ieee.mpn.sign << 7;
-    bytes[0] |= (ieee.mpn.mantissa >> (23 - 7));
-    bytes[1] = (ieee.mpn.mantissa >> (23 - 7 - 8)) & 0xFF;
-    bytes[2] = (ieee.mpn.mantissa >> (23 - 7 - 16)) & 0xFF;
-    bytes[3] = ieee.mpn.biased_exponent;
-
-    for (uint8_t i = 0; i < 4; ++i) {
-        push_back(bytes[i]);
+    const uint8_t* src = consume(count * 4);
+    for (std::size_t idx = 0; idx < count; ++idx, src += 4) {
+        const uint32_t sign = (src[0] & (1 << 7)) ? 1 : 0;
+        const uint32_t mantissa = ((src[0] & (~(1 << 7))) << (23 - 7)) | (src[1] << (23 - 7 - 8)) | (src[2] << (23 - 7 - 16));
+        const uint32_t biased_exponent = src[3];
+
+        const uint32_t bits = (sign << 31) | (biased_exponent << 23) | mantissa;
+        std::memcpy(&data[idx], &bits, 4);
     }
+}
 
+SerializationBuffer& SerializationBuffer::operator<<(float f)
+{
+    writeArray(&f, 1);
     return *this;
 }
 
 const SerializationBuffer& SerializationBuffer::operator>>(float& f) const
 {
-    uint8_t bytes[4];
-    for (uint8_t i = 0; i < 4; ++i) {
-        bytes[i] = at(pos++);
-    }
-
-    _GFloatIEEE754 ieee;
-
-    ieee.mpn.sign = (bytes[0] & (1 << 7)) ? 1 : 0;
-    ieee.mpn.mantissa = ((bytes[0] & (~(1 << 7))) << (23 - 7)) | (bytes[1] << (23 - 7 - 8)) | (bytes[2] << (23 - 7 - 16));
-    ieee.mpn.biased_exponent = bytes[3];
-
-    f = ieee.v_float;
-
+    readArray(&f, 1);
     return *this;
 }
 
 // DOUBLES
-SerializationBuffer& SerializationBuffer::operator<<(double d)
+void SerializationBuffer::writeArray(const double* data, std::size_t count)
 {
-    _GDoubleIEEE754 ieee;
-    ieee.v_double = d;
-
-    /***
-     * sign  | exponent   |  mantissa_high   | mantissa_low
-     *   1         11             20         |   32
-     *   1   | 2 - 12         | 13 - 32      |   32
-     */
-    uint8_t bytes[8];
-    // memset(&bytes[0], 0, 4);
-    bytes[0] = ieee.mpn.sign << 7;
-    bytes[0] |= (ieee.mpn.biased_exponent >> (11 - 7));
-    bytes[1] = (ieee.mpn.biased_exponent << 4);
-    bytes[1] |= (ieee.mpn.mantissa_high >> (20 - 4)) & 0xFF;
-    bytes[2] = (ieee.mpn.mantissa_high >> (20 - 4 - 8)) & 0xFF;
-    bytes[3] = (ieee.mpn.mantissa_high >> (20 - 4 - 16)) & 0xFF;
-    bytes[4] = (ieee.mpn.mantissa_low >> (3 * 8)) & 0xFF;
-    bytes[5] = (ieee.mpn.mantissa_low >> (2 * 8)) & 0xFF;
-    bytes[6] = (ieee.mpn.mantissa_low >> (1 * 8)) & 0xFF;
-    bytes[7] = (ieee.mpn.mantissa_low >> (0 * 8)) & 0xFF;
-
-    for (uint8_t i = 0; i < 8; ++i) {
-        push_back(bytes[i]);
+    uint8_t* dst = grow(count * 8);
+    for (std::size_t idx = 0; idx < count; ++idx, dst += 8) {
+        uint64_t bits;
+        std::memcpy(&bits, &data[idx], 8);
+
+        /***
+         * sign  | exponent   |  mantissa_high   | mantissa_low
+         *   1         11             20         |   32
+         *   1   | 2 - 12         | 13 - 32      |   32
+         *
+         * which is the IEEE 754 bit pattern in big endian byte order
+         */
+        for (std::size_t byte = 0; byte < 8; ++byte) {
+            dst[byte] = (bits >> ((7 - byte) * 8)) & 0xFF;
+        }
     }
-
-    return *this;
 }
 
-const SerializationBuffer& SerializationBuffer::operator>>(double& d) const
+void SerializationBuffer::readArray(double* data, std::size_t count) const
 {
-    uint8_t bytes[8];
-    for (uint8_t i = 0; i < 8; ++i) {
-        bytes[i] = at(pos++);
+    const uint8_t* src = consume(count * 8);
+    for (std::size_t idx = 0; idx < count; ++idx, src += 8) {
+        uint64_t bits = 0;
+        for (std::size_t byte = 0; byte < 8; ++byte) {
+            bits = (bits << 8) | src[byte];
+        }
+        std::memcpy(&data[idx], &bits, 8);
     }
+}
 
-    _GDoubleIEEE754 ieee;
-
-    ieee.mpn.sign = (bytes[0] & (1 << 7)) ? 1 : 0;
-    ieee.mpn.biased_exponent = ((bytes[0] & (~(1 << 7))) << (11 - 7)) | ((bytes[1] & (0xF0)) >> 4);
-    ieee.mpn.mantissa_high = ((bytes[1] & (~(1 << 7))) << (20 - 4)) | (bytes[2] << (20 - 4 - 8)) | (bytes[3] << (20 - 4 - 16));
-
-    ieee.mpn.mantissa_low = (bytes[4] << (3 * 8)) | (bytes[5] << (2 * 8)) | (bytes[6] << (1 * 8)) | (bytes[7] << (0 * 8));
-
-    d = ieee.v_double;
+SerializationBuffer& SerializationBuffer::operator<<(double d)
+{
+    writeArray(&d, 1);
+    return *this;
+}
 
+const SerializationBuffer& SerializationBuffer::operator>>(double& d) const
+{
+    readArray(&d, 1);
     return *this;
 }
 
@@ -7,8 +7,12 @@
 #include <csapex/serialization/io/csapex_io.h>
 #include <csapex/msg/io.h>
 #include <csapex_testing/mockup_msgs.h>
+#include <csapex/model/connection_description.h>
+#include <csapex/model/node_characteristics.h>
+#include <csapex/model/node_state.h>
 
 #include <bitset>
+#include <numeric>
 
 using namespace csapex;
 using namespace connection_types;
@@ -285,6 +289,133 @@ TEST_F(BinarySerializationTest, TestMap)
     ASSERT_EQ(4, restored_map.at("d"));
 }
 
+TEST_F(BinarySerializationTest, TestWireFormatIsStable)
+{
+    SerializationBuffer buffer;
+    buffer << static_cast<uint32_t>(0x04030201);
+    buffer << 1.0f;
+    buffer << 1.0;
+
+    std::vector<uint8_t> expected{ 0x01, 0x02, 0x03, 0x04, 0x00, 0x00, 0x00, 0x7F, 0x3F, 0xF0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    ASSERT_EQ(SerializationBuffer::HEADER_LENGTH + expected.size(), buffer.size());
+    ASSERT_TRUE(std::equal(expected.begin(), expected.end(), buffer.begin() + SerializationBuffer::HEADER_LENGTH));
+}
+
+TEST_F(BinarySerializationTest, TestNumericVectors)
+{
+    std::vector<uint8_t> bytes{ 0, 1, 127, 255 };
+    std::vector<int64_t> longs{ std::numeric_limits<int64_t>::min(), -1, 0, std::numeric_limits<int64_t>::max() };
+    std::vector<float> floats{ -1.5f, 0.0f, 3.25f, std::numeric_limits<float>::max() };
+    std::vector<double> doubles{ -1.5, 0.0, 3.25, std::numeric_limits<double>::lowest() };
+    std::vector<bool> bools{ true, false, true };
+
+    SerializationBuffer buffer;
+    buffer << bytes << longs << floats << doubles << bools;
+
+    std::vector<uint8_t> restored_bytes;
+    std::vector<int64_t> restored_longs;
+    std::vector<float> restored_floats;
+    std::vector<double> restored_doubles;
+    std::vector<bool> restored_bools;
+    buffer >> restored_bytes >> restored_longs >> restored_floats >> restored_doubles >> restored_bools;
+
+    ASSERT_EQ(bytes, restored_bytes);
+    ASSERT_EQ(longs, restored_longs);
+    ASSERT_EQ(floats, restored_floats);
+    ASSERT_EQ(doubles, restored_doubles);
+    ASSERT_EQ(bools, restored_bools);
+}
+
+TEST_F(BinarySerializationTest, TestLargeContainers)
+{
+    std::vector<int32_t> ints(100000);
+    std::iota(ints.begin(), ints.end(), -50000);
+    std::vector<std::string> strings(300, "entry");
+    std::string long_string(70000, 'x');
+
+    SerializationBuffer buffer;
+    buffer << ints << strings << long_string;
+
+    std::vector<int32_t> restored_ints;
+    std::vector<std::string> restored_strings;
+    std::string restored_long_string;
+    buffer >> restored_ints >> restored_strings >> restored_long_string;
+
+    ASSERT_EQ(ints, restored_ints);
+    ASSERT_EQ(strings, restored_strings);
+    ASSERT_EQ(long_string, restored_long_string);
+}
+
+TEST_F(BinarySerializationTest, TestShortLengthsKeepTheOldFormat)
+{
+    // a vector of three uint16 and a string as written before large containers were supported
+    std::vector<uint8_t> old_stream{ 3, 1, 0, 2, 0, 3, 0, 2, 0, 'o', 'k' };
+    SerializationBuffer buffer(old_stream, true);
+
+    std::vector<uint16_t> vector;
+    std::string string;
+    buffer >> vector >> string;
+
+    ASSERT_EQ((std::vector<uint16_t>{ 1, 2, 3 }), vector);
+    ASSERT_EQ("ok", string);
+
+    SerializationBuffer rewritten;
+    rewritten << vector << string;
+    ASSERT_EQ(SerializationBuffer::HEADER_LENGTH + old_stream.size(), rewritten.size());
+    ASSERT_TRUE(std::equal(old_stream.begin(), old_stream.end(), rewritten.begin() + SerializationBuffer::HEADER_LENGTH));
+}
+
+TEST_F(BinarySerializationTest, TestReadingPastTheEndThrows)
+{
+    SerializationBuffer buffer;
+    buffer << static_cast<uint16_t>(42);
+
+    uint32_t value;
+    ASSERT_THROW(buffer >> value, std::out_of_range);
+}
+
+namespace
+{
+template <typename T>
+void testArraysAreElementWiseCompatible()
+{
+    std::vector<T> payload(1000);
+    std::iota(payload.begin(), payload.end(), T(0));
+
+    SerializationBuffer element_wise;
+    for (const T& value : payload) {
+        element_wise << value;
+    }
+
+    SerializationBuffer bulk;
+    bulk.writeArray(payload.data(), payload.size());
+
+    ASSERT_EQ(element_wise.size(), bulk.size());
+    ASSERT_TRUE(std::equal(element_wise.begin(), element_wise.end(), bulk.begin()));
+
+    // each side reads what the other one wrote
+    std::vector<T> restored(payload.size());
+    element_wise.readArray(restored.data(), restored.size());
+    ASSERT_EQ(payload, restored);
+
+    std::fill(restored.begin(), restored.end(), T(0));
+    for (T& value : restored) {
+        bulk >> value;
+    }
+    ASSERT_EQ(payload, restored);
+}
+}  // namespace
+
+TEST_F(BinarySerializationTest, FloatArraysAreElementWiseCompatible)
+{
+    testArraysAreElementWiseCompatible<float>();
+}
+
+TEST_F(BinarySerializationTest, ByteArraysAreElementWiseCompatible)
+{
+    testArraysAreElementWiseCompatible<uint8_t>();
+}
+
 TEST_F(BinarySerializationTest, TestUUID)
 {
     UUID uuid1 = UUIDProvider::makeUUID_without_parent("test:|:1");
@@ -301,6 +432,129 @@ TEST_F(BinarySerializationTest, TestUUID)
     ASSERT_EQ(uuid2.getFullName(), value.getFullName());
 }
 
+TEST_F(BinarySerializationTest, ConnectionDescriptionsKeepTheirQueueCapacity)
+{
+    ConnectionDescription description(UUIDProvider::makeUUID_without_parent("a:|:out_0"), UUIDProvider::makeUUID_without_parent("b:|:in_0"), std::make_shared<MockMessage>(), 1, 2, true, {});
+    description.queue_capacity = 4;
+
+    SerializationBuffer buffer;
+    buffer << description;
+
+    ConnectionDescription restored;
+    buffer >> restored;
+    ASSERT_EQ(description.from, restored.from);
+    ASSERT_EQ(description.to, restored.to);
+    ASSERT_EQ(4, restored.queue_capacity);
+}
+
+TEST_F(BinarySerializationTest, ConnectionDescriptionsWithoutVersionUseTheDefaultQueueCapacity)
+{
+    // the layout before queue capacities were added
+    SerializationBuffer buffer;
+    buffer << SemanticVersion();
+    buffer << UUIDProvider::makeUUID_without_parent("a:|:out_0");
+    buffer << UUIDProvider::makeUUID_without_parent("b:|:in_0");
+    buffer << std::string("out");
+    buffer << std::string("in");
+    buffer << TokenDataConstPtr(std::make_shared<MockMessage>());
+    buffer << 1;
+    buffer << true;
+    buffer << std::vector<Fulcrum>();
+    buffer << 2;
+
+    ConnectionDescription restored;
+    restored.deserializeVersioned(buffer);
+    ASSERT_EQ("in", restored.to_label);
+    ASSERT_EQ(2, restored.seq);
+    ASSERT_EQ(1, restored.queue_capacity);
+}
+
+TEST_F(BinarySerializationTest, NodeStatesKeepTheirReplicaCount)
+{
+    NodeState state;
+    state.setLabel("replicated");
+    state.setReplicaCount(4);
+
+    SerializationBuffer buffer;
+    buffer << state;
+
+    NodeState restored;
+    buffer >> restored;
+    ASSERT_EQ("replicated", restored.getLabel());
+    ASSERT_EQ(4, restored.getReplicaCount());
+}
+
+TEST_F(BinarySerializationTest, NodeStatesWithoutVersionAreNotReplicated)
+{
+    // the layout before replica counts were added
+    SerializationBuffer buffer;
+    buffer << SemanticVersion();
+    buffer << 30.0;
+    buffer << std::string("legacy");
+    buffer << 1.f << 2.f;
+    buffer << 3l;
+    buffer << false << false << true << false << false;
+    buffer << 0;
+    buffer << -1 << std::string("");
+    buffer << -1 << -1 << -1;
+    buffer << std::map<std::string, std::any>();
+    buffer << ExecutionMode::PIPELINING;
+    buffer << ExecutionType::DIRECT;
+    buffer << YAML::Node();
+
+    NodeState restored;
+    restored.deserializeVersioned(buffer);
+    ASSERT_EQ("legacy", restored.getLabel());
+    ASSERT_EQ(ExecutionMode::PIPELINING, restored.getExecutionMode());
+    ASSERT_EQ(ExecutionType::DIRECT, restored.getExecutionType());
+    ASSERT_EQ(1, restored.getReplicaCount());
+}
+
+TEST_F(BinarySerializationTest, NodeCharacteristicsKeepTheirCriticalPath)
+{
+    NodeCharacteristics characteristics;
+    characteristics.depth = 2;
+    characteristics.critical_path_length = 5;
+    characteristics.is_unblocking_joining_vertex = true;
+    characteristics.fused_chain = 3;
+    characteristics.is_fused_with_child = true;
+
+    SerializationBuffer buffer;
+    buffer << characteristics;
+
+    NodeCharacteristics restored;
+    buffer >> restored;
+    ASSERT_EQ(2, restored.depth);
+    ASSERT_EQ(5, restored.critical_path_length);
+    ASSERT_TRUE(restored.is_unblocking_joining_vertex);
+    ASSERT_EQ(3, restored.fused_chain);
+    ASSERT_TRUE(restored.is_fused_with_child);
+}
+
+TEST_F(BinarySerializationTest, NodeCharacteristicsWithoutFusedChainsAreNotFused)
+{
+    // the layouts before critical paths and before fused chains were added
+    for (SemanticVersion version : { SemanticVersion(), SemanticVersion(0, 1, 0) }) {
+        SerializationBuffer buffer;
+        buffer << version;
+        buffer << 2 << 1;
+        buffer << true << false << false << true << false;
+        if (version >= SemanticVersion(0, 1, 0)) {
+            buffer << 5 << true;
+        }
+
+        NodeCharacteristics restored;
+        restored.deserializeVersioned(buffer);
+        ASSERT_EQ(2, restored.depth);
+        ASSERT_EQ(1, restored.component);
+        ASSERT_TRUE(restored.is_joining_vertex);
+        ASSERT_TRUE(restored.is_leading_to_joining_vertex);
+        ASSERT_EQ(version >= SemanticVersion(0, 1, 0) ? 5 : 0, restored.critical_path_length);
+        ASSERT_EQ(-1, restored.fused_chain);
+        ASSERT_FALSE(restored.is_fused_with_child);
+    }
+}
+
 TEST_F(BinarySerializationTest, SpecificTokenSerialization)
 {
     SerializationBuffer data;
@@ -3,6 +3,7 @@
 #include <csapex/factory/node_factory_impl.h>
 #include <csapex/msg/message.h>
 #include <csapex/msg/input.h>
+#include <csapex/msg/io.h>
 #include <csapex/msg/static_output.h>
 #include <csapex/signal/event.h>
 #include <csapex/signal/slot.h>
@@ -295,6 +296,121 @@ TEST_F(ConnectionTest, DirectConnectionCanBeDeleted)
     ASSERT_TRUE(raw_message == nullptr);
 }
 
+TEST_F(ConnectionTest, OutputsCopyMessagesPerConnectionByDefault)
+{
+    OutputPtr o = std::make_shared<StaticOutput>(uuid_provider->makeUUID("o"));
+    InputPtr i1 = std::make_shared<Input>(uuid_provider->makeUUID("i1"));
+    InputPtr i2 = std::make_shared<Input>(uuid_provider->makeUUID("i2"));
+
+    ConnectionPtr c1 = DirectConnection::connect(o, i1);
+    DirectConnection::connect(o, i2);
+
+    GenericValueMessage<int>::Ptr msg(new GenericValueMessage<int>);
+    msg->value = 42;
+
+    o->addMessage(std::make_shared<Token>(msg));
+    o->commitMessages(false);
+    o->publish();
+
+    // the producer keeps its message and modifies it after publishing
+    msg->value = 23;
+
+    ASSERT_NE(msg, i1->getToken()->getTokenData());
+    ASSERT_NE(i1->getToken()->getTokenData(), i2->getToken()->getTokenData());
+    ASSERT_EQ(42, msg::getValue<int>(i1.get()));
+    ASSERT_EQ(42, msg::getValue<int>(i2.get()));
+
+    // every consumer owns its copy and can modify it in place
+    TokenDataConstPtr data = i1->getToken()->getTokenData();
+    const TokenData* raw = data.get();
+    data.reset();
+    GenericValueMessage<int>::Ptr mutable_msg = msg::getMutableMessage<GenericValueMessage<int>>(i1.get());
+    ASSERT_EQ(raw, mutable_msg.get());
+    ASSERT_EQ(1, c1->getAvoidedCopyCount());
+
+    mutable_msg->value = 7;
+    ASSERT_EQ(42, msg::getValue<int>(i2.get()));
+}
+
+TEST_F(ConnectionTest, SharingOutputsShareMessageDataBetweenConnections)
+{
+    OutputPtr o = std::make_shared<StaticOutput>(uuid_provider->makeUUID("o"));
+    o->setSharingMessages(true);
+    InputPtr i1 = std::make_shared<Input>(uuid_provider->makeUUID("i1"));
+    InputPtr i2 = std::make_shared<Input>(uuid_provider->makeUUID("i2"));
+
+    DirectConnection::connect(o, i1);
+    DirectConnection::connect(o, i2);
+
+    GenericValueMessage<int>::Ptr msg(new GenericValueMessage<int>);
+    msg->value = 42;
+
+    o->addMessage(std::make_shared<Token>(msg));
+    o->commitMessages(false);
+    o->publish();
+
+    ASSERT_TRUE(i1->getToken() != nullptr);
+    ASSERT_TRUE(i2->getToken() != nullptr);
+
+    // every input has its own token, the data is not copied
+    ASSERT_NE(i1->getToken(), i2->getToken());
+    ASSERT_EQ(msg, i1->getToken()->getTokenData());
+    ASSERT_EQ(msg, i2->getToken()->getTokenData());
+}
+
+TEST_F(ConnectionTest, MutableMessageIsOnlyCopiedWhileShared)
+{
+    OutputPtr o = std::make_shared<StaticOutput>(uuid_provider->makeUUID("o"));
+    o->setSharingMessages(true);
+    InputPtr i1 = std::make_shared<Input>(uuid_provider->makeUUID("i1"));
+    InputPtr i2 = std::make_shared<Input>(uuid_provider->makeUUID("i2"));
+
+    ConnectionPtr c1 = DirectConnection::connect(o, i1);
+    DirectConnection::connect(o, i2);
+
+    GenericValueMessage<int>::Ptr msg(new GenericValueMessage<int>);
+    msg->value = 42;
+    TokenDataConstPtr data = msg;
+
+    o->addMessage(std::make_shared<Token>(msg));
+    o->commitMessages(false);
+    o->publish();
+    msg.reset();
+
+    // the second input still needs the original data
+    GenericValueMessage<int>::Ptr copy = msg::getMutableMessage<GenericValueMessage<int>>(i1.get());
+    ASSERT_NE(data, copy);
+    copy->value = 23;
+    ASSERT_EQ(42, msg::getValue<int>(i2.get()));
+    ASSERT_EQ(1, c1->getCopyCount());
+
+    // a reference outside of the tokens prevents taking the data
+    i2->getToken()->release();
+    ASSERT_NE(data, msg::getMutableMessage(i1.get()));
+    ASSERT_EQ(2, c1->getCopyCount());
+
+    // the output still exposes its committed token, e.g. to previews
+    const TokenData* raw = data.get();
+    data.reset();
+    ASSERT_NE(raw, msg::getMutableMessage(i1.get()).get());
+    ASSERT_EQ(3, c1->getCopyCount());
+
+    GenericValueMessage<int>::Ptr next(new GenericValueMessage<int>);
+    o->addMessage(std::make_shared<Token>(next));
+    o->commitMessages(false);
+
+    // somebody else holding the token of the input could see the modification
+    {
+        TokenPtr holder = i1->getToken();
+        ASSERT_NE(raw, msg::getMutableMessage(i1.get()).get());
+        ASSERT_EQ(4, c1->getCopyCount());
+    }
+
+    // the last consumer may modify the data in place
+    ASSERT_EQ(raw, msg::getMutableMessage(i1.get()).get());
+    ASSERT_EQ(1, c1->getAvoidedCopyCount());
+}
+
 TEST_F(ConnectionTest, ConnectionTestIsSymmetricalForGenericValue)
 {
     TokenDataPtr o_type = std::make_shared<GenericValueMessage<int>>();
@@ -21,11 +21,18 @@
 #include <csapex/msg/generic_vector_message.hpp>
 #include <csapex/model/subgraph_node.h>
 #include <csapex/model/graph/graph_impl.h>
+#include <csapex/model/node_state.h>
 
 #include <csapex_testing/csapex_test_case.h>
 #include <csapex_testing/test_exception_handler.h>
 #include <csapex_testing/stepping_test.h>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 namespace csapex
 {
 class IterationCombiner
@@ -35,7 +42,7 @@ public:
     {
     }
 
-    void setup(csapex::NodeModifier& node_modifier) override
+    void setup(csapex::NodeModifier& node_modifier)
     {
         input_a_ = node_modifier.addInput<int>("input_a");
         input_b_ = node_modifier.addInput<int>("input_b");
@@ -46,7 +53,7 @@ public:
     {
     }
 
-    void process(NodeModifier& node_modifier, Parameterizable& /*parameters*/) override
+    void process(NodeModifier& node_modifier, Parameterizable& /*parameters*/)
     {
         int a = msg::getValue<int>(input_a_);
         int b = msg::getValue<int>(input_b_);
@@ -60,6 +67,27 @@ private:
     Output* output_;
 };
 
+/// the number of busy combiners that are executing right now, and the most that ever executed at the same time
+std::atomic<int> busy_combiners(0);
+std::atomic<int> max_busy_combiners(0);
+
+class BusyIterationCombiner : public IterationCombiner
+{
+public:
+    void process(NodeModifier& node_modifier, Parameterizable& parameters)
+    {
+        int busy = ++busy_combiners;
+        int max = max_busy_combiners.load();
+        while (busy > max && !max_busy_combiners.compare_exchange_weak(max, busy)) {
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        IterationCombiner::process(node_modifier, parameters);
+
+        --busy_combiners;
+    }
+};
+
 class IterationSource : public Node
 {
 public:
@@ -141,23 +169,38 @@ public:
     {
     }
 
-    void process(NodeModifier& node_modifier, Parameterizable& /*parameters*/) override
+    void process(NodeModifier& node_modifier, Parameterizable& /*parameters*/)
     {
         auto i = msg::getMessage<connection_types::GenericVectorMessage, int>(in);
+
+        std::unique_lock<std::mutex> lock(value_mutex);
         value = *i;
+        ++received;
+        value_received.notify_all();
 
         // TRACEstd::cerr << "got vector of size " << value.size() << std::endl;
     }
 
     std::vector<int> getValue() const
     {
+        std::unique_lock<std::mutex> lock(value_mutex);
         return value;
     }
 
+    int waitForVectors(int count)
+    {
+        std::unique_lock<std::mutex> lock(value_mutex);
+        value_received.wait_for(lock, std::chrono::seconds(10), [this, count]() { return received >= count; });
+        return received;
+    }
+
 private:
     Input* in;
 
+    mutable std::mutex value_mutex;
+    std::condition_variable value_received;
     std::vector<int> value;
+    int received = 0;
 };
 
 class ContainerIterationTest : public SteppingTest
@@ -169,6 +212,10 @@ protected:
             csapex::NodeConstructor::Ptr constructor(new csapex::NodeConstructor("IterationCombiner", std::bind(&ContainerIterationTest::makeCombiner)));
             factory.registerNodeType(constructor);
         }
+        {
+            csapex::NodeConstructor::Ptr constructor(new csapex::NodeConstructor("BusyIterationCombiner", std::bind(&ContainerIterationTest::makeBusyCombiner)));
+            factory.registerNodeType(constructor);
+        }
         {
             csapex::NodeConstructor::Ptr constructor(new csapex::NodeConstructor("IterationSource", std::bind(&ContainerIterationTest::makeSource)));
             factory.registerNodeType(constructor);
@@ -199,6 +246,10 @@ protected:
     {
         return NodePtr(new NodeWrapper<IterationCombiner>());
     }
+    static NodePtr makeBusyCombiner()
+    {
+        return NodePtr(new NodeWrapper<BusyIterationCombiner>());
+    }
     static NodePtr makeSource()
     {
         return NodePtr(new IterationSource());
@@ -415,4 +466,237 @@ TEST_F(ContainerIterationTest, VectorCanBeForwardedAndIteratedInSubGraph)
         }
     }
 }
+
+TEST_F(ContainerIterationTest, MultipleVectorsAreIteratedInLockstep)
+{
+    GraphFacadeImplementation main_graph_facade(executor, graph, graph_node);
+
+    // MAIN GRAPH
+    NodeFacadeImplementationPtr src_a = factory.makeNode("IterationSource", UUIDProvider::makeUUID_without_parent("src_a"), graph);
+    ASSERT_NE(nullptr, src_a);
+    graph->addNode(src_a);
+
+    NodeFacadeImplementationPtr src_b = factory.makeNode("IterationSource", UUIDProvider::makeUUID_without_parent("src_b"), graph);
+    ASSERT_NE(nullptr, src_b);
+    graph->addNode(src_b);
+
+    NodeFacadeImplementationPtr sink_p = factory.makeNode("IterationSink", UUIDProvider::makeUUID_without_parent("Sink"), graph);
+    main_graph_facade.addNode(sink_p);
+    std::shared_ptr<IterationSink> sink = std::dynamic_pointer_cast<IterationSink>(sink_p->getNode());
+    ASSERT_NE(nullptr, sink);
+
+    // NESTED GRAPH
+    NodeFacadeImplementationPtr sub_graph_node_facade = factory.makeNode("csapex::Graph", graph->generateUUID("subgraph"), graph);
+    SubgraphNodePtr sub_graph = std::dynamic_pointer_cast<SubgraphNode>(sub_graph_node_facade->getNode());
+    apex_assert_hard(sub_graph);
+
+    GraphFacadeImplementation sub_graph_facade(executor, sub_graph->getLocalGraph(), sub_graph);
+
+    NodeFacadeImplementationPtr n2 = factory.makeNode("IterationCombiner", UUIDProvider::makeUUID_without_parent("n2"), sub_graph->getLocalGraph());
+    ASSERT_NE(nullptr, n2);
+    sub_graph_facade.addNode(n2);
+
+    graph->addNode(sub_graph_node_facade);
+
+    auto type = connection_types::GenericVectorMessage::make<int>();
+
+    auto in_a_map = sub_graph->addForwardingInput(type, "forwarding_a", false);
+    auto in_b_map = sub_graph->addForwardingInput(type, "forwarding_b", false);
+    auto out_map = sub_graph->addForwardingOutput(type, "forwarding");
+
+    sub_graph->setIterationEnabled(in_a_map.external, true);
+    sub_graph->setIterationEnabled(in_b_map.external, true);
+
+    ConnectorPtr relay_b = sub_graph_node_facade->getConnector(in_b_map.internal);
+    ASSERT_NE(relay_b, nullptr);
+    ASSERT_EQ("Value<int>", relay_b->getType()->typeName());
+
+    // forwarding connections
+    sub_graph_facade.connect(in_a_map.internal, n2, "input_a");
+    sub_graph_facade.connect(in_b_map.internal, n2, "input_b");
+    sub_graph_facade.connect(n2, "output", out_map.internal);
+
+    // crossing connections
+    main_graph_facade.connect(src_a, "output", in_a_map.external);
+    main_graph_facade.connect(src_b, "output", in_b_map.external);
+    main_graph_facade.connect(out_map.external, sink_p, "input");
+
+    executor.start();
+
+    // execution
+    for (int iter = 0; iter < 23; ++iter) {
+        step();
+
+        std::vector<int> res = sink->getValue();
+
+        ASSERT_EQ(8, res.size());
+
+        for (std::size_t j = 0; j < res.size(); ++j) {
+            ASSERT_EQ(iter * j * iter * j, res[j]);
+        }
+    }
+
+    sub_graph->setIterationEnabled(in_b_map.external, false);
+    ASSERT_EQ("Vector", relay_b->getType()->typeName());
+}
+
+TEST_F(ContainerIterationTest, VectorCanBeIteratedInParallel)
+{
+    GraphFacadeImplementation main_graph_facade(executor, graph, graph_node);
+
+    // MAIN GRAPH
+    NodeFacadeImplementationPtr src = factory.makeNode("IterationSource", UUIDProvider::makeUUID_without_parent("src"), graph);
+    ASSERT_NE(nullptr, src);
+    graph->addNode(src);
+
+    NodeFacadeImplementationPtr constant = factory.makeNode("IterationConstant", UUIDProvider::makeUUID_without_parent("const"), graph);
+    ASSERT_NE(nullptr, constant);
+    graph->addNode(constant);
+
+    NodeFacadeImplementationPtr sink_p = factory.makeNode("IterationSink", UUIDProvider::makeUUID_without_parent("Sink"), graph);
+    main_graph_facade.addNode(sink_p);
+    std::shared_ptr<IterationSink> sink = std::dynamic_pointer_cast<IterationSink>(sink_p->getNode());
+    ASSERT_NE(nullptr, sink);
+
+    // NESTED GRAPH
+    NodeFacadeImplementationPtr sub_graph_node_facade = factory.makeNode("csapex::Graph", graph->generateUUID("subgraph"), graph);
+    SubgraphNodePtr sub_graph = std::dynamic_pointer_cast<SubgraphNode>(sub_graph_node_facade->getNode());
+    apex_assert_hard(sub_graph);
+
+    GraphFacadeImplementation sub_graph_facade(executor, sub_graph->getLocalGraph(), sub_graph);
+
+    NodeFacadeImplementationPtr n1 = factory.makeNode("IterationCombiner", UUIDProvider::makeUUID_without_parent("n1"), sub_graph->getLocalGraph());
+    ASSERT_NE(nullptr, n1);
+    sub_graph_facade.addNode(n1);
+
+    NodeFacadeImplementationPtr n2 = factory.makeNode("IterationCombiner", UUIDProvider::makeUUID_without_parent("n2"), sub_graph->getLocalGraph());
+    ASSERT_NE(nullptr, n2);
+    sub_graph_facade.addNode(n2);
+
+    graph->addNode(sub_graph_node_facade);
+
+    auto type = connection_types::GenericVectorMessage::make<int>();
+
+    auto in_vec_map = sub_graph->addForwardingInput(type, "forwarding_vector", false);
+    auto in_const_map = sub_graph->addForwardingInput(makeEmpty<connection_types::GenericValueMessage<int>>(), "forwarding_const", false);
+    auto out_map = sub_graph->addForwardingOutput(type, "forwarding");
+
+    sub_graph->setIterationEnabled(in_vec_map.external, true);
+    sub_graph->setParameter<int>("iteration_parallelism", 4);
+
+    // pipelining nodes release their inputs as soon as they are done, so the next element can enter the subgraph
+    n1->getNodeState()->setExecutionMode(ExecutionMode::PIPELINING);
+    n2->getNodeState()->setExecutionMode(ExecutionMode::PIPELINING);
+
+    // two stages, so that consecutive elements can be in flight at the same time
+    sub_graph_facade.connect(in_vec_map.internal, n1, "input_a");
+    sub_graph_facade.connect(in_const_map.internal, n1, "input_b");
+    sub_graph_facade.connect(n1, "output", n2, "input_a");
+    sub_graph_facade.connect(n1, "output", n2, "input_b");
+    sub_graph_facade.connect(n2, "output", out_map.internal);
+
+    // crossing connections
+    main_graph_facade.connect(src, "output", in_vec_map.external);
+    main_graph_facade.connect(constant, "output", in_const_map.external);
+    main_graph_facade.connect(out_map.external, sink_p, "input");
+
+    executor.start();
+
+    // execution
+    for (int iter = 0; iter < 23; ++iter) {
+        step();
+
+        std::vector<int> res = sink->getValue();
+
+        ASSERT_EQ(8, res.size());
+
+        int constant = iter;
+
+        // results are collected in the order of the elements
+        for (std::size_t j = 0; j < res.size(); ++j) {
+            int expected = iter * j * constant;
+            ASSERT_EQ(expected * expected, res[j]);
+        }
+    }
+}
+TEST_F(ContainerIterationTest, PipeliningNodesProcessElementsConcurrently)
+{
+    executor.setSteppingMode(false);
+
+    GraphFacadeImplementation main_graph_facade(executor, graph, graph_node);
+
+    NodeFacadeImplementationPtr src = factory.makeNode("IterationSource", UUIDProvider::makeUUID_without_parent("src"), graph);
+    graph->addNode(src);
+    NodeFacadeImplementationPtr constant = factory.makeNode("IterationConstant", UUIDProvider::makeUUID_without_parent("const"), graph);
+    graph->addNode(constant);
+    NodeFacadeImplementationPtr sink_p = factory.makeNode("IterationSink", UUIDProvider::makeUUID_without_parent("Sink"), graph);
+    main_graph_facade.addNode(sink_p);
+    std::shared_ptr<IterationSink> sink = std::dynamic_pointer_cast<IterationSink>(sink_p->getNode());
+    ASSERT_NE(nullptr, sink);
+
+    NodeFacadeImplementationPtr sub_graph_node_facade = factory.makeNode("csapex::Graph", graph->generateUUID("subgraph"), graph);
+    SubgraphNodePtr sub_graph = std::dynamic_pointer_cast<SubgraphNode>(sub_graph_node_facade->getNode());
+    apex_assert_hard(sub_graph);
+    GraphFacadeImplementation sub_graph_facade(executor, sub_graph->getLocalGraph(), sub_graph);
+
+    // two busy stages on threads of their own, in the execution mode that iteration_parallelism requires
+    NodeFacadeImplementationPtr n1 = factory.makeNode("BusyIterationCombiner", UUIDProvider::makeUUID_without_parent("n1"), sub_graph->getLocalGraph());
+    sub_graph_facade.addNode(n1);
+    NodeFacadeImplementationPtr n2 = factory.makeNode("BusyIterationCombiner", UUIDProvider::makeUUID_without_parent("n2"), sub_graph->getLocalGraph());
+    sub_graph_facade.addNode(n2);
+    n1->getNodeState()->setExecutionMode(ExecutionMode::PIPELINING);
+    n2->getNodeState()->setExecutionMode(ExecutionMode::PIPELINING);
+    executor.addToGroup(n1->getNodeRunner().get(), executor.createGroup("stage 1")->id());
+    executor.addToGroup(n2->getNodeRunner().get(), executor.createGroup("stage 2")->id());
+
+    graph->addNode(sub_graph_node_facade);
+
+    auto type = connection_types::GenericVectorMessage::make<int>();
+    auto in_vec_map = sub_graph->addForwardingInput(type, "forwarding_vector", false);
+    auto in_const_map = sub_graph->addForwardingInput(makeEmpty<connection_types::GenericValueMessage<int>>(), "forwarding_const", false);
+    auto out_map = sub_graph->addForwardingOutput(type, "forwarding");
+    sub_graph->setIterationEnabled(in_vec_map.external, true);
+
+    sub_graph_facade.connect(in_vec_map.internal, n1, "input_a");
+    sub_graph_facade.connect(in_const_map.internal, n1, "input_b");
+    // n1 can only work on the next element while n2 is busy if the connections buffer its result
+    sub_graph_facade.connect(n1, "output", n2, "input_a")->setQueueCapacity(2);
+    sub_graph_facade.connect(n1, "output", n2, "input_b")->setQueueCapacity(2);
+    sub_graph_facade.connect(n2, "output", out_map.internal);
+
+    main_graph_facade.connect(src, "output", in_vec_map.external);
+    main_graph_facade.connect(constant, "output", in_const_map.external);
+    main_graph_facade.connect(out_map.external, sink_p, "input");
+
+    executor.start();
+
+    // the graph runs freely, stepping would hand the nested nodes one element at a time
+    auto observe = [&](int parallelism) {
+        sub_graph->setParameter<int>("iteration_parallelism", parallelism);
+        // the vector that is in flight while the parameter changes is not observed
+        int first = sink->waitForVectors(sink->waitForVectors(0) + 1);
+        max_busy_combiners = 0;
+
+        const int vectors = 4;
+        EXPECT_GE(sink->waitForVectors(first + vectors), first + vectors);
+        return max_busy_combiners.load();
+    };
+
+    int sequential_concurrency = observe(1);
+    int pipelined_concurrency = observe(4);
+
+    executor.stop();
+
+    std::vector<int> res = sink->getValue();
+    ASSERT_EQ(8, res.size());
+    for (std::size_t j = 0; j < res.size(); ++j) {
+        // (i * j * i)^2 for the i-th vector
+        ASSERT_EQ(res[1] * static_cast<int>(j * j), res[j]);
+    }
+
+    // sequentially, every element passes both stages alone, pipelined, the stages overlap
+    EXPECT_EQ(1, sequential_concurrency);
+    EXPECT_EQ(2, pipelined_concurrency);
+}
+
 }  // namespace csapex
@@ -0,0 +1,139 @@
+#include <csapex/core/binary_config.h>
+#include <csapex/core/graphio.h>
+#include <csapex/model/graph_facade_impl.h>
+#include <csapex/model/graph/graph_impl.h>
+#include <csapex/model/node_facade_impl.h>
+#include <csapex/model/node_state.h>
+#include <csapex/model/subgraph_node.h>
+#include <csapex/serialization/serialization_buffer.h>
+#include <csapex_testing/mockup_nodes.h>
+#include <csapex_testing/node_constructing_test.h>
+
+#include <boost/filesystem.hpp>
+#include <thread>
+
+namespace csapex
+{
+class GraphIOTest : public NodeConstructingTest
+{
+};
+
+TEST_F(GraphIOTest, BinaryConfigPreservesTheYamlTree)
+{
+    YAML::Node doc;
+    doc["version"] = "1.2.3";
+    doc["empty"] = YAML::Node(YAML::NodeType::Null);
+    for (int i = 0; i < 3; ++i) {
+        YAML::Node node;
+        node["uuid"] = "node_" + std::to_string(i);
+        node["type"] = "MockupSource";
+        node["pos"].push_back(1.5 * i);
+        node["pos"].push_back(-2);
+        doc["nodes"].push_back(node);
+    }
+
+    SerializationBuffer buffer;
+    BinaryConfig::write(buffer, doc);
+    buffer.finalize();
+
+    SerializationBuffer copy(buffer.data(), buffer.size());
+    YAML::Node restored = BinaryConfig::read(copy);
+
+    YAML::Emitter expected;
+    expected << doc;
+    YAML::Emitter actual;
+    actual << restored;
+    EXPECT_EQ(std::string(expected.c_str()), std::string(actual.c_str()));
+
+    EXPECT_EQ(3, restored["nodes"].size());
+    EXPECT_EQ("node_2", restored["nodes"][2]["uuid"].as<std::string>());
+    EXPECT_DOUBLE_EQ(3.0, restored["nodes"][2]["pos"][0].as<double>());
+    EXPECT_TRUE(restored["empty"].IsNull());
+}
+
+TEST_F(GraphIOTest, BinaryConfigIsReplacedAsAWhole)
+{
+    namespace bf = boost::filesystem;
+    bf::path dir = bf::temp_directory_path() / bf::unique_path("csapex_binary_config_%%%%-%%%%");
+    bf::create_directories(dir);
+    std::string file = (dir / "config.apexc").string();
+
+    YAML::Node first;
+    first["version"] = "1.0.0";
+    BinaryConfig::save(file, first);
+
+    YAML::Node second;
+    second["version"] = "2.0.0";
+    BinaryConfig::save(file, second);
+
+    EXPECT_EQ("2.0.0", BinaryConfig::load(file)["version"].as<std::string>());
+
+    // the temporary file has been renamed to the config
+    std::size_t files = std::distance(bf::directory_iterator(dir), bf::directory_iterator());
+    EXPECT_EQ(1, files);
+
+    bf::remove_all(dir);
+}
+
+TEST_F(GraphIOTest, GraphsAreLoadedWithMultipleThreads)
+{
+    const int pairs = 16;
+
+    YAML::Node store;
+    {
+        GraphFacadeImplementation main_graph_facade(executor, graph, graph_node);
+
+        for (int i = 0; i < pairs; ++i) {
+            NodeFacadeImplementationPtr src = factory.makeNode("MockupSource", graph->generateUUID("src"), graph);
+            src->getNodeState()->setMaximumFrequency(5.0);
+            main_graph_facade.addNode(src);
+            NodeFacadeImplementationPtr sink = factory.makeNode("MockupSink", graph->generateUUID("sink"), graph);
+            main_graph_facade.addNode(sink);
+
+            main_graph_facade.connect(src, "output", sink, "input");
+        }
+
+        GraphIO io(main_graph_facade, &factory, true);
+        ASSERT_NO_THROW(io.saveGraphTo(store));
+    }
+
+    SerializationBuffer buffer;
+    BinaryConfig::write(buffer, store);
+    buffer.finalize();
+    SerializationBuffer copy(buffer.data(), buffer.size());
+    YAML::Node binary_store = BinaryConfig::read(copy);
+
+    auto loaded_node = std::make_shared<SubgraphNode>(std::make_shared<GraphImplementation>());
+    auto loaded_graph = loaded_node->getLocalGraph();
+    GraphFacadeImplementation loaded_facade(executor, loaded_graph, loaded_node);
+
+    // observers of the factory run on the loading thread, before the saved state is read
+    std::vector<std::thread::id> observer_threads;
+    slim_signal::ScopedConnection observer = factory.node_constructed.connect([&](NodeFacadePtr node) {
+        observer_threads.push_back(std::this_thread::get_id());
+        node->getNodeState()->setMaximumFrequency(60.0);
+    });
+
+    GraphIO io(loaded_facade, &factory, true);
+    io.setLoadingThreads(4);
+    ASSERT_NO_THROW(io.loadGraphFrom(binary_store));
+
+    ASSERT_EQ(2 * pairs, observer_threads.size());
+    for (const std::thread::id& id : observer_threads) {
+        EXPECT_EQ(std::this_thread::get_id(), id);
+    }
+
+    EXPECT_EQ(2 * pairs, loaded_graph->countNodes());
+    EXPECT_EQ(pairs, loaded_facade.enumerateAllConnections().size());
+
+    // nodes keep the order of the file, independent of the order they were constructed in
+    std::vector<NodeFacadeImplementationPtr> nodes = loaded_graph->getAllLocalNodeFacades();
+    ASSERT_EQ(2 * pairs, nodes.size());
+    for (int i = 0; i < pairs; ++i) {
+        EXPECT_EQ("src_" + std::to_string(i), nodes[2 * i]->getUUID().getFullName());
+        EXPECT_EQ("sink_" + std::to_string(i), nodes[2 * i + 1]->getUUID().getFullName());
+        EXPECT_DOUBLE_EQ(5.0, nodes[2 * i]->getNodeState()->getMaximumFrequency());
+    }
+}
+
+}  // namespace csapex
@@ -0,0 +1,110 @@
+#include <csapex_testing/csapex_test_case.h>
+
+#include <csapex/profiling/interval.h>
+#include <csapex/profiling/interval_aggregator.h>
+#include <csapex/serialization/io/std_io.h>
+#include <csapex/serialization/io/csapex_io.h>
+#include <csapex/serialization/serialization_buffer.h>
+
+using namespace csapex;
+
+class IntervalAggregatorTest : public CsApexTestCase
+{
+protected:
+    // intervals are timed with the real clock, so they are created through deserialization
+    Interval::Ptr makeInterval(long end_micro, long length_micro, bool active = false, long step_micro = 0)
+    {
+        SerializationBuffer buffer;
+        buffer << std::string("node");
+        buffer << static_cast<uint64_t>((end_micro - length_micro) * 1000);
+        buffer << static_cast<uint64_t>(end_micro * 1000);
+        buffer << length_micro;
+        buffer << active;
+
+        std::map<std::string, Interval::Ptr> sub;
+        if (step_micro > 0) {
+            sub["step"] = makeInterval(end_micro, step_micro);
+        }
+        buffer << sub;
+
+        Interval::Ptr interval = Interval::makeEmpty();
+        SemanticVersion version;
+        interval->deserialize(buffer, version);
+        return interval;
+    }
+};
+
+TEST_F(IntervalAggregatorTest, SummaryCondensesIntervals)
+{
+    IntervalSummary summary("node", 0, 1000000);
+    summary.add(*makeInterval(100000, 5, true, 2));
+    summary.add(*makeInterval(200000, 2000, false, 1000));
+    summary.add(*makeInterval(300000, 1000000));
+
+    EXPECT_EQ(3, summary.count);
+    EXPECT_EQ(1, summary.active_count);
+    EXPECT_DOUBLE_EQ(0.005, summary.min_ms);
+    EXPECT_DOUBLE_EQ(1000.0, summary.max_ms);
+    EXPECT_NEAR((0.005 + 2.0 + 1000.0) / 3.0, summary.getMeanMs(), 1e-9);
+    EXPECT_NEAR(1.002, summary.steps_ms["step"], 1e-9);
+
+    EXPECT_EQ(1, summary.histogram[0]);
+    EXPECT_EQ(1, summary.histogram[IntervalSummary::getBin(2000)]);
+    EXPECT_EQ(1, summary.histogram[IntervalSummary::HISTOGRAM_BINS - 1]);
+    EXPECT_LT(2000, IntervalSummary::getBinUpperBoundMicro(IntervalSummary::getBin(2000)));
+
+    SerializationBuffer buffer;
+    buffer << std::any(summary);
+    std::any restored_any;
+    buffer >> restored_any;
+
+    IntervalSummary restored = std::any_cast<IntervalSummary>(restored_any);
+    EXPECT_EQ("node", restored.name);
+    EXPECT_EQ(1000000, restored.window_end_micro);
+    EXPECT_EQ(summary.count, restored.count);
+    EXPECT_DOUBLE_EQ(summary.total_ms, restored.total_ms);
+    EXPECT_EQ(summary.histogram, restored.histogram);
+    EXPECT_EQ(summary.steps_ms, restored.steps_ms);
+}
+
+TEST_F(IntervalAggregatorTest, IntervalsAreSummarizedPerWindow)
+{
+    IntervalAggregator aggregator(1000);
+
+    EXPECT_EQ(nullptr, aggregator.add(*makeInterval(10100, 50)));
+    EXPECT_EQ(nullptr, aggregator.add(*makeInterval(10900, 50)));
+
+    // the first interval of the next window completes the previous one
+    std::shared_ptr<const IntervalSummary> summary = aggregator.add(*makeInterval(11500, 50));
+    ASSERT_NE(nullptr, summary);
+    EXPECT_EQ(2, summary->count);
+    EXPECT_EQ(10000, summary->window_start_micro);
+    EXPECT_EQ(11000, summary->window_end_micro);
+
+    // intervals that end late are counted in the current window
+    EXPECT_EQ(nullptr, aggregator.add(*makeInterval(10950, 50)));
+
+    summary = aggregator.flush();
+    ASSERT_NE(nullptr, summary);
+    EXPECT_EQ(2, summary->count);
+    EXPECT_EQ(11000, summary->window_start_micro);
+
+    EXPECT_EQ(nullptr, aggregator.flush());
+}
+
+TEST_F(IntervalAggregatorTest, WindowsOfIdleTimersAreFlushedAfterTheirEnd)
+{
+    IntervalAggregator aggregator(1000);
+
+    EXPECT_EQ(nullptr, aggregator.add(*makeInterval(10100, 50)));
+
+    // the window is still open
+    EXPECT_EQ(nullptr, aggregator.flushExpired(10999));
+
+    std::shared_ptr<const IntervalSummary> summary = aggregator.flushExpired(11000);
+    ASSERT_NE(nullptr, summary);
+    EXPECT_EQ(1, summary->count);
+    EXPECT_EQ(10000, summary->window_start_micro);
+
+    EXPECT_EQ(nullptr, aggregator.flushExpired(20000));
+}
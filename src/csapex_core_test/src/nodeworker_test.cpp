@@ -7,7 +7,10 @@
 #include <csapex/model/node_modifier.h>
 #include <csapex/model/node_state.h>
 #include <csapex/model/direct_node_worker.h>
+#include <csapex/model/replicated_node_worker.h>
 #include <csapex/model/subprocess_node_worker.h>
+#include <csapex/model/subprocess_pool.h>
+#include <csapex/factory/node_wrapper.hpp>
 #include <csapex/msg/direct_connection.h>
 #include <csapex/msg/generic_value_message.hpp>
 #include <csapex/signal/event.h>
@@ -17,6 +20,7 @@
 #include <csapex/msg/io.h>
 #include <csapex/msg/output_transition.h>
 #include <csapex/msg/static_output.h>
+#include <csapex/param/parameter_factory.h>
 #include <csapex/utility/uuid_provider.h>
 
 #include <csapex_testing/csapex_test_case.h>
@@ -24,7 +28,9 @@
 #include <csapex_testing/test_exception_handler.h>
 
 #include <mutex>
+#include <set>
 #include <condition_variable>
+#include <csignal>
 
 #include <csapex_testing/stepping_test.h>
 
@@ -34,7 +40,140 @@ class NodeWorkerTest : public SteppingTest
 {
 };
 
-void runSyncTest(NodeFacadeImplementationPtr node_facade, int value = 23)
+/**
+ * @brief The MockupCrashingMultiplierNode class multiplies by 4, but crashes for negative inputs
+ */
+class MockupCrashingMultiplierNode
+{
+public:
+    void setup(NodeModifier& node_modifier)
+    {
+        in = node_modifier.addInput<int>("input");
+        out = node_modifier.addOutput<int>("output");
+    }
+
+    void setupParameters(Parameterizable& /*parameters*/)
+    {
+    }
+
+    void process(NodeModifier& /*node_modifier*/, Parameterizable& /*parameters*/)
+    {
+        int val = msg::getValue<int>(in);
+        if (val < 0) {
+            std::raise(SIGSEGV);
+        }
+        msg::publish(out, val * 4);
+    }
+
+private:
+    Input* in;
+    Output* out;
+};
+
+/**
+ * @brief The MockupParameterizedMultiplierNode class multiplies by a parameter that is read via a handle
+ */
+class MockupParameterizedMultiplierNode
+{
+public:
+    void setup(NodeModifier& node_modifier)
+    {
+        in = node_modifier.addInput<int>("input");
+        out = node_modifier.addOutput<int>("output");
+    }
+
+    void setupParameters(Parameterizable& parameters)
+    {
+        parameters.addParameter(param::factory::declareRange("factor", 1, 10, 4, 1));
+        factor = parameters.getParameterHandle<int>("factor");
+    }
+
+    void process(NodeModifier& /*node_modifier*/, Parameterizable& /*parameters*/)
+    {
+        msg::publish(out, msg::getValue<int>(in) * *factor);
+    }
+
+private:
+    Input* in;
+    Output* out;
+
+    ParameterHandle<int> factor;
+};
+
+/**
+ * @brief The MockupInstanceRecordingMultiplierNode class multiplies by a parameter and records which instance did the work
+ */
+class MockupInstanceRecordingMultiplierNode
+{
+public:
+    void setup(NodeModifier& node_modifier)
+    {
+        in = node_modifier.addInput<int>("input");
+        out = node_modifier.addOutput<int>("output");
+    }
+
+    void setupParameters(Parameterizable& parameters)
+    {
+        parameters.addParameter(param::factory::declareRange("factor", 1, 10, 4, 1));
+        factor = parameters.getParameterHandle<int>("factor");
+    }
+
+    void process(NodeModifier& /*node_modifier*/, Parameterizable& /*parameters*/)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            instances.insert(this);
+        }
+        msg::publish(out, msg::getValue<int>(in) * *factor);
+    }
+
+    static std::mutex mutex;
+    static std::set<const void*> instances;
+
+private:
+    Input* in;
+    Output* out;
+
+    ParameterHandle<int> factor;
+};
+
+std::mutex MockupInstanceRecordingMultiplierNode::mutex;
+std::set<const void*> MockupInstanceRecordingMultiplierNode::instances;
+
+/**
+ * @brief The MockupFailingReplicaNode class doubles its input, the setup of every instance but the first one fails
+ */
+class MockupFailingReplicaNode
+{
+public:
+    void setup(NodeModifier& node_modifier)
+    {
+        if (++setups > 1) {
+            throw std::runtime_error("cannot create another instance");
+        }
+        in = node_modifier.addInput<int>("input");
+        out = node_modifier.addOutput<int>("output");
+    }
+
+    void setupParameters(Parameterizable& /*parameters*/)
+    {
+    }
+
+    void process(NodeModifier& /*node_modifier*/, Parameterizable& /*parameters*/)
+    {
+        msg::publish(out, msg::getValue<int>(in) * 2);
+    }
+
+    static int setups;
+
+private:
+    Input* in;
+    Output* out;
+};
+
+int MockupFailingReplicaNode::setups = 0;
+
+void runSyncTest(NodeFacadeImplementationPtr node_facade, int value = 23, int factor = 4)
 {
     Node& node = *node_facade->getNode();
     NodeHandle& nh = *node_facade->getNodeHandle();
@@ -47,7 +186,7 @@ void runSyncTest(NodeFacadeImplementationPtr node_facade, int value = 23)
 
     // create a temporary output and connect it to the input
     OutputPtr tmp_out = std::make_shared<StaticOutput>(UUIDProvider::makeUUID_without_parent("tmp_out"));
-    InputPtr input = nh.getInput(UUIDProvider::makeUUID_without_parent("StaticMultiplier4:|:in_0"));
+    InputPtr input = nh.getInput(UUIDProvider::makeUUID_without_parent(node_facade->getUUID().getFullName() + ":|:in_0"));
     ASSERT_NE(nullptr, input);
     ConnectionPtr connection = DirectConnection::connect(tmp_out, input);
 
@@ -68,7 +207,7 @@ void runSyncTest(NodeFacadeImplementationPtr node_facade, int value = 23)
     ASSERT_TRUE(node_facade->startProcessingMessages());
 
     // commit the messages produced by the node
-    OutputPtr output = nh.getOutput(UUIDProvider::makeUUID_without_parent("StaticMultiplier4:|:out_0"));
+    OutputPtr output = nh.getOutput(UUIDProvider::makeUUID_without_parent(node_facade->getUUID().getFullName() + ":|:out_0"));
     ASSERT_NE(nullptr, output);
 
     // view outputs
@@ -79,7 +218,7 @@ void runSyncTest(NodeFacadeImplementationPtr node_facade, int value = 23)
     auto msg_out = std::dynamic_pointer_cast<connection_types::GenericValueMessage<int> const>(data_out);
     ASSERT_NE(nullptr, msg_out);
 
-    ASSERT_EQ(value * 4, msg_out->value);
+    ASSERT_EQ(value * factor, msg_out->value);
 
     input->removeConnection(tmp_out.get());
 }
@@ -181,6 +320,281 @@ TEST_F(NodeWorkerTest, SubprocessNodeWorkerCanHandleSegmentationFault)
     // TODO
 }
 
+TEST_F(NodeWorkerTest, SubprocessNodesShareSandboxes)
+{
+    SubprocessPool& pool = SubprocessPool::instance();
+    pool.setSize(1);
+    SubprocessPool::Stats before = pool.getStats();
+
+    auto make_isolated = [this](const std::string& name) {
+        NodeStatePtr state = std::make_shared<NodeState>(nullptr);
+        state->setExecutionType(ExecutionType::SUBPROCESS);
+        return factory.makeNode("StaticMultiplier4", UUIDProvider::makeUUID_without_parent(name), graph, state);
+    };
+    auto sandbox_of = [](const NodeFacadeImplementationPtr& node) {
+        auto worker = std::dynamic_pointer_cast<SubprocessNodeWorker>(node->getNodeWorker().lock());
+        return worker ? worker->getSandbox() : nullptr;
+    };
+
+    NodeFacadeImplementationPtr a = make_isolated("MultiplierA");
+    NodeFacadeImplementationPtr b = make_isolated("MultiplierB");
+
+    // loading the nodes does not fork
+    ASSERT_EQ(before.forks, pool.getStats().forks);
+    ASSERT_NE(nullptr, sandbox_of(a));
+    ASSERT_EQ(sandbox_of(a), sandbox_of(b));
+    ASSERT_EQ(before.sandboxes + 1, pool.getStats().sandboxes);
+
+    runSyncTest(a, 23);
+    runSyncTest(b, 42);
+    runSyncTest(a, 5);
+    ASSERT_EQ(before.forks + 1, pool.getStats().forks);
+
+    // a node that joins after the fork is only contained in a new process
+    NodeFacadeImplementationPtr c = make_isolated("MultiplierC");
+    ASSERT_EQ(sandbox_of(a), sandbox_of(c));
+    runSyncTest(c, 7);
+    runSyncTest(a, 8);
+    ASSERT_EQ(before.forks + 2, pool.getStats().forks);
+
+    pool.setSize(0);
+}
+
+TEST_F(NodeWorkerTest, SubprocessNodeWorkerSwitchesToStandbyAfterCrash)
+{
+    factory.registerNodeType(std::make_shared<NodeConstructor>("CrashingMultiplier4", []() { return NodePtr(new NodeWrapper<MockupCrashingMultiplierNode>()); }));
+
+    SubprocessPool& pool = SubprocessPool::instance();
+    pool.setStandby(true);
+    SubprocessPool::Stats before = pool.getStats();
+
+    NodeStatePtr state = std::make_shared<NodeState>(nullptr);
+    state->setExecutionType(ExecutionType::SUBPROCESS);
+    NodeFacadeImplementationPtr times_4 = factory.makeNode("CrashingMultiplier4", UUIDProvider::makeUUID_without_parent("StaticMultiplier4"), graph, state);
+
+    // the active process and its standby are forked for the first execution
+    runSyncTest(times_4, 23);
+    ASSERT_EQ(before.forks + 2, pool.getStats().forks);
+
+    {
+        NodeHandle& nh = *times_4->getNodeHandle();
+        OutputPtr tmp_out = std::make_shared<StaticOutput>(UUIDProvider::makeUUID_without_parent("tmp_out"));
+        InputPtr input = nh.getInput(UUIDProvider::makeUUID_without_parent("StaticMultiplier4:|:in_0"));
+        ConnectionPtr connection = DirectConnection::connect(tmp_out, input);
+
+        msg::publish(tmp_out.get(), -1);
+        tmp_out->commitMessages(false);
+        tmp_out->publish();
+
+        ASSERT_TRUE(times_4->startProcessingMessages());
+        ASSERT_TRUE(times_4->isError());
+
+        input->removeConnection(tmp_out.get());
+    }
+
+    SubprocessPool::Stats after = pool.getStats();
+    ASSERT_EQ(before.warm_restarts + 1, after.warm_restarts);
+    ASSERT_EQ(before.cold_restarts, after.cold_restarts);
+
+    // the former standby now processes the messages
+    runSyncTest(times_4, 42);
+
+    pool.setStandby(false);
+}
+
+TEST_F(NodeWorkerTest, ParameterHandlesReadTheSnapshotOfTheExecution)
+{
+    factory.registerNodeType(std::make_shared<NodeConstructor>("ParameterizedMultiplier", []() { return NodePtr(new NodeWrapper<MockupParameterizedMultiplierNode>()); }));
+
+    NodeFacadeImplementationPtr multiplier = factory.makeNode("ParameterizedMultiplier", UUIDProvider::makeUUID_without_parent("StaticMultiplier4"), graph);
+    NodePtr node = multiplier->getNode();
+
+    runSyncTest(multiplier, 23, 4);
+
+    // the handle keeps the value of the last snapshot until the next execution starts
+    ParameterHandle<int> factor = node->getParameterHandle<int>("factor");
+    node->setParameter("factor", 3);
+    ASSERT_EQ(4, *factor);
+    ASSERT_EQ(3, node->readParameter<int>("factor"));
+
+    runSyncTest(multiplier, 23, 3);
+    ASSERT_EQ(3, *factor);
+
+    // without changes, the snapshot is not replaced
+    const int* value = &factor.get();
+    runSyncTest(multiplier, 42, 3);
+    ASSERT_EQ(value, &factor.get());
+}
+
+TEST_F(NodeWorkerTest, ParameterHandlesShareOneSlotAndKeepTheirSnapshot)
+{
+    factory.registerNodeType(std::make_shared<NodeConstructor>("ParameterizedMultiplier", []() { return NodePtr(new NodeWrapper<MockupParameterizedMultiplierNode>()); }));
+
+    NodeFacadeImplementationPtr multiplier = factory.makeNode("ParameterizedMultiplier", UUIDProvider::makeUUID_without_parent("StaticMultiplier4"), graph);
+    NodePtr node = multiplier->getNode();
+    param::ParameterPtr param = node->getParameter("factor");
+
+    // asking for a handle again must neither add a slot nor another connection
+    int connections = param->parameter_changed.countAllConnections();
+    for (int i = 0; i < 100; ++i) {
+        node->getParameterHandle<int>("factor");
+    }
+    ASSERT_EQ(connections, param->parameter_changed.countAllConnections());
+    ASSERT_THROW(node->getParameterHandle<double>("factor"), std::logic_error);
+
+    // a reference stays valid for as many snapshots as it takes until the handle is read again
+    ParameterHandle<int> factor = node->getParameterHandle<int>("factor");
+    const int& value = factor.get();
+    for (int f = 5; f <= 8; ++f) {
+        node->setParameter("factor", f);
+        runSyncTest(multiplier, 23, f);
+    }
+    ASSERT_EQ(4, value);
+    ASSERT_EQ(8, *factor);
+}
+
+TEST_F(NodeWorkerTest, ReplicatedNodeWorkerProcessesQueuedTokensInOrder)
+{
+    factory.registerNodeType(std::make_shared<NodeConstructor>("RecordingMultiplier", []() { return NodePtr(new NodeWrapper<MockupInstanceRecordingMultiplierNode>()); }));
+    MockupInstanceRecordingMultiplierNode::instances.clear();
+
+    NodeStatePtr state = std::make_shared<NodeState>(nullptr);
+    state->setExecutionType(ExecutionType::REPLICATED);
+    state->setReplicaCount(3);
+    NodeFacadeImplementationPtr multiplier = factory.makeNode("RecordingMultiplier", UUIDProvider::makeUUID_without_parent("StaticMultiplier4"), graph, state);
+    ASSERT_EQ(ExecutionType::REPLICATED, multiplier->getNodeState()->getExecutionType());
+
+    auto nw = std::dynamic_pointer_cast<ReplicatedNodeWorker>(multiplier->getNodeWorker().lock());
+    ASSERT_NE(nullptr, nw);
+
+    // the replicas have to use the parameters of the node
+    multiplier->getNode()->setParameter("factor", 3);
+
+    NodeHandle& nh = *multiplier->getNodeHandle();
+    OutputPtr tmp_out = std::make_shared<StaticOutput>(UUIDProvider::makeUUID_without_parent("tmp_out"));
+    InputPtr input = nh.getInput(UUIDProvider::makeUUID_without_parent("StaticMultiplier4:|:in_0"));
+    ASSERT_NE(nullptr, input);
+    ConnectionPtr connection = DirectConnection::connect(tmp_out, input);
+    connection->setQueueCapacity(3);
+
+    for (int value = 1; value <= 3; ++value) {
+        tmp_out->setSequenceNumber(value);
+        msg::publish(tmp_out.get(), value);
+        tmp_out->commitMessages(false);
+        tmp_out->publish();
+    }
+    ASSERT_EQ(3, connection->getQueuedTokenCount());
+
+    OutputPtr output = nh.getOutput(UUIDProvider::makeUUID_without_parent("StaticMultiplier4:|:out_0"));
+    ASSERT_NE(nullptr, output);
+
+    // the results arrive in the order of the inputs, no matter which instance computed them
+    for (int value = 1; value <= 3; ++value) {
+        ASSERT_TRUE(multiplier->canProcess());
+        ASSERT_TRUE(multiplier->startProcessingMessages());
+
+        auto msg_out = std::dynamic_pointer_cast<connection_types::GenericValueMessage<int> const>(output->getToken()->getTokenData());
+        ASSERT_NE(nullptr, msg_out);
+        ASSERT_EQ(value * 3, msg_out->value);
+    }
+
+    // the queued tokens were processed by the two replicas
+    ASSERT_EQ(2, nw->getReplicaCount());
+    ASSERT_EQ(3, MockupInstanceRecordingMultiplierNode::instances.size());
+
+    input->removeConnection(tmp_out.get());
+}
+
+TEST_F(NodeWorkerTest, ReplicatedNodeWorkerOnlyReservesQueueCapacity)
+{
+    NodeStatePtr state = std::make_shared<NodeState>(nullptr);
+    state->setExecutionType(ExecutionType::REPLICATED);
+    state->setReplicaCount(3);
+    NodeFacadeImplementationPtr multiplier = factory.makeNode("StaticMultiplier4", UUIDProvider::makeUUID_without_parent("StaticMultiplier4"), graph, state);
+
+    NodeHandle& nh = *multiplier->getNodeHandle();
+    OutputPtr tmp_out = std::make_shared<StaticOutput>(UUIDProvider::makeUUID_without_parent("tmp_out"));
+    InputPtr input = nh.getInput(UUIDProvider::makeUUID_without_parent("StaticMultiplier4:|:in_0"));
+    ASSERT_NE(nullptr, input);
+    ConnectionPtr connection = DirectConnection::connect(tmp_out, input);
+
+    auto process = [&](int value) {
+        tmp_out->setSequenceNumber(value);
+        msg::publish(tmp_out.get(), value);
+        tmp_out->commitMessages(false);
+        tmp_out->publish();
+
+        ASSERT_TRUE(multiplier->canProcess());
+        ASSERT_TRUE(multiplier->startProcessingMessages());
+    };
+
+    ASSERT_NO_FATAL_FAILURE(process(1));
+
+    // the replicas can work ahead, but the configured capacity is the one that is saved
+    ASSERT_EQ(3, connection->getReservedQueueCapacity());
+    ASSERT_EQ(1, connection->getQueueCapacity());
+    ASSERT_EQ(1, connection->getDescription().queue_capacity);
+
+    multiplier->getNodeState()->setReplicaCount(1);
+    ASSERT_NO_FATAL_FAILURE(process(2));
+
+    ASSERT_EQ(0, connection->getReservedQueueCapacity());
+    ASSERT_EQ(1, connection->getQueueCapacity());
+
+    input->removeConnection(tmp_out.get());
+}
+
+TEST_F(NodeWorkerTest, ReplicatedNodeWorkerDoesNotRetryFailedReplicasOnEveryExecution)
+{
+    factory.registerNodeType(std::make_shared<NodeConstructor>("FailingReplica", []() { return NodePtr(new NodeWrapper<MockupFailingReplicaNode>()); }));
+    MockupFailingReplicaNode::setups = 0;
+
+    NodeStatePtr state = std::make_shared<NodeState>(nullptr);
+    state->setExecutionType(ExecutionType::REPLICATED);
+    state->setReplicaCount(3);
+    NodeFacadeImplementationPtr doubler = factory.makeNode("FailingReplica", UUIDProvider::makeUUID_without_parent("Doubler"), graph, state);
+    ASSERT_EQ(1, MockupFailingReplicaNode::setups);
+
+    auto nw = std::dynamic_pointer_cast<ReplicatedNodeWorker>(doubler->getNodeWorker().lock());
+    ASSERT_NE(nullptr, nw);
+
+    NodeHandle& nh = *doubler->getNodeHandle();
+    OutputPtr tmp_out = std::make_shared<StaticOutput>(UUIDProvider::makeUUID_without_parent("tmp_out"));
+    InputPtr input = nh.getInput(UUIDProvider::makeUUID_without_parent("Doubler:|:in_0"));
+    ASSERT_NE(nullptr, input);
+    DirectConnection::connect(tmp_out, input);
+    OutputPtr output = nh.getOutput(UUIDProvider::makeUUID_without_parent("Doubler:|:out_0"));
+    ASSERT_NE(nullptr, output);
+
+    auto process = [&](int value) {
+        tmp_out->setSequenceNumber(value);
+        msg::publish(tmp_out.get(), value);
+        tmp_out->commitMessages(false);
+        tmp_out->publish();
+
+        ASSERT_TRUE(doubler->canProcess());
+        ASSERT_TRUE(doubler->startProcessingMessages());
+
+        auto msg_out = std::dynamic_pointer_cast<connection_types::GenericValueMessage<int> const>(output->getToken()->getTokenData());
+        ASSERT_NE(nullptr, msg_out);
+        ASSERT_EQ(value * 2, msg_out->value);
+    };
+
+    // the node falls back to processing alone, the replica is only tried once
+    for (int value = 1; value <= 3; ++value) {
+        ASSERT_NO_FATAL_FAILURE(process(value));
+    }
+    ASSERT_EQ(0, nw->getReplicaCount());
+    ASSERT_EQ(2, MockupFailingReplicaNode::setups);
+
+    // changing the count tries again
+    doubler->getNodeState()->setReplicaCount(2);
+    ASSERT_NO_FATAL_FAILURE(process(4));
+    ASSERT_EQ(3, MockupFailingReplicaNode::setups);
+
+    input->removeConnection(tmp_out.get());
+}
+
 TEST_F(NodeWorkerTest, SubprocessNodeWorkerReceivesErrorMessagesFromSubprocess)
 {
     // TODO
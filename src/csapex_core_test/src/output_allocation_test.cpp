@@ -4,6 +4,7 @@
 #include <csapex/model/execution_type.h>
 #include <csapex/model/node_state.h>
 #include <csapex/msg/message_allocator.h>
+#include <csapex/msg/message_pool.h>
 #include <csapex/msg/output.h>
 
 #include <csapex_testing/test_exception_handler.h>
@@ -12,6 +13,7 @@
 #include <csapex_testing/io.h>
 
 #include <csapex/msg/generic_vector_message.hpp>
+#include <csapex/utility/type.h>
 
 /// SYSTEM
 #include <boost/interprocess/managed_shared_memory.hpp>
@@ -108,6 +110,53 @@ TEST_F(OutputAllocationTest, DefaultMessageAllocator)
     EXPECT_STREQ("frame", msgptr->frame_id.c_str());
 }
 
+TEST_F(OutputAllocationTest, DefaultMessageAllocatorRecyclesStorage)
+{
+    using M = connection_types::GenericValueMessage<int>;
+
+    MessageAllocator allocator;
+    MessagePool::Stats before = MessagePool::instance().getStats(type2name(typeid(M)));
+
+    M* first = nullptr;
+    {
+        M::Ptr msgptr = allocator.allocate<M>(23, "frame");
+        first = msgptr.get();
+    }
+
+    M::Ptr msgptr = allocator.allocate<M>(42, "frame");
+    EXPECT_EQ(first, msgptr.get());
+    EXPECT_EQ(42, msgptr->value);
+
+    MessagePool::Stats after = MessagePool::instance().getStats(type2name(typeid(M)));
+    EXPECT_GT(after.hits, before.hits);
+    EXPECT_GT(after.bytes_live, 0);
+}
+
+TEST_F(OutputAllocationTest, MessagePoolReservationsArePreallocated)
+{
+    using M = connection_types::GenericValueMessage<long double>;
+    const std::string name = type2name(typeid(M));
+
+    MessagePool::instance().reserve(name, 16);
+    ASSERT_EQ(16, MessagePool::instance().getReservations().at(name));
+
+    MessageAllocator allocator;
+    std::vector<M::Ptr> messages;
+    for (int i = 0; i < 16; ++i) {
+        messages.push_back(allocator.allocate<M>(i, "frame"));
+    }
+
+    MessagePool::Stats stats = MessagePool::instance().getStats(name);
+    EXPECT_EQ(16, stats.hits);
+    EXPECT_EQ(0, stats.misses);
+    EXPECT_EQ(0, stats.bytes_cached);
+
+    messages.clear();
+    stats = MessagePool::instance().getStats(name);
+    EXPECT_EQ(0, stats.bytes_live);
+    EXPECT_GT(stats.bytes_cached, 0);
+}
+
 TEST_F(OutputAllocationTest, OutputCanBeUsedToAllocateMessages)
 {
     NodeFacadeImplementationPtr nf = factory.makeNode("MockupSource", UUIDProvider::makeUUID_without_parent("src1"), graph);
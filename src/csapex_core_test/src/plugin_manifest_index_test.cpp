@@ -0,0 +1,113 @@
+#include <csapex_testing/csapex_test_case.h>
+
+#include <csapex/plugin/plugin_manifest_index.h>
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+using namespace csapex;
+
+namespace bf = boost::filesystem;
+
+class PluginManifestIndexTest : public CsApexTestCase
+{
+protected:
+    void SetUp() override
+    {
+        dir_ = bf::temp_directory_path() / bf::unique_path("csapex_manifest_index_%%%%-%%%%");
+        bf::create_directories(dir_);
+    }
+
+    void TearDown() override
+    {
+        PluginManifestIndex::instance().setFile("");
+        bf::remove_all(dir_);
+    }
+
+    std::string writeManifest(const std::string& name, const std::string& library, const std::string& type)
+    {
+        std::string file = (dir_ / name).string();
+        std::ofstream out(file);
+        out << "<library path=\"" << library << "\">\n"
+            << "  <class name=\"" << type << "\" type=\"" << type << "\" base_class_type=\"csapex::Node\">\n"
+            << "    <description>a node</description>\n"
+            << "    <tags>Test</tags>\n"
+            << "  </class>\n"
+            << "</library>\n";
+        return file;
+    }
+
+protected:
+    bf::path dir_;
+};
+
+TEST_F(PluginManifestIndexTest, ParsedManifestsContainAllClasses)
+{
+    std::string a = writeManifest("a.xml", "libfoo", "foo::A");
+    std::string b = writeManifest("b.xml", "libbar", "bar::B");
+    std::string missing = (dir_ / "missing.xml").string();
+
+    std::vector<PluginManifest> manifests = PluginManifestIndex::instance().parse({ a, missing, b });
+    ASSERT_EQ(3, manifests.size());
+
+    EXPECT_TRUE(manifests[0].valid);
+    EXPECT_FALSE(manifests[1].valid);
+    EXPECT_TRUE(manifests[2].valid);
+
+    ASSERT_EQ(1, manifests[2].libraries.size());
+    EXPECT_EQ("libbar", manifests[2].libraries[0].name);
+    ASSERT_EQ(1, manifests[2].libraries[0].classes.size());
+    const PluginManifest::Class& c = manifests[2].libraries[0].classes[0];
+    EXPECT_EQ("bar::B", c.name);
+    EXPECT_EQ("csapex::Node", c.base_class_type);
+    EXPECT_EQ("a node", c.description);
+    EXPECT_EQ("Test", c.tags);
+    EXPECT_NE(nullptr, manifests[2].document);
+}
+
+TEST_F(PluginManifestIndexTest, IndexIsPersistedAndInvalidatedByChanges)
+{
+    std::string index_file = (dir_ / "index").string();
+    std::string a = writeManifest("a.xml", "libfoo", "foo::A");
+
+    PluginManifestIndex& index = PluginManifestIndex::instance();
+    index.setFile(index_file);
+
+    PluginManifest manifest;
+    EXPECT_FALSE(index.lookup(a, manifest));
+    index.parse({ a });
+    index.save();
+    ASSERT_TRUE(bf::exists(index_file));
+
+    // reading the file again restores the entry without parsing
+    index.setFile("");
+    index.setFile(index_file);
+    ASSERT_TRUE(index.lookup(a, manifest));
+    EXPECT_TRUE(manifest.valid);
+    EXPECT_EQ(nullptr, manifest.document);
+    ASSERT_EQ(1, manifest.libraries.size());
+    EXPECT_EQ("foo::A", manifest.libraries[0].classes.at(0).name);
+
+    // a changed manifest is not served from the index anymore
+    writeManifest("a.xml", "libfoo", "foo::Renamed");
+    bf::last_write_time(a, bf::last_write_time(a) + 10);
+    EXPECT_FALSE(index.lookup(a, manifest));
+}
+
+TEST_F(PluginManifestIndexTest, EditsThatKeepSizeAndModificationTimeInvalidateTheIndex)
+{
+    std::string a = writeManifest("a.xml", "libfoo", "foo::A");
+    std::time_t modification = bf::last_write_time(a);
+
+    PluginManifestIndex& index = PluginManifestIndex::instance();
+    index.setFile((dir_ / "index").string());
+    index.parse({ a });
+
+    PluginManifest manifest;
+    ASSERT_TRUE(index.lookup(a, manifest));
+
+    // same length, same time stamp, only the content differs
+    writeManifest("a.xml", "libfoo", "foo::B");
+    bf::last_write_time(a, modification);
+    EXPECT_FALSE(index.lookup(a, manifest));
+}
@@ -3,13 +3,131 @@
 #include <csapex/model/graph/graph_impl.h>
 #include <csapex/model/execution_type.h>
 #include <csapex/model/node_state.h>
+#include <csapex/model/node_characteristics.h>
+#include <csapex/model/node_runner.h>
+#include <csapex/scheduling/thread_group.h>
+#include <csapex/factory/node_wrapper.hpp>
 
 #include <csapex_testing/test_exception_handler.h>
 #include <csapex_testing/mockup_nodes.h>
 #include <csapex_testing/stepping_test.h>
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 namespace csapex
 {
+namespace
+{
+/// counts the executions of the recording nodes below, which shows the order in which they were executed
+std::atomic<int> execution_counter(0);
+
+/**
+ * @brief The MockupOrderRecorderSinkNode class remembers when it was executed relative to the other recording nodes
+ */
+class MockupOrderRecorderSinkNode
+{
+public:
+    void setup(NodeModifier& node_modifier)
+    {
+        in = node_modifier.addInput<int>("input");
+    }
+
+    void setupParameters(Parameterizable& /*parameters*/)
+    {
+    }
+
+    void process(NodeModifier& /*node_modifier*/, Parameterizable& /*parameters*/)
+    {
+        order = ++execution_counter;
+    }
+
+    int order = 0;
+
+private:
+    Input* in;
+};
+
+/**
+ * @brief The MockupOrderRecorderJoinNode class joins two inputs and remembers when it was executed relative to the other recording nodes
+ */
+class MockupOrderRecorderJoinNode
+{
+public:
+    void setup(NodeModifier& node_modifier)
+    {
+        input_a = node_modifier.addInput<int>("input_a");
+        input_b = node_modifier.addInput<int>("input_b");
+        out = node_modifier.addOutput<int>("output");
+    }
+
+    void setupParameters(Parameterizable& /*parameters*/)
+    {
+    }
+
+    void process(NodeModifier& /*node_modifier*/, Parameterizable& /*parameters*/)
+    {
+        order = ++execution_counter;
+        msg::publish(out, msg::getValue<int>(input_a) + msg::getValue<int>(input_b));
+    }
+
+    int order = 0;
+
+private:
+    Input* input_a;
+    Input* input_b;
+    Output* out;
+};
+
+/**
+ * @brief The MockupDelayedForwarder class finishes its execution asynchronously, after 20 ms
+ */
+class MockupDelayedForwarder : public Node
+{
+public:
+    ~MockupDelayedForwarder() override
+    {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    void setup(NodeModifier& node_modifier) override
+    {
+        in = node_modifier.addInput<int>("input");
+        out = node_modifier.addOutput<int>("output");
+    }
+
+    void setupParameters(Parameterizable& /*parameters*/) override
+    {
+    }
+
+    bool isAsynchronous() const override
+    {
+        return true;
+    }
+
+    void process(NodeModifier& /*node_modifier*/, Parameterizable& /*parameters*/, Continuation continuation) override
+    {
+        int value = msg::getValue<int>(in);
+        if (worker.joinable()) {
+            worker.join();
+        }
+        worker = std::thread([this, value, continuation]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            continuation([this, value](NodeModifier&, Parameterizable&) { msg::publish(out, value); });
+        });
+    }
+
+private:
+    Input* in;
+    Output* out;
+
+    std::thread worker;
+};
+}  // namespace
+
 class SchedulingTest : public SteppingTest
 {
 protected:
@@ -101,6 +219,223 @@ TEST_F(SchedulingTest, SteppingWorksForProcessingGraphsInSubprocess)
     testStepping(ExecutionType::SUBPROCESS);
 }
 
+TEST_F(SchedulingTest, SteppingWorksForProcessingGraphsWithWorkStealing)
+{
+    executor.enableWorkStealing(4);
+    ASSERT_TRUE(executor.isWorkStealingEnabled());
+
+    // MAIN GRAPH
+    testStepping(ExecutionType::DIRECT);
+}
+
+TEST_F(SchedulingTest, SteppingWorksForProcessingGraphsWithCriticalPathPolicy)
+{
+    executor.setSchedulingPolicy(SchedulingPolicy::CRITICAL_PATH);
+    ASSERT_EQ(SchedulingPolicy::CRITICAL_PATH, executor.getDefaultGroup()->getSchedulingPolicy());
+
+    // MAIN GRAPH
+    testStepping(ExecutionType::DIRECT);
+}
+
+TEST_F(SchedulingTest, CriticalPathsAreDerivedFromTheGraph)
+{
+    // a fan-in graph: a long and a short branch are joined by the combiner
+    NodeFacadeImplementationPtr src = makeNode("MockupSource", UUIDProvider::makeUUID_without_parent("src"), graph, ExecutionType::DIRECT);
+    main_graph_facade->addNode(src);
+    NodeFacadeImplementationPtr long1 = makeNode("StaticMultiplier", UUIDProvider::makeUUID_without_parent("long1"), graph, ExecutionType::DIRECT);
+    main_graph_facade->addNode(long1);
+    NodeFacadeImplementationPtr long2 = makeNode("StaticMultiplier", UUIDProvider::makeUUID_without_parent("long2"), graph, ExecutionType::DIRECT);
+    main_graph_facade->addNode(long2);
+    NodeFacadeImplementationPtr combiner = makeNode("DynamicMultiplier", UUIDProvider::makeUUID_without_parent("combiner"), graph, ExecutionType::DIRECT);
+    main_graph_facade->addNode(combiner);
+    NodeFacadeImplementationPtr sink_p = makeNode("MockupSink", UUIDProvider::makeUUID_without_parent("sink"), graph, ExecutionType::DIRECT);
+    main_graph_facade->addNode(sink_p);
+
+    main_graph_facade->connect(src, "output", long1, "input");
+    main_graph_facade->connect(long1, "output", long2, "input");
+    main_graph_facade->connect(long2, "output", combiner, "input_a");
+    main_graph_facade->connect(src, "output", combiner, "input_b");
+    main_graph_facade->connect(combiner, "output", sink_p, "input");
+
+    ASSERT_EQ(5, src->getNodeCharacteristics().critical_path_length);
+    ASSERT_EQ(4, long1->getNodeCharacteristics().critical_path_length);
+    ASSERT_EQ(3, long2->getNodeCharacteristics().critical_path_length);
+    ASSERT_EQ(2, combiner->getNodeCharacteristics().critical_path_length);
+    ASSERT_EQ(1, sink_p->getNodeCharacteristics().critical_path_length);
+
+    ASSERT_TRUE(combiner->getNodeCharacteristics().is_joining_vertex);
+    ASSERT_TRUE(src->getNodeCharacteristics().is_unblocking_joining_vertex);
+    ASSERT_FALSE(long1->getNodeCharacteristics().is_unblocking_joining_vertex);
+    ASSERT_TRUE(long2->getNodeCharacteristics().is_unblocking_joining_vertex);
+    ASSERT_FALSE(combiner->getNodeCharacteristics().is_unblocking_joining_vertex);
+}
+
+TEST_F(SchedulingTest, CriticalPathPolicyExecutesTheChainOfAJoinFirst)
+{
+    factory.registerNodeType(std::make_shared<NodeConstructor>("OrderRecorderSink", []() { return NodePtr(new NodeWrapper<MockupOrderRecorderSinkNode>()); }));
+    factory.registerNodeType(std::make_shared<NodeConstructor>("OrderRecorderJoin", []() { return NodePtr(new NodeWrapper<MockupOrderRecorderJoinNode>()); }));
+
+    // src feeds four sinks and a chain that ends in a join, all nodes share one thread
+    NodeFacadeImplementationPtr src = makeNode("MockupSource", UUIDProvider::makeUUID_without_parent("src"), graph, ExecutionType::DIRECT);
+    main_graph_facade->addNode(src);
+    std::vector<std::shared_ptr<NodeWrapper<MockupOrderRecorderSinkNode>>> sides;
+    for (int i = 0; i < 4; ++i) {
+        NodeFacadeImplementationPtr side = makeNode("OrderRecorderSink", UUIDProvider::makeUUID_without_parent("side" + std::to_string(i)), graph, ExecutionType::DIRECT);
+        main_graph_facade->addNode(side);
+        main_graph_facade->connect(src, "output", side, "input");
+        sides.push_back(std::dynamic_pointer_cast<NodeWrapper<MockupOrderRecorderSinkNode>>(side->getNode()));
+        ASSERT_NE(nullptr, sides.back());
+    }
+    NodeFacadeImplementationPtr a1 = makeNode("StaticMultiplier", UUIDProvider::makeUUID_without_parent("a1"), graph, ExecutionType::DIRECT);
+    main_graph_facade->addNode(a1);
+    NodeFacadeImplementationPtr a2 = makeNode("StaticMultiplier", UUIDProvider::makeUUID_without_parent("a2"), graph, ExecutionType::DIRECT);
+    main_graph_facade->addNode(a2);
+    NodeFacadeImplementationPtr join = makeNode("OrderRecorderJoin", UUIDProvider::makeUUID_without_parent("join"), graph, ExecutionType::DIRECT);
+    main_graph_facade->addNode(join);
+    NodeFacadeImplementationPtr sink_p = makeNode("MockupSink", UUIDProvider::makeUUID_without_parent("sink"), graph, ExecutionType::DIRECT);
+    main_graph_facade->addNode(sink_p);
+
+    main_graph_facade->connect(src, "output", a1, "input");
+    main_graph_facade->connect(a1, "output", a2, "input");
+    main_graph_facade->connect(a2, "output", join, "input_a");
+    main_graph_facade->connect(src, "output", join, "input_b");
+    main_graph_facade->connect(join, "output", sink_p, "input");
+
+    auto recorder = std::dynamic_pointer_cast<NodeWrapper<MockupOrderRecorderJoinNode>>(join->getNode());
+    ASSERT_NE(nullptr, recorder);
+
+    executor.start();
+
+    // with FIFO, the sinks that were scheduled before the chain are executed before the join
+    executor.setSchedulingPolicy(SchedulingPolicy::FIFO);
+    for (int iter = 0; iter < 3; ++iter) {
+        ASSERT_NO_FATAL_FAILURE(step());
+        ASSERT_LT(sides.front()->order, recorder->order);
+    }
+
+    // with CRITICAL_PATH, the chain is dequeued first and the join precedes every sink
+    executor.setSchedulingPolicy(SchedulingPolicy::CRITICAL_PATH);
+    for (int iter = 0; iter < 3; ++iter) {
+        ASSERT_NO_FATAL_FAILURE(step());
+        for (const auto& side : sides) {
+            ASSERT_LT(recorder->order, side->order);
+        }
+    }
+}
+
+TEST_F(SchedulingTest, ExecutionTimeOfAsynchronousNodesIncludesTheContinuation)
+{
+    factory.registerNodeType(std::make_shared<NodeConstructor>("DelayedForwarder", []() { return NodePtr(new MockupDelayedForwarder); }));
+
+    NodeFacadeImplementationPtr src = makeNode("MockupSource", UUIDProvider::makeUUID_without_parent("src"), graph, ExecutionType::DIRECT);
+    main_graph_facade->addNode(src);
+    NodeFacadeImplementationPtr delayed = makeNode("DelayedForwarder", UUIDProvider::makeUUID_without_parent("delayed"), graph, ExecutionType::DIRECT);
+    main_graph_facade->addNode(delayed);
+    NodeFacadeImplementationPtr sink_p = makeNode("MockupSink", UUIDProvider::makeUUID_without_parent("sink"), graph, ExecutionType::DIRECT);
+    main_graph_facade->addNode(sink_p);
+    std::shared_ptr<MockupSink> sink = std::dynamic_pointer_cast<MockupSink>(sink_p->getNode());
+    ASSERT_NE(nullptr, sink);
+
+    main_graph_facade->connect(src, "output", delayed, "input");
+    main_graph_facade->connect(delayed, "output", sink_p, "input");
+
+    executor.start();
+
+    for (int iter = 0; iter < 3; ++iter) {
+        ASSERT_NO_FATAL_FAILURE(step());
+        ASSERT_EQ(iter, sink->getValue());
+    }
+
+    // process() returns right away, the 20 ms pass before the continuation is called
+    ASSERT_GE(delayed->getNodeRunner()->getMeanExecutionTime(), 20000.0);
+}
+
+TEST_F(SchedulingTest, LinearChainsAreFusedIntoOneTask)
+{
+    executor.setChainFusion(true);
+    ASSERT_TRUE(executor.getDefaultGroup()->isChainFusionEnabled());
+
+    // src -> m1 -> m2 -> sink has no branch, so all four nodes form one chain
+    NodeFacadeImplementationPtr src = makeNode("MockupSource", UUIDProvider::makeUUID_without_parent("src"), graph, ExecutionType::DIRECT);
+    main_graph_facade->addNode(src);
+    NodeFacadeImplementationPtr m1 = makeNode("StaticMultiplier", UUIDProvider::makeUUID_without_parent("m1"), graph, ExecutionType::DIRECT);
+    main_graph_facade->addNode(m1);
+    NodeFacadeImplementationPtr m2 = makeNode("StaticMultiplier", UUIDProvider::makeUUID_without_parent("m2"), graph, ExecutionType::DIRECT);
+    main_graph_facade->addNode(m2);
+    NodeFacadeImplementationPtr sink_p = makeNode("MockupSink", UUIDProvider::makeUUID_without_parent("sink"), graph, ExecutionType::DIRECT);
+    main_graph_facade->addNode(sink_p);
+    std::shared_ptr<MockupSink> sink = std::dynamic_pointer_cast<MockupSink>(sink_p->getNode());
+    ASSERT_NE(nullptr, sink);
+
+    main_graph_facade->connect(src, "output", m1, "input");
+    main_graph_facade->connect(m1, "output", m2, "input");
+    main_graph_facade->connect(m2, "output", sink_p, "input");
+
+    std::vector<std::vector<UUID>> chains = graph->getFusedChains();
+    ASSERT_EQ(1, chains.size());
+    ASSERT_EQ(4, chains.front().size());
+    ASSERT_EQ(src->getUUID(), chains.front().front());
+    ASSERT_EQ(sink_p->getUUID(), chains.front().back());
+
+    ASSERT_EQ(0, m1->getNodeCharacteristics().fused_chain);
+    ASSERT_TRUE(m1->getNodeCharacteristics().is_fused_with_child);
+    ASSERT_FALSE(sink_p->getNodeCharacteristics().is_fused_with_child);
+    ASSERT_EQ(m2->getNodeRunner(), m1->getNodeRunner()->getFusedSuccessor());
+
+    executor.start();
+
+    for (int iter = 0; iter < 20; ++iter) {
+        ASSERT_NO_FATAL_FAILURE(step());
+        ASSERT_EQ(iter * 4, sink->getValue());
+    }
+
+    std::vector<FusedChainReport> reports = graph->getFusedChainReports();
+    ASSERT_EQ(1, reports.size());
+    ASSERT_GT(reports.front().fused_executions, 0);
+    ASSERT_GE(reports.front().modeled_speedup, 1.0);
+}
+
+TEST_F(SchedulingTest, BranchesEndFusedChains)
+{
+    NodeFacadeImplementationPtr src = makeNode("MockupSource", UUIDProvider::makeUUID_without_parent("src"), graph, ExecutionType::DIRECT);
+    main_graph_facade->addNode(src);
+    NodeFacadeImplementationPtr m1 = makeNode("StaticMultiplier", UUIDProvider::makeUUID_without_parent("m1"), graph, ExecutionType::DIRECT);
+    main_graph_facade->addNode(m1);
+    NodeFacadeImplementationPtr m2 = makeNode("StaticMultiplier", UUIDProvider::makeUUID_without_parent("m2"), graph, ExecutionType::DIRECT);
+    main_graph_facade->addNode(m2);
+    NodeFacadeImplementationPtr combiner = makeNode("DynamicMultiplier", UUIDProvider::makeUUID_without_parent("combiner"), graph, ExecutionType::DIRECT);
+    main_graph_facade->addNode(combiner);
+
+    main_graph_facade->connect(src, "output", m1, "input");
+    main_graph_facade->connect(src, "output", m2, "input");
+    main_graph_facade->connect(m1, "output", combiner, "input_a");
+    main_graph_facade->connect(m2, "output", combiner, "input_b");
+
+    ASSERT_TRUE(graph->getFusedChains().empty());
+    ASSERT_EQ(-1, src->getNodeCharacteristics().fused_chain);
+    ASSERT_EQ(nullptr, m1->getNodeRunner()->getFusedSuccessor());
+}
+
+TEST_F(SchedulingTest, CyclesAreNotFused)
+{
+    // every node of the cycle has a single parent and a single child, but there is no head to start a chain from
+    NodeFacadeImplementationPtr m1 = makeNode("StaticMultiplier", UUIDProvider::makeUUID_without_parent("m1"), graph, ExecutionType::DIRECT);
+    main_graph_facade->addNode(m1);
+    NodeFacadeImplementationPtr m2 = makeNode("StaticMultiplier", UUIDProvider::makeUUID_without_parent("m2"), graph, ExecutionType::DIRECT);
+    main_graph_facade->addNode(m2);
+    NodeFacadeImplementationPtr m3 = makeNode("StaticMultiplier", UUIDProvider::makeUUID_without_parent("m3"), graph, ExecutionType::DIRECT);
+    main_graph_facade->addNode(m3);
+
+    main_graph_facade->connect(m1, "output", m2, "input");
+    main_graph_facade->connect(m2, "output", m3, "input");
+    main_graph_facade->connect(m3, "output", m1, "input");
+
+    ASSERT_TRUE(graph->getFusedChains().empty());
+    ASSERT_EQ(nullptr, m1->getNodeRunner()->getFusedSuccessor());
+    ASSERT_EQ(nullptr, m2->getNodeRunner()->getFusedSuccessor());
+    ASSERT_EQ(nullptr, m3->getNodeRunner()->getFusedSuccessor());
+}
+
 TEST_F(SchedulingTest, SteppingWorksForSourceGraphs)
 {
     // NESTED GRAPH
@@ -0,0 +1,139 @@
+#include <csapex/io/session.h>
+#include <csapex/io/raw_message.h>
+#include <csapex/utility/uuid_provider.h>
+
+#include <csapex_testing/csapex_test_case.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace csapex;
+using boost::asio::ip::tcp;
+
+class SessionTest : public CsApexTestCase
+{
+protected:
+    SessionTest() : target(UUIDProvider::makeUUID_without_parent("target"))
+    {
+        tcp::acceptor acceptor(io_service, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+        tcp::socket server_socket(io_service);
+        tcp::socket client_socket(io_service);
+
+        acceptor.async_accept(server_socket, [](boost::system::error_code) {});
+        client_socket.connect(acceptor.local_endpoint());
+        io_service.run();
+        io_service.reset();
+
+        sender = std::make_shared<Session>(std::move(client_socket), "sender");
+        receiver = std::make_shared<Session>(std::move(server_socket), "receiver");
+
+        receiver->raw_packet_received(target).connect([this](const StreamableConstPtr& packet) {
+            std::unique_lock<std::mutex> lock(received_mutex);
+            received.push_back(std::dynamic_pointer_cast<RawMessage const>(packet));
+            received_changed.notify_all();
+        });
+
+        sender->start();
+        receiver->start();
+
+        // both sessions keep a read pending, the io service runs until it is stopped
+        io_thread = std::thread([this]() { io_service.run(); });
+    }
+
+    ~SessionTest()
+    {
+        if (sender->isRunning()) {
+            sender->stop();
+        }
+        receiver->stop();
+
+        io_service.stop();
+        io_thread.join();
+    }
+
+    void send(const std::vector<uint8_t>& data)
+    {
+        sender->write(std::make_shared<RawMessage>(data, target));
+    }
+
+    std::vector<RawMessageConstPtr> waitFor(std::size_t count)
+    {
+        std::unique_lock<std::mutex> lock(received_mutex);
+        received_changed.wait_for(lock, std::chrono::seconds(5), [this, count]() { return received.size() >= count; });
+        return received;
+    }
+
+protected:
+    boost::asio::io_service io_service;
+    std::thread io_thread;
+
+    AUUID target;
+
+    SessionPtr sender;
+    SessionPtr receiver;
+
+    std::mutex received_mutex;
+    std::condition_variable received_changed;
+    std::vector<RawMessageConstPtr> received;
+};
+
+TEST_F(SessionTest, PacketsWrittenWithinTheFlushIntervalArriveInOneBatch)
+{
+    sender->setFlushInterval(std::chrono::milliseconds(50));
+
+    const std::size_t packets = 20;
+    for (std::size_t i = 0; i < packets; ++i) {
+        send({ static_cast<uint8_t>(i) });
+    }
+
+    auto packets_received = waitFor(packets);
+    ASSERT_EQ(packets, packets_received.size());
+    for (std::size_t i = 0; i < packets; ++i) {
+        ASSERT_EQ(std::vector<uint8_t>{ static_cast<uint8_t>(i) }, packets_received[i]->getData());
+    }
+
+    Session::Stats stats = sender->getStats();
+    ASSERT_EQ(packets, stats.packets_sent);
+    ASSERT_LT(stats.batches_sent, packets);
+    ASSERT_EQ(0, stats.packets_queued);
+    ASSERT_EQ(0, stats.packets_compressed);
+}
+
+TEST_F(SessionTest, CompressedPacketsArriveIntact)
+{
+    sender->setCompressionThreshold(1024);
+
+    std::vector<uint8_t> small(16, 42);
+    std::vector<uint8_t> large(100000);
+    for (std::size_t i = 0; i < large.size(); ++i) {
+        large[i] = static_cast<uint8_t>(i % 7);
+    }
+    send(small);
+    send(large);
+
+    auto packets_received = waitFor(2);
+    ASSERT_EQ(2, packets_received.size());
+    ASSERT_EQ(small, packets_received[0]->getData());
+    ASSERT_EQ(large, packets_received[1]->getData());
+
+    Session::Stats stats = sender->getStats();
+    ASSERT_EQ(1, stats.packets_compressed);
+    ASSERT_GT(stats.bytes_saved_by_compression, 0);
+}
+
+TEST_F(SessionTest, StoppingSendsTheQueuedPackets)
+{
+    // the interval is never reached, only stopping sends the packets
+    sender->setFlushInterval(std::chrono::seconds(60));
+
+    const std::size_t packets = 5;
+    for (std::size_t i = 0; i < packets; ++i) {
+        send({ static_cast<uint8_t>(i) });
+    }
+    sender->stop();
+
+    ASSERT_EQ(packets, waitFor(packets).size());
+    ASSERT_EQ(packets, sender->getStats().packets_sent);
+}
@@ -0,0 +1,122 @@
+#include <csapex/scheduling/task_queue.h>
+#include <csapex/scheduling/task.h>
+
+#include <csapex_testing/csapex_test_case.h>
+
+#include <set>
+#include <thread>
+
+using namespace csapex;
+
+namespace
+{
+std::vector<TaskPtr> makeTasks(std::size_t count)
+{
+    std::vector<TaskPtr> tasks;
+    for (std::size_t i = 0; i < count; ++i) {
+        tasks.push_back(std::make_shared<Task>("task", []() {}, 0));
+    }
+    return tasks;
+}
+
+}  // namespace
+
+class TaskQueueTest : public CsApexTestCase
+{
+};
+
+TEST_F(TaskQueueTest, PopReturnsHighestPriorityFirst)
+{
+    TaskQueue queue;
+
+    TaskPtr low = std::make_shared<Task>("low", []() {}, 0);
+    TaskPtr high = std::make_shared<Task>("high", []() {}, 10);
+    TaskPtr mid = std::make_shared<Task>("mid", []() {}, 5);
+
+    ASSERT_TRUE(queue.push(low));
+    ASSERT_TRUE(queue.push(high));
+    ASSERT_TRUE(queue.push(mid));
+
+    ASSERT_EQ(high, queue.pop());
+    ASSERT_EQ(mid, queue.pop());
+    ASSERT_EQ(low, queue.pop());
+    ASSERT_EQ(nullptr, queue.pop());
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST_F(TaskQueueTest, EqualPrioritiesAreFifo)
+{
+    TaskQueue queue;
+
+    std::vector<TaskPtr> tasks = makeTasks(16);
+    for (const TaskPtr& task : tasks) {
+        ASSERT_TRUE(queue.push(task));
+    }
+    for (const TaskPtr& task : tasks) {
+        ASSERT_EQ(task, queue.pop());
+    }
+}
+
+TEST_F(TaskQueueTest, DuplicatesAreSuppressedUntilPopped)
+{
+    TaskQueue queue;
+
+    TaskPtr task = std::make_shared<Task>("task", []() {}, 0);
+    ASSERT_TRUE(queue.push(task));
+    ASSERT_FALSE(queue.push(task));
+    ASSERT_TRUE(task->isScheduled());
+
+    ASSERT_EQ(task, queue.pop());
+    ASSERT_FALSE(task->isScheduled());
+    ASSERT_EQ(nullptr, queue.pop());
+
+    ASSERT_TRUE(queue.push(task));
+}
+
+TEST_F(TaskQueueTest, RemovedTasksCanBeScheduledAgain)
+{
+    TaskQueue queue;
+
+    TaskPtr a = std::make_shared<Task>("a", []() {}, 0);
+    TaskPtr b = std::make_shared<Task>("b", []() {}, 0);
+    queue.push(a);
+    queue.push(b);
+
+    std::vector<TaskPtr> removed = queue.removeIf([&a](const TaskPtr& t) { return t == a; });
+    ASSERT_EQ(1, removed.size());
+    ASSERT_EQ(a, removed.front());
+    ASSERT_FALSE(a->isScheduled());
+
+    queue.clear();
+    ASSERT_FALSE(b->isScheduled());
+    ASSERT_TRUE(queue.empty());
+
+    ASSERT_TRUE(queue.push(a));
+}
+
+TEST_F(TaskQueueTest, ConcurrentProducersDeliverEveryTaskOnce)
+{
+    TaskQueue queue;
+
+    std::vector<TaskPtr> tasks = makeTasks(4000);
+
+    std::vector<std::thread> producers;
+    for (std::size_t p = 0; p < 4; ++p) {
+        producers.emplace_back([&queue, &tasks, p]() {
+            for (std::size_t i = p; i < tasks.size(); i += 4) {
+                queue.push(tasks[i]);
+                // every task is pushed twice, the second push has to be suppressed
+                queue.push(tasks[i]);
+            }
+        });
+    }
+    for (std::thread& t : producers) {
+        t.join();
+    }
+
+    std::set<Task*> seen;
+    while (TaskPtr task = queue.pop()) {
+        ASSERT_TRUE(seen.insert(task.get()).second);
+    }
+    ASSERT_EQ(tasks.size(), seen.size());
+}
@@ -0,0 +1,246 @@
+#include <csapex/scheduling/timed_queue.h>
+#include <csapex/scheduling/scheduler.h>
+#include <csapex/scheduling/task.h>
+
+#include <csapex_testing/csapex_test_case.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace csapex;
+
+namespace
+{
+/**
+ * @brief The RecordingScheduler class remembers when the timed queue handed over which task
+ */
+class RecordingScheduler : public Scheduler
+{
+public:
+    typedef std::chrono::steady_clock clock;
+
+    struct Record
+    {
+        TaskPtr task;
+        clock::time_point time;
+    };
+
+    int id() const override
+    {
+        return 0;
+    }
+    std::string getName() const override
+    {
+        return "recording";
+    }
+    void setName(const std::string&) override
+    {
+    }
+    void setPause(bool) override
+    {
+    }
+    bool canStartStepping() const override
+    {
+        return true;
+    }
+    void setSteppingMode(bool) override
+    {
+    }
+    bool isStepping() const override
+    {
+        return false;
+    }
+    bool isStepDone() const override
+    {
+        return true;
+    }
+    void step() override
+    {
+    }
+    void start() override
+    {
+    }
+    void stop() override
+    {
+    }
+    void clear() override
+    {
+    }
+    bool isEmpty() const override
+    {
+        return true;
+    }
+    void add(TaskGeneratorPtr) override
+    {
+    }
+    void add(TaskGeneratorPtr, const std::vector<TaskPtr>&) override
+    {
+    }
+    std::vector<TaskPtr> remove(TaskGenerator*) override
+    {
+        return {};
+    }
+
+    void schedule(TaskPtr task) override
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        records_.push_back(Record{ task, clock::now() });
+        changed_.notify_all();
+    }
+    void scheduleDelayed(TaskPtr, clock::time_point) override
+    {
+    }
+
+    std::vector<Record> waitFor(std::size_t count, std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        changed_.wait_for(lock, timeout, [this, count]() { return records_.size() >= count; });
+        return records_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::vector<Record> records_;
+};
+
+TaskPtr makeTask(const std::string& name)
+{
+    return std::make_shared<Task>(name, []() {}, 0);
+}
+
+}  // namespace
+
+class TimedQueueTest : public CsApexTestCase
+{
+protected:
+    typedef std::chrono::steady_clock clock;
+
+    TimedQueueTest() : scheduler(std::make_shared<RecordingScheduler>())
+    {
+        queue.start();
+    }
+
+    ~TimedQueueTest()
+    {
+        queue.stop();
+    }
+
+    std::shared_ptr<RecordingScheduler> scheduler;
+    TimedQueue queue;
+};
+
+TEST_F(TimedQueueTest, TasksAreScheduledInOrderAndNeverEarly)
+{
+    auto now = clock::now();
+
+    TaskPtr a = makeTask("a");
+    TaskPtr b = makeTask("b");
+    TaskPtr c = makeTask("c");
+
+    auto time_a = now + std::chrono::milliseconds(30);
+    auto time_b = now + std::chrono::milliseconds(10);
+    auto time_c = now + std::chrono::milliseconds(20);
+    queue.schedule(scheduler, a, time_a);
+    queue.schedule(scheduler, b, time_b);
+    queue.schedule(scheduler, c, time_c);
+
+    auto records = scheduler->waitFor(3, std::chrono::seconds(2));
+    ASSERT_EQ(3, records.size());
+
+    ASSERT_EQ(b, records[0].task);
+    ASSERT_EQ(c, records[1].task);
+    ASSERT_EQ(a, records[2].task);
+
+    ASSERT_GE(records[0].time, time_b);
+    ASSERT_GE(records[1].time, time_c);
+    ASSERT_GE(records[2].time, time_a);
+
+    ASSERT_EQ(0, queue.size());
+}
+
+TEST_F(TimedQueueTest, ExpiredTimesAreScheduledImmediately)
+{
+    TaskPtr task = makeTask("task");
+    queue.schedule(scheduler, task, clock::now() - std::chrono::milliseconds(5));
+
+    auto records = scheduler->waitFor(1, std::chrono::milliseconds(0));
+    ASSERT_EQ(1, records.size());
+    ASSERT_EQ(task, records[0].task);
+}
+
+TEST_F(TimedQueueTest, TimersBeyondOneRotationWaitForTheirRound)
+{
+    auto now = clock::now();
+
+    // the same slot, one rotation apart
+    TaskPtr near = makeTask("near");
+    TaskPtr far = makeTask("far");
+    auto time_near = now + std::chrono::milliseconds(5);
+    auto time_far = time_near + std::chrono::milliseconds(TimedQueue::SLOT_COUNT);
+    queue.schedule(scheduler, far, time_far);
+    queue.schedule(scheduler, near, time_near);
+
+    auto records = scheduler->waitFor(1, std::chrono::seconds(1));
+    ASSERT_EQ(1, records.size());
+    ASSERT_EQ(near, records[0].task);
+    ASSERT_EQ(1, queue.size());
+
+    records = scheduler->waitFor(2, std::chrono::seconds(3));
+    ASSERT_EQ(2, records.size());
+    ASSERT_EQ(far, records[1].task);
+    ASSERT_GE(records[1].time, time_far);
+}
+
+TEST_F(TimedQueueTest, ManyTimersAllFireAndNoneEarly)
+{
+    const std::size_t timers = 200;
+    const auto period = std::chrono::microseconds(2500);
+
+    auto start = clock::now();
+    std::vector<clock::time_point> deadlines;
+    std::vector<TaskPtr> tasks;
+    for (std::size_t i = 0; i < timers; ++i) {
+        deadlines.push_back(start + period * (i + 1));
+        tasks.push_back(makeTask("periodic"));
+        queue.schedule(scheduler, tasks.back(), deadlines.back());
+    }
+
+    auto records = scheduler->waitFor(timers, std::chrono::seconds(5));
+    ASSERT_EQ(timers, records.size());
+
+    for (const auto& record : records) {
+        std::size_t index = std::find(tasks.begin(), tasks.end(), record.task) - tasks.begin();
+        ASSERT_LT(index, timers);
+        ASSERT_GE(record.time, deadlines[index]);
+    }
+}
+
+TEST_F(TimedQueueTest, NearDeadlinesFromSeveralThreadsAreNotDelayedByARotation)
+{
+    const std::size_t producers = 4;
+    const std::size_t timers_per_producer = 200;
+
+    // deadlines within the current tick race with the timer thread advancing the wheel
+    std::vector<std::thread> threads;
+    for (std::size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([this, timers_per_producer]() {
+            for (std::size_t i = 0; i < timers_per_producer; ++i) {
+                queue.schedule(scheduler, makeTask("racing"), clock::now() + std::chrono::microseconds(100 + (i % 10) * 100));
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    auto scheduled = clock::now();
+    auto records = scheduler->waitFor(producers * timers_per_producer, std::chrono::milliseconds(TimedQueue::SLOT_COUNT / 2));
+    ASSERT_EQ(producers * timers_per_producer, records.size());
+    ASSERT_LT(records.back().time - scheduled, std::chrono::milliseconds(TimedQueue::SLOT_COUNT / 2));
+    ASSERT_EQ(0, queue.size());
+}
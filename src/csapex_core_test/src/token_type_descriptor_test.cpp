@@ -0,0 +1,141 @@
+#include <csapex_testing/csapex_test_case.h>
+
+#include <csapex/model/token_type_descriptor.h>
+#include <csapex/msg/generic_value_message.hpp>
+#include <csapex/msg/generic_pointer_message.hpp>
+#include <csapex/msg/no_message.h>
+#include <csapex/serialization/serialization_buffer.h>
+
+using namespace csapex;
+using namespace connection_types;
+
+class TokenTypeDescriptorTest : public CsApexTestCase
+{
+};
+
+TEST_F(TokenTypeDescriptorTest, DescriptorsAreInterned)
+{
+    const TokenTypeDescriptor* a = TokenTypeDescriptor::get("Foo");
+    const TokenTypeDescriptor* b = TokenTypeDescriptor::get(std::string("Fo") + "o");
+    ASSERT_EQ(a, b);
+    ASSERT_EQ("Foo", a->typeName());
+    ASSERT_EQ("Foo", a->descriptiveName());
+
+    const TokenTypeDescriptor* described = TokenTypeDescriptor::get("Foo", "a foo");
+    ASSERT_NE(a, described);
+    ASSERT_EQ("a foo", described->descriptiveName());
+    ASSERT_EQ(a->typeId(), described->typeId());
+
+    ASSERT_NE(a->typeId(), TokenTypeDescriptor::get("Bar")->typeId());
+}
+
+TEST_F(TokenTypeDescriptorTest, MessagesOfATypeShareTheirDescriptor)
+{
+    GenericValueMessage<int> a(1);
+    GenericValueMessage<int> b(2);
+    GenericValueMessage<std::string> c("3");
+
+    ASSERT_EQ(a.getTypeDescriptor(), b.getTypeDescriptor());
+    ASSERT_NE(a.getTypeDescriptor(), c.getTypeDescriptor());
+    ASSERT_EQ(type<GenericValueMessage<int>>::name(), a.typeName());
+
+    ASSERT_TRUE(a.canConnectTo(&b));
+    ASSERT_FALSE(c.canConnectTo(&a));
+
+    NoMessage x, y;
+    ASSERT_EQ(x.getTypeDescriptor(), y.getTypeDescriptor());
+
+    TokenData::Ptr clone = a.cloneAs<TokenData>();
+    ASSERT_EQ(a.getTypeDescriptor(), clone->getTypeDescriptor());
+}
+
+TEST_F(TokenTypeDescriptorTest, PointerMessagesAreDescribedByTheirPointee)
+{
+    GenericPointerMessage<std::string> a;
+    GenericPointerMessage<std::string> b;
+    GenericPointerMessage<int> c;
+
+    ASSERT_EQ(a.getTypeDescriptor(), b.getTypeDescriptor());
+    ASSERT_EQ(type2name(typeid(std::string)), a.descriptiveName());
+    ASSERT_TRUE(a.canConnectTo(&b));
+    ASSERT_FALSE(a.canConnectTo(&c));
+}
+
+TEST_F(TokenTypeDescriptorTest, FrameIdsAreInterned)
+{
+    GenericValueMessage<int> a(1, "/base_link");
+    GenericValueMessage<int> b(2, "base_link");
+
+    ASSERT_EQ("base_link", a.frame_id);
+    ASSERT_EQ(a.frame_id.c_str(), b.frame_id.c_str());
+
+    GenericValueMessage<int>::Ptr copy = std::dynamic_pointer_cast<GenericValueMessage<int>>(a.cloneAs<TokenData>());
+    ASSERT_NE(nullptr, copy);
+    ASSERT_EQ(a.frame_id.c_str(), copy->frame_id.c_str());
+
+    b.frame_id = "odom";
+    ASSERT_EQ("odom", b.frame_id);
+    ASSERT_NE(a.frame_id, b.frame_id);
+}
+
+TEST_F(TokenTypeDescriptorTest, SerializationRestoresDescriptorAndFrameId)
+{
+    GenericValueMessage<int> a(42, "/map");
+
+    SerializationBuffer buffer;
+    SemanticVersion version;
+    a.Message::serialize(buffer, version);
+
+    GenericValueMessage<int> b;
+    b.frame_id = "odom";
+    b.Message::deserialize(buffer, version);
+
+    ASSERT_EQ(a.frame_id, b.frame_id);
+    ASSERT_EQ(a.getTypeDescriptor(), b.getTypeDescriptor());
+}
+
+TEST_F(TokenTypeDescriptorTest, NamesFromPeersCannotGrowTheRegistryWithoutBound)
+{
+    GenericValueMessage<int> a(42, "/map");
+    const TokenTypeDescriptor* own = a.getTypeDescriptor();
+
+    for (int i = 0; TokenTypeDescriptor::count() < TokenTypeDescriptor::MAX_UNTRUSTED_COUNT; ++i) {
+        ASSERT_NE(nullptr, TokenTypeDescriptor::tryGet("Flood", "flood " + std::to_string(i)));
+    }
+    std::size_t registered = TokenTypeDescriptor::count();
+
+    // known names are still found, unknown ones are not registered anymore
+    ASSERT_EQ(own, TokenTypeDescriptor::tryGet(own->typeName(), own->descriptiveName()));
+    ASSERT_EQ(nullptr, TokenTypeDescriptor::tryGet("Flood", "one more"));
+    ASSERT_EQ(registered, TokenTypeDescriptor::count());
+
+    SerializationBuffer buffer;
+    buffer << own->typeName() << std::string("unknown descriptive name");
+    buffer << std::string("map") << a.stamp_micro_seconds;
+
+    GenericValueMessage<int> b;
+    SemanticVersion version;
+    b.Message::deserialize(buffer, version);
+    ASSERT_EQ(own, b.getTypeDescriptor());
+    ASSERT_EQ("map", b.frame_id);
+    ASSERT_EQ(registered, TokenTypeDescriptor::count());
+}
+
+TEST_F(TokenTypeDescriptorTest, FrameIdsAreReleasedWithTheirMessages)
+{
+    std::size_t before = InternedString::count();
+    {
+        GenericValueMessage<int> a(42, "/released_frame");
+        ASSERT_EQ(before + 1, InternedString::count());
+
+        SerializationBuffer buffer;
+        SemanticVersion version;
+        a.Message::serialize(buffer, version);
+
+        GenericValueMessage<int> b;
+        b.Message::deserialize(buffer, version);
+        ASSERT_EQ(a.frame_id, b.frame_id);
+        ASSERT_EQ(before + 1, InternedString::count());
+    }
+    ASSERT_EQ(before, InternedString::count());
+}
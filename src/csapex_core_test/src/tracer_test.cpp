@@ -0,0 +1,222 @@
+#include <csapex_testing/csapex_test_case.h>
+
+#include <csapex/profiling/timer.h>
+#include <csapex/profiling/tracer.h>
+#include <csapex/utility/yaml.h>
+
+#include <set>
+#include <sstream>
+#include <thread>
+
+using namespace csapex;
+
+class TracerTest : public CsApexTestCase
+{
+protected:
+    TracerTest() : tracer(Tracer::instance())
+    {
+        tracer.stop();
+        tracer.clear();
+        tracer.setEnabled(true);
+    }
+
+    ~TracerTest() override
+    {
+        tracer.setEnabled(false);
+        tracer.setHistoryLength(1000000);
+        tracer.clear();
+    }
+
+    Tracer& tracer;
+};
+
+TEST_F(TracerTest, SpansAreOnlyRecordedWhenEnabled)
+{
+    tracer.setEnabled(false);
+    {
+        TRACE_SPAN("disabled");
+    }
+    tracer.setEnabled(true);
+    {
+        TRACE_SPAN("outer");
+        TRACE_SPAN("inner");
+    }
+
+    ASSERT_EQ(2, tracer.drain());
+
+    std::vector<TraceEvent> events = tracer.getEvents();
+    ASSERT_EQ(2, events.size());
+
+    // spans are recorded when they end
+    EXPECT_EQ("inner", tracer.getName(events[0].name));
+    EXPECT_EQ("outer", tracer.getName(events[1].name));
+    EXPECT_LE(events[1].begin_ns, events[0].begin_ns);
+    EXPECT_GE(events[1].end_ns, events[0].end_ns);
+    EXPECT_EQ(events[0].thread, events[1].thread);
+}
+
+TEST_F(TracerTest, TimerStepsAreRecorded)
+{
+    Timer timer("timer");
+    {
+        Trace::Ptr step = timer.step("step");
+    }
+    timer.finish();
+
+    tracer.drain();
+
+    std::set<std::string> names;
+    for (const TraceEvent& event : tracer.getEvents()) {
+        names.insert(tracer.getName(event.name));
+    }
+    EXPECT_EQ((std::set<std::string>{ "timer", "step" }), names);
+}
+
+TEST_F(TracerTest, TimerStepsAreRecordedOnce)
+{
+    Timer timer("timer");
+    {
+        Trace::Ptr step = timer.step("step");
+    }
+    timer.finish();
+
+    ASSERT_EQ(2, tracer.drain());
+}
+
+TEST_F(TracerTest, TimerStepsAreNestedIntoIntervals)
+{
+    tracer.setEnabled(false);
+
+    Timer timer("timer");
+    for (int i = 0; i < 3; ++i) {
+        Trace::Ptr outer = timer.step("outer");
+        Trace::Ptr inner = timer.step("inner");
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    {
+        Trace::Ptr other = timer.step("other");
+    }
+    timer.finish();
+
+    Interval::Ptr root = timer.getRoot();
+    ASSERT_EQ(2, root->sub.size());
+    ASSERT_EQ(1, root->sub.count("outer"));
+    ASSERT_EQ(1, root->sub.count("other"));
+
+    // repeated steps are accumulated
+    Interval::Ptr outer = root->sub.at("outer");
+    ASSERT_EQ(1, outer->sub.size());
+    Interval::Ptr inner = outer->sub.at("inner");
+    EXPECT_TRUE(inner->isStopped());
+    EXPECT_GE(inner->lengthMs(), 3.0);
+    EXPECT_GE(outer->lengthMs(), inner->lengthMs());
+    EXPECT_TRUE(root->sub.at("other")->sub.empty());
+
+    // a restarted timer starts with an empty tree
+    timer.restart();
+    timer.finish();
+    EXPECT_TRUE(timer.getRoot()->sub.empty());
+}
+
+TEST_F(TracerTest, StepsOfAnEarlierRunDoNotEndTheStepsOfTheNextOne)
+{
+    tracer.setEnabled(false);
+
+    Timer timer("timer");
+    Trace::Ptr earlier = timer.step("earlier");
+    timer.restart();
+
+    // the step reuses the slot of the earlier one
+    Trace::Ptr step = timer.step("step");
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    earlier.reset();
+    step.reset();
+    timer.finish();
+
+    Interval::Ptr root = timer.getRoot();
+    ASSERT_EQ(1, root->sub.size());
+    ASSERT_EQ(1, root->sub.count("step"));
+    EXPECT_GE(root->sub.at("step")->lengthMs(), 2.0);
+}
+
+TEST_F(TracerTest, TimerStepsBeyondTheCapacityAreDropped)
+{
+    Timer timer("timer");
+    for (std::size_t i = 0; i < Timer::STEP_CAPACITY + 10; ++i) {
+        Trace::Ptr step = timer.step("step");
+    }
+    timer.finish();
+
+    EXPECT_EQ(10, timer.countDroppedSteps());
+    EXPECT_EQ(1, timer.getRoot()->sub.size());
+}
+
+TEST_F(TracerTest, ThreadsRecordIntoSeparateBuffers)
+{
+    constexpr int threads = 4;
+    constexpr int spans = 1000;
+
+    tracer.start(std::chrono::milliseconds(1));
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([]() {
+            for (int i = 0; i < spans; ++i) {
+                TRACE_SPAN("work");
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    tracer.stop();
+    tracer.drain();
+
+    std::vector<TraceEvent> events = tracer.getEvents();
+    EXPECT_EQ(threads * spans, events.size() + tracer.countDroppedEvents());
+
+    std::set<uint32_t> thread_ids;
+    for (const TraceEvent& event : events) {
+        thread_ids.insert(event.thread);
+    }
+    EXPECT_EQ(threads, thread_ids.size());
+}
+
+TEST_F(TracerTest, FullBuffersDropEvents)
+{
+    for (std::size_t i = 0; i < Tracer::BUFFER_CAPACITY + 10; ++i) {
+        TRACE_SPAN("span");
+    }
+
+    EXPECT_EQ(10, tracer.countDroppedEvents());
+    EXPECT_EQ(Tracer::BUFFER_CAPACITY, tracer.drain());
+
+    tracer.setHistoryLength(100);
+    for (int i = 0; i < 150; ++i) {
+        TRACE_SPAN("span");
+    }
+    tracer.drain();
+
+    EXPECT_EQ(100, tracer.getEvents().size());
+}
+
+TEST_F(TracerTest, ChromeTraceIsValidJson)
+{
+    {
+        TraceSpan span(std::string("quoted \"name\""));
+    }
+
+    std::stringstream json;
+    tracer.writeChromeTrace(json);
+
+    // JSON is a subset of YAML
+    YAML::Node trace = YAML::Load(json.str());
+    YAML::Node events = trace["traceEvents"];
+    ASSERT_TRUE(events.IsSequence());
+    ASSERT_EQ(1, events.size());
+
+    EXPECT_EQ("quoted \"name\"", events[0]["name"].as<std::string>());
+    EXPECT_EQ("X", events[0]["ph"].as<std::string>());
+    EXPECT_GE(events[0]["dur"].as<double>(), 0.0);
+}
@@ -408,3 +408,43 @@ TEST_F(TransitionTest, TestBundledAndDirectConnectionsCanBeMixed)
         ASSERT_RECEIVED(*i2, iter);
     }
 }
+
+TEST_F(TransitionTest, TestQueuedConnectionsLetTheProducerRunAhead)
+{
+    OutputTransition ot;
+    ot.addOutput(o1);
+
+    InputTransition it;
+    it.addInput(i1);
+
+    int processed = 0;
+    ot.messages_processed.connect([&processed]() { ++processed; });
+
+    ConnectionPtr c = DirectConnection::connect(o1, i1);
+    c->setQueueCapacity(3);
+
+    // the producer can send until all slots are taken
+    for (int value = 1; value <= 3; ++value) {
+        ASSERT_TRUE(ot.canStartSendingMessages());
+        sendMessage(*o1, value);
+        ot.sendMessages(false);
+    }
+    ASSERT_FALSE(ot.canStartSendingMessages());
+    ASSERT_EQ(2, processed);
+    ASSERT_EQ(3, c->getQueuedTokenCount());
+
+    // the consumer receives the tokens in order, the first one frees a slot for the producer
+    for (int value = 1; value <= 3; ++value) {
+        ASSERT_TRUE(it.isEnabled());
+        it.forwardMessages();
+        ASSERT_RECEIVED(*i1, value);
+
+        it.notifyMessageRead();
+        it.notifyMessageProcessed();
+
+        ASSERT_TRUE(ot.canStartSendingMessages());
+    }
+    ASSERT_EQ(3, processed);
+    ASSERT_EQ(0, c->getQueuedTokenCount());
+    ASSERT_FALSE(it.isEnabled());
+}
@@ -0,0 +1,230 @@
+#include <csapex/scheduling/worker_pool.h>
+#include <csapex/scheduling/thread_group.h>
+#include <csapex/scheduling/task.h>
+#include <csapex/scheduling/timed_queue.h>
+
+#include <csapex_testing/csapex_test_case.h>
+#include <csapex_testing/test_exception_handler.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace csapex;
+
+namespace
+{
+/**
+ * @brief The Latch class blocks a job until the test releases it
+ */
+class Latch
+{
+public:
+    Latch() : entered_(false), released_(false)
+    {
+    }
+
+    void block()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        entered_ = true;
+        changed_.notify_all();
+        changed_.wait_for(lock, std::chrono::seconds(5), [this]() { return released_; });
+    }
+
+    void waitUntilBlocked()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        changed_.wait_for(lock, std::chrono::seconds(5), [this]() { return entered_; });
+    }
+
+    void release()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        released_ = true;
+        changed_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    bool entered_;
+    bool released_;
+};
+
+bool waitFor(const std::function<bool()>& condition)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+}  // namespace
+
+class WorkerPoolTest : public CsApexTestCase
+{
+};
+
+TEST_F(WorkerPoolTest, JobsWithHigherPriorityAreExecutedFirst)
+{
+    WorkerPool pool(1);
+    pool.start();
+
+    Latch latch;
+    pool.post([&latch]() { latch.block(); });
+    latch.waitUntilBlocked();
+
+    std::mutex order_mutex;
+    std::vector<long> order;
+    for (long priority : { 1, 3, 0, 2, 3 }) {
+        pool.post(
+            [&order_mutex, &order, priority]() {
+                std::unique_lock<std::mutex> lock(order_mutex);
+                order.push_back(priority);
+            },
+            -1, priority);
+    }
+
+    latch.release();
+    ASSERT_TRUE(waitFor([&pool]() { return pool.getExecutedCount() == 6; }));
+    pool.stop();
+
+    ASSERT_EQ((std::vector<long>{ 3, 3, 2, 1, 0 }), order);
+}
+
+TEST_F(WorkerPoolTest, IdleWorkersStealFromAnOverloadedWorker)
+{
+    WorkerPool pool(4);
+    pool.start();
+
+    // every job is queued at worker 0, which is blocked until the others have done all the work
+    Latch latch;
+    pool.post([&latch]() { latch.block(); }, 0);
+    latch.waitUntilBlocked();
+
+    const std::size_t jobs = 100;
+    std::atomic<std::size_t> done(0);
+    for (std::size_t i = 0; i < jobs; ++i) {
+        pool.post([&done]() { ++done; }, 0);
+    }
+
+    ASSERT_TRUE(waitFor([&done]() { return done == jobs; }));
+    ASSERT_EQ(jobs, pool.getStolenCount());
+
+    latch.release();
+    pool.stop();
+}
+
+TEST_F(WorkerPoolTest, StoppingDiscardsQueuedJobs)
+{
+    WorkerPool pool(2);
+    pool.start();
+
+    Latch latch_a;
+    Latch latch_b;
+    pool.post([&latch_a]() { latch_a.block(); }, 0);
+    pool.post([&latch_b]() { latch_b.block(); }, 1);
+    latch_a.waitUntilBlocked();
+    latch_b.waitUntilBlocked();
+
+    std::atomic<int> executed(0);
+    for (int i = 0; i < 10; ++i) {
+        pool.post([&executed]() { ++executed; });
+    }
+
+    // workers finish their current job, the queued ones are dropped
+    std::thread stopper([&pool]() { pool.stop(); });
+    ASSERT_TRUE(waitFor([&pool]() { return !pool.isRunning(); }));
+    latch_a.release();
+    latch_b.release();
+    stopper.join();
+
+    ASSERT_EQ(2, pool.getExecutedCount());
+    ASSERT_EQ(0, executed);
+
+    // nothing is left over for the next start
+    pool.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    pool.stop();
+    ASSERT_EQ(0, executed);
+}
+
+TEST_F(WorkerPoolTest, ThreadGroupsPassTheirTaskPriorityToThePool)
+{
+    TestExceptionHandler handler;
+    TimedQueuePtr timed_queue = std::make_shared<TimedQueue>();
+
+    WorkerPoolPtr pool = std::make_shared<WorkerPool>(1);
+    ThreadGroupPtr low = std::make_shared<ThreadGroup>(timed_queue, handler, "low");
+    ThreadGroupPtr high = std::make_shared<ThreadGroup>(timed_queue, handler, "high");
+    low->useWorkerPool(pool);
+    high->useWorkerPool(pool);
+    pool->start();
+    low->start();
+    high->start();
+
+    Latch latch;
+    pool->post([&latch]() { latch.block(); });
+    latch.waitUntilBlocked();
+
+    std::mutex order_mutex;
+    std::vector<std::string> order;
+    auto record = [&order_mutex, &order](const std::string& name) {
+        std::unique_lock<std::mutex> lock(order_mutex);
+        order.push_back(name);
+    };
+    low->schedule(std::make_shared<Task>("low", [&record]() { record("low"); }, 1));
+    high->schedule(std::make_shared<Task>("high", [&record]() { record("high"); }, 5));
+
+    latch.release();
+    ASSERT_TRUE(waitFor([&order_mutex, &order]() {
+        std::unique_lock<std::mutex> lock(order_mutex);
+        return order.size() == 2;
+    }));
+
+    low->stop();
+    high->stop();
+    pool->stop();
+
+    ASSERT_EQ((std::vector<std::string>{ "high", "low" }), order);
+}
+
+TEST_F(WorkerPoolTest, StoppingAGroupDropsItsQueuedTasks)
+{
+    TestExceptionHandler handler;
+    TimedQueuePtr timed_queue = std::make_shared<TimedQueue>();
+
+    WorkerPoolPtr pool = std::make_shared<WorkerPool>(2);
+    ThreadGroupPtr group = std::make_shared<ThreadGroup>(timed_queue, handler, "group");
+    group->useWorkerPool(pool);
+    pool->start();
+    group->start();
+
+    // tasks without a generator share one strand, so the first one blocks the others
+    Latch latch;
+    std::atomic<int> executed(0);
+    group->schedule(std::make_shared<Task>("blocking", [&latch]() { latch.block(); }));
+    latch.waitUntilBlocked();
+    for (int i = 0; i < 10; ++i) {
+        group->schedule(std::make_shared<Task>("queued", [&executed]() { ++executed; }));
+    }
+
+    // stopping waits for the running task, but not for the queued ones
+    std::thread stopper([&group]() { group->stop(); });
+    ASSERT_TRUE(waitFor([&group]() { return !group->isRunning(); }));
+    latch.release();
+    stopper.join();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    pool->stop();
+
+    ASSERT_EQ(0, executed);
+}
@@ -4,6 +4,7 @@
 /// COMPONENT
 #include <csapex_qt/export.h>
 #include <csapex/data/point.h>
+#include <csapex/model/connection_description.h>
 #include <csapex/command/command_fwd.h>
 #include <csapex/view/view_fwd.h>
 #include <csapex/view/designer/fulcrum_widget.h>
@@ -16,13 +17,14 @@
 /// SYSTEM
 #include <QGraphicsScene>
 #include <QLabel>
+#include <QPainterPath>
 #include <QTime>
+#include <set>
 #include <unordered_map>
 #include <QPointer>
 
 namespace csapex
 {
-class ConnectionDescription;
 class Timer;
 
 class CSAPEX_QT_EXPORT DesignerScene : public QGraphicsScene, public Profilable
@@ -55,6 +57,11 @@ public:
 
     std::string makeStatusString() const;
 
+    /// invalidates the cached geometry of all connections of a node or connector
+    void invalidateConnectionGeometry(const UUID& uuid);
+    /// invalidates the cached geometry of all connections of the graph's own ports
+    void invalidateGraphPortGeometry();
+
 public Q_SLOTS:
     void fulcrumAdded(Fulcrum* f);
     void fulcrumMoved(void* f, bool dropped);
@@ -96,6 +103,9 @@ private:
 
     void displayConnections(bool& member, bool show);
 
+    void invalidateConnectionGeometry(int id);
+    void invalidateAllConnectionGeometry();
+
 private:
     struct TempConnection
     {
@@ -157,10 +167,43 @@ private:
         double r;
     };
 
+    /**
+     * @brief The ConnectionGeometry struct caches the paths of a connection, they only change when a box or a fulcrum moves
+     */
+    struct ConnectionGeometry
+    {
+        QPointF from;
+        QPointF to;
+        QPointF real_to;
+
+        Position start_pos;
+        Position end_pos;
+
+        bool minimized;
+        bool asynchronous;
+
+        std::vector<std::pair<QPainterPath, int>> paths;
+        QRectF bounds;
+    };
+
 private:
-    void drawConnection(QPainter* painter, const ConnectionDescription& connection);
-    std::vector<QRectF> drawConnection(QPainter* painter, Connector* from, Connector* to, int id);
-    std::vector<QRectF> drawConnection(QPainter* painter, const QPointF& from, const QPointF& to, int id);
+    void drawConnection(QPainter* painter, int id);
+    void drawConnection(QPainter* painter, Connector* from, Connector* to, int id);
+    void drawConnection(QPainter* painter, const QPointF& from, const QPointF& to, int id);
+    void drawConnection(QPainter* painter, const ConnectionGeometry& geometry, int id);
+
+    bool isDisplayed(Connector* to) const;
+    void updateConnectionState(Connector* from, Connector* to, Port* from_port, Port* to_port, int id);
+
+    bool makeConnectionGeometry(const ConnectionDescription& connection, ConnectionGeometry& geometry);
+    ConnectionGeometry makeConnectionGeometry(const QPointF& from, const QPointF& to, const std::vector<Fulcrum>& fulcrums);
+    void updateConnectionGeometry();
+
+    std::vector<int> findConnections(const QRectF& rect) const;
+    void addToGrid(int id, const QRectF& bounds);
+    void removeFromGrid(int id, const QRectF& bounds);
+
+    void drawSchematics();
 
     void drawPort(QPainter* painter, bool selected, Port* p, int pos = -1);
 
@@ -186,7 +229,12 @@ private:
     std::vector<TempConnection> temp_;
 
     std::vector<csapex::slim_signal::Connection> connections_;
-    std::map<int, std::vector<QRectF>> connection_bb_;
+
+    std::unordered_map<int, ConnectionDescription> connection_descriptions_;
+    std::map<int, ConnectionWeakPtr> local_connections_;
+    std::unordered_map<int, ConnectionGeometry> connection_geometry_;
+    std::set<int> dirty_connections_;
+    std::unordered_map<int64_t, std::vector<int>> connection_grid_;
 
     std::map<int, std::vector<Fulcrum>> connection_2_fulcrum_;
     std::map<Fulcrum*, FulcrumWidget*> fulcrum_2_widget_;
@@ -251,6 +251,7 @@ private:
     void flipBox();
     void setExecutionMode(ExecutionMode mode);
     void setExecutionType(ExecutionType typed);
+    void setReplicatedExecution(int replicas);
     void setLoggerLevel(int level);
     void setMaximumFrequency();
     void setUnboundedMaximumFrequency();
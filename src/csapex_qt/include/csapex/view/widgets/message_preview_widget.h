@@ -5,10 +5,19 @@
 #include <csapex_qt/export.h>
 #include <csapex/msg/output.h>
 #include <csapex/msg/input.h>
+#include <csapex/msg/msg_fwd.h>
+#include <csapex/utility/latest_value_slot.hpp>
 
 /// SYSTEM
 #include <QGraphicsView>
 #include <QPointer>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <typeindex>
 
 namespace csapex
 {
@@ -16,17 +25,56 @@ class MessagePreviewWidget;
 
 namespace impl
 {
+/**
+ * @brief The PreviewRenderer renders the latest message of a preview in a background thread.
+ *        Producers only replace the message in a lock-free mailbox, messages that arrive faster than
+ *        the maximum frame rate are dropped instead of delaying the producer.
+ */
+class CSAPEX_QT_EXPORT PreviewRenderer
+{
+public:
+    PreviewRenderer(QPointer<MessagePreviewWidget> parent);
+    ~PreviewRenderer();
+
+    void post(const TokenDataConstPtr& message);
+
+    void setMaximumFrameRate(double fps);
+
+    void stop();
+
+private:
+    void run();
+    void render(const TokenDataConstPtr& message);
+    MessageRendererPtr getRenderer(const TokenDataConstPtr& message);
+
+private:
+    QPointer<MessagePreviewWidget> parent_;
+
+    LatestValueSlot<TokenDataConstPtr> mailbox_;
+
+    std::atomic<bool> running_;
+    std::atomic<long> frame_interval_us_;
+
+    std::mutex wakeup_mutex_;
+    std::condition_variable wakeup_;
+
+    // renderers are looked up once per message type
+    std::map<std::type_index, MessageRendererPtr> renderers_;
+
+    std::thread thread_;
+};
+
 class CSAPEX_QT_EXPORT PreviewInput : public Input
 {
 public:
-    PreviewInput(QPointer<MessagePreviewWidget> parent);
+    PreviewInput(std::shared_ptr<PreviewRenderer> renderer);
 
     void setToken(TokenPtr message) override;
 
     void detach();
 
 private:
-    QPointer<MessagePreviewWidget> parent_;
+    std::shared_ptr<PreviewRenderer> renderer_;
 };
 }  // namespace impl
 
@@ -46,6 +94,8 @@ public:
 
     bool isConnected() const;
 
+    void setMaximumFrameRate(double fps);
+
 Q_SIGNALS:
     void displayImageRequest(const QImage& msg);
     void displayTextRequest(const QString& txt);
@@ -60,6 +110,7 @@ private:
 
 private:
     ConnectionPtr connection_;
+    std::shared_ptr<impl::PreviewRenderer> renderer_;
     std::shared_ptr<impl::PreviewInput> input_;
 
     QString displayed_;
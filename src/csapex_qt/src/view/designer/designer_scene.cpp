@@ -16,6 +16,7 @@
 #include <csapex/model/graph_facade_impl.h>
 #include <csapex/model/graph/graph_impl.h>
 #include <csapex/model/graph.h>
+#include <csapex/model/token.h>
 #include <csapex/msg/marker_message.h>
 #include <csapex/msg/no_message.h>
 #include <csapex/profiling/trace.hpp>
@@ -32,6 +33,8 @@
 #include <QtGui>
 #include <QtOpenGL>
 #include <QTimer>
+#include <algorithm>
+#include <cmath>
 
 #ifndef GL_MULTISAMPLE
 #define GL_MULTISAMPLE 0x809D
@@ -101,6 +104,32 @@ Point convert(const QPointF& p)
 {
     return Point(p.x(), p.y());
 }
+
+const double GRID_CELL_SIZE = 256.0;
+
+int64_t cellKey(int x, int y)
+{
+    return (static_cast<int64_t>(x) << 32) | static_cast<uint32_t>(y);
+}
+
+struct CellRange
+{
+    int min_x;
+    int min_y;
+    int max_x;
+    int max_y;
+
+    std::size_t size() const
+    {
+        return static_cast<std::size_t>(max_x - min_x + 1) * static_cast<std::size_t>(max_y - min_y + 1);
+    }
+};
+
+CellRange cellsOf(const QRectF& rect)
+{
+    return CellRange{ static_cast<int>(std::floor(rect.left() / GRID_CELL_SIZE)), static_cast<int>(std::floor(rect.top() / GRID_CELL_SIZE)),
+                      static_cast<int>(std::floor(rect.right() / GRID_CELL_SIZE)), static_cast<int>(std::floor(rect.bottom() / GRID_CELL_SIZE)) };
+}
 }  // namespace
 
 DesignerScene::DesignerScene(GraphFacadePtr graph_facade, CsApexViewCore& view_core)
@@ -200,8 +229,6 @@ void DesignerScene::displayConnections(bool& member, bool display)
     if (display != member) {
         member = display;
 
-        connection_bb_.clear();
-
         invalidate();
     }
 }
@@ -375,21 +402,15 @@ void DesignerScene::drawForeground(QPainter* painter, const QRectF& rect)
             }
         }
 
-        // draw all connections
-        auto intersects_any = [](const std::vector<QRectF>& rects, const QRectF& rect) {
-            for (auto r : rects) {
-                if (rect.intersects(r)) {
-                    return true;
-                }
-            }
-            return false;
-        };
+        // draw the connections that intersect the exposed area
+        updateConnectionGeometry();
 
-        for (const ConnectionDescription& connection : graph_facade_->enumerateAllConnections()) {
-            auto pos = connection_bb_.find(connection.id);
-            if (pos == connection_bb_.end() || intersects_any(pos->second, rect)) {
-                drawConnection(painter, connection);
-            }
+        for (int id : findConnections(rect)) {
+            drawConnection(painter, id);
+        }
+
+        if (schema_dirty_) {
+            drawSchematics();
         }
     }
 
@@ -687,6 +708,9 @@ bool DesignerScene::isEmpty() const
 
 void DesignerScene::connectionAdded(const ConnectionDescription& ci)
 {
+    connection_descriptions_[ci.id] = ci;
+    invalidateConnectionGeometry(ci.id);
+
     for (const Fulcrum& f : ci.fulcrums) {
         connection_2_fulcrum_[ci.id].push_back(f);
         Fulcrum* proxy = &connection_2_fulcrum_[ci.id].back();
@@ -695,6 +719,7 @@ void DesignerScene::connectionAdded(const ConnectionDescription& ci)
 
     if (GraphFacadeImplementationPtr gfl = std::dynamic_pointer_cast<GraphFacadeImplementation>(graph_facade_)) {
         ConnectionPtr connection = gfl->getLocalGraph()->getConnection(ci.from, ci.to);
+        local_connections_[ci.id] = connection;
 
         connection->fulcrum_added.connect(std::bind(&DesignerScene::fulcrumAdded, this, std::placeholders::_1));
         connection->fulcrum_deleted.connect(std::bind(&DesignerScene::fulcrumDeleted, this, std::placeholders::_1));
@@ -711,6 +736,11 @@ void DesignerScene::connectionAdded(const ConnectionDescription& ci)
 
 void DesignerScene::connectionDeleted(const ConnectionDescription& ci)
 {
+    invalidateConnectionGeometry(ci.id);
+    dirty_connections_.erase(ci.id);
+    connection_descriptions_.erase(ci.id);
+    local_connections_.erase(ci.id);
+
     invalidateSchema();
 }
 
@@ -742,6 +772,7 @@ void DesignerScene::fulcrumAdded(Fulcrum* f)
     w->setSelected(true);
     setFocusItem(w, Qt::MouseFocusReason);
 
+    invalidateConnectionGeometry(f->connectionId());
     invalidateSchema();
 }
 
@@ -758,6 +789,7 @@ void DesignerScene::fulcrumDeleted(void* fulcrum)
     pos->second->deleteLater();
     fulcrum_2_widget_.erase(pos);
 
+    invalidateConnectionGeometry(f->connectionId());
     invalidateSchema();
 }
 
@@ -769,6 +801,7 @@ void DesignerScene::fulcrumMoved(void* fulcrum, bool dropped)
         view_core_.getCommandDispatcher()->execute(Command::Ptr(new command::MoveFulcrum(graph_facade_->getAbsoluteUUID(), f->connectionId(), f->id(), fulcrum_last_pos_[f], f->pos())));
         fulcrum_last_pos_[f] = f->pos();
     }
+    invalidateConnectionGeometry(f->connectionId());
     invalidateSchema();
 }
 
@@ -783,11 +816,15 @@ void DesignerScene::fulcrumHandleMoved(void* fulcrum, bool dropped, int /*which*
         fulcrum_last_hin_[f] = f->handleIn();
         fulcrum_last_hout_[f] = f->handleOut();
     }
+    invalidateConnectionGeometry(f->connectionId());
     invalidateSchema();
 }
 
-void DesignerScene::fulcrumTypeChanged(void* /*f*/, int /*type*/)
+void DesignerScene::fulcrumTypeChanged(void* fulcrum, int /*type*/)
 {
+    Fulcrum* f = (Fulcrum*)fulcrum;
+
+    invalidateConnectionGeometry(f->connectionId());
     invalidateSchema();
 }
 
@@ -847,30 +884,33 @@ void DesignerScene::deleteTemporaryConnectionsAndRepaint()
     update();
 }
 
-void DesignerScene::drawConnection(QPainter* painter, const ConnectionDescription& ci)
+void DesignerScene::drawConnection(QPainter* painter, int id)
 {
-    if (ci.active && !display_active_) {
+    auto geometry = connection_geometry_.find(id);
+    auto description = connection_descriptions_.find(id);
+    if (geometry == connection_geometry_.end() || description == connection_descriptions_.end()) {
         return;
     }
-    if (!ci.active && !display_inactive_) {
+
+    Port* from_port = getPort(description->second.from);
+    Port* to_port = getPort(description->second.to);
+    if (!from_port || !to_port) {
         return;
     }
 
-    ConnectorPtr from = graph_facade_->findConnector(ci.from);
-    ConnectorPtr to = graph_facade_->findConnector(ci.to);
-
-    ccs = CurrentConnectionState();
-
-    if(std::dynamic_pointer_cast<const connection_types::NoMessage>(ci.type)) {
-        ccs.marker_token = true;
-    } else {
-        ccs.marker_token = false;
+    ConnectorPtr from = from_port->getAdaptee();
+    ConnectorPtr to = to_port->getAdaptee();
+    if (!from || !to || !isDisplayed(to.get())) {
+        return;
     }
 
-    if (GraphFacadeImplementationPtr gfl = std::dynamic_pointer_cast<GraphFacadeImplementation>(graph_facade_)) {
-        ConnectionPtr connection = gfl->getLocalGraph()->getConnection(ci.from, ci.to);
+    ccs = CurrentConnectionState();
+    ccs.disabled = !(from->isEnabled() && to->isEnabled());
 
-        ccs.disabled = !(from->isEnabled() && to->isEnabled());
+    auto local = local_connections_.find(id);
+    if (ConnectionPtr connection = local != local_connections_.end() ? local->second.lock() : nullptr) {
+        TokenPtr token = connection->getToken();
+        ccs.marker_token = token && std::dynamic_pointer_cast<const connection_types::NoMessage>(token->getTokenData());
         ccs.full_read = connection->getState() == Connection::State::READ;
         ccs.full_unread = connection->getState() == Connection::State::UNREAD;
         ccs.active = connection->isActive();
@@ -878,7 +918,10 @@ void DesignerScene::drawConnection(QPainter* painter, const ConnectionDescriptio
         ccs.target_is_pipelining = connection->isPipelining();
 
     } else {
-        ccs.disabled = !(from->isEnabled() && to->isEnabled());
+        // remote descriptions only change when connections are added or removed, the cached one is current
+        const ConnectionDescription& ci = description->second;
+
+        ccs.marker_token = std::dynamic_pointer_cast<const connection_types::NoMessage>(ci.type) != nullptr;
         // TODO: implement state forwarding for connections
         ccs.full_read = false;
         ccs.full_unread = false;
@@ -887,33 +930,42 @@ void DesignerScene::drawConnection(QPainter* painter, const ConnectionDescriptio
         ccs.target_is_pipelining = false;
     }
 
-    connection_bb_[ci.id] = drawConnection(painter, from.get(), to.get(), ci.id);
+    if ((ccs.active && !display_active_) || (!ccs.active && !display_inactive_)) {
+        return;
+    }
+
+    updateConnectionState(from.get(), to.get(), from_port, to_port, id);
+
+    drawConnection(painter, geometry->second, id);
 }
 
-std::vector<QRectF> DesignerScene::drawConnection(QPainter* painter, Connector* from, Connector* to, int id)
+void DesignerScene::drawConnection(QPainter* painter, Connector* from, Connector* to, int id)
 {
     Port* from_port = getPort(from->getUUID());
     Port* to_port = getPort(to->getUUID());
 
-    if (!from_port || !to_port) {
-        return std::vector<QRectF>();
+    if (!from_port || !to_port || !isDisplayed(to)) {
+        return;
     }
 
-    if (to->isAsynchronous()) {
-        if (!display_signals_) {
-            return std::vector<QRectF>();
-        }
-        ccs.type = TokenType::SIG;
+    updateConnectionState(from, to, from_port, to_port, id);
 
-    } else {
-        if (!display_messages_) {
-            return std::vector<QRectF>();
-        }
-        ccs.type = TokenType::MSG;
-    }
+    drawConnection(painter, makeConnectionGeometry(centerPoint(from_port), centerPoint(to_port), {}), id);
+}
 
-    QPointF p1 = centerPoint(from_port);
-    QPointF p2 = centerPoint(to_port);
+void DesignerScene::drawConnection(QPainter* painter, const QPointF& from, const QPointF& to, int id)
+{
+    drawConnection(painter, makeConnectionGeometry(from, to, {}), id);
+}
+
+bool DesignerScene::isDisplayed(Connector* to) const
+{
+    return to->isAsynchronous() ? display_signals_ : display_messages_;
+}
+
+void DesignerScene::updateConnectionState(Connector* from, Connector* to, Port* from_port, Port* to_port, int id)
+{
+    ccs.type = to->isAsynchronous() ? TokenType::SIG : TokenType::MSG;
 
     ccs.highlighted = (highlight_connection_id_ == id);
     ccs.error = false;
@@ -934,8 +986,6 @@ std::vector<QRectF> DesignerScene::drawConnection(QPainter* painter, Connector*
     } else {
         ccs.end_pos = to_port->isFlipped() ? RIGHT : LEFT;
     }
-
-    return drawConnection(painter, p1, p2, id);
 }
 
 QPointF DesignerScene::offset(const QPointF& vector, Position position, double offset)
@@ -961,28 +1011,44 @@ QPointF DesignerScene::offset(const QPointF& vector, Position position, double o
     return result;
 }
 
-std::vector<QRectF> DesignerScene::drawConnection(QPainter* painter, const QPointF& from, const QPointF& real_to, int id)
+bool DesignerScene::makeConnectionGeometry(const ConnectionDescription& ci, ConnectionGeometry& geometry)
 {
-    QPointF to = offset(real_to, ccs.end_pos, view_core_.getStyle().lineWidth() * ARROW_LENGTH);
-
-    painter->setRenderHint(QPainter::Antialiasing);
-
-    double scale_factor = 1.0 / scale_;
-    if (scale_factor < 1.0) {
-        scale_factor = 1.0;
+    Port* from_port = getPort(ci.from);
+    Port* to_port = getPort(ci.to);
+    if (!from_port || !to_port) {
+        return false;
     }
 
-    if (ccs.type == TokenType::SIG) {
-        //        scale_factor *= 0.5;
+    ConnectorPtr from = from_port->getAdaptee();
+    ConnectorPtr to = to_port->getAdaptee();
+    if (!from || !to) {
+        return false;
     }
 
-    if (ccs.active) {
-        scale_factor *= 3;
+    ccs = CurrentConnectionState();
+    updateConnectionState(from.get(), to.get(), from_port, to_port, ci.id);
+
+    auto local = local_connections_.find(ci.id);
+    if (ConnectionPtr connection = local != local_connections_.end() ? local->second.lock() : nullptr) {
+        geometry = makeConnectionGeometry(centerPoint(from_port), centerPoint(to_port), connection->getFulcrumsCopy());
+    } else {
+        geometry = makeConnectionGeometry(centerPoint(from_port), centerPoint(to_port), ci.fulcrums);
     }
+    return true;
+}
 
-    ccs.minimized = ccs.minimized_from || ccs.minimized_to;
-    ccs.r = ccs.minimized ? view_core_.getStyle().lineWidth() / 2.0 : view_core_.getStyle().lineWidth();
-    ccs.r *= scale_factor;
+DesignerScene::ConnectionGeometry DesignerScene::makeConnectionGeometry(const QPointF& from, const QPointF& real_to, const std::vector<Fulcrum>& fulcrums)
+{
+    ConnectionGeometry geometry;
+    geometry.from = from;
+    geometry.real_to = real_to;
+    geometry.to = offset(real_to, ccs.end_pos, view_core_.getStyle().lineWidth() * ARROW_LENGTH);
+    geometry.start_pos = ccs.start_pos;
+    geometry.end_pos = ccs.end_pos;
+    geometry.minimized = ccs.minimized_from || ccs.minimized_to;
+    geometry.asynchronous = ccs.type == TokenType::SIG;
+
+    const QPointF& to = geometry.to;
 
     double max_slack_height = 40.0;
     double mindist_for_slack = 60.0;
@@ -990,22 +1056,15 @@ std::vector<QRectF> DesignerScene::drawConnection(QPainter* painter, const QPoin
 
     Fulcrum first(-1, convert(from), Fulcrum::FULCRUM_OUT, convert(from), convert(from));
     const Fulcrum* current = &first;
-    //    const Fulcrum* last = current;
 
-    std::vector<Fulcrum> targets;
-    if (id >= 0) {
-        ConnectionDescription connection = graph_facade_->getConnectionWithId(id);
-        targets = connection.fulcrums;
-    }
+    std::vector<Fulcrum> targets = fulcrums;
     targets.emplace_back(-1, convert(to), Fulcrum::FULCRUM_IN, convert(to), convert(to));
 
     int sub_section = 0;
 
     QPointF cp1, cp2;
 
-    // paths
-    typedef std::pair<QPainterPath, int> Path;
-    std::vector<Path> paths;
+    QRectF bounds = QRectF(from, real_to).normalized();
 
     // generate lines
     for (std::size_t i = 0; i < targets.size(); ++i) {
@@ -1029,10 +1088,10 @@ std::vector<QRectF> DesignerScene::drawConnection(QPainter* painter, const QPoin
         QPainterPath path(current_pos);
 
         if (current->type() == Fulcrum::FULCRUM_OUT) {
-            cp1 = offset(current_pos, ccs.start_pos, x_offset) + y_offset;
+            cp1 = offset(current_pos, geometry.start_pos, x_offset) + y_offset;
 
         } else if (current->type() == Fulcrum::FULCRUM_IN) {
-            cp1 = offset(current_pos, ccs.end_pos, x_offset) + y_offset;
+            cp1 = offset(current_pos, geometry.end_pos, x_offset) + y_offset;
 
         } else {
             const Fulcrum& last = targets[sub_section - 1];
@@ -1044,10 +1103,10 @@ std::vector<QRectF> DesignerScene::drawConnection(QPainter* painter, const QPoin
         }
 
         if (next.type() == Fulcrum::FULCRUM_OUT) {
-            cp2 = offset(next_pos, ccs.start_pos, x_offset) + y_offset;
+            cp2 = offset(next_pos, geometry.start_pos, x_offset) + y_offset;
 
         } else if (next.type() == Fulcrum::FULCRUM_IN) {
-            cp2 = offset(next_pos, ccs.end_pos, x_offset) + y_offset;
+            cp2 = offset(next_pos, geometry.end_pos, x_offset) + y_offset;
 
         } else {
             if (next.type() == Fulcrum::FULCRUM_LINEAR) {
@@ -1059,16 +1118,42 @@ std::vector<QRectF> DesignerScene::drawConnection(QPainter* painter, const QPoin
 
         path.cubicTo(cp1, cp2, next_pos);
 
-        paths.push_back(std::make_pair(path, sub_section));
+        bounds |= path.boundingRect();
+        geometry.paths.emplace_back(path, sub_section);
 
-        //        last = current;
         current = &next;
         ++sub_section;
     }
 
+    // straight lines have empty bounds, which would never intersect anything
+    geometry.bounds = bounds.adjusted(-1.0, -1.0, 1.0, 1.0);
+
+    return geometry;
+}
+
+void DesignerScene::drawConnection(QPainter* painter, const ConnectionGeometry& geometry, int id)
+{
+    const QPointF& from = geometry.from;
+    const QPointF& to = geometry.to;
+
+    painter->setRenderHint(QPainter::Antialiasing);
+
+    double scale_factor = 1.0 / scale_;
+    if (scale_factor < 1.0) {
+        scale_factor = 1.0;
+    }
+
+    if (ccs.active) {
+        scale_factor *= 3;
+    }
+
+    ccs.minimized = ccs.minimized_from || ccs.minimized_to;
+    ccs.r = ccs.minimized ? view_core_.getStyle().lineWidth() / 2.0 : view_core_.getStyle().lineWidth();
+    ccs.r *= scale_factor;
+
     // arrow
     QPolygonF arrow;
-    QPointF a = offset(QPointF(0, 0), ccs.end_pos, ARROW_LENGTH * view_core_.getStyle().lineWidth()) * scale_factor;
+    QPointF a = offset(QPointF(0, 0), geometry.end_pos, ARROW_LENGTH * view_core_.getStyle().lineWidth()) * scale_factor;
 
     QPointF side(a.y() / 2.0, a.x() / 2.0);
     arrow.append(to - a);
@@ -1079,19 +1164,21 @@ std::vector<QRectF> DesignerScene::drawConnection(QPainter* painter, const QPoin
     QPainterPath arrow_path;
     arrow_path.addPolygon(arrow);
 
+    typedef std::pair<QPainterPath, int> Path;
+
     // reset brush if it is set
     painter->setBrush(QBrush());
 
     // draw
     if (ccs.highlighted) {
         painter->setPen(QPen(Qt::black, ccs.r + 6 * scale_factor, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
-        for (const Path& path : paths) {
+        for (const Path& path : geometry.paths) {
             painter->drawPath(path.first);
         }
         painter->drawPath(arrow_path);
 
         painter->setPen(QPen(Qt::white, ccs.r + 3 * scale_factor, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
-        for (const Path& path : paths) {
+        for (const Path& path : geometry.paths) {
             painter->drawPath(path.first);
         }
         painter->drawPath(arrow_path);
@@ -1121,7 +1208,7 @@ std::vector<QRectF> DesignerScene::drawConnection(QPainter* painter, const QPoin
         color_start = view_core_.getStyle().lineColorMarker();
         color_end = view_core_.getStyle().lineColorMarker();
     }
-    
+
     if (ccs.selected_from) {
         color_start.setAlpha(255);
     } else {
@@ -1152,34 +1239,180 @@ std::vector<QRectF> DesignerScene::drawConnection(QPainter* painter, const QPoin
 
     painter->setPen(QPen(QBrush(lg), ccs.r * 0.75, ccs.target_is_pipelining ? Qt::DotLine : Qt::SolidLine, ccs.target_is_pipelining ? Qt::SquareCap : Qt::RoundCap, Qt::RoundJoin));
 
-    std::vector<QRectF> bounding_boxes;
-
-    for (const Path& path : paths) {
+    for (const Path& path : geometry.paths) {
         painter->drawPath(path.first);
-        bounding_boxes.push_back(path.first.boundingRect());
-
-        if (id >= 0 && schema_dirty_) {
-            QPen schema_pen = QPen(QColor(id2rgb(id, path.second)), ccs.r * 1.75, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin);
-            schematics_painter->setPen(schema_pen);
-            schematics_painter->drawPath(path.first);
-        }
     }
     painter->setBrush(color_end);
     painter->setPen(QPen(painter->brush(), 1.0));
     painter->drawPath(arrow_path);
 
-    bounding_boxes.push_back(arrow_path.boundingRect());
-
     if (draw_schema_) {
         painter->setBrush(QBrush());
-        for (auto r : bounding_boxes) {
-            painter->drawRect(r);
+        for (const Path& path : geometry.paths) {
+            painter->drawRect(path.first.boundingRect());
+        }
+        painter->drawRect(arrow_path.boundingRect());
+    }
+
+    painter->drawText(QPointF(from + geometry.real_to) * 0.5, ccs.label);
+}
+
+void DesignerScene::drawSchematics()
+{
+    double scale_factor = std::max(1.0, 1.0 / scale_);
+
+    typedef std::pair<QPainterPath, int> Path;
+
+    // all connections are drawn, so that connections outside of the exposed area can be picked as well
+    for (const auto& pair : connection_geometry_) {
+        const ConnectionGeometry& geometry = pair.second;
+        if (!(geometry.asynchronous ? display_signals_ : display_messages_)) {
+            continue;
+        }
+
+        double r = (geometry.minimized ? view_core_.getStyle().lineWidth() / 2.0 : view_core_.getStyle().lineWidth()) * scale_factor;
+
+        for (const Path& path : geometry.paths) {
+            QPen schema_pen = QPen(QColor(id2rgb(pair.first, path.second)), r * 1.75, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin);
+            schematics_painter->setPen(schema_pen);
+            schematics_painter->drawPath(path.first);
+        }
+    }
+}
+
+void DesignerScene::updateConnectionGeometry()
+{
+    for (auto it = dirty_connections_.begin(); it != dirty_connections_.end();) {
+        auto pos = connection_descriptions_.find(*it);
+        if (pos == connection_descriptions_.end()) {
+            it = dirty_connections_.erase(it);
+            continue;
+        }
+
+        ConnectionGeometry geometry;
+        if (makeConnectionGeometry(pos->second, geometry)) {
+            addToGrid(*it, geometry.bounds);
+            connection_geometry_[*it] = std::move(geometry);
+            it = dirty_connections_.erase(it);
+
+        } else {
+            // the ports are not known yet, try again with the next frame
+            ++it;
         }
     }
+}
 
-    painter->drawText(QPointF(from + real_to) * 0.5, ccs.label);
+std::vector<int> DesignerScene::findConnections(const QRectF& rect) const
+{
+    // the index only contains the paths, the margin covers the line width and the arrow
+    double scale_factor = std::max(1.0, 1.0 / scale_) * 3.0;
+    double margin = ((ARROW_LENGTH + 1.0) * view_core_.getStyle().lineWidth() + 6.0) * scale_factor;
+    QRectF area = rect.adjusted(-margin, -margin, margin, margin);
+
+    std::vector<int> result;
+
+    CellRange cells = cellsOf(area);
+    if (cells.size() > connection_grid_.size()) {
+        // more cells are exposed than occupied, checking all connections is cheaper
+        for (const auto& pair : connection_geometry_) {
+            if (area.intersects(pair.second.bounds)) {
+                result.push_back(pair.first);
+            }
+        }
 
-    return bounding_boxes;
+    } else {
+        for (int x = cells.min_x; x <= cells.max_x; ++x) {
+            for (int y = cells.min_y; y <= cells.max_y; ++y) {
+                auto pos = connection_grid_.find(cellKey(x, y));
+                if (pos == connection_grid_.end()) {
+                    continue;
+                }
+                for (int id : pos->second) {
+                    if (area.intersects(connection_geometry_.at(id).bounds)) {
+                        result.push_back(id);
+                    }
+                }
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+
+    return result;
+}
+
+void DesignerScene::addToGrid(int id, const QRectF& bounds)
+{
+    CellRange cells = cellsOf(bounds);
+    for (int x = cells.min_x; x <= cells.max_x; ++x) {
+        for (int y = cells.min_y; y <= cells.max_y; ++y) {
+            connection_grid_[cellKey(x, y)].push_back(id);
+        }
+    }
+}
+
+void DesignerScene::removeFromGrid(int id, const QRectF& bounds)
+{
+    CellRange cells = cellsOf(bounds);
+    for (int x = cells.min_x; x <= cells.max_x; ++x) {
+        for (int y = cells.min_y; y <= cells.max_y; ++y) {
+            auto pos = connection_grid_.find(cellKey(x, y));
+            if (pos == connection_grid_.end()) {
+                continue;
+            }
+            std::vector<int>& ids = pos->second;
+            ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+            if (ids.empty()) {
+                connection_grid_.erase(pos);
+            }
+        }
+    }
+}
+
+void DesignerScene::invalidateConnectionGeometry(int id)
+{
+    auto pos = connection_geometry_.find(id);
+    if (pos != connection_geometry_.end()) {
+        removeFromGrid(id, pos->second.bounds);
+        connection_geometry_.erase(pos);
+    }
+    dirty_connections_.insert(id);
+}
+
+void DesignerScene::invalidateAllConnectionGeometry()
+{
+    connection_geometry_.clear();
+    connection_grid_.clear();
+    for (const auto& pair : connection_descriptions_) {
+        dirty_connections_.insert(pair.first);
+    }
+}
+
+void DesignerScene::invalidateConnectionGeometry(const UUID& uuid)
+{
+    // connectors are nested in their node, node UUIDs are not
+    bool is_node = !uuid.composite();
+
+    for (const auto& pair : connection_descriptions_) {
+        const ConnectionDescription& ci = pair.second;
+        if (ci.from == uuid || ci.to == uuid || (is_node && (ci.from.rootUUID() == uuid || ci.to.rootUUID() == uuid))) {
+            invalidateConnectionGeometry(pair.first);
+        }
+    }
+    update();
+}
+
+void DesignerScene::invalidateGraphPortGeometry()
+{
+    // connectors of the graph itself are not nested in a node
+    for (const auto& pair : connection_descriptions_) {
+        const ConnectionDescription& ci = pair.second;
+        if (!ci.from.composite() || !ci.to.composite()) {
+            invalidateConnectionGeometry(pair.first);
+        }
+    }
+    update();
 }
 
 void DesignerScene::addPort(Port* port)
@@ -1187,6 +1420,7 @@ void DesignerScene::addPort(Port* port)
     ConnectorPtr c = port->getAdaptee();
     if (c) {
         port_map_[c->getUUID()] = port;
+        invalidateConnectionGeometry(c->getUUID());
     }
 }
 
@@ -1195,6 +1429,7 @@ void DesignerScene::removePort(Port* port)
     if (!port_map_.empty()) {
         for (auto it = port_map_.begin(); it != port_map_.end();) {
             if (it->second == port) {
+                invalidateConnectionGeometry(it->first);
                 it = port_map_.erase(it);
             } else {
                 ++it;
@@ -1444,6 +1679,7 @@ void DesignerScene::invalidateSchema()
 
 void DesignerScene::refresh()
 {
+    invalidateAllConnectionGeometry();
     invalidateSchema();
 }
 
@@ -24,6 +24,7 @@
 #include <csapex/command/add_variadic_connector_and_connect.h>
 #include <csapex/command/set_execution_mode.h>
 #include <csapex/command/set_isolated_execution.h>
+#include <csapex/command/set_replicated_execution.h>
 #include <csapex/core/settings.h>
 #include <csapex/factory/node_factory.h>
 #include <csapex/factory/snippet_factory.h>
@@ -214,6 +215,10 @@ void GraphView::setupWidgets()
         }
     }
 
+    for (QGraphicsProxyWidget* proxy : { outputs_widget_proxy_, inputs_widget_proxy_, slots_widget_proxy_, triggers_widget_proxy_ }) {
+        QObject::connect(proxy, &QGraphicsWidget::geometryChanged, this, [this]() { scene_->invalidateGraphPortGeometry(); });
+    }
+
     QObject::connect(scene_, &DesignerScene::changed, [this]() {
         bool visible = !scene_->isEmpty();
 
@@ -952,6 +957,11 @@ void GraphView::addBox(NodeBox* box)
 
     QObject::connect(proxy, &MovableGraphicsProxyWidget::moved, this, &GraphView::movedBoxes);
 
+    // the scene caches the geometry of connections, it has to be updated when the box moves or changes its layout
+    UUID box_uuid = facade->getUUID();
+    QObject::connect(proxy, &QGraphicsWidget::geometryChanged, this, [this, box_uuid]() { scene_->invalidateConnectionGeometry(box_uuid); });
+    QObject::connect(box, &NodeBox::flipped, this, [this, box_uuid](bool) { scene_->invalidateConnectionGeometry(box_uuid); });
+
     boxes_.push_back(box);
 
     for (QGraphicsItem* item : items()) {
@@ -1376,6 +1386,15 @@ void GraphView::setExecutionType(ExecutionType type)
     view_core_.getCommandDispatcher()->execute(cmd);
 }
 
+void GraphView::setReplicatedExecution(int replicas)
+{
+    command::Meta::Ptr cmd(new command::Meta(graph_facade_->getAbsoluteUUID(), "set replicated execution"));
+    for (NodeBox* box : selected_boxes_) {
+        cmd->add(Command::Ptr(new command::SetReplicatedExecution(graph_facade_->getAbsoluteUUID(), box->getNodeFacade()->getUUID(), replicas)));
+    }
+    view_core_.getCommandDispatcher()->execute(cmd);
+}
+
 void GraphView::setLoggerLevel(int level)
 {
     view_core_.getCommandDispatcher()->execute(CommandFactory(graph_facade_.get()).setLoggerLevelRecursively(getSelectedUUIDs(), level));
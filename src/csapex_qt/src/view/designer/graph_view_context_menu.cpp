@@ -17,7 +17,9 @@
 #include <csapex/view/utility/snippet_list_generator.h>
 
 /// SYSTEM
+#include <algorithm>
 #include <sstream>
+#include <thread>
 #include <QMenu>
 
 using namespace csapex;
@@ -350,6 +352,12 @@ void GraphViewContextMenu::showSelectionMenu(const QPoint& global_pos)
         handler[subprocess] = std::bind(&GraphView::setExecutionType, &view_, ExecutionType::SUBPROCESS);
         menu.addAction(subprocess);
 
+        // one instance per core, the node itself counts as one of them
+        int replicas = std::max(2, static_cast<int>(std::thread::hardware_concurrency()));
+        QAction* replicated = new QAction("replicated execution", &menu);
+        handler[replicated] = std::bind(&GraphView::setReplicatedExecution, &view_, replicas);
+        menu.addAction(replicated);
+
         menu.addSeparator();
 
         bool has_profiling = false;
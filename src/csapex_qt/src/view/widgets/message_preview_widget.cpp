@@ -4,6 +4,7 @@
 /// PROJECT
 #include <csapex/msg/direct_connection.h>
 #include <csapex/manager/message_renderer_manager.h>
+#include <csapex/msg/message_renderer.h>
 #include <csapex/msg/io.h>
 #include <csapex/msg/generic_value_message.hpp>
 #include <csapex/msg/any_message.h>
@@ -19,58 +20,153 @@
 using namespace csapex;
 using namespace csapex::impl;
 
-PreviewInput::PreviewInput(QPointer<MessagePreviewWidget> parent) : Input(UUIDProvider::makeUUID_without_parent("message_preview_in")), parent_(parent)
+namespace
 {
-    setType(std::make_shared<connection_types::AnyMessage>());
-    setVirtual(true);
+const double DEFAULT_MAXIMUM_FRAME_RATE = 30.0;
+
+template <typename T>
+const connection_types::GenericValueMessage<T>* asValue(const TokenDataConstPtr& message)
+{
+    return dynamic_cast<const connection_types::GenericValueMessage<T>*>(message.get());
 }
+}  // namespace
 
-void PreviewInput::setToken(TokenPtr token)
+PreviewRenderer::PreviewRenderer(QPointer<MessagePreviewWidget> parent) : parent_(parent), running_(true), frame_interval_us_(static_cast<long>(1e6 / DEFAULT_MAXIMUM_FRAME_RATE))
 {
-    Input::setToken(token);
+    thread_ = std::thread([this]() { run(); });
+}
 
-    if (isConnected()) {
-        TokenDataConstPtr message = token->getTokenData();
+PreviewRenderer::~PreviewRenderer()
+{
+    stop();
+}
+
+void PreviewRenderer::post(const TokenDataConstPtr& message)
+{
+    // the previous message is replaced, if it has not been rendered yet
+    mailbox_.store(message);
+
+    std::unique_lock<std::mutex> lock(wakeup_mutex_);
+    wakeup_.notify_one();
+}
+
+void PreviewRenderer::setMaximumFrameRate(double fps)
+{
+    frame_interval_us_ = fps > 0.0 ? static_cast<long>(1e6 / fps) : 0;
+}
 
-        if (!parent_) {
-            return;
+void PreviewRenderer::stop()
+{
+    bool was_running;
+    {
+        std::unique_lock<std::mutex> lock(wakeup_mutex_);
+        was_running = running_.exchange(false);
+        wakeup_.notify_one();
+    }
+    if (was_running) {
+        if (thread_.joinable()) {
+            thread_.join();
         }
-        try {
-            if (msg::isExactValue<std::string>(this)) {
-                parent_->displayTextRequest(QString::fromStdString(msg::getValue<std::string>(this)));
-
-            } else if (msg::isExactValue<int>(this)) {
-                parent_->displayTextRequest(QString::number(msg::getValue<int>(this)));
-
-            } else if (msg::isExactValue<float>(this)) {
-                parent_->displayTextRequest(QString::number(msg::getValue<float>(this)));
-
-            } else if (msg::isExactValue<double>(this)) {
-                parent_->displayTextRequest(QString::number(msg::getValue<float>(this)));
-
-            } else {
-                MessageRenderer::Ptr renderer = MessageRendererManager::instance().createMessageRenderer(message);
-                if (renderer) {
-                    std::unique_ptr<QImage> img = renderer->render(message);
-                    if (parent_) {
-                        parent_->displayImageRequest(*img);
-                    }
-                }
+        mailbox_.clear();
+    }
+}
+
+void PreviewRenderer::run()
+{
+    auto next_frame = std::chrono::steady_clock::now();
+    while (running_) {
+        {
+            std::unique_lock<std::mutex> lock(wakeup_mutex_);
+            wakeup_.wait_until(lock, next_frame + std::chrono::milliseconds(100), [this]() { return !running_ || !mailbox_.empty(); });
+        }
+        if (!running_) {
+            break;
+        }
+
+        std::this_thread::sleep_until(next_frame);
+
+        TokenDataConstPtr message;
+        if (!mailbox_.take(message)) {
+            continue;
+        }
+
+        render(message);
+
+        next_frame = std::chrono::steady_clock::now() + std::chrono::microseconds(frame_interval_us_);
+    }
+}
+
+void PreviewRenderer::render(const TokenDataConstPtr& message)
+{
+    if (!parent_) {
+        return;
+    }
+    try {
+        if (auto value = asValue<std::string>(message)) {
+            parent_->displayTextRequest(QString::fromStdString(value->value));
+
+        } else if (auto value = asValue<int>(message)) {
+            parent_->displayTextRequest(QString::number(value->value));
+
+        } else if (auto value = asValue<float>(message)) {
+            parent_->displayTextRequest(QString::number(value->value));
+
+        } else if (auto value = asValue<double>(message)) {
+            parent_->displayTextRequest(QString::number(value->value));
+
+        } else if (MessageRenderer::Ptr renderer = getRenderer(message)) {
+            std::unique_ptr<QImage> img = renderer->render(message);
+            if (img) {
+                parent_->displayImageRequest(*img);
             }
-        } catch (const std::exception& e) {
-            // silent death
         }
+    } catch (const std::exception& e) {
+        // silent death
+    }
+}
+
+MessageRendererPtr PreviewRenderer::getRenderer(const TokenDataConstPtr& message)
+{
+    const TokenData& m = *message;
+    std::type_index type(typeid(m));
+
+    auto pos = renderers_.find(type);
+    if (pos != renderers_.end()) {
+        return pos->second;
+    }
+
+    MessageRendererPtr renderer = MessageRendererManager::instance().createMessageRenderer(message);
+    renderers_[type] = renderer;
+    return renderer;
+}
+
+PreviewInput::PreviewInput(std::shared_ptr<PreviewRenderer> renderer) : Input(UUIDProvider::makeUUID_without_parent("message_preview_in")), renderer_(renderer)
+{
+    setType(std::make_shared<connection_types::AnyMessage>());
+    setVirtual(true);
+}
+
+void PreviewInput::setToken(TokenPtr token)
+{
+    Input::setToken(token);
+
+    // this is called by the producer, rendering happens in the renderer's thread
+    if (isConnected() && renderer_) {
+        renderer_->post(token->getTokenData());
     }
 }
 
 void PreviewInput::detach()
 {
-    parent_.clear();
+    if (renderer_) {
+        renderer_->stop();
+    }
 }
 
 MessagePreviewWidget::MessagePreviewWidget() : pm_item_(nullptr), txt_item_(nullptr)
 {
-    input_ = std::make_shared<impl::PreviewInput>(this);
+    renderer_ = std::make_shared<impl::PreviewRenderer>(this);
+    input_ = std::make_shared<impl::PreviewInput>(renderer_);
     setScene(new QGraphicsScene);
 
     setWindowFlags(windowFlags() | Qt::FramelessWindowHint);
@@ -91,11 +187,13 @@ MessagePreviewWidget::MessagePreviewWidget() : pm_item_(nullptr), txt_item_(null
 
 MessagePreviewWidget::~MessagePreviewWidget()
 {
+    // joins the render thread, no further requests can arrive after this
+    input_->detach();
+
     if (scene()) {
         delete scene();
         setScene(nullptr);
     }
-    input_->detach();
     if (isConnected()) {
         disconnect();
     }
@@ -210,5 +308,10 @@ bool MessagePreviewWidget::isConnected() const
     return static_cast<bool>(connection_);
 }
 
+void MessagePreviewWidget::setMaximumFrameRate(double fps)
+{
+    renderer_->setMaximumFrameRate(fps);
+}
+
 /// MOC
 #include "../../../include/csapex/view/widgets/moc_message_preview_widget.cpp"
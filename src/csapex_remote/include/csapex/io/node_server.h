@@ -6,8 +6,13 @@
 #include <csapex/io/remote_io_fwd.h>
 #include <csapex/model/observer.h>
 #include <csapex/utility/uuid.h>
+#include <csapex/profiling/interval_aggregator.h>
 
 /// SYSTEM
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 
 namespace csapex
@@ -21,11 +26,33 @@ public:
     void startObservingNode(const NodeFacadeImplementationPtr& graph);
     void stopObservingNode(const NodeFacadeImplementationPtr& graph);
 
+private:
+    /**
+     * @brief The Telemetry struct decides how the profiling intervals of a node are sent to the client
+     */
+    struct Telemetry
+    {
+        Telemetry(long window_micro_seconds);
+
+        IntervalAggregator aggregator;
+        std::atomic<bool> subscribed;
+    };
+
+    /// sends the summaries of windows that ended without a later interval, e.g. because the node stopped
+    void flushTelemetry();
+
 private:
     SessionPtr session_;
     ConnectorServerPtr connector_server_;
 
+    std::mutex nodes_mutex_;
     std::unordered_map<AUUID, io::ChannelPtr, AUUID::Hasher> channels_;
+    std::unordered_map<AUUID, std::shared_ptr<Telemetry>, AUUID::Hasher> telemetry_;
+
+    std::mutex flush_mutex_;
+    std::condition_variable flush_stopped_;
+    bool flushing_;
+    std::thread flush_thread_;
 };
 }  // namespace csapex
 
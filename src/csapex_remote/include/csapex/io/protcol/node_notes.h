@@ -43,7 +43,13 @@ enum class NodeNoteType
     ConnectionRemovedTriggered,
 
     ErrorEvent,
-    Notification
+    Notification,
+
+    // values are serialized, new types are only appended
+    IntervalSummaryTriggered,
+
+    // sent by clients that need the individual intervals of a node
+    TracingSubscriptionChanged
 };
 
 class NodeNote : public NoteImplementation<NodeNote>
@@ -11,9 +11,11 @@
 
 /// SYSTEM
 #include <boost/asio.hpp>
+#include <chrono>
 #include <deque>
 #include <future>
 #include <unordered_map>
+#include <vector>
 #include <boost/asio.hpp>
 
 namespace csapex
@@ -31,6 +33,28 @@ public:
         }
     };
 
+    /**
+     * @brief The Stats struct describes the send queue, queued bytes that keep growing mean that the peer cannot keep up
+     */
+    struct Stats
+    {
+        std::size_t packets_queued = 0;
+        std::size_t bytes_queued = 0;
+        std::size_t max_bytes_queued = 0;
+
+        std::size_t packets_sent = 0;
+        std::size_t bytes_sent = 0;
+        std::size_t batches_sent = 0;
+
+        std::size_t packets_compressed = 0;
+        std::size_t bytes_saved_by_compression = 0;
+    };
+
+    // set in the length header of a packet whose payload is zlib compressed
+    static constexpr uint32_t COMPRESSED_FLAG = 0x80000000u;
+    // larger compressed packets are rejected when reading, larger packets are therefore never compressed
+    static constexpr std::size_t MAX_DECOMPRESSED_LENGTH = 256u << 20;
+
 public:
     Session(Socket socket, const std::string& name);
     ~Session() override;
@@ -50,6 +74,17 @@ public:
     void write(const StreamableConstPtr& packet);
     void write(const std::string& message);
 
+    /**
+     * @brief setFlushInterval lets packets wait up to this long, so that they are sent together, 0 sends as soon as the socket is free
+     */
+    void setFlushInterval(std::chrono::microseconds interval);
+
+    /**
+     * @brief setCompressionThreshold compresses packets of at least this many bytes, e.g. raw messages and profiler data, 0 disables compression
+     */
+    void setCompressionThreshold(std::size_t bytes);
+
+    Stats getStats() const;
 
     //
     // REQUEST
@@ -118,8 +153,19 @@ protected:
     void mainLoop();
 
     void read_async();
+    void readBodyAsync(const std::shared_ptr<SerializationBuffer>& message_data, bool compressed);
+    bool handleReadError(const boost::system::error_code& ec, const SessionWeakPtr& self);
+    void handleReceivedPacket(const StreamablePtr& serial);
 
-    void write_packet(SerializationBuffer& buffer);
+    void flush();
+    void drain(std::chrono::milliseconds timeout);
+    void discardQueuedPackets();
+
+    /**
+     * @brief abort stops the session after a socket error in the io thread, queued packets are dropped instead of drained
+     */
+    void abort();
+    void stop(bool drain_queue);
 
 protected:
     std::thread packet_handler_thread_;
@@ -127,10 +173,19 @@ protected:
 
     uint8_t next_request_id_;
 
-    std::recursive_mutex packets_mutex_;
+    mutable std::recursive_mutex packets_mutex_;
     std::condition_variable_any packets_available_;
     std::deque<StreamableConstPtr> packets_received_;
-    std::deque<StreamableConstPtr> packets_to_send_;
+
+    // serialized packets, sent by one gather write per batch
+    std::deque<std::shared_ptr<SerializationBuffer>> packets_to_send_;
+    std::chrono::steady_clock::time_point oldest_queued_packet_;
+    bool write_in_progress_;
+    // set when a queued packet must not wait for the flush interval
+    bool flush_requested_;
+    std::chrono::microseconds flush_interval_;
+    std::size_t compression_threshold_;
+    Stats stats_;
 
     std::recursive_mutex open_requests_mutex_;
     std::map<uint8_t, std::promise<ResponseConstPtr>*> open_requests_;
@@ -74,6 +74,8 @@ private:
 
     void createParameterProxy(param::ParameterPtr proxy) const;
 
+    void updateTracingSubscription();
+
 private:
     AUUID uuid_;
 
@@ -109,6 +111,9 @@ private:
     // TODO: auto generate
     std::unordered_map<UUID, bool, UUID::Hasher> is_parameter_output_;
     std::unordered_map<UUID, bool, UUID::Hasher> is_parameter_input_;
+
+    bool profiling_requested_;
+    bool tracing_subscribed_;
 };
 
 }  // namespace csapex
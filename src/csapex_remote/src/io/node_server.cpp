@@ -10,23 +10,73 @@
 #include <csapex/io/channel.h>
 #include <csapex/io/protcol/node_notes.h>
 #include <csapex/io/protcol/profiler_note.h>
+#include <csapex/profiling/interval.h>
 #include <csapex/profiling/profiler.h>
 
 /// SYSTEM
+#include <chrono>
 #include <iostream>
 
 using namespace csapex;
 
-NodeServer::NodeServer(SessionPtr session) : session_(session)
+namespace
+{
+// length of the windows in which the intervals of a node are summarized
+const long TELEMETRY_WINDOW_MICRO = 500000;
+}  // namespace
+
+NodeServer::Telemetry::Telemetry(long window_micro_seconds) : aggregator(window_micro_seconds), subscribed(false)
+{
+}
+
+NodeServer::NodeServer(SessionPtr session) : session_(session), flushing_(true)
 {
     connector_server_ = std::make_shared<ConnectorServer>(session_);
+
+    flush_thread_ = std::thread([this]() {
+        std::unique_lock<std::mutex> lock(flush_mutex_);
+        while (flushing_) {
+            flush_stopped_.wait_for(lock, std::chrono::microseconds(TELEMETRY_WINDOW_MICRO));
+            if (flushing_) {
+                lock.unlock();
+                flushTelemetry();
+                lock.lock();
+            }
+        }
+    });
 }
 
 NodeServer::~NodeServer()
 {
+    {
+        std::unique_lock<std::mutex> lock(flush_mutex_);
+        flushing_ = false;
+        flush_stopped_.notify_all();
+    }
+    flush_thread_.join();
+
     stopObserving();
 }
 
+void NodeServer::flushTelemetry()
+{
+    long now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+
+    std::vector<std::pair<io::ChannelPtr, std::shared_ptr<const IntervalSummary>>> summaries;
+    {
+        std::unique_lock<std::mutex> lock(nodes_mutex_);
+        for (const auto& pair : telemetry_) {
+            if (std::shared_ptr<const IntervalSummary> summary = pair.second->aggregator.flushExpired(now)) {
+                summaries.emplace_back(channels_.at(pair.first), summary);
+            }
+        }
+    }
+
+    for (const auto& pair : summaries) {
+        pair.first->sendNote<NodeNote>(NodeNoteType::IntervalSummaryTriggered, *pair.second);
+    }
+}
+
 void NodeServer::startObservingNode(const NodeFacadeImplementationPtr& node)
 {
     io::ChannelPtr channel = session_->openChannel(node->getAUUID());
@@ -66,10 +116,32 @@ void NodeServer::startObservingNode(const NodeFacadeImplementationPtr& node)
 
     observe(node->connection_removed, [channel](ConnectorDescription c) { channel->sendNote<NodeNote>(NodeNoteType::ConnectionRemovedTriggered, c); });
 
-    observe(node->interval_start,
-            [channel](NodeFacade* facade, TracingType type, std::shared_ptr<const Interval> stamp) { channel->sendNote<NodeNote>(NodeNoteType::IntervalStartTriggered, type, stamp); });
-
-    observe(node->interval_end, [channel](NodeFacade* facade, std::shared_ptr<const Interval> stamp) { channel->sendNote<NodeNote>(NodeNoteType::IntervalEndTriggered, stamp); });
+    // individual intervals are only sent if the client subscribed to them, otherwise they are summarized per time window
+    auto telemetry = std::make_shared<Telemetry>(TELEMETRY_WINDOW_MICRO);
+    observe(channel->note_received, [channel, telemetry](const io::NoteConstPtr& note) {
+        if (const std::shared_ptr<NodeNote const>& cn = std::dynamic_pointer_cast<NodeNote const>(note)) {
+            if (cn->getNoteType() == NodeNoteType::TracingSubscriptionChanged) {
+                telemetry->subscribed = cn->getPayload<bool>(0);
+                if (std::shared_ptr<const IntervalSummary> summary = telemetry->aggregator.flush()) {
+                    channel->sendNote<NodeNote>(NodeNoteType::IntervalSummaryTriggered, *summary);
+                }
+            }
+        }
+    });
+
+    observe(node->interval_start, [channel, telemetry](NodeFacade* facade, TracingType type, std::shared_ptr<const Interval> stamp) {
+        if (telemetry->subscribed) {
+            channel->sendNote<NodeNote>(NodeNoteType::IntervalStartTriggered, type, stamp);
+        }
+    });
+
+    observe(node->interval_end, [channel, telemetry](NodeFacade* facade, std::shared_ptr<const Interval> stamp) {
+        if (telemetry->subscribed) {
+            channel->sendNote<NodeNote>(NodeNoteType::IntervalEndTriggered, stamp);
+        } else if (std::shared_ptr<const IntervalSummary> summary = telemetry->aggregator.add(*stamp)) {
+            channel->sendNote<NodeNote>(NodeNoteType::IntervalSummaryTriggered, *summary);
+        }
+    });
     observe(node->error_event, [channel](bool e, const std::string& msg, ErrorState::ErrorLevel level) { channel->sendNote<NodeNote>(NodeNoteType::ErrorEvent, e, msg, level); });
     observe(node->notification, [channel](Notification n) { channel->sendNote<NodeNote>(NodeNoteType::Notification, n); });
 
@@ -79,12 +151,27 @@ void NodeServer::startObservingNode(const NodeFacadeImplementationPtr& node)
     ProfilerPtr profiler = node->getProfiler();
     observe(profiler->enabled_changed, [channel](bool enabled) { channel->sendNote<ProfilerNote>(ProfilerNoteType::EnabledChanged, enabled); });
 
+    std::unique_lock<std::mutex> lock(nodes_mutex_);
     channels_[node->getAUUID()] = channel;
+    telemetry_[node->getAUUID()] = telemetry;
 }
 
 void NodeServer::stopObservingNode(const NodeFacadeImplementationPtr& node)
 {
+    std::unique_lock<std::mutex> lock(nodes_mutex_);
+
     auto pos = channels_.find(node->getAUUID());
+    auto telemetry = telemetry_.find(node->getAUUID());
+    if (telemetry != telemetry_.end()) {
+        // the client still gets the last window of the node
+        if (pos != channels_.end()) {
+            if (std::shared_ptr<const IntervalSummary> summary = telemetry->second->aggregator.flush()) {
+                pos->second->sendNote<NodeNote>(NodeNoteType::IntervalSummaryTriggered, *summary);
+            }
+        }
+        telemetry_.erase(telemetry);
+    }
+
     if (pos != channels_.end()) {
         channels_.erase(pos);
     }
@@ -19,16 +19,88 @@
 
 /// SYSTEM
 #include <csapex/utility/error_handling.h>
+#include <algorithm>
 #include <iostream>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/copy.hpp>
+#include <boost/version.hpp>
 
 using namespace csapex;
 using boost::asio::ip::tcp;
 
-Session::Session(Socket socket, const std::string& name) : socket_(new Socket(std::move(socket))), next_request_id_(1), running_(false), is_live_(false), was_live_(false), name_(name), is_valid_(true)
+constexpr uint32_t Session::COMPRESSED_FLAG;
+constexpr std::size_t Session::MAX_DECOMPRESSED_LENGTH;
+
+namespace
+{
+// boost::asio::async_write does not pass more buffers to the system at once
+const std::size_t MAX_PACKETS_PER_BATCH = 64;
+
+// how long stop() waits for queued packets to be sent
+const std::chrono::seconds STOP_FLUSH_TIMEOUT(1);
+
+std::vector<char> compress(const uint8_t* data, std::size_t length)
+{
+    std::vector<char> compressed;
+    boost::iostreams::filtering_ostream out;
+    out.push(boost::iostreams::zlib_compressor(boost::iostreams::zlib::best_speed));
+    out.push(boost::iostreams::back_inserter(compressed));
+    out.write(reinterpret_cast<const char*>(data), length);
+    out.reset();
+    return compressed;
+}
+
+std::vector<char> decompress(const uint8_t* data, std::size_t length)
+{
+    std::vector<char> decompressed;
+    boost::iostreams::filtering_istream in;
+    in.push(boost::iostreams::zlib_decompressor());
+    in.push(boost::iostreams::array_source(reinterpret_cast<const char*>(data), length));
+
+    // the size is only known after inflating, the peer must not make us allocate arbitrary amounts
+    char chunk[4096];
+    while (in) {
+        in.read(chunk, sizeof(chunk));
+        std::size_t read = static_cast<std::size_t>(in.gcount());
+        if (decompressed.size() + read > Session::MAX_DECOMPRESSED_LENGTH) {
+            throw std::runtime_error("the decompressed packet exceeds " + std::to_string(Session::MAX_DECOMPRESSED_LENGTH) + " bytes");
+        }
+        decompressed.insert(decompressed.end(), chunk, chunk + read);
+    }
+    return decompressed;
+}
+
+}  // namespace
+
+Session::Session(Socket socket, const std::string& name)
+  : socket_(new Socket(std::move(socket)))
+  , next_request_id_(1)
+  , write_in_progress_(false)
+  , flush_requested_(false)
+  , flush_interval_(0)
+  , compression_threshold_(0)
+  , running_(false)
+  , is_live_(false)
+  , was_live_(false)
+  , name_(name)
+  , is_valid_(true)
 {
 }
 
-Session::Session(const std::string& name) : next_request_id_(1), running_(false), is_live_(false), was_live_(false), name_(name), is_valid_(true)
+Session::Session(const std::string& name)
+  : next_request_id_(1)
+  , write_in_progress_(false)
+  , flush_requested_(false)
+  , flush_interval_(0)
+  , compression_threshold_(0)
+  , running_(false)
+  , is_live_(false)
+  , was_live_(false)
+  , name_(name)
+  , is_valid_(true)
 {
 }
 
@@ -81,10 +153,12 @@ void Session::start()
     }
     started(this);
 
+    // packets written right after starting must not be dropped before the handler thread runs
+    is_live_ = true;
+    was_live_ = true;
+
     packet_handler_thread_ = std::thread([this]() {
         csapex::thread::set_name(name_.c_str());
-        is_live_ = true;
-        was_live_ = true;
 
         try {
             mainLoop();
@@ -106,24 +180,25 @@ void Session::mainLoop()
 {
     while (running_) {
         std::unique_lock<std::recursive_mutex> packet_lock(packets_mutex_);
-        while (running_ && (packets_received_.empty() && packets_to_send_.empty())) {
-            packets_available_.wait_for(packet_lock, std::chrono::milliseconds(100));
+        while (running_ && packets_received_.empty()) {
+            auto timeout = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+            if (!packets_to_send_.empty() && !write_in_progress_) {
+                // packets are waiting for the flush interval
+                auto flush_time = oldest_queued_packet_ + flush_interval_;
+                if (flush_time <= std::chrono::steady_clock::now()) {
+                    packet_lock.unlock();
+                    flush();
+                    packet_lock.lock();
+                    continue;
+                }
+                timeout = std::min(timeout, flush_time);
+            }
+            packets_available_.wait_until(packet_lock, timeout);
         }
 
-        // so as not to starve the clients, we limit the max amount of packets to send
-        // before receiving other packets
+        // so as not to starve the clients, we limit the max amount of packets to handle
+        // before checking the send queue again
         const int max_operations_per_iteration = 32;
-        for (int i = 0; i < max_operations_per_iteration && running_ && !packets_to_send_.empty(); ++i) {
-            StreamableConstPtr packet = packets_to_send_.front();
-            packets_to_send_.pop_front();
-            packet_lock.unlock();
-
-            SerializationBuffer buffer = PacketSerializer::serializePacket(packet);
-            write_packet(buffer);
-
-            packet_lock.lock();
-        }
-
         for (int i = 0; i < max_operations_per_iteration && running_ && !packets_received_.empty(); ++i) {
             StreamableConstPtr packet = packets_received_.front();
             packets_received_.pop_front();
@@ -166,6 +241,18 @@ void Session::mainLoop()
 }
 
 void Session::stop()
+{
+    stop(true);
+}
+
+void Session::abort()
+{
+    // only the io thread can finish a write in progress, so it must not wait for the queue
+    discardQueuedPackets();
+    stop(false);
+}
+
+void Session::stop(bool drain_queue)
 {
     apex_assert_hard(packet_handler_thread_.get_id() != std::this_thread::get_id());
 
@@ -173,6 +260,11 @@ void Session::stop()
         stopped(this);
     }
 
+    if (drain_queue) {
+        // packets written right before stopping, e.g. the last notes, are still sent
+        drain(STOP_FLUSH_TIMEOUT);
+    }
+
     std::unique_lock<std::recursive_mutex> running_lock(running_mutex_);
 
     //    if(!live_) {
@@ -249,17 +341,32 @@ void Session::sendNote(io::NoteConstPtr note)
 void Session::write(const StreamableConstPtr& packet)
 {
     if (is_live_) {
+        std::shared_ptr<SerializationBuffer> buffer = std::make_shared<SerializationBuffer>(PacketSerializer::serializePacket(packet));
+
+        bool send_now;
         {
-            if (packet_handler_thread_.get_id() != std::this_thread::get_id()) {
-                std::unique_lock<std::recursive_mutex> packet_lock(packets_mutex_);
-                packets_to_send_.push_back(packet);
-            } else {
-                SerializationBuffer buffer = PacketSerializer::serializePacket(packet);
-                write_packet(buffer);
+            std::unique_lock<std::recursive_mutex> packet_lock(packets_mutex_);
+            if (packets_to_send_.empty()) {
+                oldest_queued_packet_ = std::chrono::steady_clock::now();
+            }
+            packets_to_send_.push_back(buffer);
+
+            ++stats_.packets_queued;
+            stats_.bytes_queued += buffer->size();
+            stats_.max_bytes_queued = std::max(stats_.max_bytes_queued, stats_.bytes_queued);
+
+            // the packet handler must not wait for the interval, it might block on a response to this packet
+            send_now = flush_interval_.count() == 0 || packet_handler_thread_.get_id() == std::this_thread::get_id();
+            if (send_now) {
+                flush_requested_ = true;
             }
         }
 
-        packets_available_.notify_all();
+        if (send_now) {
+            flush();
+        } else {
+            packets_available_.notify_all();
+        }
 
     } else {
         if (was_live_) {
@@ -273,6 +380,161 @@ void Session::write(const std::string& message)
     write(std::make_shared<Feedback>(message));
 }
 
+void Session::setFlushInterval(std::chrono::microseconds interval)
+{
+    std::unique_lock<std::recursive_mutex> packet_lock(packets_mutex_);
+    flush_interval_ = interval;
+}
+
+void Session::setCompressionThreshold(std::size_t bytes)
+{
+    std::unique_lock<std::recursive_mutex> packet_lock(packets_mutex_);
+    compression_threshold_ = bytes;
+}
+
+Session::Stats Session::getStats() const
+{
+    std::unique_lock<std::recursive_mutex> packet_lock(packets_mutex_);
+    return stats_;
+}
+
+void Session::flush()
+{
+    auto batch = std::make_shared<std::vector<std::shared_ptr<SerializationBuffer>>>();
+    std::size_t compression_threshold;
+    {
+        std::unique_lock<std::recursive_mutex> packet_lock(packets_mutex_);
+        if (write_in_progress_ || packets_to_send_.empty() || !socket_) {
+            // a running write continues with the queued packets when it is done
+            return;
+        }
+        write_in_progress_ = true;
+
+        while (!packets_to_send_.empty() && batch->size() < MAX_PACKETS_PER_BATCH) {
+            std::shared_ptr<SerializationBuffer> buffer = packets_to_send_.front();
+            packets_to_send_.pop_front();
+
+            --stats_.packets_queued;
+            stats_.bytes_queued -= buffer->size();
+
+            batch->push_back(buffer);
+        }
+        if (packets_to_send_.empty()) {
+            flush_requested_ = false;
+        } else {
+            oldest_queued_packet_ = std::chrono::steady_clock::now();
+        }
+        compression_threshold = compression_threshold_;
+    }
+
+    std::size_t compressed_packets = 0;
+    std::size_t saved_bytes = 0;
+    std::vector<boost::asio::const_buffer> buffers;
+    for (std::shared_ptr<SerializationBuffer>& buffer : *batch) {
+        if (compression_threshold > 0 && buffer->size() >= compression_threshold && buffer->size() <= MAX_DECOMPRESSED_LENGTH) {
+            std::vector<char> compressed = compress(buffer->data() + SerializationBuffer::HEADER_LENGTH, buffer->size() - SerializationBuffer::HEADER_LENGTH);
+            if (compressed.size() + SerializationBuffer::HEADER_LENGTH < buffer->size()) {
+                saved_bytes += buffer->size() - compressed.size() - SerializationBuffer::HEADER_LENGTH;
+                ++compressed_packets;
+
+                buffer = std::make_shared<SerializationBuffer>(reinterpret_cast<const uint8_t*>(compressed.data()), compressed.size(), true);
+                buffer->finalize();
+
+                uint32_t header = (static_cast<uint32_t>(buffer->size()) | COMPRESSED_FLAG);
+                for (std::size_t byte = 0; byte < SerializationBuffer::HEADER_LENGTH; ++byte) {
+                    buffer->at(byte) = (header >> (byte * 8)) & 0xFF;
+                }
+                buffers.push_back(boost::asio::buffer(buffer->data(), buffer->size()));
+                continue;
+            }
+        }
+
+        buffer->finalize();
+        buffers.push_back(boost::asio::buffer(buffer->data(), buffer->size()));
+    }
+
+    SessionWeakPtr self = shared_from_this();
+    auto send = [this, self, batch, buffers, compressed_packets, saved_bytes]() {
+        if (!self.lock()) {
+            return;
+        }
+        boost::asio::async_write(*socket_, buffers, [this, self, batch, compressed_packets, saved_bytes](boost::system::error_code ec, std::size_t written_bytes) {
+            SessionPtr session = self.lock();
+            if (!session) {
+                return;
+            }
+
+            bool flush_now;
+            {
+                std::unique_lock<std::recursive_mutex> packet_lock(packets_mutex_);
+                write_in_progress_ = false;
+
+                if (!ec) {
+                    stats_.packets_sent += batch->size();
+                    stats_.bytes_sent += written_bytes;
+                    ++stats_.batches_sent;
+                    stats_.packets_compressed += compressed_packets;
+                    stats_.bytes_saved_by_compression += saved_bytes;
+                }
+
+                flush_now = !packets_to_send_.empty() && (flush_requested_ || oldest_queued_packet_ + flush_interval_ <= std::chrono::steady_clock::now());
+            }
+
+            if (ec) {
+                if (ec != boost::asio::error::operation_aborted) {
+                    std::cerr << "the session cannot send: " << ec.message() << std::endl;
+                    abort();
+                }
+                packets_available_.notify_all();
+                return;
+            }
+
+            if (flush_now) {
+                // packets that were written in the meantime go out as the next batch
+                flush();
+            } else {
+                // the packet handler flushes once the interval has passed, stop() waits for an empty queue
+                packets_available_.notify_all();
+            }
+        });
+    };
+
+    // all operations on the socket happen in the thread of its io service
+#if BOOST_VERSION >= 106600
+    boost::asio::post(socket_->get_executor(), send);
+#else
+    socket_->get_io_service().post(send);
+#endif
+}
+
+void Session::drain(std::chrono::milliseconds timeout)
+{
+    {
+        std::unique_lock<std::recursive_mutex> packet_lock(packets_mutex_);
+        if (!socket_ || (packets_to_send_.empty() && !write_in_progress_)) {
+            return;
+        }
+        // the remaining packets must not wait for the flush interval
+        flush_requested_ = true;
+    }
+
+    flush();
+
+    std::unique_lock<std::recursive_mutex> packet_lock(packets_mutex_);
+    if (!packets_available_.wait_for(packet_lock, timeout, [this]() { return packets_to_send_.empty() && !write_in_progress_; })) {
+        std::cerr << "the session could not send " << packets_to_send_.size() << " queued packets before stopping" << std::endl;
+    }
+}
+
+void Session::discardQueuedPackets()
+{
+    std::unique_lock<std::recursive_mutex> packet_lock(packets_mutex_);
+    packets_to_send_.clear();
+    stats_.packets_queued = 0;
+    stats_.bytes_queued = 0;
+    flush_requested_ = false;
+}
+
 void Session::read_async()
 {
     {
@@ -286,70 +548,24 @@ void Session::read_async()
     std::shared_ptr<SerializationBuffer> message_data = std::make_shared<SerializationBuffer>();
     boost::asio::async_read(
         *socket_, boost::asio::buffer(&message_data->at(0), SerializationBuffer::HEADER_LENGTH), [this, message_data, self](boost::system::error_code ec, std::size_t reply_length) {
-            if (ec == boost::asio::error::eof) {
-                // do nothing
-                return;
-
-            } else if (ec == boost::asio::error::connection_reset) {
-                // disconnect
-                if (SessionPtr session = self.lock()) {
-                    stop();
-                }
+            if (handleReadError(ec, self)) {
                 return;
 
             } else if (reply_length > 0) {
                 // payload received
                 if (reply_length == SerializationBuffer::HEADER_LENGTH) {
                     message_data->seek(0);
-                    uint32_t message_length;
-                    *message_data >> message_length;
+                    uint32_t header;
+                    *message_data >> header;
+
+                    bool compressed = (header & COMPRESSED_FLAG) != 0;
+                    uint32_t message_length = header & ~COMPRESSED_FLAG;
 
                     if (message_length > SerializationBuffer::HEADER_LENGTH) {
                         message_data->resize(message_length, ' ');
-                        reply_length = boost::asio::read(*socket_, boost::asio::buffer(&message_data->at(SerializationBuffer::HEADER_LENGTH), message_length - SerializationBuffer::HEADER_LENGTH));
-                        apex_assert_equal_hard((int)reply_length, ((int)(message_length - SerializationBuffer::HEADER_LENGTH)));
-
-                        StreamablePtr serial = PacketSerializer::deserializePacket(*message_data);
-
-                        if (serial) {
-                            if (FeedbackConstPtr feedback = std::dynamic_pointer_cast<Feedback const>(serial)) {
-                                std::cerr << feedback->getMessage() << std::endl;
-                                if (feedback->getRequestID() != 0) {
-                                    std::unique_lock<std::recursive_mutex> lock(open_requests_mutex_);
-                                    auto it = open_requests_.find(feedback->getRequestID());
-                                    if (it != open_requests_.end()) {
-                                        std::promise<ResponseConstPtr>* promise = it->second;
-                                        promise->set_value(feedback);
-                                        open_requests_.erase(it);
+                        readBodyAsync(message_data, compressed);
+                        return;
 
-                                    } else {
-                                        std::cerr << "got feedback for unknown request " << (int)feedback->getRequestID() << std::endl;
-                                    }
-                                }
-
-                            } else if (ResponseConstPtr response = std::dynamic_pointer_cast<Response const>(serial)) {
-                                // std::cerr << "got response #" << (int) response->getRequestID() << std::endl;
-
-                                std::unique_lock<std::recursive_mutex> lock(open_requests_mutex_);
-                                auto it = open_requests_.find(response->getRequestID());
-                                if (it != open_requests_.end()) {
-                                    std::promise<ResponseConstPtr>* promise = it->second;
-                                    apex_assert_hard(response);
-                                    promise->set_value(response);
-                                    open_requests_.erase(it);
-
-                                } else {
-                                    std::cerr << "got response for unknown request " << (int)response->getRequestID() << std::endl;
-                                }
-
-                            } else {
-                                std::unique_lock<std::recursive_mutex> packet_lock(packets_mutex_);
-                                packets_received_.push_back(serial);
-                                packets_available_.notify_all();
-                            }
-                        } else {
-                            std::cerr << "could not deserialize message of length " << (int)message_length << std::endl;
-                        }
                     } else {
                         std::cerr << "got illegal message of length " << (int)message_length << std::endl;
                     }
@@ -364,26 +580,96 @@ void Session::read_async()
         });
 }
 
-void Session::write_packet(SerializationBuffer& buffer)
+void Session::readBodyAsync(const std::shared_ptr<SerializationBuffer>& message_data, bool compressed)
 {
-    try {
-        buffer.finalize();
+    SessionWeakPtr self = shared_from_this();
 
-        apex_assert_hard(socket_->is_open());
-        // std::cerr << (long) this << " is sending:\n" << buffer.toString() << std::endl;
+    std::size_t body_length = message_data->size() - SerializationBuffer::HEADER_LENGTH;
+    boost::asio::async_read(*socket_, boost::asio::buffer(&message_data->at(SerializationBuffer::HEADER_LENGTH), body_length),
+                            [this, message_data, compressed, self](boost::system::error_code ec, std::size_t reply_length) {
+                                if (handleReadError(ec, self)) {
+                                    return;
+                                } else if (ec) {
+                                    std::cerr << "cannot read message: " << ec.message() << std::endl;
+                                    return;
+                                }
+                                apex_assert_equal_hard((int)reply_length, ((int)(message_data->size() - SerializationBuffer::HEADER_LENGTH)));
+
+                                try {
+                                    StreamablePtr serial;
+                                    if (compressed) {
+                                        std::vector<char> payload = decompress(message_data->data() + SerializationBuffer::HEADER_LENGTH, reply_length);
+                                        SerializationBuffer buffer(reinterpret_cast<const uint8_t*>(payload.data()), payload.size(), true);
+                                        serial = PacketSerializer::deserializePacket(buffer);
+                                    } else {
+                                        serial = PacketSerializer::deserializePacket(*message_data);
+                                    }
 
-        std::size_t written_bytes = boost::asio::write(*socket_, boost::asio::buffer(buffer, buffer.size()));
+                                    if (serial) {
+                                        handleReceivedPacket(serial);
+                                    } else {
+                                        std::cerr << "could not deserialize message of length " << (int)message_data->size() << std::endl;
+                                    }
+                                } catch (const std::exception& e) {
+                                    std::cerr << "could not read message of length " << (int)message_data->size() << ": " << e.what() << std::endl;
+                                }
 
-        apex_assert_eq_hard(buffer.size(), written_bytes);
+                                read_async();
+                            });
+}
 
-        // std::cerr << (long) this << " has sent " << written_bytes << " bytes" << std::endl;
+bool Session::handleReadError(const boost::system::error_code& ec, const SessionWeakPtr& self)
+{
+    if (ec == boost::asio::error::eof) {
+        // do nothing
+        return true;
+
+    } else if (ec == boost::asio::error::connection_reset) {
+        // disconnect
+        if (SessionPtr session = self.lock()) {
+            abort();
+        }
+        return true;
+    }
+    return false;
+}
+
+void Session::handleReceivedPacket(const StreamablePtr& serial)
+{
+    if (FeedbackConstPtr feedback = std::dynamic_pointer_cast<Feedback const>(serial)) {
+        std::cerr << feedback->getMessage() << std::endl;
+        if (feedback->getRequestID() != 0) {
+            std::unique_lock<std::recursive_mutex> lock(open_requests_mutex_);
+            auto it = open_requests_.find(feedback->getRequestID());
+            if (it != open_requests_.end()) {
+                std::promise<ResponseConstPtr>* promise = it->second;
+                promise->set_value(feedback);
+                open_requests_.erase(it);
+
+            } else {
+                std::cerr << "got feedback for unknown request " << (int)feedback->getRequestID() << std::endl;
+            }
+        }
 
-    } catch (const std::exception& e) {
-        std::cerr << "the session has thrown an exception: " << e.what() << std::endl;
-        stopForced();
-    } catch (...) {
-        std::cerr << "the session has crashed with an unknown cause." << std::endl;
-        stopForced();
+    } else if (ResponseConstPtr response = std::dynamic_pointer_cast<Response const>(serial)) {
+        // std::cerr << "got response #" << (int) response->getRequestID() << std::endl;
+
+        std::unique_lock<std::recursive_mutex> lock(open_requests_mutex_);
+        auto it = open_requests_.find(response->getRequestID());
+        if (it != open_requests_.end()) {
+            std::promise<ResponseConstPtr>* promise = it->second;
+            apex_assert_hard(response);
+            promise->set_value(response);
+            open_requests_.erase(it);
+
+        } else {
+            std::cerr << "got response for unknown request " << (int)response->getRequestID() << std::endl;
+        }
+
+    } else {
+        std::unique_lock<std::recursive_mutex> packet_lock(packets_mutex_);
+        packets_received_.push_back(serial);
+        packets_available_.notify_all();
     }
 }
 
@@ -40,9 +40,10 @@ void SessionClient::run()
 
 void SessionClient::shutdown()
 {
+    // stopping first lets the io service send the queued packets
+    stop();
     io_service_running_ = false;
     io_service.stop();
-    stop();
 }
 
 bool SessionClient::isRunning() const
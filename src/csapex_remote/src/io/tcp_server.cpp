@@ -47,6 +47,8 @@ void TcpServer::do_accept()
     acceptor_.async_accept(socket_, [this](boost::system::error_code ec) {
         if (!ec) {
             SessionPtr session = std::make_shared<Session>(std::move(socket_), "server");
+            session->setFlushInterval(std::chrono::microseconds(core_.getSettings().get<int>("session_flush_interval_us", 0)));
+            session->setCompressionThreshold(core_.getSettings().get<int>("session_compression_threshold", 0));
 
             startSession(session);
         }
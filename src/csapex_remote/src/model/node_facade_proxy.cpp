@@ -14,6 +14,7 @@
 #include <csapex/model/connector_proxy.h>
 #include <csapex/model/node_characteristics.h>
 #include <csapex/model/node_state.h>
+#include <csapex/profiling/interval_summary.h>
 #include <csapex/profiling/profiler_proxy.h>
 #include <csapex/utility/uuid_provider.h>
 #include <csapex/utility/slim_signal_invoker.hpp>
@@ -42,6 +43,8 @@ NodeFacadeProxy::NodeFacadeProxy(const SessionPtr& session, AUUID uuid)
    **/
 
   guard_(-1)
+  , profiling_requested_(false)
+  , tracing_subscribed_(false)
 {
     node_channel_ = session->openChannel(uuid.getAbsoluteUUID());
 
@@ -149,6 +152,12 @@ NodeFacadeProxy::NodeFacadeProxy(const SessionPtr& session, AUUID uuid)
                     profiler_proxy_->updateInterval(interval);
                     interval_end(this, interval);
                 } break;
+                case NodeNoteType::IntervalSummaryTriggered: {
+                    interval_summary(this, std::make_shared<const IntervalSummary>(cn->getPayload<IntervalSummary>(0)));
+                } break;
+                case NodeNoteType::TracingSubscriptionChanged:
+                    // only sent to the server
+                    break;
                 case NodeNoteType::ErrorEvent: {
                     bool e = cn->getPayload<bool>(0);
                     std::string msg = cn->getPayload<std::string>(1);
@@ -175,6 +184,12 @@ NodeFacadeProxy::NodeFacadeProxy(const SessionPtr& session, AUUID uuid)
         createConnectorProxy(c);
     }
 
+    // individual intervals are only transmitted while someone looks at them
+    observe(interval_start.first_connected, [this]() { updateTracingSubscription(); });
+    observe(interval_start.last_disconnected, [this]() { updateTracingSubscription(); });
+    observe(interval_end.first_connected, [this]() { updateTracingSubscription(); });
+    observe(interval_end.last_disconnected, [this]() { updateTracingSubscription(); });
+
     observe(raw_data_connection.first_connected, [this]() { node_channel_->sendRequest<NodeRequests>(NodeRequests::NodeRequestType::AddClient); });
 
     observe(raw_data_connection.last_disconnected, [this]() { node_channel_->sendRequest<NodeRequests>(NodeRequests::NodeRequestType::RemoveClient); });
@@ -303,6 +318,19 @@ param::ParameterPtr NodeFacadeProxy::getParameter(const std::string& name) const
 void NodeFacadeProxy::setProfiling(bool profiling)
 {
     node_channel_->sendRequest<NodeRequests>(NodeRequests::NodeRequestType::SetProfiling, profiling);
+
+    profiling_requested_ = profiling;
+    updateTracingSubscription();
+}
+
+void NodeFacadeProxy::updateTracingSubscription()
+{
+    // the profiler proxy is fed with individual intervals, so profiling requires them as well
+    bool subscribe = profiling_requested_ || interval_start.isConnected() || interval_end.isConnected();
+    if (subscribe != tracing_subscribed_) {
+        tracing_subscribed_ = subscribe;
+        node_channel_->sendNote<NodeNote>(NodeNoteType::TracingSubscriptionChanged, subscribe);
+    }
 }
 
 NodeStatePtr NodeFacadeProxy::getNodeState() const
@@ -0,0 +1,363 @@
+/// HEADER
+#include "component_benchmarks.h"
+
+/// PROJECT
+#include <csapex/scheduling/task.h>
+#include <csapex/scheduling/task_queue.h>
+#include <csapex/scheduling/timed_queue.h>
+#include <csapex/scheduling/scheduler.h>
+#include <csapex/serialization/serialization_buffer.h>
+#include <csapex/utility/subprocess.h>
+
+/// SYSTEM
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+using namespace csapex;
+using namespace csapex::benchmarks;
+
+namespace
+{
+/**
+ * @brief The LockedMultisetQueue class mirrors the queue ThreadGroup used before the TaskQueue:
+ *        one mutex, a linear scan for duplicates and a priority ordered multiset.
+ */
+class LockedMultisetQueue
+{
+public:
+    bool push(const TaskPtr& task)
+    {
+        std::unique_lock<std::recursive_mutex> lock(mutex_);
+        for (auto it = tasks_.begin(); it != tasks_.end(); ++it) {
+            if (it->get() == task.get()) {
+                return false;
+            }
+        }
+        tasks_.insert(task);
+        task->setScheduled(true);
+        return true;
+    }
+
+    TaskPtr pop()
+    {
+        std::unique_lock<std::recursive_mutex> lock(mutex_);
+        if (tasks_.empty()) {
+            return nullptr;
+        }
+        TaskPtr task = *tasks_.begin();
+        tasks_.erase(tasks_.begin());
+        task->setScheduled(false);
+        return task;
+    }
+
+private:
+    struct greater
+    {
+        bool operator()(const TaskPtr& a, const TaskPtr& b) const
+        {
+            return a->getPriority() > b->getPriority();
+        }
+    };
+
+    std::recursive_mutex mutex_;
+    std::multiset<TaskPtr, greater> tasks_;
+};
+
+std::vector<TaskPtr> makeTasks(std::size_t count)
+{
+    std::vector<TaskPtr> tasks;
+    for (std::size_t i = 0; i < count; ++i) {
+        tasks.push_back(std::make_shared<Task>("task", []() {}, 0));
+    }
+    return tasks;
+}
+
+template <typename Queue>
+double measureScheduleRate(Queue& queue, const std::vector<TaskPtr>& tasks, std::size_t producers, std::size_t rounds)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    std::atomic<std::size_t> producers_done(0);
+
+    std::vector<std::thread> threads;
+    for (std::size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&queue, &tasks, &producers_done, p, producers, rounds]() {
+            for (std::size_t r = 0; r < rounds; ++r) {
+                for (std::size_t i = p; i < tasks.size(); i += producers) {
+                    queue.push(tasks[i]);
+                }
+            }
+            ++producers_done;
+        });
+    }
+
+    while (producers_done < producers) {
+        queue.pop();
+    }
+    while (queue.pop()) {
+    }
+
+    for (std::thread& t : threads) {
+        t.join();
+    }
+
+    // duplicates are dropped, so the rate is measured in schedule calls
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return tasks.size() * rounds / seconds;
+}
+
+/**
+ * @brief The RecordingScheduler class remembers when the timed queue handed over which task
+ */
+class RecordingScheduler : public Scheduler
+{
+public:
+    typedef std::chrono::steady_clock clock;
+
+    struct Record
+    {
+        TaskPtr task;
+        clock::time_point time;
+    };
+
+    int id() const override
+    {
+        return 0;
+    }
+    std::string getName() const override
+    {
+        return "recording";
+    }
+    void setName(const std::string&) override
+    {
+    }
+    void setPause(bool) override
+    {
+    }
+    bool canStartStepping() const override
+    {
+        return true;
+    }
+    void setSteppingMode(bool) override
+    {
+    }
+    bool isStepping() const override
+    {
+        return false;
+    }
+    bool isStepDone() const override
+    {
+        return true;
+    }
+    void step() override
+    {
+    }
+    void start() override
+    {
+    }
+    void stop() override
+    {
+    }
+    void clear() override
+    {
+    }
+    bool isEmpty() const override
+    {
+        return true;
+    }
+    void add(TaskGeneratorPtr) override
+    {
+    }
+    void add(TaskGeneratorPtr, const std::vector<TaskPtr>&) override
+    {
+    }
+    std::vector<TaskPtr> remove(TaskGenerator*) override
+    {
+        return {};
+    }
+
+    void schedule(TaskPtr task) override
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        records_.push_back(Record{ task, clock::now() });
+        changed_.notify_all();
+    }
+    void scheduleDelayed(TaskPtr, clock::time_point) override
+    {
+    }
+
+    std::vector<Record> waitFor(std::size_t count, std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        changed_.wait_for(lock, timeout, [this, count]() { return records_.size() >= count; });
+        return records_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::vector<Record> records_;
+};
+
+template <typename T>
+Measurement measureArraySerialization(const std::string& type)
+{
+    typedef std::chrono::steady_clock clock;
+
+    const std::size_t bytes = 16 * 1024 * 1024;
+    std::vector<T> payload(bytes / sizeof(T));
+    std::iota(payload.begin(), payload.end(), T(0));
+    std::vector<T> restored(payload.size());
+
+    auto mb_per_s = [bytes](clock::duration duration) { return (bytes / (1024.0 * 1024.0)) / std::chrono::duration<double>(duration).count(); };
+
+    SerializationBuffer element_wise;
+    auto start = clock::now();
+    for (const T& value : payload) {
+        element_wise << value;
+    }
+    auto element_write = clock::now() - start;
+    start = clock::now();
+    for (T& value : restored) {
+        element_wise >> value;
+    }
+    auto element_read = clock::now() - start;
+
+    SerializationBuffer bulk;
+    start = clock::now();
+    bulk.writeArray(payload.data(), payload.size());
+    auto bulk_write = clock::now() - start;
+    start = clock::now();
+    bulk.readArray(restored.data(), restored.size());
+    auto bulk_read = clock::now() - start;
+
+    if (restored != payload) {
+        throw std::runtime_error("bulk serialization of " + type + " arrays is broken");
+    }
+
+    return Measurement{ "serialization_" + type,
+                        { { "bytes", static_cast<double>(bytes) },
+                          { "element_wise_write_mb_per_second", mb_per_s(element_write) },
+                          { "element_wise_read_mb_per_second", mb_per_s(element_read) },
+                          { "bulk_write_mb_per_second", mb_per_s(bulk_write) },
+                          { "bulk_read_mb_per_second", mb_per_s(bulk_read) } } };
+}
+
+}  // namespace
+
+std::vector<Measurement> csapex::benchmarks::measureTaskQueue()
+{
+    const std::size_t producers = 4;
+    const std::size_t rounds = 20;
+
+    std::vector<Measurement> measurements;
+    for (std::size_t distinct_tasks : { 16, 256, 2048 }) {
+        std::vector<TaskPtr> tasks = makeTasks(distinct_tasks);
+
+        LockedMultisetQueue multiset_queue;
+        double multiset_rate = measureScheduleRate(multiset_queue, tasks, producers, rounds);
+
+        TaskQueue task_queue;
+        double task_queue_rate = measureScheduleRate(task_queue, tasks, producers, rounds);
+
+        measurements.push_back(Measurement{ "task_queue",
+                                            { { "tasks", static_cast<double>(distinct_tasks) },
+                                              { "producers", static_cast<double>(producers) },
+                                              { "multiset_schedules_per_second", multiset_rate },
+                                              { "task_queue_schedules_per_second", task_queue_rate } } });
+    }
+    return measurements;
+}
+
+std::vector<Measurement> csapex::benchmarks::measureTimedQueue()
+{
+    typedef std::chrono::steady_clock clock;
+
+    const std::size_t timers = 200;
+    const auto period = std::chrono::microseconds(2500);
+
+    TimedQueue queue;
+    queue.start();
+    auto scheduler = std::make_shared<RecordingScheduler>();
+
+    auto start = clock::now();
+    std::vector<clock::time_point> deadlines;
+    std::vector<TaskPtr> tasks;
+    for (std::size_t i = 0; i < timers; ++i) {
+        deadlines.push_back(start + period * (i + 1));
+        tasks.push_back(std::make_shared<Task>("periodic", []() {}, 0));
+        queue.schedule(scheduler, tasks.back(), deadlines.back());
+    }
+
+    auto records = scheduler->waitFor(timers, std::chrono::seconds(5));
+    queue.stop();
+
+    std::vector<double> lateness_ms;
+    for (const auto& record : records) {
+        std::size_t index = std::find(tasks.begin(), tasks.end(), record.task) - tasks.begin();
+        lateness_ms.push_back(std::chrono::duration<double, std::milli>(record.time - deadlines[index]).count());
+    }
+    if (lateness_ms.empty()) {
+        throw std::runtime_error("no timer fired");
+    }
+
+    double mean = std::accumulate(lateness_ms.begin(), lateness_ms.end(), 0.0) / lateness_ms.size();
+    double max = *std::max_element(lateness_ms.begin(), lateness_ms.end());
+    return { Measurement{ "timed_queue",
+                          { { "timers", static_cast<double>(timers) },
+                            { "period_us", static_cast<double>(period.count()) },
+                            { "fired", static_cast<double>(records.size()) },
+                            { "mean_lateness_ms", mean },
+                            { "max_lateness_ms", max } } } };
+}
+
+std::vector<Measurement> csapex::benchmarks::measureSerialization()
+{
+    return { measureArraySerialization<float>("float"), measureArraySerialization<uint8_t>("uint8") };
+}
+
+std::vector<Measurement> csapex::benchmarks::measureSharedMemory()
+{
+    const std::size_t size = 3 * 1024 * 1024;
+    const int rounds = 32;
+
+    Subprocess sp("benchmark");
+    sp.fork([&sp, size]() {
+        for (int i = 0; i < rounds; ++i) {
+            SubprocessChannel::Message msg = sp.in.read();
+            // answer with the same payload, written directly into the slot
+            sp.out.write(SubprocessChannel::MessageType::PROCESS_FINISHED, [&msg](uint8_t* slot, std::size_t) {
+                std::memcpy(slot, msg.data, msg.length);
+                return msg.length;
+            });
+        }
+    });
+
+    std::vector<uint8_t> payload(size);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        std::fill(payload.begin(), payload.end(), i);
+        sp.in.write({ SubprocessChannel::MessageType::PROCESS_SYNC, payload.data(), payload.size() });
+
+        SubprocessChannel::Message answer = sp.out.read();
+        if (answer.length != size) {
+            throw std::runtime_error("the subprocess answered with a truncated message");
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return { Measurement{ "shared_memory",
+                          { { "message_bytes", static_cast<double>(size) },
+                            { "round_trips", static_cast<double>(rounds) },
+                            { "mb_per_second", (2.0 * rounds * size / (1024.0 * 1024.0)) / seconds },
+                            { "ms_per_round_trip", seconds / rounds * 1e3 } } } };
+}
@@ -0,0 +1,38 @@
+#ifndef COMPONENT_BENCHMARKS_H
+#define COMPONENT_BENCHMARKS_H
+
+/// SYSTEM
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace csapex
+{
+namespace benchmarks
+{
+/**
+ * @brief The Measurement struct holds the named values of one run of a component benchmark.
+ *        Component benchmarks measure a single building block, independent of any graph.
+ */
+struct Measurement
+{
+    std::string component;
+    std::vector<std::pair<std::string, double>> values;
+};
+
+/// schedule throughput of the TaskQueue compared to a locked multiset
+std::vector<Measurement> measureTaskQueue();
+
+/// lateness of many timers that are due one after another in the TimedQueue
+std::vector<Measurement> measureTimedQueue();
+
+/// element wise and bulk throughput of the SerializationBuffer for float and byte arrays
+std::vector<Measurement> measureSerialization();
+
+/// round trips of large messages through the shared memory channels of a subprocess
+std::vector<Measurement> measureSharedMemory();
+
+}  // namespace benchmarks
+}  // namespace csapex
+
+#endif  // COMPONENT_BENCHMARKS_H
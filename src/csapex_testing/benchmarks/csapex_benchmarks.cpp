@@ -0,0 +1,837 @@
+/// PROJECT
+#include <csapex/core/settings/settings_impl.h>
+#include <csapex/factory/node_factory_impl.h>
+#include <csapex/factory/node_wrapper.hpp>
+#include <csapex/info.h>
+#include <csapex/model/connection.h>
+#include <csapex/model/graph/graph_impl.h>
+#include <csapex/model/graph_facade_impl.h>
+#include <csapex/model/node_facade_impl.h>
+#include <csapex/model/node_runner.h>
+#include <csapex/model/node_state.h>
+#include <csapex/model/subgraph_node.h>
+#include <csapex/msg/generic_value_message.hpp>
+#include <csapex/msg/generic_vector_message.hpp>
+#include <csapex/msg/input.h>
+#include <csapex/scheduling/thread_group.h>
+#include <csapex/scheduling/thread_pool.h>
+#include <csapex/utility/error_handling.h>
+#include <csapex/utility/uuid_provider.h>
+#include <csapex_testing/mockup_nodes.h>
+#include <csapex_testing/test_exception_handler.h>
+
+/// COMPONENT
+#include "component_benchmarks.h"
+
+/// SYSTEM
+#include <boost/program_options.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace po = boost::program_options;
+
+using namespace csapex;
+
+/// count all heap allocations of the process, the benchmarks report the allocations and bytes per message
+namespace
+{
+std::atomic<uint64_t> allocations(0);
+std::atomic<uint64_t> allocated_bytes(0);
+
+void* countedAllocation(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+}  // namespace
+
+void* operator new(std::size_t size)
+{
+    return countedAllocation(size);
+}
+void* operator new[](std::size_t size)
+{
+    return countedAllocation(size);
+}
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace
+{
+template <typename T>
+NodePtr makeNode()
+{
+    return NodePtr(new T());
+}
+
+/// @pre sorted is not empty and sorted in ascending order
+double sortedPercentile(const std::vector<double>& sorted, double p)
+{
+    std::size_t index = std::min(sorted.size() - 1, static_cast<std::size_t>(p * sorted.size()));
+    return sorted.at(index);
+}
+
+struct Result
+{
+    std::string graph;
+    std::string scheduler;
+    int size;
+    int iterations;
+    int messages_per_iteration;
+
+    double seconds;
+    std::vector<double> latencies_us;
+    uint64_t allocations;
+    uint64_t bytes;
+
+    // duration of the same graph on the single thread without fusion, divided by this duration
+    double measured_fusion_speedup = 0.0;
+
+    // only for graphs with a join, the time from the start of a step until the join is executed
+    std::vector<double> join_latencies_us;
+
+    double percentile(double p) const
+    {
+        return sortedPercentile(latencies_us, p);
+    }
+};
+
+/**
+ * @brief The BusySinkNode class keeps its thread busy for 50 us per message
+ */
+class BusySinkNode
+{
+public:
+    void setup(NodeModifier& node_modifier)
+    {
+        in = node_modifier.addInput<int>("input");
+    }
+
+    void setupParameters(Parameterizable& /*parameters*/)
+    {
+    }
+
+    void process(NodeModifier& /*node_modifier*/, Parameterizable& /*parameters*/)
+    {
+        auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(50);
+        while (std::chrono::steady_clock::now() < end) {
+        }
+    }
+
+private:
+    Input* in;
+};
+
+/**
+ * @brief The ArrivalRecorderNode class joins two inputs and remembers when it was executed
+ */
+class ArrivalRecorderNode
+{
+public:
+    void setup(NodeModifier& node_modifier)
+    {
+        input_a = node_modifier.addInput<int>("input_a");
+        input_b = node_modifier.addInput<int>("input_b");
+        out = node_modifier.addOutput<int>("output");
+    }
+
+    void setupParameters(Parameterizable& /*parameters*/)
+    {
+    }
+
+    void process(NodeModifier& /*node_modifier*/, Parameterizable& /*parameters*/)
+    {
+        arrival = std::chrono::steady_clock::now();
+        msg::publish(out, msg::getValue<int>(input_a) + msg::getValue<int>(input_b));
+    }
+
+    std::chrono::steady_clock::time_point arrival;
+
+private:
+    Input* input_a;
+    Input* input_b;
+    Output* out;
+};
+
+/**
+ * @brief The BusyStageNode class forwards its input after blocking its thread for 500 us
+ */
+class BusyStageNode
+{
+public:
+    void setup(NodeModifier& node_modifier)
+    {
+        in = node_modifier.addInput<int>("input");
+        out = node_modifier.addOutput<int>("output");
+    }
+
+    void setupParameters(Parameterizable& /*parameters*/)
+    {
+    }
+
+    void process(NodeModifier& /*node_modifier*/, Parameterizable& /*parameters*/)
+    {
+        // sleeping, so that the stages overlap on machines with a single core, too
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+        msg::publish(out, msg::getValue<int>(in));
+    }
+
+private:
+    Input* in;
+    Output* out;
+};
+
+/**
+ * @brief The VectorSourceNode class publishes a vector of 8 elements per execution
+ */
+class VectorSourceNode : public Node
+{
+public:
+    void setup(NodeModifier& node_modifier) override
+    {
+        out = node_modifier.addOutput<connection_types::GenericVectorMessage, int>("output");
+    }
+
+    void setupParameters(Parameterizable& /*parameters*/) override
+    {
+    }
+
+    void process() override
+    {
+        auto vector = std::make_shared<std::vector<int>>(8, 1);
+        msg::publish<connection_types::GenericVectorMessage, int>(out, vector);
+    }
+
+private:
+    Output* out;
+};
+
+/**
+ * @brief The VectorSinkNode class remembers when each vector arrived
+ */
+class VectorSinkNode
+{
+public:
+    void setup(NodeModifier& node_modifier)
+    {
+        in = node_modifier.addInput<connection_types::GenericVectorMessage, int>("input");
+    }
+
+    void setupParameters(Parameterizable& /*parameters*/)
+    {
+    }
+
+    void process(NodeModifier& /*node_modifier*/, Parameterizable& /*parameters*/)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        arrivals.push_back(std::chrono::steady_clock::now());
+        changed.notify_all();
+    }
+
+    void waitFor(std::size_t count)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!changed.wait_for(lock, std::chrono::seconds(10), [this, count]() { return arrivals.size() >= count; })) {
+            throw std::runtime_error("waiting for a vector timed out");
+        }
+    }
+
+    std::vector<std::chrono::steady_clock::time_point> getArrivals() const
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return arrivals;
+    }
+
+private:
+    Input* in;
+
+    mutable std::mutex mutex;
+    std::condition_variable changed;
+    std::vector<std::chrono::steady_clock::time_point> arrivals;
+};
+
+/**
+ * @brief The Benchmark class builds one graph of mockup nodes and executes it step by step.
+ *        Each step pushes one message per source through the complete graph.
+ *        Graphs that iterate containers run freely instead, each vector that reaches the sink counts as one step.
+ */
+class Benchmark
+{
+public:
+    Benchmark(const std::string& scheduler)
+      : node_factory(std::make_shared<NodeFactoryImplementation>(SettingsImplementation::NoSettings, nullptr))
+      , factory(*node_factory)
+      , executor(eh, scheduler != "single_thread" && scheduler != "critical_path" && scheduler != "fused_chains", false, false)
+      , messages_per_iteration(0)
+      , step_done(false)
+    {
+        factory.registerNodeType(std::make_shared<NodeConstructor>("Identity", std::bind(&makeNode<NodeWrapper<MockupStaticMultiplierNode<1>>>)));
+        factory.registerNodeType(std::make_shared<NodeConstructor>("MockupSource", std::bind(&makeNode<MockupSource>)));
+        factory.registerNodeType(std::make_shared<NodeConstructor>("MockupSink", std::bind(&makeNode<MockupSink>)));
+        factory.registerNodeType(std::make_shared<NodeConstructor>("MockupVariadicSum", std::bind(&makeNode<MockupVariadicSum>)));
+        factory.registerNodeType(std::make_shared<NodeConstructor>("BusySink", std::bind(&makeNode<NodeWrapper<BusySinkNode>>)));
+        factory.registerNodeType(std::make_shared<NodeConstructor>("ArrivalRecorder", std::bind(&makeNode<NodeWrapper<ArrivalRecorderNode>>)));
+        factory.registerNodeType(std::make_shared<NodeConstructor>("BusyStage", std::bind(&makeNode<NodeWrapper<BusyStageNode>>)));
+        factory.registerNodeType(std::make_shared<NodeConstructor>("VectorSource", std::bind(&makeNode<VectorSourceNode>)));
+        factory.registerNodeType(std::make_shared<NodeConstructor>("VectorSink", std::bind(&makeNode<NodeWrapper<VectorSinkNode>>)));
+
+        if (scheduler == "work_stealing") {
+            executor.enableWorkStealing(0);
+        } else if (scheduler == "critical_path") {
+            executor.setSchedulingPolicy(SchedulingPolicy::CRITICAL_PATH);
+        } else if (scheduler == "fused_chains") {
+            executor.setChainFusion(true);
+        }
+
+        graph_node = std::make_shared<SubgraphNode>(std::make_shared<GraphImplementation>());
+        graph = graph_node->getLocalGraph();
+
+        main_graph_facade = std::make_shared<GraphFacadeImplementation>(executor, graph, graph_node);
+        graph->setNodeFacade(main_graph_facade->getLocalNodeFacade().get());
+
+        executor.setSteppingMode(true);
+        executor.setSuppressExceptions(false);
+
+        end_step_connection = executor.end_step.connect([this]() {
+            std::unique_lock<std::mutex> lock(step_mutex);
+            step_done = true;
+            step_changed.notify_all();
+        });
+    }
+
+    ~Benchmark()
+    {
+        end_step_connection.disconnect();
+    }
+
+    NodeFacadeImplementationPtr add(const std::string& type, const std::string& name)
+    {
+        NodeFacadeImplementationPtr nf = factory.makeNode(type, UUIDProvider::makeUUID_without_parent(name), graph);
+        apex_assert_hard(nf);
+        main_graph_facade->addNode(nf);
+        return nf;
+    }
+
+    void connect(NodeFacadeImplementationPtr from, const std::string& output, NodeFacadeImplementationPtr to, const std::string& input)
+    {
+        main_graph_facade->connect(from, output, to, input);
+        ++messages_per_iteration;
+    }
+
+    void connectVariadic(NodeFacadeImplementationPtr from, const std::string& output, NodeFacadeImplementationPtr sum)
+    {
+        auto variadic = std::dynamic_pointer_cast<MockupVariadicSum>(sum->getNode());
+        apex_assert_hard(variadic);
+        Input* input = variadic->createVariadicInput(makeEmpty<connection_types::GenericValueMessage<int>>(), "input", false);
+        main_graph_facade->connect(from, output, input->getUUID());
+        ++messages_per_iteration;
+    }
+
+    void reportFusedChains(std::ostream& out) const
+    {
+        for (const FusedChainReport& report : graph->getFusedChainReports()) {
+            out << "  fused chain of " << report.nodes.size() << " nodes starting at " << report.nodes.front().getShortName() << ": " << report.fused_executions
+                << " fused executions, " << report.handover_latency << "us per handover, modeled speedup " << report.modeled_speedup << " (an estimate, not measured)" << std::endl;
+        }
+    }
+
+    /// source -> n x identity -> sink
+    void makeChain(int n)
+    {
+        NodeFacadeImplementationPtr last = add("MockupSource", "source");
+        std::string last_output = "output";
+        for (int i = 0; i < n; ++i) {
+            NodeFacadeImplementationPtr node = add("Identity", "identity_" + std::to_string(i));
+            connect(last, last_output, node, "input");
+            last = node;
+        }
+        connect(last, last_output, add("MockupSink", "sink"), "input");
+    }
+
+    /// source -> n parallel identities -> variadic sum -> sink
+    void makeFanOutFanIn(int n)
+    {
+        NodeFacadeImplementationPtr source = add("MockupSource", "source");
+        NodeFacadeImplementationPtr sum = add("MockupVariadicSum", "sum");
+        for (int i = 0; i < n; ++i) {
+            NodeFacadeImplementationPtr node = add("Identity", "identity_" + std::to_string(i));
+            connect(source, "output", node, "input");
+            connectVariadic(node, "output", sum);
+        }
+        connect(sum, "sum", add("MockupSink", "sink"), "input");
+    }
+
+    /// n sources -> variadic sum with n inputs -> sink
+    void makeVariadic(int n)
+    {
+        NodeFacadeImplementationPtr sum = add("MockupVariadicSum", "sum");
+        for (int i = 0; i < n; ++i) {
+            connectVariadic(add("MockupSource", "source_" + std::to_string(i)), "output", sum);
+        }
+        connect(sum, "sum", add("MockupSink", "sink"), "input");
+    }
+
+    /// source -> n busy sinks, source -> 2 x identity -> join <- source, the join latency shows the effect of the scheduling policy
+    void makeJoin(int n)
+    {
+        NodeFacadeImplementationPtr source = add("MockupSource", "source");
+        for (int i = 0; i < n; ++i) {
+            connect(source, "output", add("BusySink", "busy_sink_" + std::to_string(i)), "input");
+        }
+        NodeFacadeImplementationPtr a1 = add("Identity", "identity_0");
+        NodeFacadeImplementationPtr a2 = add("Identity", "identity_1");
+        NodeFacadeImplementationPtr join = add("ArrivalRecorder", "join");
+        connect(source, "output", a1, "input");
+        connect(a1, "output", a2, "input");
+        connect(a2, "output", join, "input_a");
+        connect(source, "output", join, "input_b");
+        connect(join, "output", add("MockupSink", "sink"), "input");
+
+        arrival_recorder = std::dynamic_pointer_cast<NodeWrapper<ArrivalRecorderNode>>(join->getNode());
+        apex_assert_hard(arrival_recorder);
+    }
+
+    /// vector source -> subgraph iterating the elements through 2 busy pipelining stages, n elements at a time -> sink, the graph runs freely
+    void makePipelinedIteration(int n)
+    {
+        NodeFacadeImplementationPtr source = add("VectorSource", "source");
+        NodeFacadeImplementationPtr sink = add("VectorSink", "sink");
+
+        NodeFacadeImplementationPtr sub_graph_node_facade = factory.makeNode("csapex::Graph", graph->generateUUID("subgraph"), graph);
+        SubgraphNodePtr sub_graph = std::dynamic_pointer_cast<SubgraphNode>(sub_graph_node_facade->getNode());
+        apex_assert_hard(sub_graph);
+
+        auto sub_graph_facade = std::make_shared<GraphFacadeImplementation>(executor, sub_graph->getLocalGraph(), sub_graph);
+        sub_graph_facades.push_back(sub_graph_facade);
+
+        // each stage runs on a thread of its own, in the execution mode that iteration_parallelism requires
+        std::vector<NodeFacadeImplementationPtr> stages;
+        for (int i = 0; i < 2; ++i) {
+            NodeFacadeImplementationPtr stage = factory.makeNode("BusyStage", UUIDProvider::makeUUID_without_parent("stage_" + std::to_string(i)), sub_graph->getLocalGraph());
+            sub_graph_facade->addNode(stage);
+            stage->getNodeState()->setExecutionMode(ExecutionMode::PIPELINING);
+            executor.addToGroup(stage->getNodeRunner().get(), executor.createGroup("stage " + std::to_string(i))->id());
+            stages.push_back(stage);
+        }
+        graph->addNode(sub_graph_node_facade);
+
+        auto type = connection_types::GenericVectorMessage::make<int>();
+        auto in_map = sub_graph->addForwardingInput(type, "forwarding", false);
+        auto out_map = sub_graph->addForwardingOutput(type, "forwarding");
+        sub_graph->setIterationEnabled(in_map.external, true);
+        iterated_graph = sub_graph;
+        iteration_parallelism = n;
+
+        sub_graph_facade->connect(in_map.internal, stages[0], "input");
+        // the first stage can only work on the next element while the second is busy if the connection buffers its result
+        sub_graph_facade->connect(stages[0], "output", stages[1], "input")->setQueueCapacity(2);
+        sub_graph_facade->connect(stages[1], "output", out_map.internal);
+
+        main_graph_facade->connect(source, "output", in_map.external);
+        main_graph_facade->connect(out_map.external, sink, "input");
+        // each of the 8 elements passes 3 connections in the subgraph
+        messages_per_iteration += 2 + 3 * 8;
+
+        vector_sink = std::dynamic_pointer_cast<NodeWrapper<VectorSinkNode>>(sink->getNode());
+        apex_assert_hard(vector_sink);
+    }
+
+    /// source -> n subgraphs, each forwarding through one identity -> sink
+    void makeNested(int n)
+    {
+        auto type = makeEmpty<connection_types::GenericValueMessage<int>>();
+
+        NodeFacadeImplementationPtr source = add("MockupSource", "source");
+        NodeFacadeImplementationPtr sink = add("MockupSink", "sink");
+
+        UUID last_output;
+        for (int i = 0; i < n; ++i) {
+            NodeFacadeImplementationPtr sub_graph_node_facade = factory.makeNode("csapex::Graph", graph->generateUUID("subgraph"), graph);
+            SubgraphNodePtr sub_graph = std::dynamic_pointer_cast<SubgraphNode>(sub_graph_node_facade->getNode());
+            apex_assert_hard(sub_graph);
+
+            auto sub_graph_facade = std::make_shared<GraphFacadeImplementation>(executor, sub_graph->getLocalGraph(), sub_graph);
+            sub_graph_facades.push_back(sub_graph_facade);
+
+            NodeFacadeImplementationPtr node = factory.makeNode("Identity", UUIDProvider::makeUUID_without_parent("identity"), sub_graph->getLocalGraph());
+            sub_graph_facade->addNode(node);
+            graph->addNode(sub_graph_node_facade);
+
+            auto in_map = sub_graph->addForwardingInput(type, "forwarding", false);
+            auto out_map = sub_graph->addForwardingOutput(type, "forwarding");
+            sub_graph_facade->connect(in_map.internal, node, "input");
+            sub_graph_facade->connect(node, "output", out_map.internal);
+
+            if (i == 0) {
+                main_graph_facade->connect(source, "output", in_map.external);
+            } else {
+                main_graph_facade->connect(last_output, in_map.external);
+            }
+            last_output = out_map.external;
+            messages_per_iteration += 3;
+        }
+        main_graph_facade->connect(last_output, sink, "input");
+        ++messages_per_iteration;
+    }
+
+    void step()
+    {
+        std::unique_lock<std::mutex> lock(step_mutex);
+        step_done = false;
+        lock.unlock();
+
+        executor.step();
+
+        lock.lock();
+        if (!step_changed.wait_for(lock, std::chrono::seconds(10), [this]() { return step_done; })) {
+            throw std::runtime_error("waiting for the end of a step timed out");
+        }
+    }
+
+    Result run(int warmup, int iterations)
+    {
+        if (vector_sink) {
+            return runFreely(warmup, iterations);
+        }
+
+        executor.start();
+
+        for (int i = 0; i < warmup; ++i) {
+            step();
+        }
+
+        Result result;
+        result.iterations = iterations;
+        result.messages_per_iteration = messages_per_iteration;
+        result.latencies_us.reserve(iterations);
+
+        uint64_t allocations_before = allocations.load();
+        uint64_t bytes_before = allocated_bytes.load();
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            auto step_start = std::chrono::steady_clock::now();
+            step();
+            result.latencies_us.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - step_start).count());
+            if (arrival_recorder) {
+                result.join_latencies_us.push_back(std::chrono::duration<double, std::micro>(arrival_recorder->arrival - step_start).count());
+            }
+        }
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.allocations = allocations.load() - allocations_before;
+        result.bytes = allocated_bytes.load() - bytes_before;
+
+        executor.stop();
+
+        std::sort(result.latencies_us.begin(), result.latencies_us.end());
+        std::sort(result.join_latencies_us.begin(), result.join_latencies_us.end());
+        return result;
+    }
+
+private:
+    /// stepping would hand the nested nodes one element at a time, so every vector that reaches the sink counts as one iteration
+    Result runFreely(int warmup, int iterations)
+    {
+        executor.setSteppingMode(false);
+        executor.start();
+        iterated_graph->setParameter<int>("iteration_parallelism", iteration_parallelism);
+
+        vector_sink->waitFor(warmup + 1);
+        uint64_t allocations_before = allocations.load();
+        uint64_t bytes_before = allocated_bytes.load();
+
+        vector_sink->waitFor(warmup + 1 + iterations);
+        Result result;
+        result.allocations = allocations.load() - allocations_before;
+        result.bytes = allocated_bytes.load() - bytes_before;
+
+        executor.stop();
+
+        std::vector<std::chrono::steady_clock::time_point> arrivals = vector_sink->getArrivals();
+        result.iterations = iterations;
+        result.messages_per_iteration = messages_per_iteration;
+        result.seconds = std::chrono::duration<double>(arrivals.at(warmup + iterations) - arrivals.at(warmup)).count();
+        for (int i = warmup + 1; i <= warmup + iterations; ++i) {
+            result.latencies_us.push_back(std::chrono::duration<double, std::micro>(arrivals[i] - arrivals[i - 1]).count());
+        }
+        std::sort(result.latencies_us.begin(), result.latencies_us.end());
+        return result;
+    }
+
+private:
+    std::shared_ptr<NodeFactoryImplementation> node_factory;
+    NodeFactoryImplementation& factory;
+
+    TestExceptionHandler eh;
+
+    ThreadPool executor;
+
+    SubgraphNodePtr graph_node;
+    GraphImplementationPtr graph;
+    GraphFacadeImplementationPtr main_graph_facade;
+    std::vector<GraphFacadeImplementationPtr> sub_graph_facades;
+
+    std::shared_ptr<NodeWrapper<ArrivalRecorderNode>> arrival_recorder;
+    std::shared_ptr<NodeWrapper<VectorSinkNode>> vector_sink;
+    SubgraphNodePtr iterated_graph;
+    int iteration_parallelism = 1;
+
+    int messages_per_iteration;
+
+    std::mutex step_mutex;
+    std::condition_variable step_changed;
+    bool step_done;
+    slim_signal::Connection end_step_connection;
+};
+
+/// the cost of creating and copying single messages, independent of any graph
+struct MessageFootprint
+{
+    std::size_t size;
+    double allocations_per_message;
+    double bytes_per_message;
+    double allocations_per_clone;
+    double bytes_per_clone;
+};
+
+MessageFootprint measureMessageFootprint()
+{
+    typedef connection_types::GenericValueMessage<int> IntMessage;
+    const int count = 1000;
+
+    MessageFootprint footprint;
+    footprint.size = sizeof(IntMessage);
+
+    std::vector<std::shared_ptr<IntMessage>> messages;
+    messages.reserve(count);
+    // the first message registers the type
+    messages.push_back(std::make_shared<IntMessage>(0, "/base_link"));
+
+    uint64_t allocations_before = allocations.load();
+    uint64_t bytes_before = allocated_bytes.load();
+    for (int i = 1; i < count; ++i) {
+        messages.push_back(std::make_shared<IntMessage>(i, "/base_link"));
+    }
+    footprint.allocations_per_message = (allocations.load() - allocations_before) / double(count - 1);
+    footprint.bytes_per_message = (allocated_bytes.load() - bytes_before) / double(count - 1);
+
+    std::vector<TokenData::Ptr> clones;
+    clones.reserve(count);
+    allocations_before = allocations.load();
+    bytes_before = allocated_bytes.load();
+    for (const std::shared_ptr<IntMessage>& message : messages) {
+        clones.push_back(message->cloneAs<TokenData>());
+    }
+    footprint.allocations_per_clone = (allocations.load() - allocations_before) / double(count);
+    footprint.bytes_per_clone = (allocated_bytes.load() - bytes_before) / double(count);
+
+    return footprint;
+}
+
+void writeJson(std::ostream& out, const MessageFootprint& footprint, const std::vector<benchmarks::Measurement>& measurements, const std::vector<Result>& results)
+{
+    out << std::fixed << std::setprecision(3);
+    out << "{\n";
+    out << "  \"version\": \"" << info::CSAPEX_VERSION.toString() << "\",\n";
+    out << "  \"commit\": \"" << info::GIT_COMMIT_HASH << "\",\n";
+    out << "  \"message\": {\"size\": " << footprint.size << ", \"allocations_per_message\": " << footprint.allocations_per_message
+        << ", \"bytes_per_message\": " << footprint.bytes_per_message << ", \"allocations_per_clone\": " << footprint.allocations_per_clone
+        << ", \"bytes_per_clone\": " << footprint.bytes_per_clone << "},\n";
+    out << "  \"components\": [";
+    for (std::size_t i = 0; i < measurements.size(); ++i) {
+        const benchmarks::Measurement& m = measurements[i];
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    {\"component\": \"" << m.component << "\"";
+        for (const auto& value : m.values) {
+            out << ", \"" << value.first << "\": " << value.second;
+        }
+        out << "}";
+    }
+    out << "\n  ],\n";
+    out << "  \"benchmarks\": [";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        double messages = static_cast<double>(r.iterations) * r.messages_per_iteration;
+
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    {\"graph\": \"" << r.graph << "\", \"scheduler\": \"" << r.scheduler << "\", \"size\": " << r.size;
+        out << ", \"iterations\": " << r.iterations << ", \"messages_per_iteration\": " << r.messages_per_iteration;
+        out << ", \"seconds\": " << r.seconds;
+        out << ", \"iterations_per_second\": " << r.iterations / r.seconds << ", \"messages_per_second\": " << messages / r.seconds;
+        out << ", \"latency_us\": {\"p50\": " << r.percentile(0.5) << ", \"p90\": " << r.percentile(0.9) << ", \"p99\": " << r.percentile(0.99) << ", \"max\": " << r.latencies_us.back() << "}";
+        out << ", \"allocations_per_message\": " << r.allocations / messages << ", \"bytes_per_message\": " << r.bytes / messages;
+        if (!r.join_latencies_us.empty()) {
+            out << ", \"join_latency_us\": {\"p50\": " << sortedPercentile(r.join_latencies_us, 0.5) << ", \"p90\": " << sortedPercentile(r.join_latencies_us, 0.9)
+                << ", \"max\": " << r.join_latencies_us.back() << "}";
+        }
+        if (r.measured_fusion_speedup > 0.0) {
+            out << ", \"measured_fusion_speedup\": " << r.measured_fusion_speedup;
+        }
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+std::vector<std::string> split(const std::string& list)
+{
+    std::vector<std::string> result;
+    std::stringstream ss(list);
+    std::string entry;
+    while (std::getline(ss, entry, ',')) {
+        if (!entry.empty()) {
+            result.push_back(entry);
+        }
+    }
+    return result;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    po::options_description desc("Allowed options");
+    // clang-format off
+    desc.add_options()
+            ("help", "show help message")
+            ("components", po::value<std::string>()->default_value("task_queue,timed_queue,serialization,shared_memory"), "comma separated list of components to benchmark on their own")
+            ("graphs", po::value<std::string>()->default_value("chain,fan_out_fan_in,variadic,nested,join,pipelined_iteration"), "comma separated list of graphs to benchmark")
+            ("schedulers", po::value<std::string>()->default_value("single_thread,thread_per_node,work_stealing,critical_path,fused_chains"), "comma separated list of scheduler configurations")
+            ("sizes", po::value<std::string>()->default_value("1,8,32"), "comma separated list of graph sizes")
+            ("iterations", po::value<int>()->default_value(1000), "measured steps per benchmark")
+            ("warmup", po::value<int>()->default_value(50), "unmeasured steps before each benchmark")
+            ("output", po::value<std::string>()->default_value(""), "file to write the JSON report to, default is stdout");
+    // clang-format on
+
+    po::variables_map vm;
+    try {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+    } catch (const std::exception& e) {
+        std::cerr << "cannot parse parameters: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    csapex::error_handling::init();
+
+    int iterations = std::max(1, vm["iterations"].as<int>());
+    int warmup = std::max(0, vm["warmup"].as<int>());
+
+    MessageFootprint footprint = measureMessageFootprint();
+
+    auto benchmark = [&](const std::string& graph, const std::string& scheduler, int size) {
+        std::cerr << "benchmarking " << graph << " (" << size << ") with " << scheduler << std::endl;
+
+        Benchmark benchmark(scheduler);
+        if (graph == "chain") {
+            benchmark.makeChain(size);
+        } else if (graph == "fan_out_fan_in") {
+            benchmark.makeFanOutFanIn(size);
+        } else if (graph == "variadic") {
+            benchmark.makeVariadic(size);
+        } else if (graph == "nested") {
+            benchmark.makeNested(size);
+        } else if (graph == "join") {
+            benchmark.makeJoin(size);
+        } else if (graph == "pipelined_iteration") {
+            benchmark.makePipelinedIteration(size);
+        } else {
+            throw std::invalid_argument("unknown graph " + graph);
+        }
+
+        Result result = benchmark.run(warmup, iterations);
+        if (scheduler == "fused_chains") {
+            benchmark.reportFusedChains(std::cerr);
+        }
+        result.graph = graph;
+        result.scheduler = scheduler;
+        result.size = size;
+        return result;
+    };
+
+    std::vector<benchmarks::Measurement> measurements;
+    std::vector<Result> results;
+    try {
+        for (const std::string& component : split(vm["components"].as<std::string>())) {
+            std::cerr << "benchmarking component " << component << std::endl;
+
+            std::vector<benchmarks::Measurement> component_measurements;
+            if (component == "task_queue") {
+                component_measurements = benchmarks::measureTaskQueue();
+            } else if (component == "timed_queue") {
+                component_measurements = benchmarks::measureTimedQueue();
+            } else if (component == "serialization") {
+                component_measurements = benchmarks::measureSerialization();
+            } else if (component == "shared_memory") {
+                component_measurements = benchmarks::measureSharedMemory();
+            } else {
+                throw std::invalid_argument("unknown component " + component);
+            }
+            measurements.insert(measurements.end(), component_measurements.begin(), component_measurements.end());
+        }
+
+        for (const std::string& graph : split(vm["graphs"].as<std::string>())) {
+            for (const std::string& scheduler : split(vm["schedulers"].as<std::string>())) {
+                for (const std::string& size_string : split(vm["sizes"].as<std::string>())) {
+                    int size = std::max(1, std::stoi(size_string));
+                    Result result = benchmark(graph, scheduler, size);
+
+                    if (scheduler == "fused_chains") {
+                        // fusion runs on the single thread, so that is the unfused execution to compare with
+                        auto unfused = std::find_if(results.begin(), results.end(), [&](const Result& r) { return r.graph == graph && r.scheduler == "single_thread" && r.size == size; });
+                        double unfused_seconds = unfused != results.end() ? unfused->seconds : benchmark(graph, "single_thread", size).seconds;
+                        result.measured_fusion_speedup = unfused_seconds / result.seconds;
+                        std::cerr << "  measured speedup over single_thread " << result.measured_fusion_speedup << std::endl;
+                    }
+
+                    results.push_back(result);
+                }
+            }
+        }
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    std::string output = vm["output"].as<std::string>();
+    if (output.empty()) {
+        writeJson(std::cout, footprint, measurements, results);
+    } else {
+        std::ofstream out(output);
+        writeJson(out, footprint, measurements, results);
+    }
+
+    return 0;
+}
@@ -5,6 +5,7 @@
 #include <csapex/model/node.h>
 #include <csapex/msg/msg_fwd.h>
 #include <csapex/model/node_modifier.h>
+#include <csapex/model/variadic_io.h>
 #include <csapex/msg/generic_value_message.hpp>
 #include <csapex/msg/io.h>
 #include <csapex/model/token.h>
@@ -122,6 +123,21 @@ private:
     bool aborted;
 };
 
+class MockupVariadicSum : public Node, public VariadicInputs
+{
+public:
+    MockupVariadicSum();
+
+    void setup(NodeModifier& node_modifier) override;
+
+    void setupParameters(Parameterizable& parameters) override;
+
+    void process(NodeModifier& node_modifier, Parameterizable& parameters) override;
+
+private:
+    Output* out;
+};
+
 class AnySink : public Node
 {
 public:
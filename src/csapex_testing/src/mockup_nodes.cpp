@@ -90,6 +90,33 @@ void MockupSink::abort()
     aborted = true;
 }
 
+MockupVariadicSum::MockupVariadicSum() : VariadicBase(makeEmpty<connection_types::GenericValueMessage<int>>())
+{
+}
+
+void MockupVariadicSum::setup(NodeModifier& node_modifier)
+{
+    setupVariadic(node_modifier);
+
+    out = node_modifier.addOutput<int>("sum");
+}
+
+void MockupVariadicSum::setupParameters(Parameterizable& parameters)
+{
+    setupVariadicParameters(parameters);
+}
+
+void MockupVariadicSum::process(NodeModifier& node_modifier, Parameterizable& parameters)
+{
+    unsigned sum = 0;
+    for (const InputPtr& input : variadic_inputs_) {
+        if (msg::hasMessage(input.get())) {
+            sum += msg::getValue<int>(input.get());
+        }
+    }
+    msg::publish(out, static_cast<int>(sum));
+}
+
 AnySink::AnySink()
 {
 }
@@ -42,6 +42,8 @@ void SteppingTest::SetUp()
 
 void SteppingTest::TearDown()
 {
+    // a worker may still be signaling the end of the last step
+    executor.stop();
     executor.end_step.disconnectAll();
 
     NodeConstructingTest::TearDown();
@@ -0,0 +1,152 @@
+#ifndef INTERNED_STRING_H
+#define INTERNED_STRING_H
+
+/// PROJECT
+#include <csapex_util/export.h>
+
+/// SYSTEM
+#include <atomic>
+#include <string>
+#include <ostream>
+
+namespace csapex
+{
+/**
+ * @brief The InternedString class refers to a single shared copy of its value.
+ *        Copying an interned string copies a pointer and counts a reference, comparing only compares the pointers.
+ *        Only interning a value that is not in use allocates, a value is released with its last reference.
+ */
+class CSAPEX_UTILS_EXPORT InternedString
+{
+public:
+    struct CSAPEX_UTILS_EXPORT Hasher
+    {
+        std::size_t operator()(const InternedString& s) const;
+    };
+
+    // number of distinct values that are currently interned
+    static std::size_t count();
+
+public:
+    InternedString();
+    InternedString(const std::string& value);
+    InternedString(const char* value);
+    InternedString(const InternedString& other);
+    InternedString(InternedString&& other) noexcept;
+    ~InternedString();
+
+    InternedString& operator=(const InternedString& other);
+    InternedString& operator=(InternedString&& other) noexcept;
+    InternedString& operator=(const std::string& value);
+    InternedString& operator=(const char* value);
+
+    const std::string& str() const
+    {
+        return *entry_->value;
+    }
+    operator const std::string&() const
+    {
+        return *entry_->value;
+    }
+
+    const char* c_str() const
+    {
+        return entry_->value->c_str();
+    }
+    bool empty() const
+    {
+        return entry_->value->empty();
+    }
+    std::size_t size() const
+    {
+        return entry_->value->size();
+    }
+
+    bool operator==(const InternedString& other) const
+    {
+        return entry_ == other.entry_;
+    }
+    bool operator!=(const InternedString& other) const
+    {
+        return entry_ != other.entry_;
+    }
+    bool operator<(const InternedString& other) const
+    {
+        return str() < other.str();
+    }
+
+    friend bool operator==(const InternedString& a, const std::string& b)
+    {
+        return a.str() == b;
+    }
+    friend bool operator==(const std::string& a, const InternedString& b)
+    {
+        return a == b.str();
+    }
+    friend bool operator!=(const InternedString& a, const std::string& b)
+    {
+        return a.str() != b;
+    }
+    friend bool operator!=(const std::string& a, const InternedString& b)
+    {
+        return a != b.str();
+    }
+    friend bool operator==(const InternedString& a, const char* b)
+    {
+        return a.str() == b;
+    }
+    friend bool operator!=(const InternedString& a, const char* b)
+    {
+        return a.str() != b;
+    }
+    friend bool operator==(const char* a, const InternedString& b)
+    {
+        return a == b.str();
+    }
+    friend bool operator!=(const char* a, const InternedString& b)
+    {
+        return a != b.str();
+    }
+
+    friend std::string operator+(const InternedString& a, const std::string& b)
+    {
+        return a.str() + b;
+    }
+    friend std::string operator+(const std::string& a, const InternedString& b)
+    {
+        return a + b.str();
+    }
+    friend std::string operator+(const InternedString& a, const char* b)
+    {
+        return a.str() + b;
+    }
+    friend std::string operator+(const char* a, const InternedString& b)
+    {
+        return a + b.str();
+    }
+
+    friend std::ostream& operator<<(std::ostream& out, const InternedString& s)
+    {
+        return out << s.str();
+    }
+
+private:
+    struct Entry
+    {
+        const std::string* value = nullptr;
+        std::atomic<std::size_t> references{ 0 };
+    };
+    struct Table;
+
+    static Table& table();
+    static Entry* emptyEntry();
+    static Entry* intern(const std::string& value);
+    static void release(Entry* entry);
+
+private:
+    Entry* entry_;
+};
+
+}  // namespace csapex
+
+#endif  // INTERNED_STRING_H
@@ -0,0 +1,73 @@
+#ifndef LATEST_VALUE_SLOT_HPP
+#define LATEST_VALUE_SLOT_HPP
+
+/// SYSTEM
+#include <atomic>
+#include <utility>
+
+namespace csapex
+{
+/**
+ * @brief The LatestValueSlot class passes the latest of a stream of values from producers to a consumer.
+ *        Storing replaces a value that has not been taken yet. Both sides only exchange a pointer,
+ *        so neither of them can block the other. Every stored value is allocated once.
+ */
+template <typename T>
+class LatestValueSlot
+{
+public:
+    LatestValueSlot() : value_(nullptr)
+    {
+    }
+
+    ~LatestValueSlot()
+    {
+        delete value_.exchange(nullptr);
+    }
+
+    LatestValueSlot(const LatestValueSlot&) = delete;
+    LatestValueSlot& operator=(const LatestValueSlot&) = delete;
+
+    /**
+     * @brief store makes value the latest one
+     * @return true, iff a value that had not been taken yet was dropped
+     */
+    bool store(T value)
+    {
+        T* previous = value_.exchange(new T(std::move(value)), std::memory_order_acq_rel);
+        delete previous;
+        return previous != nullptr;
+    }
+
+    /**
+     * @brief take moves the latest value into value and empties the slot
+     * @return false, iff the slot was empty
+     */
+    bool take(T& value)
+    {
+        T* latest = value_.exchange(nullptr, std::memory_order_acq_rel);
+        if (!latest) {
+            return false;
+        }
+        value = std::move(*latest);
+        delete latest;
+        return true;
+    }
+
+    bool empty() const
+    {
+        return value_.load(std::memory_order_acquire) == nullptr;
+    }
+
+    void clear()
+    {
+        delete value_.exchange(nullptr, std::memory_order_acq_rel);
+    }
+
+private:
+    std::atomic<T*> value_;
+};
+
+}  // namespace csapex
+
+#endif  // LATEST_VALUE_SLOT_HPP
@@ -33,14 +33,14 @@ public:
 
     constexpr SemanticVersion() = default;
 
-    bool operator!=(const SemanticVersion& other);
-    bool operator==(const SemanticVersion& other);
+    bool operator!=(const SemanticVersion& other) const;
+    bool operator==(const SemanticVersion& other) const;
 
-    bool operator<(const SemanticVersion& other);
-    bool operator<=(const SemanticVersion& other);
+    bool operator<(const SemanticVersion& other) const;
+    bool operator<=(const SemanticVersion& other) const;
 
-    bool operator>(const SemanticVersion& other);
-    bool operator>=(const SemanticVersion& other);
+    bool operator>(const SemanticVersion& other) const;
+    bool operator>=(const SemanticVersion& other) const;
 
     bool valid() const;
     operator bool() const;
@@ -161,6 +161,12 @@ public:
     bool isConnected() const override;
     int countAllConnections() const override;
 
+    /**
+     * @brief hasReceivers checks if emitting calls anything, following chained signals.
+     *        Unlike isConnected, a chain of signals without any function at its end has no receivers.
+     */
+    bool hasReceivers() const;
+
     template <typename... Args>
     Signal& operator()(Args&&... args);
 
@@ -128,6 +128,18 @@ int Signal<Signature>::countAllConnections() const
     return functions_.size() + delegates_.size() + children_.size();
 }
 
+template <typename Signature>
+bool Signal<Signature>::hasReceivers() const
+{
+    std::unique_lock<std::recursive_mutex> lock(mutex_);
+    if (!functions_.empty() || !functions_to_add_.empty() || !delegates_.empty() || !delegates_to_add_.empty()) {
+        return true;
+    }
+
+    auto has_receivers = [](const Signal<Signature>* child) { return child->hasReceivers(); };
+    return std::any_of(children_.begin(), children_.end(), has_receivers) || std::any_of(children_to_add_.begin(), children_to_add_.end(), has_receivers);
+}
+
 template <typename Signature>
 void Signal<Signature>::removeParent(Signal<Signature>* parent)
 {
@@ -17,7 +17,10 @@ namespace csapex
 class Subprocess
 {
 public:
-    Subprocess(const std::string& name_space);
+    /**
+     * @param max_message_size size of the shared memory slots for data messages, the memory is only committed when used
+     */
+    Subprocess(const std::string& name_space, std::size_t max_message_size = 4 * 1024 * 1024);
     ~Subprocess();
 
     void handleSignal(int signal);
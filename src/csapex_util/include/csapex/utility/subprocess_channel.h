@@ -2,8 +2,13 @@
 #define SUBPROCESS_CHANNEL_H
 
 /// SYSTEM
+#include <atomic>
+#include <condition_variable>
+#include <functional>
 #include <mutex>
 #include <memory>
+#include <stdexcept>
+#include <string>
 #include <boost/interprocess/interprocess_fwd.hpp>
 
 /// FORWARD DECLARATIONS
@@ -11,9 +16,14 @@ namespace csapex
 {
 namespace impl
 {
-class ShmBlock;
+struct RingHeader;
 }
 
+/**
+ * @brief The SubprocessChannel class transfers messages from one process to another.
+ *        Messages are kept in a ring of fixed size slots in shared memory with a single producer and a single consumer.
+ *        Readers get a pointer into the slot, which stays valid until the Message handle is destroyed.
+ */
 class SubprocessChannel
 {
 public:
@@ -70,34 +80,54 @@ public:
         SubprocessChannel* parent = nullptr;
     };
 
+    typedef std::function<std::size_t(uint8_t* slot, std::size_t capacity)> SlotWriter;
+
 public:
-    SubprocessChannel(const std::string& name_space, bool is_control_channel = false, int32_t size = -1);
+    SubprocessChannel(const std::string& name_space, bool is_control_channel, std::size_t slot_size, std::size_t slot_count = 2);
 
     ~SubprocessChannel();
 
     Message read();
     void write(const Message& message);
+    /**
+     * @brief write lets writer serialize a message directly into the next free slot
+     * @param writer gets the slot memory and its capacity and returns the number of bytes used
+     */
+    void write(const MessageType type, const SlotWriter& writer);
     bool hasMessage() const;
 
+    std::size_t getSlotSize() const;
+    std::size_t getSlotCount() const;
+
     void shutdown();
 
 private:
     void allocate();
 
+    uint8_t* slot(uint64_t index) const;
+    void release();
+
+    template <typename Predicate>
+    void waitUntil(Predicate predicate) const;
+    void notify() const;
+
 private:
-    std::shared_ptr<boost::interprocess::managed_shared_memory> shm_segment;
+    std::shared_ptr<boost::interprocess::mapped_region> region_;
 
-    mutable std::recursive_mutex channel_mutex_;
+    std::mutex write_mutex_;
+    std::mutex read_mutex_;
+    std::condition_variable message_released_;
 
     std::string name_space_;
 
-    int32_t size_;
+    std::size_t slot_size_;
+    std::size_t slot_count_;
     bool is_control_channel_;
 
     bool is_locked_;
-    bool is_shutdown_;
+    std::atomic<bool> is_shutdown_;
 
-    impl::ShmBlock* shm_block_;
+    impl::RingHeader* header_;
 };
 
 }  // namespace csapex
@@ -24,6 +24,8 @@ class AUUID;
  *  - ID[0]    - the unique id of this instance
  *  - ID[1]    - the unique id of the parent id
  *  - ...
+ *
+ * The identifiers are interned, so that comparing two UUIDs compares pointers, and the hash is computed once.
  */
 class CSAPEX_UTILS_EXPORT UUID
 {
@@ -93,13 +95,21 @@ public:
     std::shared_ptr<UUIDProvider> getParent() const;
 
 private:
+    typedef const std::string* Part;
+
+    static Part intern(const std::string& part);
+
     explicit UUID(std::weak_ptr<UUIDProvider> parent, const std::string& representation);
-    explicit UUID(std::weak_ptr<UUIDProvider> parent, const std::vector<std::string>& representation);
+    explicit UUID(std::weak_ptr<UUIDProvider> parent, const std::vector<Part>& representation);
     explicit UUID(std::weak_ptr<UUIDProvider> parent, const UUID& representation);
 
+protected:
+    void updateHash();
+
 protected:
     std::weak_ptr<UUIDProvider> parent_;
-    std::vector<std::string> representation_;
+    std::vector<Part> representation_;
+    std::size_t hash_;
 };
 
 /**
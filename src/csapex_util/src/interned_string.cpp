@@ -0,0 +1,147 @@
+/// HEADER
+#include <csapex/utility/interned_string.h>
+
+/// SYSTEM
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+
+using namespace csapex;
+
+struct InternedString::Table
+{
+    std::shared_timed_mutex mutex;
+    // the entries point to their keys, which keep their address on rehashing
+    std::unordered_map<std::string, Entry> entries;
+};
+
+InternedString::Table& InternedString::table()
+{
+    // never destroyed: interned strings in static objects can outlive this translation unit during shutdown
+    static Table* table = new Table;
+    return *table;
+}
+
+InternedString::Entry* InternedString::emptyEntry()
+{
+    // the empty value is not counted, it is never released
+    static Entry* empty = []() {
+        Entry* entry = new Entry;
+        entry->value = new std::string;
+        return entry;
+    }();
+    return empty;
+}
+
+std::size_t InternedString::Hasher::operator()(const InternedString& s) const
+{
+    return std::hash<const Entry*>()(s.entry_);
+}
+
+std::size_t InternedString::count()
+{
+    Table& t = table();
+    std::shared_lock<std::shared_timed_mutex> lock(t.mutex);
+    return t.entries.size();
+}
+
+InternedString::Entry* InternedString::intern(const std::string& value)
+{
+    if (value.empty()) {
+        return emptyEntry();
+    }
+
+    Table& t = table();
+
+    // most values are in use already, they only need a shared lock
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(t.mutex);
+        auto pos = t.entries.find(value);
+        if (pos != t.entries.end()) {
+            pos->second.references.fetch_add(1, std::memory_order_relaxed);
+            return &pos->second;
+        }
+    }
+
+    std::unique_lock<std::shared_timed_mutex> lock(t.mutex);
+    auto pos = t.entries.try_emplace(value).first;
+    pos->second.value = &pos->first;
+    pos->second.references.fetch_add(1, std::memory_order_relaxed);
+    return &pos->second;
+}
+
+void InternedString::release(Entry* entry)
+{
+    if (entry == emptyEntry()) {
+        return;
+    }
+
+    std::size_t references = entry->references.load(std::memory_order_relaxed);
+    while (references > 1) {
+        if (entry->references.compare_exchange_weak(references, references - 1, std::memory_order_acq_rel)) {
+            return;
+        }
+    }
+
+    // this might be the last reference, no lookup may find the entry while it is removed
+    Table& t = table();
+    std::unique_lock<std::shared_timed_mutex> lock(t.mutex);
+    if (entry->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        t.entries.erase(t.entries.find(*entry->value));
+    }
+}
+
+InternedString::InternedString() : entry_(emptyEntry())
+{
+}
+
+InternedString::InternedString(const std::string& value) : entry_(intern(value))
+{
+}
+
+InternedString::InternedString(const char* value) : entry_(intern(value))
+{
+}
+
+InternedString::InternedString(const InternedString& other) : entry_(other.entry_)
+{
+    if (entry_ != emptyEntry()) {
+        entry_->references.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+InternedString::InternedString(InternedString&& other) noexcept : entry_(other.entry_)
+{
+    other.entry_ = emptyEntry();
+}
+
+InternedString::~InternedString()
+{
+    release(entry_);
+}
+
+InternedString& InternedString::operator=(const InternedString& other)
+{
+    InternedString copy(other);
+    std::swap(entry_, copy.entry_);
+    return *this;
+}
+
+InternedString& InternedString::operator=(InternedString&& other) noexcept
+{
+    std::swap(entry_, other.entry_);
+    return *this;
+}
+
+InternedString& InternedString::operator=(const std::string& value)
+{
+    InternedString interned(value);
+    std::swap(entry_, interned.entry_);
+    return *this;
+}
+
+InternedString& InternedString::operator=(const char* value)
+{
+    return *this = std::string(value);
+}
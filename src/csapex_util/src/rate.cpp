@@ -8,7 +8,7 @@ using namespace csapex;
 
 Rate::Rate(double frequency, bool immediate) : frequency_(frequency), immediate_(immediate)
 {
-    last_scheduled_tick_ = std::chrono::system_clock::now();
+    last_scheduled_tick_ = std::chrono::steady_clock::now();
 }
 
 Rate::Rate() : Rate(-1, 0)
@@ -54,14 +54,19 @@ void Rate::setImmediate(bool immediate)
     immediate_ = immediate;
 }
 
+std::chrono::steady_clock::duration Rate::interval() const
+{
+    // millisecond truncation would run e.g. 30 Hz at 33 ms instead of 33.3 ms
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / frequency_));
+}
+
 void Rate::keepUp()
 {
-    std::chrono::milliseconds interval(int(1000.0 / frequency_));
-    auto end_of_cycle = last_scheduled_tick_ + interval;
+    auto end_of_cycle = last_scheduled_tick_ + interval();
 
     last_scheduled_tick_ = end_of_cycle;
 
-    auto now = std::chrono::system_clock::now();
+    auto now = std::chrono::steady_clock::now();
     if (end_of_cycle > now) {
         std::this_thread::sleep_until(end_of_cycle);
     }
@@ -69,19 +74,17 @@ void Rate::keepUp()
 
 void Rate::startCycle()
 {
-    last_tick_ = std::chrono::system_clock::now();
+    last_tick_ = std::chrono::steady_clock::now();
 }
 
-std::chrono::system_clock::time_point Rate::endOfCycle() const
+std::chrono::steady_clock::time_point Rate::endOfCycle() const
 {
-    std::chrono::milliseconds interval(int(1000.0 / frequency_));
-
-    return last_tick_ + interval;
+    return last_tick_ + interval();
 }
 
 void Rate::tick()
 {
-    auto now = std::chrono::system_clock::now();
+    auto now = std::chrono::steady_clock::now();
     real_ticks_.emplace_back(now);
 
     const std::size_t N = 4;
@@ -27,9 +27,9 @@ void sp_signal_handler(int signal)
 }
 }  // namespace detail
 
-Subprocess::Subprocess(const std::string& name_space)
-  : in(name_space + "_in", false, 65536)
-  , out(name_space + "_out", false, 65536)
+Subprocess::Subprocess(const std::string& name_space, std::size_t max_message_size)
+  : in(name_space + "_in", false, max_message_size)
+  , out(name_space + "_out", false, max_message_size)
   , ctrl_in(name_space + "_ctrl", true, 1024)
   , ctrl_out(name_space + "_ctrl", true, 1024)
   , pid_(-1)
@@ -6,34 +6,58 @@
 
 /// SYSTEM
 #include <iostream>
-#include <boost/optional.hpp>
-#include <boost/interprocess/managed_shared_memory.hpp>
-#include <boost/interprocess/containers/string.hpp>
+#include <sstream>
+#include <thread>
+#include <cstring>
+#include <unistd.h>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 #include <boost/interprocess/sync/interprocess_mutex.hpp>
 #include <boost/interprocess/sync/interprocess_condition.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
 
 using namespace csapex;
 using namespace boost::interprocess;
 
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "the shared memory ring requires lock free 64 bit atomics");
+
 namespace csapex
 {
 namespace impl
 {
-template <typename T>
-using ShmAllocator = boost::interprocess::allocator<T, boost::interprocess::managed_shared_memory::segment_manager>;
+namespace
+{
+// keep header and slots on separate cache lines
+const std::size_t ALIGNMENT = 64;
 
-using shared_buffer = typename boost::interprocess::basic_string<uint8_t, std::char_traits<uint8_t>, ShmAllocator<uint8_t>>;
+std::size_t align(std::size_t bytes)
+{
+    return (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+// spin this many times before a side goes to sleep
+const int SPIN_COUNT = 64;
+}  // namespace
+
+struct SlotHeader
+{
+    SubprocessChannel::MessageType message_type;
+    uint64_t length;
+};
 
-struct ShmBlock
+struct RingHeader
 {
+    // only used to sleep, the ring itself is lock free
     boost::interprocess::interprocess_mutex m;
-    boost::interprocess::interprocess_condition message_available;
-    boost::interprocess::interprocess_condition message_read;
+    boost::interprocess::interprocess_condition changed;
 
-    SubprocessChannel::MessageType message_type = SubprocessChannel::MessageType::NONE;
+    // next slot to read, only written by the consumer
+    std::atomic<uint64_t> head{ 0 };
+    // next slot to write, only written by the producer
+    std::atomic<uint64_t> tail{ 0 };
 
-    bool is_full = false;
-    bool active = true;
+    std::atomic<uint32_t> sleepers{ 0 };
+    std::atomic<bool> active{ true };
 };
 
 }  // namespace impl
@@ -72,24 +96,13 @@ SubprocessChannel::Message& SubprocessChannel::Message::operator=(SubprocessChan
 SubprocessChannel::Message::~Message()
 {
     if (parent) {
-        scoped_lock<interprocess_mutex> lock(parent->shm_block_->m);
-
-        parent->shm_segment->destroy<impl::shared_buffer>("data");
-        parent->shm_block_->is_full = false;
-        parent->is_locked_ = false;
-        parent->shm_block_->message_read.notify_all();
+        parent->release();
     }
 }
 
 std::string SubprocessChannel::Message::toString() const
 {
-    std::stringstream ss;
-    const uint8_t* ptr = data;
-    for (std::size_t i = 0; i < length; ++i, ++ptr) {
-        ss << *ptr;
-    }
-
-    return ss.str();
+    return std::string(reinterpret_cast<const char*>(data), length);
 }
 
 SubprocessChannel::Message::Message(SubprocessChannel* parent) : parent(parent)
@@ -98,9 +111,15 @@ SubprocessChannel::Message::Message(SubprocessChannel* parent) : parent(parent)
 
 // SubprocesChannel
 
-SubprocessChannel::SubprocessChannel(const std::string& name_space, bool is_control_channel, int32_t size)
-  : name_space_(std::to_string(getpid()) + "_" + name_space), size_(size), is_control_channel_(is_control_channel), is_locked_(false), is_shutdown_(false)
+SubprocessChannel::SubprocessChannel(const std::string& name_space, bool is_control_channel, std::size_t slot_size, std::size_t slot_count)
+  : name_space_(std::to_string(getpid()) + "_" + name_space)
+  , slot_size_(slot_size)
+  , slot_count_(slot_count)
+  , is_control_channel_(is_control_channel)
+  , is_locked_(false)
+  , is_shutdown_(false)
 {
+    apex_assert_hard(slot_count_ > 0);
     allocate();
 }
 
@@ -111,111 +130,170 @@ SubprocessChannel::~SubprocessChannel()
 
 void SubprocessChannel::allocate()
 {
+    std::size_t total_size = impl::align(sizeof(impl::RingHeader)) + slot_count_ * impl::align(sizeof(impl::SlotHeader) + slot_size_);
+
+    std::unique_ptr<shared_memory_object> shm;
     try {
-        //        std::cout << "try to create shared memory object " << getUUID() << std::endl;
-        shm_segment.reset(new managed_shared_memory(create_only, name_space_.c_str(), size_));
+        shm.reset(new shared_memory_object(create_only, name_space_.c_str(), read_write));
 
     } catch (const boost::interprocess::interprocess_exception& e) {
-        //        std::cout << "could not create shared memory object: " << e.what() << std::endl;
-        //        std::cout << "removing shared memory object " << getUUID() << std::endl;
+        // left over from a previous process with the same pid
         shared_memory_object::remove(name_space_.c_str());
-        shm_segment.reset(new managed_shared_memory(create_only, name_space_.c_str(), size_));
+        shm.reset(new shared_memory_object(create_only, name_space_.c_str(), read_write));
     }
+    shm->truncate(total_size);
+
+    // the mapping is shared with the child after fork
+    region_.reset(new mapped_region(*shm, read_write));
 
-    // Create a managed shared memory segment
-    shm_block_ = shm_segment->construct<impl::ShmBlock>("shm")();
+    header_ = new (region_->get_address()) impl::RingHeader;
 }
 
-bool SubprocessChannel::hasMessage() const
+uint8_t* SubprocessChannel::slot(uint64_t index) const
 {
-    std::unique_lock<std::recursive_mutex> channel_lock(channel_mutex_);
+    uint8_t* base = static_cast<uint8_t*>(region_->get_address()) + impl::align(sizeof(impl::RingHeader));
+    return base + (index % slot_count_) * impl::align(sizeof(impl::SlotHeader) + slot_size_);
+}
 
-    scoped_lock<interprocess_mutex> lock(shm_block_->m);
+std::size_t SubprocessChannel::getSlotSize() const
+{
+    return slot_size_;
+}
 
-    return shm_block_->is_full;
+std::size_t SubprocessChannel::getSlotCount() const
+{
+    return slot_count_;
 }
 
-SubprocessChannel::Message SubprocessChannel::read()
+template <typename Predicate>
+void SubprocessChannel::waitUntil(Predicate predicate) const
 {
-    std::unique_lock<std::recursive_mutex> channel_lock(channel_mutex_);
+    for (int i = 0; i < impl::SPIN_COUNT; ++i) {
+        if (predicate()) {
+            return;
+        }
+        std::this_thread::yield();
+    }
 
-    scoped_lock<interprocess_mutex> lock(shm_block_->m);
+    scoped_lock<interprocess_mutex> lock(header_->m);
+    ++header_->sleepers;
+    while (!predicate()) {
+        header_->changed.wait(lock);
+    }
+    --header_->sleepers;
+}
 
-    if (!shm_block_->active) {
-        throw ShutdownException();
+void SubprocessChannel::notify() const
+{
+    // the other side checks its condition after announcing that it sleeps, so this cannot miss it
+    if (header_->sleepers > 0) {
+        scoped_lock<interprocess_mutex> lock(header_->m);
+        header_->changed.notify_all();
     }
+}
 
-    if (is_shutdown_) {
+bool SubprocessChannel::hasMessage() const
+{
+    return header_->head != header_->tail;
+}
+
+SubprocessChannel::Message SubprocessChannel::read()
+{
+    std::unique_lock<std::mutex> lock(read_mutex_);
+
+    if (!header_->active || is_shutdown_) {
         throw ShutdownException();
     }
 
-    while (is_locked_) {
-        shm_block_->message_read.wait(lock);
-    }
+    // only one message can be read at a time, the next one is available after the handle is destroyed
+    message_released_.wait(lock, [this]() { return !is_locked_ || is_shutdown_; });
 
-    while (!shm_block_->is_full) {
-        shm_block_->message_available.wait(lock);
+    waitUntil([this]() { return hasMessage() || !header_->active || is_shutdown_; });
 
-        if (is_shutdown_) {
-            throw ShutdownException();
-        }
+    if (is_shutdown_ || !hasMessage()) {
+        throw ShutdownException();
     }
 
+    uint8_t* memory = slot(header_->head);
+    const impl::SlotHeader* slot_header = reinterpret_cast<const impl::SlotHeader*>(memory);
+
     if (!is_control_channel_) {
-        if (shm_block_->message_type == MessageType::SHUTDOWN) {
+        if (slot_header->message_type == MessageType::SHUTDOWN) {
             throw ShutdownException();
         }
     }
 
-    std::pair<impl::shared_buffer*, managed_shared_memory::size_type> input = shm_segment->find<impl::shared_buffer>("data");
-
     Message result(this);
     is_locked_ = true;
 
-    if (input.first) {
-        result.type = shm_block_->message_type;
-        result.data = input.first->c_str();
-        result.length = input.first->size();
-    }
+    result.type = slot_header->message_type;
+    result.data = memory + sizeof(impl::SlotHeader);
+    result.length = slot_header->length;
 
     return result;
 }
 
-void SubprocessChannel::write(const Message& message)
+void SubprocessChannel::release()
 {
-    std::unique_lock<std::recursive_mutex> channel_lock(channel_mutex_);
+    {
+        std::unique_lock<std::mutex> lock(read_mutex_);
+        ++header_->head;
+        is_locked_ = false;
+    }
+    message_released_.notify_all();
+
+    notify();
+}
 
-    const impl::ShmAllocator<int> alloc_inst(shm_segment->get_segment_manager());
+void SubprocessChannel::write(const Message& message)
+{
+    write(message.type, [&message](uint8_t* slot, std::size_t capacity) {
+        if (message.length > capacity) {
+            throw std::runtime_error("message of " + std::to_string(message.length) + " bytes does not fit into a slot of " + std::to_string(capacity) + " bytes");
+        }
+        if (message.length > 0) {
+            std::memcpy(slot, message.data, message.length);
+        }
+        return message.length;
+    });
+}
 
-    scoped_lock<interprocess_mutex> lock(shm_block_->m);
+void SubprocessChannel::write(const MessageType type, const SlotWriter& writer)
+{
+    std::unique_lock<std::mutex> lock(write_mutex_);
 
     if (is_shutdown_) {
         return;
     }
 
-    while (shm_block_->is_full) {
-        shm_block_->message_read.wait(lock);
+    const uint64_t tail = header_->tail;
+    waitUntil([this, tail]() { return tail - header_->head < slot_count_ || !header_->active || is_shutdown_; });
 
-        if (is_shutdown_) {
-            return;
-        }
+    if (is_shutdown_ || tail - header_->head >= slot_count_) {
+        return;
     }
 
-    apex_assert_hard(!is_locked_);
+    uint8_t* memory = slot(tail);
+    impl::SlotHeader* slot_header = reinterpret_cast<impl::SlotHeader*>(memory);
+
+    std::size_t length = writer(memory + sizeof(impl::SlotHeader), slot_size_);
+    apex_assert_hard(length <= slot_size_);
 
-    shm_segment->construct<impl::shared_buffer>("data")(message.data, message.length, alloc_inst);
+    slot_header->message_type = type;
+    slot_header->length = length;
 
-    shm_block_->message_type = message.type;
-    shm_block_->is_full = true;
+    // publish the slot
+    header_->tail = tail + 1;
 
-    shm_block_->message_available.notify_all();
+    notify();
 }
 
 void SubprocessChannel::shutdown()
 {
     is_shutdown_ = true;
+    message_released_.notify_all();
 
-    scoped_lock<interprocess_mutex> lock(shm_block_->m);
-    shm_block_->active = false;
-    shm_block_->message_available.notify_all();
+    scoped_lock<interprocess_mutex> lock(header_->m);
+    header_->active = false;
+    header_->changed.notify_all();
 }
@@ -10,11 +10,28 @@
 #include <iostream>
 #include <boost/functional/hash.hpp>
 #include <ostream>
-#include <sstream>
 #include <algorithm>
+#include <mutex>
+#include <unordered_set>
 
 using namespace csapex;
 
+namespace
+{
+std::mutex& internMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::unordered_set<std::string>& internTable()
+{
+    // never destroyed: UUIDs in static objects can outlive this translation unit during shutdown
+    static std::unordered_set<std::string>* table = new std::unordered_set<std::string>;
+    return *table;
+}
+}  // namespace
+
 const std::string UUID::namespace_separator = ":|:";
 UUID UUID::NONE;
 AUUID AUUID::NONE;
@@ -39,13 +56,13 @@ bool UUID::global() const
         return false;
     }
 
-    return representation_.back().at(0) == ':';
+    return representation_.back()->at(0) == ':';
 }
 
 std::string UUID::globalName() const
 {
     apex_assert_hard(global());
-    return representation_.back().substr(1);
+    return representation_.back()->substr(1);
 }
 
 std::string UUID::stripNamespace(const std::string& name)
@@ -54,11 +71,18 @@ std::string UUID::stripNamespace(const std::string& name)
     return name.substr(from != name.npos ? from + 2 : 0);
 }
 
-UUID::UUID()
+UUID::Part UUID::intern(const std::string& part)
+{
+    // elements of an unordered_set keep their address on rehashing
+    std::unique_lock<std::mutex> lock(internMutex());
+    return &*internTable().insert(part).first;
+}
+
+UUID::UUID() : hash_(0)
 {
 }
 
-UUID::UUID(const UUID& other) : parent_(other.parent_), representation_(other.representation_)
+UUID::UUID(const UUID& other) : parent_(other.parent_), representation_(other.representation_), hash_(other.hash_)
 {
 }
 
@@ -70,6 +94,7 @@ UUID& UUID::operator=(const UUID& other)
 {
     parent_ = other.parent_;
     representation_ = other.representation_;
+    hash_ = other.hash_;
     return *this;
 }
 
@@ -77,12 +102,13 @@ UUID::UUID(std::weak_ptr<UUIDProvider> parent, const UUID& copy) : UUID(parent,
 {
 }
 
-UUID::UUID(std::weak_ptr<UUIDProvider> parent, const std::vector<std::string>& representation) : parent_(parent), representation_(representation)
+UUID::UUID(std::weak_ptr<UUIDProvider> parent, const std::vector<Part>& representation) : parent_(parent), representation_(representation)
 {
-    apex_assert_hard(representation_.empty() || representation_.back() != "~");
+    apex_assert_hard(representation_.empty() || *representation_.back() != "~");
+    updateHash();
 }
 
-UUID::UUID(std::weak_ptr<UUIDProvider> parent, const std::string& representation) : parent_(parent)
+UUID::UUID(std::weak_ptr<UUIDProvider> parent, const std::string& representation) : parent_(parent), hash_(0)
 {
     /**
      *  UUIDs are built like this:
@@ -115,15 +141,24 @@ UUID::UUID(std::weak_ptr<UUIDProvider> parent, const std::string& representation
         std::string sub_id = representation.substr(begin, end - begin);
 
         if (sub_id != "~") {
-            representation_.push_back(sub_id);
+            representation_.push_back(intern(sub_id));
         }
         end = pos;
 
         if (begin == 0) {
-            return;
+            break;
         }
     }
-    apex_assert_hard(representation_.empty() || representation_.back() != "~");
+    apex_assert_hard(representation_.empty() || *representation_.back() != "~");
+    updateHash();
+}
+
+void UUID::updateHash()
+{
+    hash_ = 0;
+    for (Part part : representation_) {
+        boost::hash_combine(hash_, boost::hash<std::string>()(*part));
+    }
 }
 
 void UUID::free()
@@ -135,7 +170,9 @@ void UUID::free()
 
 bool UUID::operator<(const UUID& other) const
 {
-    return representation_ < other.representation_;
+    // order by the names of the parts, so that the order is the same in every process
+    return std::lexicographical_compare(representation_.begin(), representation_.end(), other.representation_.begin(), other.representation_.end(),
+                                        [](Part a, Part b) { return a != b && *a < *b; });
 }
 
 std::string UUID::getFullName() const
@@ -144,28 +181,30 @@ std::string UUID::getFullName() const
         return "~";
     }
 
-    std::stringstream ss;
+    std::size_t length = (representation_.size() - 1) * namespace_separator.size();
+    for (Part part : representation_) {
+        length += part->size();
+    }
+
+    std::string name;
+    name.reserve(length);
     auto it = representation_.rbegin();
-    ss << *it;
+    name += **it;
     for (++it; it != representation_.rend(); ++it) {
-        ss << namespace_separator;
-        ss << *it;
+        name += namespace_separator;
+        name += **it;
     }
-    return ss.str();
+    return name;
 }
 
 std::size_t UUID::hash() const
 {
-    if (empty()) {
-        return 0;
-    } else {
-        return boost::hash<std::string>()(representation_.front());
-    }
+    return hash_;
 }
 
 std::string UUID::getShortName() const
 {
-    return stripNamespace(representation_.front());
+    return stripNamespace(*representation_.front());
 }
 
 bool UUID::composite() const
@@ -175,8 +214,8 @@ bool UUID::composite() const
 
 bool UUID::contains(const std::string& sub) const
 {
-    for (const std::string& s : representation_) {
-        if (s == sub) {
+    for (Part s : representation_) {
+        if (*s == sub) {
             return true;
         }
     }
@@ -188,6 +227,7 @@ UUID UUID::parentUUID() const
     UUID parent = *this;
     if (!representation_.empty()) {
         parent.representation_.erase(parent.representation_.begin());
+        parent.updateHash();
     }
 
     return parent;
@@ -200,9 +240,9 @@ UUID UUID::nestedUUID() const
 UUID UUID::rootUUID() const
 {
     if (auto parent = parent_.lock()) {
-        return UUID(parent, representation_.back());
+        return UUID(parent, std::vector<Part>{ representation_.back() });
     } else {
-        return UUID(std::weak_ptr<UUIDProvider>(), representation_.back());
+        return UUID(std::weak_ptr<UUIDProvider>(), std::vector<Part>{ representation_.back() });
     }
 }
 
@@ -211,11 +251,11 @@ UUID UUID::reshape(std::size_t _depth) const
     if (_depth > depth()) {
         throw std::invalid_argument("cannot reshape UUID to a larger size");
     }
-    return UUID(parent_, std::vector<std::string>(representation_.begin(), representation_.begin() + static_cast<long>(_depth)));
+    return UUID(parent_, std::vector<Part>(representation_.begin(), representation_.begin() + static_cast<long>(_depth)));
 }
 UUID UUID::reshapeSoft(std::size_t max_depth) const
 {
-    return UUID(parent_, std::vector<std::string>(representation_.begin(), representation_.begin() + static_cast<long>(std::min(depth(), max_depth))));
+    return UUID(parent_, std::vector<Part>(representation_.begin(), representation_.begin() + static_cast<long>(std::min(depth(), max_depth))));
 }
 
 UUID UUID::makeRelativeTo(const UUID& prefix) const
@@ -227,7 +267,7 @@ UUID UUID::makeRelativeTo(const UUID& prefix) const
         ++this_it;
     }
 
-    auto reversed = std::vector<std::string>(this_it, representation_.rend());
+    auto reversed = std::vector<Part>(this_it, representation_.rend());
     std::reverse(reversed.begin(), reversed.end());
     return UUID(parent_, reversed);
 }
@@ -240,13 +280,13 @@ UUID UUID::id() const
 std::string UUID::type() const
 {
     apex_assert_hard(!representation_.empty());
-    std::string t = representation_.front();
+    const std::string& t = *representation_.front();
     return t.substr(0, t.find("_"));
 }
 std::string UUID::name() const
 {
     apex_assert_hard(!representation_.empty());
-    std::string t = representation_.front();
+    const std::string& t = *representation_.front();
     return t.substr(t.find("_") + 1);
 }
 
@@ -255,9 +295,8 @@ AUUID UUID::getAbsoluteUUID() const
     if (auto parent = parent_.lock()) {
         UUID parent_uuid = parent->getAbsoluteUUID();
         UUID uuid = *this;
-        for (const std::string& part : parent_uuid.representation_) {
-            uuid.representation_.push_back(part);
-        }
+        uuid.representation_.insert(uuid.representation_.end(), parent_uuid.representation_.begin(), parent_uuid.representation_.end());
+        uuid.updateHash();
         return AUUID(uuid);
     } else {
         return AUUID(*this);
@@ -286,7 +325,7 @@ bool operator==(const UUID& uuid_, const std::string& str)
 }
 bool operator==(const UUID& a, const UUID& b)
 {
-    if (a.representation_.size() != b.representation_.size()) {
+    if (a.hash_ != b.hash_ || a.representation_.size() != b.representation_.size()) {
         return false;
     }
 
@@ -334,6 +373,7 @@ AUUID AUUID::parentAUUID() const
     AUUID parent = *this;
     if (!representation_.empty()) {
         parent.representation_.erase(parent.representation_.begin());
+        parent.updateHash();
     }
 
     return parent;
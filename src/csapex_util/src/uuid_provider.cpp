@@ -80,9 +80,8 @@ UUID UUIDProvider::generateUUID(const std::string& prefix)
 UUID UUIDProvider::makeDerivedUUID(const UUID& parent, const UUID& child)
 {
     UUID result = child;
-    for (const std::string& level : parent.representation_) {
-        result.representation_.push_back(level);
-    }
+    result.representation_.insert(result.representation_.end(), parent.representation_.begin(), parent.representation_.end());
+    result.updateHash();
     registerUUID(result);
     return result;
 }
@@ -90,9 +89,8 @@ UUID UUIDProvider::makeDerivedUUID(const UUID& parent, const UUID& child)
 UUID UUIDProvider::makeDerivedUUID_forced(const UUID& parent, const UUID& child)
 {
     UUID result = child;
-    for (const std::string& level : parent.representation_) {
-        result.representation_.push_back(level);
-    }
+    result.representation_.insert(result.representation_.end(), parent.representation_.begin(), parent.representation_.end());
+    result.updateHash();
     return result;
 }
 
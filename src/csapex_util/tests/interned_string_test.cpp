@@ -0,0 +1,118 @@
+#include "gtest/gtest.h"
+
+#include <csapex/utility/interned_string.h>
+
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace csapex;
+
+class InternedStringTest : public ::testing::Test
+{
+};
+
+TEST_F(InternedStringTest, EqualValuesShareTheirStorage)
+{
+    InternedString a("base_link");
+    InternedString b(std::string("base") + "_link");
+    InternedString c("odom");
+
+    ASSERT_EQ(a, b);
+    ASSERT_EQ(a.c_str(), b.c_str());
+    ASSERT_NE(a, c);
+    ASSERT_NE(a.c_str(), c.c_str());
+}
+
+TEST_F(InternedStringTest, InternedStringsBehaveLikeStrings)
+{
+    InternedString frame;
+    ASSERT_TRUE(frame.empty());
+    ASSERT_EQ(InternedString(""), frame);
+
+    frame = "map";
+    ASSERT_EQ("map", frame);
+    ASSERT_EQ(std::string("map"), frame);
+    ASSERT_EQ(frame, std::string("map"));
+    ASSERT_EQ(3, frame.size());
+    ASSERT_EQ("/map", "/" + frame);
+
+    std::string copy = frame;
+    ASSERT_EQ("map", copy);
+
+    std::stringstream ss;
+    ss << frame;
+    ASSERT_EQ("map", ss.str());
+}
+
+TEST_F(InternedStringTest, InterningIsThreadSafe)
+{
+    std::vector<std::thread> threads;
+    std::vector<InternedString> results(8);
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        threads.emplace_back([i, &results]() {
+            for (int j = 0; j < 1000; ++j) {
+                InternedString("frame_" + std::to_string(j));
+            }
+            results[i] = InternedString("frame_42");
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    for (const InternedString& result : results) {
+        ASSERT_EQ(results.front(), result);
+        ASSERT_EQ(results.front().c_str(), result.c_str());
+    }
+}
+
+TEST_F(InternedStringTest, ValuesAreReleasedWithTheirLastReference)
+{
+    std::size_t before = InternedString::count();
+    {
+        InternedString a("released_frame");
+        InternedString b = a;
+        InternedString c(std::move(b));
+        ASSERT_EQ(before + 1, InternedString::count());
+        ASSERT_TRUE(b.empty());
+
+        a = "other_frame";
+        ASSERT_EQ(before + 2, InternedString::count());
+        ASSERT_EQ("released_frame", c);
+    }
+    ASSERT_EQ(before, InternedString::count());
+
+    // frame ids that are only used for a while do not accumulate
+    for (int i = 0; i < 1000; ++i) {
+        InternedString frame("frame_" + std::to_string(i));
+    }
+    ASSERT_EQ(before, InternedString::count());
+}
+
+TEST_F(InternedStringTest, ReleasingIsThreadSafe)
+{
+    InternedString kept("kept_frame");
+    std::size_t before = InternedString::count();
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([&kept]() {
+            for (int j = 0; j < 10000; ++j) {
+                InternedString a("shared_frame");
+                InternedString b = a;
+                InternedString c("kept_frame");
+                if (c != kept || a != b) {
+                    throw std::logic_error("interned values differ");
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(before, InternedString::count());
+    ASSERT_EQ("kept_frame", kept);
+}
@@ -0,0 +1,107 @@
+#include "gtest/gtest.h"
+
+#include <csapex/utility/latest_value_slot.hpp>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace csapex;
+
+class LatestValueSlotTest : public ::testing::Test
+{
+};
+
+TEST_F(LatestValueSlotTest, OnlyTheLatestValueIsTaken)
+{
+    LatestValueSlot<int> slot;
+    ASSERT_TRUE(slot.empty());
+
+    int value = 0;
+    ASSERT_FALSE(slot.take(value));
+
+    ASSERT_FALSE(slot.store(1));
+    ASSERT_TRUE(slot.store(2));
+    ASSERT_FALSE(slot.empty());
+
+    ASSERT_TRUE(slot.take(value));
+    ASSERT_EQ(2, value);
+    ASSERT_TRUE(slot.empty());
+    ASSERT_FALSE(slot.take(value));
+}
+
+TEST_F(LatestValueSlotTest, DroppedValuesAreReleased)
+{
+    std::weak_ptr<int> dropped;
+    std::weak_ptr<int> cleared;
+    {
+        LatestValueSlot<std::shared_ptr<const int>> slot;
+
+        auto first = std::make_shared<int>(1);
+        dropped = first;
+        slot.store(first);
+        first.reset();
+        ASSERT_FALSE(dropped.expired());
+
+        auto second = std::make_shared<int>(2);
+        cleared = second;
+        slot.store(second);
+        second.reset();
+        ASSERT_TRUE(dropped.expired());
+
+        slot.clear();
+        ASSERT_TRUE(cleared.expired());
+
+        slot.store(std::make_shared<int>(3));
+    }
+}
+
+TEST_F(LatestValueSlotTest, ValuesArePassedBetweenThreads)
+{
+    LatestValueSlot<std::shared_ptr<const int>> slot;
+
+    const int producers = 4;
+    const int values = 10000;
+
+    std::atomic<bool> done(false);
+    std::atomic<int> taken(0);
+    std::vector<int> last_taken(producers, -1);
+
+    // every value is encoded as value * producers + producer, so the values of a producer have to increase
+    std::thread consumer([&]() {
+        auto take = [&]() {
+            std::shared_ptr<const int> value;
+            while (slot.take(value)) {
+                int producer = *value % producers;
+                int index = *value / producers;
+                ASSERT_GT(index, last_taken[producer]);
+                last_taken[producer] = index;
+                ++taken;
+            }
+        };
+        while (!done) {
+            take();
+            std::this_thread::yield();
+        }
+        take();
+    });
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&slot, p]() {
+            for (int i = 0; i < values; ++i) {
+                slot.store(std::make_shared<const int>(i * producers + p));
+            }
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    done = true;
+    consumer.join();
+
+    ASSERT_TRUE(slot.empty());
+    ASSERT_GT(taken, 0);
+    ASSERT_LE(taken, producers * values);
+}
@@ -2,7 +2,10 @@
 
 #include <csapex/utility/subprocess.h>
 
+#include <chrono>
 #include <cstdlib>
+#include <cstring>
+#include <future>
 #include <thread>
 #include <condition_variable>
 
@@ -376,3 +379,76 @@ TEST_F(SharedMemoryTest, MessageHandleActsAsRAII)
 
     ASSERT_EQ(SubprocessChannel::MessageType::PROCESS_SYNC, sp.out.read().type);
 }
+
+TEST_F(SharedMemoryTest, WriterRunsAheadUntilAllSlotsAreUsed)
+{
+    SubprocessChannel channel("test_ring", false, 64, 2);
+
+    channel.write({ SubprocessChannel::MessageType::PARAMETER_UPDATE, "1" });
+    channel.write({ SubprocessChannel::MessageType::PARAMETER_UPDATE, "2" });
+
+    std::future<void> third = std::async(std::launch::async, [&channel]() { channel.write({ SubprocessChannel::MessageType::PROCESS_SYNC, "3" }); });
+    ASSERT_EQ(std::future_status::timeout, third.wait_for(std::chrono::milliseconds(20)));
+
+    ASSERT_EQ("1", channel.read().toString());
+    ASSERT_EQ(std::future_status::ready, third.wait_for(std::chrono::seconds(1)));
+
+    ASSERT_EQ("2", channel.read().toString());
+    auto msg = channel.read();
+    ASSERT_EQ(SubprocessChannel::MessageType::PROCESS_SYNC, msg.type);
+    ASSERT_EQ("3", msg.toString());
+}
+
+TEST_F(SharedMemoryTest, WriterSerializesDirectlyIntoTheSlot)
+{
+    SubprocessChannel channel("test_ring", false, 64, 2);
+
+    channel.write(SubprocessChannel::MessageType::PARAMETER_UPDATE, [](uint8_t* slot, std::size_t capacity) {
+        EXPECT_EQ(64, capacity);
+        std::memcpy(slot, "in place", 8);
+        return 8;
+    });
+
+    ASSERT_EQ("in place", channel.read().toString());
+}
+
+TEST_F(SharedMemoryTest, MessagesLargerThanASlotAreRejected)
+{
+    SubprocessChannel channel("test_ring", false, 64, 2);
+
+    std::string too_large(65, 'x');
+    ASSERT_THROW(channel.write({ SubprocessChannel::MessageType::PARAMETER_UPDATE, too_large }), std::runtime_error);
+    ASSERT_FALSE(channel.hasMessage());
+}
+
+TEST_F(SharedMemoryTest, LargeMessagesAreTransferred)
+{
+    const std::size_t size = 3 * 1024 * 1024;
+    const int rounds = 32;
+
+    Subprocess sp("test");
+    sp.fork([&sp, size]() {
+        for (int i = 0; i < rounds; ++i) {
+            SubprocessChannel::Message msg = sp.in.read();
+            bool valid = msg.length == size && msg.data[0] == i && msg.data[size - 1] == i;
+            // answer with the same payload, written directly into the slot
+            sp.out.write(valid ? SubprocessChannel::MessageType::PROCESS_FINISHED : SubprocessChannel::MessageType::CHILD_ERROR, [&msg](uint8_t* slot, std::size_t) {
+                std::memcpy(slot, msg.data, msg.length);
+                return msg.length;
+            });
+        }
+    });
+
+    std::vector<uint8_t> payload(size);
+
+    for (int i = 0; i < rounds; ++i) {
+        std::fill(payload.begin(), payload.end(), i);
+        sp.in.write({ SubprocessChannel::MessageType::PROCESS_SYNC, payload.data(), payload.size() });
+
+        SubprocessChannel::Message answer = sp.out.read();
+        ASSERT_EQ(SubprocessChannel::MessageType::PROCESS_FINISHED, answer.type);
+        ASSERT_EQ(size, answer.length);
+        ASSERT_EQ(i, answer.data[0]);
+        ASSERT_EQ(i, answer.data[size - 1]);
+    }
+}
@@ -566,6 +566,27 @@ TEST_F(SlimSignalsTest, ChainingUpcast)
     ASSERT_TRUE(called);
 }
 
+TEST_F(SlimSignalsTest, ChainedSignalsOnlyHaveReceiversWithAFunctionAtTheirEnd)
+{
+    slim_signal::Signal<void(int)> slim_sig1;
+    slim_signal::Signal<void(int)> slim_sig2;
+
+    ASSERT_FALSE(slim_sig1.hasReceivers());
+
+    slim_sig1.connect(slim_sig2);
+    ASSERT_TRUE(slim_sig1.isConnected());
+    ASSERT_FALSE(slim_sig1.hasReceivers());
+
+    {
+        slim_signal::ScopedConnection c = slim_sig2.connect([](int) {});
+        ASSERT_TRUE(slim_sig1.hasReceivers());
+        ASSERT_TRUE(slim_sig2.hasReceivers());
+    }
+
+    ASSERT_FALSE(slim_sig1.hasReceivers());
+    ASSERT_FALSE(slim_sig2.hasReceivers());
+}
+
 TEST_F(SlimSignalsTest, Deletion)
 {
     int i = 0;
@@ -247,6 +247,37 @@ TEST_F(UUIDTest, UUIDsCanBeReshaped)
     ASSERT_THROW(baz.reshape(1000), std::invalid_argument);
 }
 
+TEST_F(UUIDTest, EqualUUIDsHaveEqualHashes)
+{
+    UUID foo = uuid_provider->generateUUID("foo");
+    UUID bar = uuid_provider->generateDerivedUUID(foo, "bar");
+
+    UUID parsed = UUIDProvider::makeUUID_without_parent("foo_0:|:bar_0");
+    ASSERT_EQ(bar, parsed);
+    ASSERT_EQ(bar.hash(), parsed.hash());
+
+    ASSERT_EQ(foo, bar.parentUUID());
+    ASSERT_EQ(foo.hash(), bar.parentUUID().hash());
+    ASSERT_EQ(foo.hash(), parsed.rootUUID().hash());
+
+    UUID bar_only = UUIDProvider::makeUUID_without_parent("bar_0");
+    ASSERT_EQ(bar_only, bar.id());
+    ASSERT_EQ(bar_only.hash(), bar.id().hash());
+    ASSERT_NE(bar_only, bar);
+}
+
+TEST_F(UUIDTest, UUIDsAreOrderedByName)
+{
+    UUID a = UUIDProvider::makeUUID_without_parent("x_0:|:a_0");
+    UUID b = UUIDProvider::makeUUID_without_parent("b_0");
+    UUID c = UUIDProvider::makeUUID_without_parent("a_0:|:b_0");
+
+    ASSERT_TRUE(a < b);
+    ASSERT_TRUE(b < c);
+    ASSERT_FALSE(b < b);
+    ASSERT_FALSE(c < a);
+}
+
 // test reshaping thoroughly
 // refactor other methods to use reshape
 // implement reshape more efficiently